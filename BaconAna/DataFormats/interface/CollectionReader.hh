@@ -0,0 +1,55 @@
+#ifndef BACONANA_DATAFORMATS_COLLECTIONREADER_HH
+#define BACONANA_DATAFORMATS_COLLECTIONREADER_HH
+
+#include <Rtypes.h>
+#include <string>
+
+class TTree;
+class TBranch;
+class TClonesArray;
+
+namespace baconhep
+{
+  class ColumnarCollection;
+
+  //
+  // Reads a Bacon collection into a TClonesArray, whether the tree holds it in the classic
+  // TClonesArray branch or in columns (see ColumnarCollection), so that analysis code sees the
+  // same objects for both formats. Code reading columnar files can also use the columns directly.
+  //
+  class CollectionReader
+  {
+    public:
+      CollectionReader(TTree *tree, const std::string &name, const char *className);
+      ~CollectionReader();
+
+      TClonesArray* array() const { return fArray; }   // owned by the reader
+
+      bool isColumnar() const { return fBranch == 0; }
+      ColumnarCollection* columns() const { return isColumnar() ? fColumns : 0; }
+
+      // Read only the given data members (separated by spaces or commas), by disabling the
+      // sub-branches or columns of the others. Members that are not read are not reset between
+      // entries in the classic format.
+      void project(const std::string &members);
+
+      // Check mode for the projections made afterwards: the members that are not read are
+      // overwritten after every entry with signaling NaNs (floating point) or all bits set (integers,
+      // bit sets), and invalid-operation exceptions are enabled, so any computation with a member
+      // missing from a projection stops the job (SIGFPE).
+      static void checkProjections(const bool check);
+
+      // read an entry of the collection into array(); returns the bytes read
+      Int_t getEntry(const Long64_t entry);
+
+
+    protected:
+      std::string          fName;
+      TTree               *fTree;
+      TClonesArray        *fArray;
+      TBranch             *fBranch;    // classic format
+      ColumnarCollection  *fColumns;   // columns of the collection, read in the columnar format
+      bool                 fCheck;     // poison the members that are not read
+  };
+}
+#endif
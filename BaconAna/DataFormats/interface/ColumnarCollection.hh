@@ -0,0 +1,107 @@
+#ifndef BACONANA_DATAFORMATS_COLUMNARCOLLECTION_HH
+#define BACONANA_DATAFORMATS_COLUMNARCOLLECTION_HH
+
+#include <Rtypes.h>
+#include <TDataType.h>
+#include <typeinfo>
+#include <string>
+#include <vector>
+
+class TTree;
+class TBranch;
+class TClass;
+class TClonesArray;
+
+namespace baconhep
+{
+  //
+  // Structure-of-arrays storage of a collection of Bacon objects (TJet, TElectron, ...):
+  // a count branch "<name>_n" and an array branch "<name>_<member>[<name>_n]" per data member
+  // of the class, taken from its dictionary. Trigger bit sets are stored as 64-bit words.
+  // Objects are written by gathering a TClonesArray into the columns, and read back either
+  // into a TClonesArray of the same objects or in place through column().
+  //
+  class ColumnarCollection
+  {
+    public:
+      ColumnarCollection(const std::string &name, const char *className);
+      ~ColumnarCollection(){}
+
+      const std::string& name()      const { return fName; }
+      const TClass*      itemClass() const { return fClass; }
+      unsigned int       size()      const { return fSize; }     // objects in the current entry
+
+      // true if the tree holds the collection in columns
+      static bool isColumnar(TTree *tree, const std::string &name);
+
+      //
+      // writing: create the branches once, then gather every entry before TTree::Fill
+      //
+      void branch(TTree *tree, const int bufsize=32000);
+      void gather(const TClonesArray &array);
+
+      //
+      // reading: connect to the tree (members without a branch keep their default),
+      // then read an entry of the collection's branches
+      //
+      bool setupRead(TTree *tree);
+      Int_t getEntry(const Long64_t entry);
+      void scatter(TClonesArray &array) const;
+
+      // values of a member for the current entry (nValues(member) per object),
+      // 0 if the member is not in the tree or has another type
+      template<class T> const T* column(const std::string &member) const {
+        const Column *col = find(member);
+        if(!col || !col->branch || col->type != TDataType::GetType(typeid(T))) return 0;
+        return reinterpret_cast<const T*>(&col->data[0]);
+      }
+      unsigned int nValues(const std::string &member) const;
+      // persistent data members of the class that have no column (neither basic types nor bit sets)
+      const std::vector<std::string>& unstored() const { return fUnstored; }
+
+      // all members of two objects of the class are equal (bitwise)
+      bool sameMembers(const void *a, const void *b) const;
+
+      //
+      // projection: only the selected members (all by default) are read; the others keep the
+      // values of a newly constructed object. Names are separated by spaces or commas, and a
+      // name that is not a data member of the class is an error; members without a column are
+      // accepted (they can be read in the classic format).
+      //
+      void select(const std::string &members);
+      const std::vector<std::string>& selected() const { return fSelected; }
+      // overwrite the members that are not selected with values no computation can take for data:
+      // signaling NaN for floating point members, all bits set for the others
+      void poison(void *obj) const;
+
+
+    protected:
+      struct Column {
+        std::string        name;       // data member
+        int                type;       // EDataType of the stored values
+        Long_t             offset;     // of the member in the object
+        unsigned int       valueSize;
+        unsigned int       memberSize; // of a value in the object (long members are stored as 64 bits)
+        unsigned int       nValues;    // per object (fixed size arrays, bit set words)
+        unsigned int       nBits;      // bit set size, 0 for basic members
+        std::string        shape;      // fixed dimensions and leaf type, e.g. "[4]/l"
+        std::vector<char>  data;
+        TBranch           *branch;
+        bool               selected;
+      };
+
+      const Column* find(const std::string &member) const;
+      void resize(Column &col, const unsigned int nObjects);
+      void store(const Column &col, const char *obj, char *dst) const;
+      void load (const Column &col, const char *src, char *obj) const;
+
+      std::string          fName;
+      TClass              *fClass;
+      std::vector<Column>  fColumns;
+      std::vector<std::string> fUnstored;
+      std::vector<std::string> fSelected;   // member names, all persistent members by default
+      Int_t                fSize;
+      TBranch             *fCountBranch;
+  };
+}
+#endif
@@ -0,0 +1,58 @@
+#ifndef BACONANA_DATAFORMATS_LUMISUMMARY_HH
+#define BACONANA_DATAFORMATS_LUMISUMMARY_HH
+
+#include <Rtypes.h>
+#include <string>
+#include <vector>
+
+class TFile;
+class TDirectory;
+
+namespace baconhep
+{
+  //
+  // Lumi section index of a Bacon ntuple, stored in the "Lumis" tree next to the Events tree:
+  // one entry per block of consecutive events of a lumi section, with the range of its entries in
+  // the Events tree and the number of events processed by the ntupler and selected (written).
+  // Analyses can skip the entries of whole lumi sections without reading any event data.
+  //
+  class LumiSummary
+  {
+    public:
+      struct Block {
+        UInt_t    run;
+        UInt_t    lumi;
+        Long64_t  firstEntry;    // in the Events tree
+        Long64_t  nEntries;
+        ULong64_t nProcessed;    // events seen by the ntupler
+        ULong64_t nSelected;     // events written
+      };
+
+      LumiSummary();
+      ~LumiSummary(){}
+
+      //
+      // writing: begin a block at every lumi section, count every event, and write the tree at the
+      // end of the job (the blocks are kept in memory until then, so that the tree is not filled
+      // while the event tree is being written)
+      //
+      void beginBlock(const UInt_t run, const UInt_t lumi);
+      void count(const bool selected);
+      void write(TDirectory *dir) const;
+
+      //
+      // reading: false if the file has no lumi summary (ntuples from older releases)
+      //
+      bool read(TFile *file);
+
+      const std::vector<Block>& blocks() const { return fBlocks; }
+
+      static const char* treeName() { return "Lumis"; }
+
+
+    protected:
+      std::vector<Block> fBlocks;
+      Long64_t           fNEntries;   // entries written so far
+  };
+}
+#endif
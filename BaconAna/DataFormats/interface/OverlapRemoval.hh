@@ -0,0 +1,60 @@
+#ifndef BACONANA_DATAFORMATS_OVERLAPREMOVAL_HH
+#define BACONANA_DATAFORMATS_OVERLAPREMOVAL_HH
+
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/ColumnarCollection.hh"
+#include <TClonesArray.h>
+#include <TLorentzVector.h>
+#include <vector>
+
+namespace baconhep
+{
+  //
+  // Overlap removal of a whole collection against a list of vetoes (the objects selected so far):
+  // an object overlaps if it is within deltaR <= cone of any veto. The veto eta and phi are kept in
+  // flat arrays, computed once per list rather than once per object, and the mask of a collection
+  // is computed in one pass per veto over the eta and phi arrays of the objects, a loop without
+  // branches or square roots that the compiler vectorizes. Each caller chooses its own cone.
+  //
+  class OverlapVetoes
+  {
+    public:
+      OverlapVetoes(){}
+      explicit OverlapVetoes(const std::vector<TLorentzVector> &vetoes) { set(vetoes); }
+      ~OverlapVetoes(){}
+
+      void set(const std::vector<TLorentzVector> &vetoes);
+      void add(const float eta, const float phi) { fEta.push_back(eta); fPhi.push_back(phi); }
+      void clear() { fEta.clear(); fPhi.clear(); }
+      unsigned int size() const { return fEta.size(); }
+
+      // mask[i] = 1 if object i (of n) overlaps with a veto, 0 otherwise
+      void mask(const float *eta, const float *phi, const unsigned int n, const float cone, std::vector<char> &mask) const;
+
+      // the same for the current entry of a collection of Bacon objects with eta and phi members,
+      // in the order of reader.array(); columnar files are read straight from their columns
+      template<class T> void mask(const CollectionReader &reader, const float cone, std::vector<char> &mask) const {
+        const ColumnarCollection *columns = reader.columns();
+        const float *eta = columns ? columns->column<float>("eta") : 0;
+        const float *phi = columns ? columns->column<float>("phi") : 0;
+        if(eta && phi) { this->mask(eta, phi, columns->size(), cone, mask); return; }
+
+        const TClonesArray &objects = *reader.array();
+        const unsigned int n = objects.GetEntriesFast();
+        fObjEta.resize(n);
+        fObjPhi.resize(n);
+        for(unsigned int i=0; i<n; i++) {
+          const T *obj = static_cast<const T*>(objects.UncheckedAt(i));
+          fObjEta[i] = obj->eta;
+          fObjPhi[i] = obj->phi;
+        }
+        this->mask(n ? &fObjEta[0] : 0, n ? &fObjPhi[0] : 0, n, cone, mask);
+      }
+
+
+    protected:
+      std::vector<float>          fEta, fPhi;         // of the vetoes
+      mutable std::vector<float>  fObjEta, fObjPhi;   // objects gathered from a TClonesArray
+  };
+}
+#endif
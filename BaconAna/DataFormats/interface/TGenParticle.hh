@@ -9,17 +9,18 @@ namespace baconhep
   {
     public:
       TGenParticle():
-	parent(-1), pdgId(0),status(0),
+	parent(-1), firstDaughter(-1), lastDaughter(-1), pdgId(0),status(0),
 	pt(0), eta(0), phi(0), mass(0), y(0)
       {}
       ~TGenParticle(){}
 
-      int   parent;
+      int   parent;                       // index of mother in particle array (-1: no mother, -2: mother not stored)
+      int   firstDaughter, lastDaughter;  // index range in particle array of the stored daughters (-1: none, -2: not a contiguous range, see parent)
       int   pdgId;
       int   status;
       float pt, eta, phi, mass, y;
 
-    ClassDef(TGenParticle,1)
+    ClassDef(TGenParticle,2)
   };
 }
 #endif
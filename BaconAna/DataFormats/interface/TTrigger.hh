@@ -6,6 +6,39 @@
 
 namespace baconhep
 {
+  //
+  // Trigger selection compiled from an expression of trigger names, e.g. "HLT_A_v* || (HLT_B_v* && !HLT_C_v*)",
+  // into masks of the bacon trigger bits (TriggerBits) or trigger object bits (TriggerObjects).
+  // The expression is kept as an OR of terms: a term passes if all its required bits are set, none of its
+  // vetoed bits is set, and at least one bit of each of its trigger object masks (triggers with several
+  // object bits) is set. A check is a few word-wise ANDs and allocates nothing.
+  //
+  template<class BitSet> class TriggerMask
+  {
+    public:
+      struct Term {
+        BitSet              all;    // required bits
+        BitSet              none;   // vetoed bits
+        std::vector<BitSet> any;    // masks with at least one bit required
+      };
+
+      bool pass(const BitSet &iBits) const {
+        for(unsigned int i0 = 0; i0 < fTerms.size(); i0++) {
+          const Term &lTerm = fTerms[i0];
+          if((iBits & lTerm.all) != lTerm.all) continue;
+          if((iBits & lTerm.none).any())       continue;
+          bool lPass = true;
+          for(unsigned int i1 = 0; i1 < lTerm.any.size() && lPass; i1++) lPass = (iBits & lTerm.any[i1]).any();
+          if(lPass) return true;
+        }
+        return false;
+      }
+
+      std::vector<Term> fTerms;
+  };
+  typedef TriggerMask<TriggerBits>    TriggerBitsMask;
+  typedef TriggerMask<TriggerObjects> TriggerObjectsMask;
+
   class TTrigger 
   {
     public:
@@ -13,10 +46,16 @@ namespace baconhep
       ~TTrigger(){}
     //Methods
     int  getTriggerBit(std::string iName);
-    int* getTriggerObjectBits(std::string iName);
+    std::vector<unsigned int> getTriggerObjectBits(std::string iName);
     int  getTriggerObjectBit(std::string iName,std::string iObjName);
     bool pass(std::string iName,TriggerBits &iTrig);
     bool passObj(std::string iName,TriggerObjects &iTrigObj);
+    //Compiled selections: names are combined with &&, || and ! (and parentheses);
+    //a trigger missing from the records never passes
+    TriggerBitsMask    compile   (std::string iExpression);
+    TriggerObjectsMask compileObj(std::string iExpression);
+    TriggerBits        triggerMask(std::string iName);
+    TriggerObjects     objectMask (std::string iName);
 
     std::vector<baconhep::TriggerRecord> fRecords;
   };
@@ -0,0 +1,85 @@
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/ColumnarCollection.hh"
+#include <TTree.h>
+#include <TBranch.h>
+#include <TClonesArray.h>
+#include <TObjArray.h>
+#include <TSystem.h>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  bool sCheckProjections = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+CollectionReader::CollectionReader(TTree *tree, const std::string &name, const char *className):
+  fName   (name),
+  fTree   (tree),
+  fArray  (new TClonesArray(className)),
+  fBranch (0),
+  fColumns(new ColumnarCollection(name, className)),
+  fCheck  (false)
+{
+  assert(fTree);
+  if(ColumnarCollection::isColumnar(fTree, name)) {
+    fColumns->setupRead(fTree);
+    return;
+  }
+  fBranch = fTree->GetBranch(name.c_str());
+  if(!fBranch) { std::cout << "[CollectionReader] no branch " << name << " in the tree!" << std::endl; assert(0); }
+  fTree->SetBranchAddress(name.c_str(), &fArray);
+}
+
+//--------------------------------------------------------------------------------------------------
+CollectionReader::~CollectionReader()
+{
+  delete fColumns;
+  delete fArray;
+}
+
+//--------------------------------------------------------------------------------------------------
+void CollectionReader::checkProjections(const bool check)
+{
+  sCheckProjections = check;
+  if(check) gSystem->SetFPEMask(kInvalid);
+}
+
+//--------------------------------------------------------------------------------------------------
+void CollectionReader::project(const std::string &members)
+{
+  fColumns->select(members);
+  fCheck = sCheckProjections;
+  if(isColumnar()) return;
+
+  // sub-branches of a split array are named "<name>.<member>", followed by the dimensions of fixed size arrays
+  const std::vector<std::string> &selected = fColumns->selected();
+  TObjArray *branches = fBranch->GetListOfBranches();
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) {
+    const std::string branchName = branches->UncheckedAt(ibr)->GetName();
+    const std::string member = branchName.substr(fName.size()+1, branchName.find('[')-fName.size()-1);
+    const bool read = std::find(selected.begin(), selected.end(), member) != selected.end();
+    fTree->SetBranchStatus(branchName.c_str(), read);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+Int_t CollectionReader::getEntry(const Long64_t entry)
+{
+  Int_t nbytes = 0;
+  if(isColumnar()) {
+    nbytes = fColumns->getEntry(entry);
+    fColumns->scatter(*fArray);
+  } else {
+    fArray->Clear();
+    nbytes = fBranch->GetEntry(entry);
+  }
+  if(fCheck) {
+    for(int iobj=0; iobj<fArray->GetEntriesFast(); iobj++) fColumns->poison(fArray->UncheckedAt(iobj));
+  }
+  return nbytes;
+}
@@ -0,0 +1,350 @@
+#include "BaconAna/DataFormats/interface/ColumnarCollection.hh"
+#include <TTree.h>
+#include <TBranch.h>
+#include <TClass.h>
+#include <TClonesArray.h>
+#include <TDataMember.h>
+#include <TList.h>
+#include <bitset>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  // leaf type code of a basic type, 0 if it cannot be stored
+  char leafCode(const int type)
+  {
+    switch(type) {
+      case kChar_t:     return 'B';
+      case kUChar_t:    return 'b';
+      case kShort_t:    return 'S';
+      case kUShort_t:   return 's';
+      case kInt_t:      return 'I';
+      case kUInt_t:     return 'i';
+      case kFloat_t:    return 'F';
+      case kFloat16_t:  return 'F';
+      case kDouble_t:   return 'D';
+      case kDouble32_t: return 'D';
+      case kLong_t:     return 'L';
+      case kULong_t:    return 'l';
+      case kLong64_t:   return 'L';
+      case kULong64_t:  return 'l';
+      case kBool_t:     return 'O';
+      default:          return 0;
+    }
+  }
+
+  // size of a std::bitset type, 0 for other types
+  unsigned int bitSetSize(const std::string &typeName)
+  {
+    const size_t pos = typeName.find("bitset<");
+    if(pos == std::string::npos) return 0;
+    const unsigned int nBits = atoi(typeName.c_str()+pos+7);
+    return (nBits == 64 || nBits == 128 || nBits == 256 || nBits == 512) ? nBits : 0;
+  }
+
+  template<size_t N> void packBits(const void *src, ULong64_t *words)
+  {
+    const std::bitset<N> &bits = *static_cast<const std::bitset<N>*>(src);
+    for(size_t iw=0; iw<N/64; iw++) {
+      ULong64_t word = 0;
+      for(size_t ib=0; ib<64; ib++) {
+        if(bits.test(iw*64+ib)) word |= (1ULL << ib);
+      }
+      words[iw] = word;
+    }
+  }
+
+  template<size_t N> void unpackBits(const ULong64_t *words, void *dst)
+  {
+    std::bitset<N> &bits = *static_cast<std::bitset<N>*>(dst);
+    for(size_t iw=0; iw<N/64; iw++) {
+      for(size_t ib=0; ib<64; ib++) bits.set(iw*64+ib, (words[iw] >> ib) & 1);
+    }
+  }
+
+  void packBits(const unsigned int nBits, const void *src, ULong64_t *words)
+  {
+    switch(nBits) {
+      case 64:  packBits<64> (src, words); break;
+      case 128: packBits<128>(src, words); break;
+      case 256: packBits<256>(src, words); break;
+      case 512: packBits<512>(src, words); break;
+    }
+  }
+
+  void unpackBits(const unsigned int nBits, const ULong64_t *words, void *dst)
+  {
+    switch(nBits) {
+      case 64:  unpackBits<64> (words, dst); break;
+      case 128: unpackBits<128>(words, dst); break;
+      case 256: unpackBits<256>(words, dst); break;
+      case 512: unpackBits<512>(words, dst); break;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+ColumnarCollection::ColumnarCollection(const std::string &name, const char *className):
+  fName       (name),
+  fClass      (TClass::GetClass(className)),
+  fSize       (0),
+  fCountBranch(0)
+{
+  if(!fClass) { std::cout << "[ColumnarCollection] no dictionary for " << className << "!" << std::endl; assert(0); }
+
+  TIter next(fClass->GetListOfDataMembers());
+  TDataMember *member = 0;
+  while((member = (TDataMember*)next())) {
+    if(!member->IsPersistent() || member->IsaPointer()) continue;
+    fSelected.push_back(member->GetName());
+
+    Column col;
+    col.name   = member->GetName();
+    col.offset = member->GetOffset();
+    col.nBits  = bitSetSize(member->GetTrueTypeName());
+    col.memberSize = 0;
+    col.branch   = 0;
+    col.selected = true;
+    std::stringstream shape;
+    if(col.nBits > 0) {
+      col.type      = kULong64_t;
+      col.valueSize = sizeof(ULong64_t);
+      col.memberSize = col.valueSize;
+      col.nValues   = col.nBits/64;
+      shape << "[" << col.nValues << "]/l";
+
+    } else if(member->IsBasic() && member->GetDataType() && leafCode(member->GetDataType()->GetType())) {
+      const int type = member->GetDataType()->GetType();
+      col.type      = (type == kDouble32_t) ? kDouble_t : ((type == kFloat16_t) ? kFloat_t : type);  // as in memory
+      col.valueSize = member->GetDataType()->Size();
+      col.memberSize = col.valueSize;
+      if(type == kLong_t || type == kULong_t) {
+        // the size of long depends on the platform: stored as 64 bits
+        col.type      = (type == kLong_t) ? kLong64_t : kULong64_t;
+        col.valueSize = sizeof(Long64_t);
+      }
+      col.nValues   = 1;
+      for(int idim=0; idim<member->GetArrayDim(); idim++) {
+        col.nValues *= member->GetMaxIndex(idim);
+        shape << "[" << member->GetMaxIndex(idim) << "]";
+      }
+      shape << "/" << leafCode(type);
+
+    } else {
+      std::cout << "[ColumnarCollection] " << className << "::" << col.name << " (" << member->GetTrueTypeName() << ") is not stored in columns" << std::endl;
+      fUnstored.push_back(col.name);
+      continue;
+    }
+    col.shape = shape.str();
+    fColumns.push_back(col);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool ColumnarCollection::isColumnar(TTree *tree, const std::string &name)
+{
+  return tree->GetBranch((name+"_n").c_str()) != 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::branch(TTree *tree, const int bufsize)
+{
+  const std::string countName = fName + "_n";
+  fCountBranch = tree->Branch(countName.c_str(), &fSize, (countName+"/I").c_str(), bufsize);
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    Column &col = fColumns[icol];
+    resize(col, 1);
+    const std::string branchName = fName + "_" + col.name;
+    const std::string leafList   = branchName + "[" + countName + "]" + col.shape;
+    col.branch = tree->Branch(branchName.c_str(), &col.data[0], leafList.c_str(), bufsize);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::gather(const TClonesArray &array)
+{
+  assert(array.GetClass() == fClass);
+  fSize = array.GetEntriesFast();
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    Column &col = fColumns[icol];
+    resize(col, fSize);
+    const unsigned int stride = col.valueSize*col.nValues;
+    for(Int_t iobj=0; iobj<fSize; iobj++) {
+      store(col, (const char*)array.UncheckedAt(iobj), &col.data[iobj*stride]);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool ColumnarCollection::setupRead(TTree *tree)
+{
+  fCountBranch = tree->GetBranch((fName+"_n").c_str());
+  if(!fCountBranch) return false;
+  fCountBranch->SetAddress(&fSize);
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    Column &col = fColumns[icol];
+    resize(col, 1);
+    col.branch = tree->GetBranch((fName+"_"+col.name).c_str());
+    if(col.branch) col.branch->SetAddress(&col.data[0]);
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+Int_t ColumnarCollection::getEntry(const Long64_t entry)
+{
+  assert(fCountBranch);
+  fSize = 0;
+  Int_t nbytes = fCountBranch->GetEntry(entry);
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    Column &col = fColumns[icol];
+    if(!col.branch || !col.selected) continue;
+    resize(col, fSize);
+    nbytes += col.branch->GetEntry(entry);
+  }
+  return nbytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::scatter(TClonesArray &array) const
+{
+  assert(array.GetClass() == fClass);
+  array.Clear();
+  for(Int_t iobj=0; iobj<fSize; iobj++) {
+    char *obj = (char*)fClass->New(array[iobj]);
+    for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+      const Column &col = fColumns[icol];
+      if(!col.branch || !col.selected) continue;
+      load(col, &col.data[iobj*col.valueSize*col.nValues], obj);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+unsigned int ColumnarCollection::nValues(const std::string &member) const
+{
+  const Column *col = find(member);
+  return col ? col->nValues : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool ColumnarCollection::sameMembers(const void *a, const void *b) const
+{
+  std::vector<char> bufA, bufB;
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    const Column &col = fColumns[icol];
+    bufA.resize(col.valueSize*col.nValues);
+    bufB.resize(col.valueSize*col.nValues);
+    store(col, (const char*)a, &bufA[0]);
+    store(col, (const char*)b, &bufB[0]);
+    if(bufA != bufB) return false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::select(const std::string &members)
+{
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) fColumns[icol].selected = false;
+  fSelected.clear();
+
+  // names are checked against the class, not the columns: members without a column can be
+  // projected in the classic format
+  std::string names(members);
+  std::replace(names.begin(), names.end(), ',', ' ');
+  std::stringstream ss(names);
+  std::string member;
+  while(ss >> member) {
+    if(!fClass->GetDataMember(member.c_str())) { std::cout << "[ColumnarCollection] " << fClass->GetName() << " has no member " << member << " to read!" << std::endl; assert(0); }
+    for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+      if(fColumns[icol].name == member) fColumns[icol].selected = true;
+    }
+    fSelected.push_back(member);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::poison(void *obj) const
+{
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    const Column &col = fColumns[icol];
+    if(col.selected) continue;
+    char *member = static_cast<char*>(obj) + col.offset;
+    if(col.type == kFloat_t) {
+      for(unsigned int ival=0; ival<col.nValues; ival++) reinterpret_cast<float*>(member)[ival] = std::numeric_limits<float>::signaling_NaN();
+    } else if(col.type == kDouble_t) {
+      for(unsigned int ival=0; ival<col.nValues; ival++) reinterpret_cast<double*>(member)[ival] = std::numeric_limits<double>::signaling_NaN();
+    } else if(col.nBits > 0) {
+      ULong64_t words[8];
+      for(unsigned int iw=0; iw<col.nValues; iw++) words[iw] = ~0ULL;
+      unpackBits(col.nBits, words, member);
+    } else if(col.type != kBool_t) {
+      memset(member, 0xff, col.memberSize*col.nValues);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+const ColumnarCollection::Column* ColumnarCollection::find(const std::string &member) const
+{
+  for(unsigned int icol=0; icol<fColumns.size(); icol++) {
+    if(fColumns[icol].name == member) return &fColumns[icol];
+  }
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::resize(Column &col, const unsigned int nObjects)
+{
+  // buffers only grow, so the branch address changes only when they are reallocated
+  const size_t bytes = std::max(nObjects, 1u)*col.valueSize*col.nValues;
+  if(col.data.size() >= bytes) return;
+  col.data.resize(bytes);
+  if(col.branch) col.branch->SetAddress(&col.data[0]);
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::store(const Column &col, const char *obj, char *dst) const
+{
+  if(col.nBits > 0) {
+    ULong64_t words[8];
+    packBits(col.nBits, obj+col.offset, words);
+    memcpy(dst, words, col.nValues*sizeof(ULong64_t));
+  } else if(col.memberSize != col.valueSize) {
+    // long members, through a 64-bit value
+    for(unsigned int ival=0; ival<col.nValues; ival++) {
+      Long64_t value = 0;
+      if(col.type == kLong64_t) value = reinterpret_cast<const long*>(obj+col.offset)[ival];
+      else                      value = reinterpret_cast<const unsigned long*>(obj+col.offset)[ival];
+      memcpy(dst+ival*sizeof(Long64_t), &value, sizeof(Long64_t));
+    }
+  } else {
+    memcpy(dst, obj+col.offset, col.valueSize*col.nValues);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void ColumnarCollection::load(const Column &col, const char *src, char *obj) const
+{
+  if(col.nBits > 0) {
+    ULong64_t words[8];
+    memcpy(words, src, col.nValues*sizeof(ULong64_t));
+    unpackBits(col.nBits, words, obj+col.offset);
+  } else if(col.memberSize != col.valueSize) {
+    for(unsigned int ival=0; ival<col.nValues; ival++) {
+      Long64_t value = 0;
+      memcpy(&value, src+ival*sizeof(Long64_t), sizeof(Long64_t));
+      if(col.type == kLong64_t) reinterpret_cast<long*>(obj+col.offset)[ival] = value;
+      else                      reinterpret_cast<unsigned long*>(obj+col.offset)[ival] = value;
+    }
+  } else {
+    memcpy(obj+col.offset, src, col.valueSize*col.nValues);
+  }
+}
@@ -0,0 +1,86 @@
+#include "BaconAna/DataFormats/interface/LumiSummary.hh"
+#include <TFile.h>
+#include <TDirectory.h>
+#include <TTree.h>
+#include <iostream>
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+LumiSummary::LumiSummary():
+  fNEntries(0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+void LumiSummary::beginBlock(const UInt_t run, const UInt_t lumi)
+{
+  Block block;
+  block.run        = run;
+  block.lumi       = lumi;
+  block.firstEntry = fNEntries;
+  block.nEntries   = 0;
+  block.nProcessed = 0;
+  block.nSelected  = 0;
+  fBlocks.push_back(block);
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiSummary::count(const bool selected)
+{
+  if(fBlocks.empty()) { std::cout << "[LumiSummary] event outside of a lumi section!" << std::endl; assert(0); }
+  Block &block = fBlocks.back();
+  block.nProcessed++;
+  if(!selected) return;
+  block.nSelected++;
+  block.nEntries++;
+  fNEntries++;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiSummary::write(TDirectory *dir) const
+{
+  TDirectory *saveDir = gDirectory;
+  dir->cd();
+  TTree *tree = new TTree(treeName(), treeName());
+  Block block;
+  tree->Branch("run",        &block.run,        "run/i");
+  tree->Branch("lumi",       &block.lumi,       "lumi/i");
+  tree->Branch("firstEntry", &block.firstEntry, "firstEntry/L");
+  tree->Branch("nEntries",   &block.nEntries,   "nEntries/L");
+  tree->Branch("nProcessed", &block.nProcessed, "nProcessed/l");
+  tree->Branch("nSelected",  &block.nSelected,  "nSelected/l");
+  for(unsigned int iblock=0; iblock<fBlocks.size(); iblock++) {
+    block = fBlocks[iblock];
+    tree->Fill();
+  }
+  tree->Write("", TObject::kOverwrite);
+  saveDir->cd();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool LumiSummary::read(TFile *file)
+{
+  fBlocks.clear();
+  fNEntries = 0;
+  TTree *tree = (TTree*)file->Get(treeName());
+  if(!tree) return false;
+
+  // the entry ranges are recomputed from the entry counts, so that they stay valid for files
+  // merged with hadd, where the Events and Lumis trees are both concatenated in file order
+  Block block;
+  tree->SetBranchAddress("run",        &block.run);
+  tree->SetBranchAddress("lumi",       &block.lumi);
+  tree->SetBranchAddress("firstEntry", &block.firstEntry);
+  tree->SetBranchAddress("nEntries",   &block.nEntries);
+  tree->SetBranchAddress("nProcessed", &block.nProcessed);
+  tree->SetBranchAddress("nSelected",  &block.nSelected);
+  for(Long64_t ientry=0; ientry<tree->GetEntries(); ientry++) {
+    tree->GetEntry(ientry);
+    block.firstEntry = fNEntries;
+    fBlocks.push_back(block);
+    fNEntries += block.nEntries;
+  }
+  delete tree;
+  return true;
+}
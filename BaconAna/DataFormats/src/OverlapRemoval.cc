@@ -0,0 +1,37 @@
+#include "BaconAna/DataFormats/interface/OverlapRemoval.hh"
+#include <TMath.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+void OverlapVetoes::set(const std::vector<TLorentzVector> &vetoes)
+{
+  fEta.resize(vetoes.size());
+  fPhi.resize(vetoes.size());
+  for(unsigned int i=0; i<vetoes.size(); i++) {
+    fEta[i] = vetoes[i].Eta();
+    fPhi[i] = vetoes[i].Phi();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void OverlapVetoes::mask(const float *eta, const float *phi, const unsigned int n, const float cone, std::vector<char> &mask) const
+{
+  mask.assign(n, 0);
+  if(n == 0) return;
+  const float twoPi = 2*TMath::Pi();
+  const float cone2 = cone*cone;
+  char *out = &mask[0];
+  for(unsigned int iveto=0; iveto<fEta.size(); iveto++) {
+    const float vetoEta = fEta[iveto];
+    const float vetoPhi = fPhi[iveto];
+    for(unsigned int i=0; i<n; i++) {
+      const float deta = eta[i] - vetoEta;
+      float dphi = std::fabs(phi[i] - vetoPhi);
+      dphi = std::min(dphi, twoPi - dphi);
+      out[i] |= (deta*deta + dphi*dphi <= cone2);
+    }
+  }
+}
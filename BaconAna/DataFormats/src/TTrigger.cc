@@ -5,9 +5,128 @@
 #include <iostream>
 #include <fstream>
 #include <limits> 
+#include <cctype>
 
 using namespace baconhep;
 
+namespace {
+  // expression in disjunctive normal form: an OR of terms, each an AND of (negated) trigger names
+  struct Literal {
+    std::string name;
+    bool        negated;
+  };
+  typedef std::vector<Literal> Conjunction;
+  typedef std::vector<Conjunction> Disjunction;
+
+  Disjunction orOf(const Disjunction &iA,const Disjunction &iB) { 
+    Disjunction lOut(iA);
+    lOut.insert(lOut.end(),iB.begin(),iB.end());
+    return lOut;
+  }
+  Disjunction andOf(const Disjunction &iA,const Disjunction &iB) { 
+    Disjunction lOut;
+    for(unsigned int i0 = 0; i0 < iA.size(); i0++) { 
+      for(unsigned int i1 = 0; i1 < iB.size(); i1++) { 
+        Conjunction lTerm(iA[i0]);
+        lTerm.insert(lTerm.end(),iB[i1].begin(),iB[i1].end());
+        lOut.push_back(lTerm);
+      }
+    }
+    return lOut;
+  }
+  Disjunction notOf(const Disjunction &iA) { 
+    // !(t1 || t2) = !t1 && !t2, with !(a && b) = !a || !b
+    Disjunction lOut(1);
+    for(unsigned int i0 = 0; i0 < iA.size(); i0++) { 
+      Disjunction lNot;
+      for(unsigned int i1 = 0; i1 < iA[i0].size(); i1++) { 
+        Literal lLit = iA[i0][i1];
+        lLit.negated = !lLit.negated;
+        lNot.push_back(Conjunction(1,lLit));
+      }
+      lOut = andOf(lOut,lNot);
+    }
+    return lOut;
+  }
+
+  // recursive descent over "||", "&&", "!" and parentheses
+  class Parser { 
+  public:
+    Parser(const std::string &iExpression) : fExpr(iExpression),fPos(0) {}
+    Disjunction parse() { 
+      Disjunction lOut = parseOr();
+      if(next() != "") error("unexpected "+next());
+      return lOut;
+    }
+  private:
+    Disjunction parseOr() { 
+      Disjunction lOut = parseAnd();
+      while(next() == "||") { take(); lOut = orOf(lOut,parseAnd()); }
+      return lOut;
+    }
+    Disjunction parseAnd() { 
+      Disjunction lOut = parseNot();
+      while(next() == "&&") { take(); lOut = andOf(lOut,parseNot()); }
+      return lOut;
+    }
+    Disjunction parseNot() { 
+      const std::string lToken = take();
+      if(lToken == "!") return notOf(parseNot());
+      if(lToken == "(") { 
+        Disjunction lOut = parseOr();
+        if(take() != ")") error("missing )");
+        return lOut;
+      }
+      if(lToken == "" || lToken == ")" || lToken == "||" || lToken == "&&") error("missing trigger name");
+      Literal lLit;
+      lLit.name    = lToken;
+      lLit.negated = false;
+      return Disjunction(1,Conjunction(1,lLit));
+    }
+    std::string next() { 
+      size_t lPos = fPos;
+      return token(lPos);
+    }
+    std::string take() { return token(fPos); }
+    std::string token(size_t &iPos) const { 
+      while(iPos < fExpr.size() && isspace(fExpr[iPos])) iPos++;
+      if(iPos >= fExpr.size()) return "";
+      const size_t lStart = iPos;
+      if(fExpr[iPos] == '!' || fExpr[iPos] == '(' || fExpr[iPos] == ')') { iPos++; return fExpr.substr(lStart,1); }
+      if(fExpr.compare(iPos,2,"&&") == 0 || fExpr.compare(iPos,2,"||") == 0) { iPos += 2; return fExpr.substr(lStart,2); }
+      while(iPos < fExpr.size() && !isspace(fExpr[iPos]) && strchr("!()&|",fExpr[iPos]) == 0) iPos++;
+      if(iPos == lStart) error(std::string("unexpected ")+fExpr[iPos]);
+      return fExpr.substr(lStart,iPos-lStart);
+    }
+    void error(const std::string &iMessage) const { 
+      std::cout << "[TTrigger] " << iMessage << " in trigger expression \"" << fExpr << "\" !" << std::endl;
+      assert(0);
+    }
+    std::string fExpr;
+    size_t      fPos;
+  };
+
+  template<class BitSet> TriggerMask<BitSet> compileMask(TTrigger &iTrigger,const std::string &iExpression,
+                                                         BitSet (TTrigger::*iMask)(std::string)) { 
+    TriggerMask<BitSet> lOut;
+    const Disjunction lTerms = Parser(iExpression).parse();
+    for(unsigned int i0 = 0; i0 < lTerms.size(); i0++) { 
+      typename TriggerMask<BitSet>::Term lTerm;
+      bool lNever = false;
+      for(unsigned int i1 = 0; i1 < lTerms[i0].size(); i1++) { 
+        const Literal &lLit = lTerms[i0][i1];
+        const BitSet lMask = (iTrigger.*iMask)(lLit.name);
+        if(lLit.negated)           lTerm.none |= lMask;  // a missing trigger never vetoes
+        else if(lMask.none())      lNever = true;        // nor passes
+        else if(lMask.count() == 1) lTerm.all  |= lMask;
+        else                        lTerm.any.push_back(lMask);
+      }
+      if(!lNever) lOut.fTerms.push_back(lTerm);
+    }
+    return lOut;
+  }
+}
+
 TTrigger::TTrigger(std::string iFileName) { 
   std::ifstream lFile(iFileName.c_str());
   assert(lFile.is_open());
@@ -45,15 +164,12 @@ int TTrigger::getTriggerBit(std::string iName) {
   if(lId == -1) std::cout << "=== Missing Trigger ==" << iName << std::endl;
   return lId;
 }
-int* TTrigger::getTriggerObjectBits(std::string iName) { 
+std::vector<unsigned int> TTrigger::getTriggerObjectBits(std::string iName) { 
+  std::vector<unsigned int> lOut;
   int lId = getTriggerBit(iName);
-  int *lOut;
-  if(lId == -1) {lOut = new int[1]; lOut[0] = -1; return lOut;}
-  int lNBins = fRecords[lId].objectMap.size()+1;
-  lOut = new int[lNBins];
-  lOut[0] = lNBins=1;
+  if(lId == -1) return lOut;
   for(unsigned int i0 = 0; i0 < fRecords[lId].objectMap.size(); i0++) { 
-    lOut[i0+1] = fRecords[lId].objectMap[i0].second;
+    lOut.push_back(fRecords[lId].objectMap[i0].second);
   }
   return lOut;
 }
@@ -81,3 +197,21 @@ bool TTrigger::passObj(std::string iName,TriggerObjects &iTrigObj) {
   }
   return lPass;
 }
+TriggerBits TTrigger::triggerMask(std::string iName) { 
+  TriggerBits lOut;
+  int lId = getTriggerBit(iName);
+  if(lId != -1) lOut[fRecords[lId].baconTrigBit] = 1;
+  return lOut;
+}
+TriggerObjects TTrigger::objectMask(std::string iName) { 
+  TriggerObjects lOut;
+  std::vector<unsigned int> lBits = getTriggerObjectBits(iName);
+  for(unsigned int i0 = 0; i0 < lBits.size(); i0++) lOut[lBits[i0]] = 1;
+  return lOut;
+}
+TriggerBitsMask TTrigger::compile(std::string iExpression) { 
+  return compileMask(*this,iExpression,&TTrigger::triggerMask);
+}
+TriggerObjectsMask TTrigger::compileObj(std::string iExpression) { 
+  return compileMask(*this,iExpression,&TTrigger::objectMask);
+}
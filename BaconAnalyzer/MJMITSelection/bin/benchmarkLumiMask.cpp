@@ -0,0 +1,151 @@
+//
+// Benchmark the lumi mask used by RunLumiRangeMap and RunLumiSet
+//
+//   benchmarkLumiMask [<golden JSON>] [<lookups>]
+//
+// Loads the JSON (a synthetic mask of 2000 runs if none is given) from memory, in JSON and in the
+// binary form, then times the lookups: in event order (runs and lumis increasing, 300 events per
+// lumi section, as when reading an ntuple) and at random, 1e9 of each kind by default. The binary
+// form and the lookups of every lumi section of the runs in the mask are first checked against
+// the JSON and a reference with the former map of runs and linear scan over their lumi ranges;
+// the job fails on any difference.
+//
+
+#include "../include/LumiMask.h"
+#include <TStopwatch.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+typedef std::map<UInt_t,std::vector<std::pair<UInt_t,UInt_t> > > ReferenceType;
+
+bool referenceHas(const ReferenceType &iRef,UInt_t iRun,UInt_t iLumi) {
+  ReferenceType::const_iterator it = iRef.find(iRun);
+  if(it == iRef.end()) return false;
+  for(unsigned int i0 = 0; i0 < it->second.size(); i0++) {
+    if(iLumi >= it->second[i0].first && iLumi <= it->second[i0].second) return true;
+  }
+  return false;
+}
+
+std::string syntheticJSON() {
+  std::stringstream lSS;
+  lSS << "{";
+  srand(1);
+  for(int i0 = 0; i0 < 2000; i0++) {
+    lSS << (i0 ? ", " : "") << "\"" << 190000+3*i0 << "\": [";
+    UInt_t lLumi = 1;
+    int lNRanges = 1+rand()%8;
+    for(int i1 = 0; i1 < lNRanges; i1++) {
+      lLumi += rand()%20;
+      UInt_t lLast = lLumi + rand()%200;
+      lSS << (i1 ? ", " : "") << "[" << lLumi << ", " << lLast << "]";
+      lLumi = lLast+2;
+    }
+    lSS << "]";
+  }
+  lSS << "}";
+  return lSS.str();
+}
+
+int main( int argc, char **argv ) {
+  std::string lJSON;
+  if(argc > 1 && std::string(argv[1]) != "-") {
+    std::ifstream lFile(argv[1]);
+    if(!lFile.is_open()) { std::cout << "[benchmarkLumiMask] " << argv[1] << " not found!" << std::endl; return 1; }
+    std::stringstream lSS; lSS << lFile.rdbuf();
+    lJSON = lSS.str();
+  } else {
+    lJSON = syntheticJSON();
+  }
+  const Long64_t lNLookups = (argc > 2) ? atoll(argv[2]) : 1000000000LL;
+  std::cout << std::fixed;
+
+  //
+  // loading
+  //
+  const int lNLoads = 100;
+  LumiMask lMask;
+  TStopwatch lTimer;
+  for(int i0 = 0; i0 < lNLoads; i0++) {
+    std::istringstream lIS(lJSON);
+    lMask.Clear();
+    lMask.ReadJSON(lIS);
+  }
+  const double lJSONSeconds = lTimer.RealTime()/lNLoads;
+
+  std::ostringstream lOS;
+  lMask.WriteBinary(lOS);
+  const std::string lBinary = lOS.str();
+  LumiMask lCopy;
+  lTimer.Start();
+  for(int i0 = 0; i0 < lNLoads; i0++) {
+    std::istringstream lIS(lBinary);
+    lCopy.Clear();
+    lCopy.ReadBinary(lIS);
+  }
+  const double lBinarySeconds = lTimer.RealTime()/lNLoads;
+
+  std::cout << "[benchmarkLumiMask] " << lMask.NIntervals() << " lumi ranges, " << lMask.NLumis() << " lumi sections" << std::endl;
+  std::cout << "  JSON   " << std::setw(9) << lJSON.size()   << " bytes, loaded in " << std::setprecision(3) << 1e3*lJSONSeconds   << " ms" << std::endl;
+  std::cout << "  binary " << std::setw(9) << lBinary.size() << " bytes, loaded in " << std::setprecision(3) << 1e3*lBinarySeconds << " ms" << std::endl;
+
+  //
+  // reference
+  //
+  ReferenceType lRef;
+  bool lSame = (lCopy.NIntervals() == lMask.NIntervals());
+  for(UInt_t i0 = 0; i0 < lMask.NIntervals(); i0++) {
+    lRef[lMask.Run(i0)].push_back(std::pair<UInt_t,UInt_t>(lMask.FirstLumi(i0),lMask.LastLumi(i0)));
+    lSame = lSame && lCopy.Run(i0) == lMask.Run(i0) && lCopy.FirstLumi(i0) == lMask.FirstLumi(i0) && lCopy.LastLumi(i0) == lMask.LastLumi(i0);
+  }
+  if(!lSame) { std::cout << "[benchmarkLumiMask] the binary form differs from the JSON!" << std::endl; return 1; }
+  if(lMask.NIntervals() == 0) { std::cout << "[benchmarkLumiMask] empty mask" << std::endl; return 0; }
+
+  // every lumi section of the runs in the mask, and some past their last range, in event order
+  std::vector<std::pair<UInt_t,UInt_t> > lLumis;
+  for(ReferenceType::const_iterator it = lRef.begin(); it != lRef.end(); ++it) {
+    for(UInt_t lLumi = 1; lLumi <= it->second.back().second+10; lLumi++) lLumis.push_back(std::pair<UInt_t,UInt_t>(it->first,lLumi));
+  }
+  for(unsigned int i0 = 0; i0 < lLumis.size(); i0++) {
+    if(lMask.Contains(lLumis[i0].first,lLumis[i0].second) != referenceHas(lRef,lLumis[i0].first,lLumis[i0].second)) {
+      std::cout << "[benchmarkLumiMask] run " << lLumis[i0].first << " lumi " << lLumis[i0].second << " differs from the reference!" << std::endl;
+      return 1;
+    }
+  }
+
+  //
+  // lookups
+  //
+  const UInt_t lFirstRun = lRef.begin()->first;
+  const UInt_t lNRuns    = lRef.rbegin()->first - lFirstRun + 2;
+  for(int iPass = 0; iPass < 2; iPass++) {
+    const bool lRandom = (iPass == 1);
+    Long64_t lNPass = 0;
+    UInt_t   lSeed  = 12345;
+    lTimer.Start();
+    for(Long64_t i0 = 0; i0 < lNLookups; i0++) {
+      UInt_t lRun, lLumi;
+      if(lRandom) {
+        lSeed = 1664525*lSeed + 1013904223;
+        lRun  = lFirstRun + (lSeed >> 8) % lNRuns;
+        lLumi = 1 + (lSeed & 0xff) % 250;
+      } else {
+        const std::pair<UInt_t,UInt_t> &lRunLumi = lLumis[(i0/300) % lLumis.size()];
+        lRun  = lRunLumi.first;
+        lLumi = lRunLumi.second;
+      }
+      lNPass += lMask.Contains(lRun,lLumi);
+    }
+    const double lSeconds = lTimer.RealTime();
+    std::cout << "  " << (lRandom ? "random  " : "in order") << " " << lNLookups << " lookups in " << std::setprecision(2) << lSeconds << " s ("
+              << std::setprecision(2) << 1e9*lSeconds/lNLookups << " ns/lookup, " << lNPass << " pass)" << std::endl;
+  }
+
+  return 0;
+}
@@ -9,72 +9,70 @@
 #include "../include/TauLoader.hh"
 #include "../include/JetLoader.hh"
 #include "../include/RunLumiRangeMap.h"
+#include "BaconAnalyzer/Utils/include/EntryRangeRunner.hh"
 
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include <boost/bind.hpp>
 #include <string>
 #include <iostream>
 
-//Object Processors
-GenLoader       *fGen      = 0; 
-EvtLoader       *fEvt      = 0; 
-MuonLoader      *fMuon     = 0; 
-ElectronLoader  *fElectron = 0; 
-LeptonLoader    *fLepton   = 0; 
-TauLoader       *fTau      = 0; 
-PhotonLoader    *fPhoton   = 0; 
-JetLoader       *fJet      = 0; 
-RunLumiRangeMap *fRangeMap = 0; 
-
-TH1F *fHist                = 0; 
-
-TTree* load(std::string iName) { 
-  TFile *lFile = TFile::Open(iName.c_str());
-  TTree *lTree = (TTree*) lFile->FindObjectAny("Events");
-  fHist        = (TH1F* ) lFile->FindObjectAny("TotalEvents");
-  return lTree;
-}
-bool passEvent(unsigned int iRun,unsigned int iLumi) { 
-  RunLumiRangeMap::RunLumiPairType lRunLumi(iRun,iLumi);
-  return fRangeMap->HasRunLumi(lRunLumi);
-}
-int main( int argc, char **argv ) {
-  gROOT->ProcessLine("#include <vector>");          
-  int maxEvents     = atoi(argv[1]);
-  std::string lName = argv[2];
-  bool        lGen  = atoi(argv[3]);
-  std::string lJSON = argv[4];
-  int         lDMu  = atoi(argv[5]);
-  double      lXS   = atof(argv[6]);
-  fRangeMap = new RunLumiRangeMap();
-  if(lJSON.size() > 0) fRangeMap->AddJSONFile(lJSON.c_str());
-
-  TTree *lTree = load(lName); 
-  if(lTree->GetEntries() < maxEvents || maxEvents == -1) maxEvents = lTree->GetEntries(); 
+//Object Processors of one entry range
+class MJMITWorker : public EntryRangeRunner::Worker { 
+public:
+  MJMITWorker(bool iGen,int iDMu,double iXS,const RunLumiRangeMap &iRangeMap) : 
+    fGen(0),fEvt(0),fMuon(0),fElectron(0),fLepton(0),fTau(0),fPhoton(0),fJet(0),fRangeMap(iRangeMap),fIsGen(iGen),fDMu(iDMu),fXS(iXS) {}
+  ~MJMITWorker() { 
+    delete fGen; delete fEvt; delete fMuon; delete fElectron; delete fLepton; delete fTau; delete fPhoton; delete fJet;
+  }
+  static EntryRangeRunner::Worker* create(bool iGen,int iDMu,double iXS,const RunLumiRangeMap *iRangeMap) { 
+    return new MJMITWorker(iGen,iDMu,iXS,*iRangeMap); 
+  }
+  void setup(TTree *iTree,TTree *iOut);
+  bool process(const Long64_t i0);
+  bool acceptLumi(const UInt_t iRun,const UInt_t iLumi) { return fIsGen || passEvent(iRun,iLumi); }
+private:
+  bool passEvent(unsigned int iRun,unsigned int iLumi) { 
+    RunLumiRangeMap::RunLumiPairType lRunLumi(iRun,iLumi);
+    return fRangeMap.HasRunLumi(lRunLumi);
+  }
+  GenLoader       *fGen; 
+  EvtLoader       *fEvt; 
+  MuonLoader      *fMuon; 
+  ElectronLoader  *fElectron; 
+  LeptonLoader    *fLepton; 
+  TauLoader       *fTau; 
+  PhotonLoader    *fPhoton; 
+  JetLoader       *fJet; 
+  RunLumiRangeMap  fRangeMap;   //own copy, the lookups cache the last range
+  bool             fIsGen;
+  int              fDMu;
+  double           fXS;
+};
+void MJMITWorker::setup(TTree *iTree,TTree *iOut) { 
+  TH1F *lHist = (TH1F*) iTree->GetCurrentFile()->FindObjectAny("TotalEvents");
   //Declare Readers
-  fEvt      = new EvtLoader     (lTree);
-  fMuon     = new MuonLoader    (lTree);
-  fElectron = new ElectronLoader(lTree);
-  fLepton   = new LeptonLoader  (lTree);
-  fTau      = new TauLoader     (lTree); 
-  fPhoton   = new PhotonLoader  (lTree); 
-  fJet      = new JetLoader     (lTree);
-  if(lGen) fGen      = new GenLoader     (lTree);
-  if(lDMu == 2) {fMuon->fMassMin = 60; fMuon->fMassMax = 120;}
+  fEvt      = new EvtLoader     (iTree);
+  fMuon     = new MuonLoader    (iTree);
+  fElectron = new ElectronLoader(iTree);
+  fLepton   = new LeptonLoader  (iTree);
+  fTau      = new TauLoader     (iTree); 
+  fPhoton   = new PhotonLoader  (iTree); 
+  fJet      = new JetLoader     (iTree);
+  if(fIsGen) fGen      = new GenLoader     (iTree);
+  if(fDMu == 2) {fMuon->fMassMin = 60; fMuon->fMassMax = 120;}
 
-  TFile *lFile = new TFile("Output.root","RECREATE");
-  TTree *lOut  = new TTree("Tree","Tree");
   //Setup Tree
-  float lWeight = float(lXS)/float(fHist->Integral())/1000.; if(!lGen) lWeight = 1.;
-  fEvt     ->setupTree      (lOut,lWeight);
-  fJet     ->setupTree      (lOut); 
-  fMuon    ->setupTree      (lOut); 
-  fElectron->setupTree      (lOut); 
-  fLepton  ->setupTree      (lOut); 
-  fTau     ->setupTree      (lOut); 
-  fPhoton  ->setupTree      (lOut); 
-  if(lGen) fGen ->setupTree      (lOut);
+  float lWeight = float(fXS)/float(lHist->Integral())/1000.; if(!fIsGen) lWeight = 1.;
+  fEvt     ->setupTree      (iOut,lWeight);
+  fJet     ->setupTree      (iOut); 
+  fMuon    ->setupTree      (iOut); 
+  fElectron->setupTree      (iOut); 
+  fLepton  ->setupTree      (iOut); 
+  fTau     ->setupTree      (iOut); 
+  fPhoton  ->setupTree      (iOut); 
+  if(fIsGen) fGen ->setupTree      (iOut);
   //Add the triggers we want
   fEvt ->addTrigger("HLT_MonoCentralPFJet80_PFMETnoMu105_NHEF0p95_v*");
   fEvt ->addTrigger("HLT_DiPFJet40_PFMETnoMu65_MJJ800VBF_AllJets_v*");
@@ -86,46 +84,59 @@ int main( int argc, char **argv ) {
 
   fJet ->addTrigger("HLT_MonoCentralPFJet80_PFMETnoMu105_NHEF0p95_v*");
   fJet ->addTrigger("HLT_DiPFJet40_PFMETnoMu65_MJJ800VBF_AllJets_v*");
+}
+bool MJMITWorker::process(const Long64_t i0) { 
+  //Load event and require trigger
+  std::vector<TLorentzVector> lVetoes; 
+  if(fDMu > 0) fMuon->load(i0);
+  if(fDMu > 0) fMuon->selectDiMuon(lVetoes);
+  if(fDMu > 0 && lVetoes.size() == 0) return false;
+  fEvt     ->load(i0);
+  fEvt     ->fillEvent(lVetoes);
+  if(fDMu == 0) if(!fEvt->passSkim()) return false;
+  if(!fIsGen && !passEvent(fEvt->fRun,fEvt->fLumi)) return false;
 
-  for(int i0 = 0; i0 < maxEvents; i0++) { 
-    if(i0 % 1000 == 0) std::cout << "===> Processed " << i0 << " - Done : " << (float(i0)/float(maxEvents)) << std::endl;
-    //Load event and require trigger
-    std::vector<TLorentzVector> lVetoes; 
-    if(lDMu > 0) fMuon->load(i0);
-    if(lDMu > 0) fMuon->selectDiMuon(lVetoes);
-    if(lDMu > 0 && lVetoes.size() == 0) continue;
-    fEvt     ->load(i0);
-    fEvt     ->fillEvent(lVetoes);
-    if(lDMu == 0) if(!fEvt->passSkim()) continue;
-    if(!lGen && !passEvent(fEvt->fRun,fEvt->fLumi)) continue;
+  if(fDMu == 0) fMuon    ->load(i0);    
+  fMuon    ->selectMuons(lVetoes);
+  fMuon    ->fillVetoes(lVetoes);
+  
+  fElectron->load(i0);
+  fElectron->selectElectrons(fEvt->fRho,lVetoes); //Add a muon veto?
+  fElectron->fillVetoes(lVetoes);
 
-    if(lDMu == 0) fMuon    ->load(i0);    
-    fMuon    ->selectMuons(lVetoes);
-    fMuon    ->fillVetoes(lVetoes);
-    
-    fElectron->load(i0);
-    fElectron->selectElectrons(fEvt->fRho,lVetoes); //Add a muon veto?
-    fElectron->fillVetoes(lVetoes);
+  //std::cout << "Size ===> " << fMuon->fSelMuons.size() << " -- " << fElectron->fSelElectrons.size() << std::endl;
+  fLepton  ->fillLeptons(fMuon->fSelMuons,fElectron->fSelElectrons); 
 
-    //std::cout << "Size ===> " << fMuon->fSelMuons.size() << " -- " << fElectron->fSelElectrons.size() << std::endl;
-    fLepton  ->fillLeptons(fMuon->fSelMuons,fElectron->fSelElectrons); 
+  fTau     ->load(i0);
+  fTau     ->selectTaus(lVetoes);
+  fTau     ->fillVetoes(lVetoes);
 
-    fTau     ->load(i0);
-    fTau     ->selectTaus(lVetoes);
-    fTau     ->fillVetoes(lVetoes);
+  fPhoton  ->load(i0);
+  fPhoton  ->selectPhotons(lVetoes,fEvt->fRho);
+  
+  fJet->load(i0); 
+  fJet->selectJets(lVetoes);
 
-    fPhoton  ->load(i0);
-    fPhoton  ->selectPhotons(lVetoes,fEvt->fRho);
-    
-    fJet->load(i0); 
-    fJet->selectJets(lVetoes);
+  if(fIsGen) fGen->load(i0);
+  if(fIsGen) fGen->selectBoson();
+  if(fIsGen) fGen->fillGenEvent();
+  return true;
+}
 
-    if(lGen) fGen->load(i0);
-    if(lGen) fGen->selectBoson();
-    if(lGen) fGen->fillGenEvent();
-    lOut->Fill();
-  }
-  lFile->cd();
-  lOut->Write();
-  lFile->Close();
+int main( int argc, char **argv ) {
+  gROOT->ProcessLine("#include <vector>");          
+  int maxEvents     = atoi(argv[1]);
+  std::string lName = argv[2];
+  bool        lGen  = atoi(argv[3]);
+  std::string lJSON = argv[4];
+  int         lDMu  = atoi(argv[5]);
+  double      lXS   = atof(argv[6]);
+  bool        lCheck = argc > 7 && atoi(argv[7]);   // check that the loaders read only the members they project
+  int         lNThreads = argc > 8 ? atoi(argv[8]) : 1;
+  CollectionReader::checkProjections(lCheck);
+  RunLumiRangeMap lRangeMap;
+  if(lJSON.size() > 0) lRangeMap.AddJSONFile(lJSON.c_str());
+
+  EntryRangeRunner lRunner(lName);
+  lRunner.run(boost::bind(&MJMITWorker::create,lGen,lDMu,lXS,&lRangeMap),maxEvents,lNThreads);
 }
@@ -2,6 +2,8 @@
 #include "TLorentzVector.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/OverlapRemoval.hh"
 #include "BaconAna/DataFormats/interface/TElectron.hh"
 
 using namespace baconhep;
@@ -27,10 +29,13 @@ public:
   std::vector<TLorentzVector> nonConversions();
   //
   std::vector<TElectron*> fSelElectrons;
+  float         fVetoCone;   //deltaR of the overlap removal against the vetoes
 
 protected: 
   TClonesArray *fElectrons;
-  TBranch      *fElectronBr;
+  CollectionReader *fElectronReader;
   TTree        *fTree;
   int           fNElectrons;
+  OverlapVetoes fVetoes;
+  std::vector<char> fOverlap;
 };
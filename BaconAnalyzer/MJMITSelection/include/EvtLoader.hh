@@ -1,3 +1,4 @@
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TEventInfo.hh"
 #include "BaconAna/DataFormats/interface/TVertex.hh"
 #include "BaconAna/DataFormats/interface/TTrigger.hh"
@@ -47,12 +48,13 @@ protected:
   TBranch      *fEvtBr;
 
   TClonesArray *fVertices;
-  TBranch      *fVertexBr;
+  CollectionReader *fVertexReader;
 
   TTree        *fTree;
   TTrigger     *fTrigger;
   
   std::vector<std::string>   fTrigString;
+  std::vector<TriggerBitsMask> fTrigMasks;   // fTrigString compiled once
   unsigned int fITrigger;
   unsigned int fHLTMatch;
   unsigned int fMetFilters;
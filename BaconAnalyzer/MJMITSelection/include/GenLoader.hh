@@ -2,6 +2,7 @@
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "TLorentzVector.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TGenEventInfo.hh"
 #include "BaconAna/DataFormats/interface/TGenParticle.hh"
 
@@ -23,7 +24,7 @@ public:
 
 protected: 
   TClonesArray  *fGens;
-  TBranch       *fGenBr;
+  CollectionReader *fGenReader;
   TGenEventInfo *fGenInfo;
   TBranch       *fGenInfoBr;
   TTree         *fTree;
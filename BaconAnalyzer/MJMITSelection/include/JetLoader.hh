@@ -2,6 +2,8 @@
 #include "TLorentzVector.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/OverlapRemoval.hh"
 #include "BaconAna/DataFormats/interface/TJet.hh"
 #include "BaconAna/DataFormats/interface/TAddJet.hh"
 #include "BaconAna/DataFormats/interface/TTrigger.hh"
@@ -30,15 +32,19 @@ public:
   //Trigger Stuff
   void addTrigger (std::string iName);
   bool passTrigObj(TJet *iJet,int iId);
+  float fVetoCone;   //deltaR of the overlap removal against the vetoes
 
 protected: 
   TClonesArray *fJets;
-  TBranch      *fJetBr;
+  CollectionReader *fJetReader;
   TClonesArray *fAddJets;
-  TBranch      *fAddJetBr;
+  CollectionReader *fAddJetReader;
   
   TTree        *fTree;
+  OverlapVetoes fVetoes;
+  std::vector<char> fOverlap;
   std::vector<std::string> fTrigString;
+  std::vector<TriggerObjectsMask> fTrigObjMasks;   // fTrigString compiled once
   TTrigger     *fTrigger;
 
   unsigned int fNJets;
@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------
+// LumiMask
+//
+// Set of accepted run,lumi ranges (e.g. a golden JSON), stored as sorted flat arrays of disjoint
+// intervals of the key run<<32|lumi. Lookups are a binary search, skipped when the key falls in
+// the same slot (between the same two interval starts) as the previous lookup, which is the
+// common case when reading events in order. The cache makes lookups non-const in effect: use one
+// copy of the mask per thread.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef _LUMIMASK_H
+#define _LUMIMASK_H
+
+#include <Rtypes.h>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+class LumiMask
+{
+ public:
+  LumiMask() : fSlot(0) {}
+
+  void                         AddRange(UInt_t run, UInt_t firstLumi, UInt_t lastLumi);
+  void                         AddLumi(UInt_t run, UInt_t lumi)        { AddRange(run,lumi,lumi); }
+  void                         Add(const LumiMask &mask);
+  void                         Clear();
+
+  // golden JSON: {"run": [[firstLumi, lastLumi], ...], ...}; asserts on a malformed file
+  void                         AddJSONFile(const std::string &filepath);
+  void                         ReadJSON(std::istream &is);
+
+  // compact binary form: varint-coded run and lumi deltas
+  void                         WriteBinary(std::ostream &os) const;
+  void                         ReadBinary(std::istream &is);
+
+  Bool_t                       Contains(UInt_t run, UInt_t lumi) const;
+
+  UInt_t                       NIntervals()                       const { return fBegin.size(); }
+  ULong64_t                    NLumis()                           const;
+  UInt_t                       Run      (UInt_t i)                const { return fBegin[i] >> 32; }
+  UInt_t                       FirstLumi(UInt_t i)                const { return fBegin[i] & 0xffffffff; }
+  UInt_t                       LastLumi (UInt_t i)                const { return fEnd[i]   & 0xffffffff; }
+
+ protected:
+  static ULong64_t             Key(UInt_t run, UInt_t lumi)             { return (ULong64_t(run) << 32) | lumi; }
+  void                         Normalize();
+
+  std::vector<ULong64_t>       fBegin;   //first key of each interval, sorted
+  std::vector<ULong64_t>       fEnd;     //last key of each interval (same run)
+  mutable size_t               fSlot;    //number of intervals starting at or before the last key looked up
+};
+#endif
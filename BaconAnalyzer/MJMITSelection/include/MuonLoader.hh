@@ -2,6 +2,8 @@
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "TLorentzVector.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/OverlapRemoval.hh"
 #include "BaconAna/DataFormats/interface/TMuon.hh"
 
 using namespace baconhep;
@@ -27,11 +29,14 @@ public:
   std::vector<TMuon *> fSelMuons;
   float            fMassMin;
   float            fMassMax;
+  float            fVetoCone;   //deltaR of the overlap removal against the vetoes
 
 protected: 
   TClonesArray    *fMuons;
-  TBranch         *fMuonBr;
+  CollectionReader *fMuonReader;
   TTree           *fTree;
   int              fNMuons;
   TLorentzVector  *fDiMuon;
+  OverlapVetoes    fVetoes;
+  std::vector<char> fOverlap;
 };
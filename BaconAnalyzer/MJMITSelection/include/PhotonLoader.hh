@@ -2,6 +2,7 @@
 #include "TLorentzVector.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TPhoton.hh"
 
 using namespace baconhep;
@@ -23,7 +24,7 @@ public:
   bool passCiCPFIso    (TPhoton *p,float iRho);
 protected: 
   TClonesArray *fPhotons;
-  TBranch      *fPhotonBr;
+  CollectionReader *fPhotonReader;
   TTree        *fTree;
   int             fNPhotons;
   TLorentzVector *fPtr1;
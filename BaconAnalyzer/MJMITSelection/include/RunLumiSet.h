@@ -14,25 +14,24 @@
 #include <TNamed.h>
 #include <TCollection.h>
 #include <TGraph.h>
-#include <set>
+#include "LumiMask.h"
 
 class RunLumiSet : public TNamed 
   {
     public:
       typedef std::pair<UInt_t,UInt_t> RunLumiPairType;
-      typedef std::set<RunLumiPairType> SetType;
     
       RunLumiSet() {}
       RunLumiSet(const TGraph &graph);
 
-      void                         Add(const RunLumiPairType &runlumi)        { fSet.insert(runlumi); }
-      UInt_t                       GetEntries()                        const  { return fSet.size();   }
-      const SetType               &runLumiSet()                        const  { return fSet;          }
+      void                         Add(const RunLumiPairType &runlumi)        { fMask.AddLumi(runlumi.first,runlumi.second); }
+      UInt_t                       GetEntries()                        const  { return fMask.NLumis(); }
+      const LumiMask              &Mask()                              const  { return fMask;          }
       Long64_t                     Merge(TCollection *list);
       //void                         DumpJSONFile(const std::string &filepath);
 
     protected:
-      SetType                      fSet;
+      LumiMask                     fMask;
 
 };
 #endif
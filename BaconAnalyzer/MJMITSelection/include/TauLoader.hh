@@ -3,6 +3,8 @@
 #include "TLorentzVector.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/OverlapRemoval.hh"
 #include "BaconAna/DataFormats/interface/TTau.hh"
 #include "BaconAna/DataFormats/interface/TElectron.hh"
 #include "BaconAna/DataFormats/interface/TPhoton.hh"
@@ -23,11 +25,14 @@ public:
   bool passTight(TTau *iTau);
   bool passVeto (TTau *iTau);
   bool passAntiEMVA3(int iCat, float raw, TString WP);
+  float fVetoCone;   //deltaR of the overlap removal against the vetoes
 protected: 
   TClonesArray *fTaus;
-  TBranch      *fTauBr;
+  CollectionReader *fTauReader;
   TTree        *fTree;
   int   fNTaus;
+  OverlapVetoes fVetoes;
+  std::vector<char> fOverlap;
   TLorentzVector *fPtr1;
   TLorentzVector *fPtr2;
   
@@ -12,13 +12,13 @@ using namespace baconhep;
 #define ELE_REFERENCE_IDMVA_CUT_BIN5  0.600   // pT>10, |eta|>1.479                                                                                                                                   
 
 ElectronLoader::ElectronLoader(TTree *iTree) { 
-  fElectrons  = new TClonesArray("baconhep::TElectron");
-  iTree->SetBranchAddress("Electron",       &fElectrons);
-  fElectronBr  = iTree->GetBranch("Electron");
+  fElectronReader = new CollectionReader(iTree, "Electron", "baconhep::TElectron");
+  fElectrons      = fElectronReader->array();
+  fElectronReader->project("pt eta phi scEt scEta scPhi ptHZZ4l ecalEnergy chHadIso03 gammaIso03 neuHadIso03 chHadIso04 gammaIso04 neuHadIso04 d0 dz sip3d sieie eoverp hovere dEtaIn dPhiIn mva q isConv nMissingHits typeBits");
+  fVetoCone       = 0.3;
 }
 ElectronLoader::~ElectronLoader() { 
-  delete fElectrons;
-  delete fElectronBr;
+  delete fElectronReader;
 }
 void ElectronLoader::reset() { 
   fNElectrons = 0; 
@@ -30,8 +30,7 @@ void ElectronLoader::setupTree(TTree *iTree) {
   fTree->Branch("nelectrons",&fNElectrons,"fNElectrons/I");
 }
 void ElectronLoader::load(int iEvent) { 
-  fElectrons   ->Clear();
-  fElectronBr ->GetEntry(iEvent);
+  fElectronReader ->getEntry(iEvent);
 }
 void ElectronLoader::fillVetoes(std::vector<TLorentzVector> &iVec) { 
   for(unsigned int i0 = 0; i0 < fSelElectrons.size(); i0++) { 
@@ -43,20 +42,14 @@ void ElectronLoader::fillVetoes(std::vector<TLorentzVector> &iVec) {
 
 bool ElectronLoader::selectElectrons(float iRho,std::vector<TLorentzVector> &iVetoes) {
   reset(); 
+  fVetoes.set(iVetoes);
+  fVetoes.mask<TElectron>(*fElectronReader,fVetoCone,fOverlap);
   int lCount = 0; 
   for  (int i0 = 0; i0 < fElectrons->GetEntriesFast(); i0++) { 
     TElectron *pElectron = (TElectron*)((*fElectrons)[i0]);
     if(pElectron->pt < 10)     continue;
     if(!passVeto(pElectron,iRho)) continue;
-    bool pMatch = false;
-    for(unsigned int i1 = 0; i1 < iVetoes.size(); i1++) { 
-      double pDEta = pElectron->eta      - iVetoes[i1].Eta();
-      double pDPhi = fabs(pElectron->phi - iVetoes[i1].Phi());
-      if(fabs(pDPhi) > 2.*TMath::Pi()-fabs(pDPhi)) pDPhi =  2.*TMath::Pi()-fabs(pDPhi);
-      if(sqrt(pDPhi*pDPhi+pDEta*pDEta) > 0.3) continue;
-      pMatch = true;
-    }
-    if(pMatch) continue;
+    if(fOverlap[i0]) continue;
     bool lFill = false;
     for( std::vector<TElectron*>::iterator pElectronIter = fSelElectrons.begin(); pElectronIter != fSelElectrons.end(); pElectronIter++) { 
       if((*pElectronIter)->pt > pElectron->pt) continue;
@@ -11,18 +11,17 @@ EvtLoader::EvtLoader(TTree *iTree,std::string iHLTFile,std::string iPUWeight) {
   fEvtBr    = iTree->GetBranch("Info");
   fTrigger  = new TTrigger(iHLTFile);
   
-  fVertices = new TClonesArray("baconhep::TVertex");
-  iTree->SetBranchAddress("PV",       &fVertices);
-  fVertexBr   = iTree->GetBranch("PV");
+  fVertexReader = new CollectionReader(iTree, "PV", "baconhep::TVertex");
+  fVertices     = fVertexReader->array();
+  fVertexReader->project("ndof x y z");
   
   TFile *lFile = new TFile(iPUWeight.c_str()); 
   fPUWeightHist = (TH1F*) lFile->FindObjectAny("pileup");
 }
 EvtLoader::~EvtLoader() { 
   delete  fEvt;
-  delete  fEvtBr;
-  delete  fVertices;
-  delete  fVertexBr;
+  delete  fTrigger;
+  delete  fVertexReader;
 }
 void EvtLoader::reset() { 
   fRun       = 0;
@@ -117,22 +116,22 @@ void EvtLoader::setupTree(TTree *iTree,float iWeight) {
   fTree->Branch("mvaMetUSig"    ,&fMVAMetUnitySig     ,"fMVAMetUnitySig/F");
 }
 void EvtLoader::load(int iEvent) { 
-  fVertices ->Clear();
   fEvtBr    ->GetEntry(iEvent);
-  fVertexBr ->GetEntry(iEvent);
+  fVertexReader ->getEntry(iEvent);
 }
 //MonoCentralPFJet80_PFMETnoMu
 //HLT_DiPFJet40_PFMETnoMu65_MJJ800VBF_AllJets_v
 void EvtLoader::addTrigger(std::string iName) { 
   fTrigString.push_back(iName);
+  fTrigMasks .push_back(fTrigger->compile(iName));
 }
 bool EvtLoader::passFilter() { 
   return (fEvt->metFilterFailBits == 0);
 }
 bool EvtLoader::passTrigger() {
   bool lPass = false;
-  for(unsigned int i0 = 0; i0 < fTrigString.size(); i0++) { 
-    if(fTrigger->pass(fTrigString[i0],fEvt->triggerBits)) lPass = true;
+  for(unsigned int i0 = 0; i0 < fTrigMasks.size(); i0++) { 
+    if(fTrigMasks[i0].pass(fEvt->triggerBits)) lPass = true;
   }
   return lPass;
 }
@@ -148,8 +147,8 @@ bool EvtLoader::passSkim() {
 }
 unsigned int EvtLoader::triggerBit() {
   unsigned int lBit = 0;
-  for(unsigned int i0 = 0; i0 < fTrigString.size(); i0++) { 
-    if(fTrigger->pass(fTrigString[i0],fEvt->triggerBits))  lBit |= 1 << i0;
+  for(unsigned int i0 = 0; i0 < fTrigMasks.size(); i0++) { 
+    if(fTrigMasks[i0].pass(fEvt->triggerBits))  lBit |= 1 << i0;
   }
   return lBit;
 }
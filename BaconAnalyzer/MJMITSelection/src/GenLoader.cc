@@ -9,16 +9,14 @@ GenLoader::GenLoader(TTree *iTree) {
   iTree->SetBranchAddress("GenEvtInfo",       &fGenInfo);
   fGenInfoBr  = iTree->GetBranch("GenEvtInfo");
 
-  fGens  = new TClonesArray("baconhep::TGenParticle");
-  iTree->SetBranchAddress("GenParticle",       &fGens);
-  fGenBr  = iTree->GetBranch("GenParticle");
+  fGenReader = new CollectionReader(iTree, "GenParticle", "baconhep::TGenParticle");
+  fGens      = fGenReader->array();
+  fGenReader->project("parent pdgId status pt eta phi mass");
 }
 GenLoader::~GenLoader() { 
   delete fGenInfo;
-  delete fGenInfoBr;
 
-  delete fGens;
-  delete fGenBr;
+  delete fGenReader;
 }
 void GenLoader::reset() { 
   fQ     = 0;
@@ -78,8 +76,7 @@ void GenLoader::setupTree(TTree *iTree) {
   fTree->Branch("genid_2"  ,&fId2 ,"fId2/I");
 }
 void GenLoader::load(int iEvent) { 
-  fGens     ->Clear();
-  fGenBr    ->GetEntry(iEvent);
+  fGenReader    ->getEntry(iEvent);
   fGenInfoBr->GetEntry(iEvent);
 }
 void GenLoader::fillGenEvent() { 
@@ -5,14 +5,15 @@
 using namespace baconhep;
 
 JetLoader::JetLoader(TTree *iTree,std::string iHLTFile) { 
-  fJets     = new TClonesArray("baconhep::TJet");
-  fAddJets  = new TClonesArray("baconhep::TAddJet");
-  iTree->SetBranchAddress("Jet05",       &fJets);
-  iTree->SetBranchAddress("AddJet05",    &fAddJets);
-  fJetBr      = iTree->GetBranch("Jet05");
-  fAddJetBr   = iTree->GetBranch("AddJet05");
+  fJetReader = new CollectionReader(iTree, "Jet05", "baconhep::TJet");
+  fJets      = fJetReader->array();
+  fJetReader->project("pt eta phi mass unc csv csv1 csv2 mva qgid qg1 qg2 tau1 tau2 tau3 tau4 prunedm nCharged nNeutrals nParticles beta betaStar dR2Mean ptD q pull pullAngle chEmFrac neuEmFrac chHadFrac neuHadFrac mcFlavor mcFlavorPhys genpt geneta genphi genm hltMatchBits");
+  fAddJetReader = new CollectionReader(iTree, "AddJet05", "baconhep::TAddJet");
+  fAddJets      = fAddJetReader->array();
+  fAddJetReader->project("index pt_p1 eta_p1 phi_p1 mass_p1 pt_t1 eta_t1 phi_t1 mass_t1");
 
   fTrigger = new TTrigger(iHLTFile);
+  fVetoCone = 0.5;
 
   fPtr1    = new TLorentzVector();
   fPtr2    = new TLorentzVector();
@@ -21,10 +22,9 @@ JetLoader::JetLoader(TTree *iTree,std::string iHLTFile) {
   fDiJet   = new TLorentzVector();
 }
 JetLoader::~JetLoader() { 
-  delete fJets;
-  delete fJetBr;
-  delete fAddJets;
-  delete fAddJetBr;
+  delete fJetReader;
+  delete fAddJetReader;
+  delete fTrigger;
 
   delete fPtr1;
   delete fPtr2; 
@@ -204,26 +204,18 @@ void JetLoader::setupTree(TTree *iTree) {
   */
 }
 void JetLoader::load(int iEvent) { 
-  fJets     ->Clear();
-  fAddJets  ->Clear();
-  fJetBr    ->GetEntry(iEvent);
-  fAddJetBr ->GetEntry(iEvent);
+  fJetReader    ->getEntry(iEvent);
+  fAddJetReader ->getEntry(iEvent);
 }
 bool JetLoader::selectJets(std::vector<TLorentzVector> &iVetoes) {
   reset(); 
+  fVetoes.set(iVetoes);
+  fVetoes.mask<TJet>(*fJetReader,fVetoCone,fOverlap);
   std::vector<TJet*> lJets;
   for  (int i0 = 0; i0 < fJets->GetEntriesFast(); i0++) { 
     TJet *pJet = (TJet*)((*fJets)[i0]);
     //Veto
-    bool pMatch = false;
-    for(unsigned int i1 = 0; i1 < iVetoes.size(); i1++) {
-      double pDEta = pJet->eta      - iVetoes[i1].Eta();
-      double pDPhi = fabs(pJet->phi - iVetoes[i1].Phi());
-      if(fabs(pDPhi) > 2.*TMath::Pi()-fabs(pDPhi)) pDPhi =  2.*TMath::Pi()-fabs(pDPhi);
-      if(sqrt(pDPhi*pDPhi+pDEta*pDEta) > 0.5) continue;
-      pMatch = true;
-    }
-    if(pMatch) continue;
+    if(fOverlap[i0]) continue;
     if(passLoose(pJet)    && pJet->pt > 30 && passPUId(pJet)) fNJets++;
     if(pJet->csv  > 0.679 && pJet->pt > 20 && passPUId(pJet)) fNBTags++;    
     if(pJet->csv  > 0.679 && pJet->pt > 10 && passPUId(pJet)) fNBTags10++;    
@@ -357,10 +349,11 @@ TAddJet *JetLoader::addJet(TJet *iJet) {
 //MonoCentralPFJet80_PFMETnoMu
 //HLT_DiPFJet40_PFMETnoMu65_MJJ800VBF_AllJets_v"
 void JetLoader::addTrigger(std::string iName) { 
-  fTrigString.push_back(iName);
+  fTrigString  .push_back(iName);
+  fTrigObjMasks.push_back(fTrigger->compileObj(iName));
 }
 bool JetLoader::passTrigObj(TJet *iJet,int iId) {
   bool lPass = false;
-  if(fTrigger->passObj(fTrigString[iId],iJet->hltMatchBits))  lPass = true;
+  if(fTrigObjMasks[iId].pass(iJet->hltMatchBits))  lPass = true;
   return lPass;
 }
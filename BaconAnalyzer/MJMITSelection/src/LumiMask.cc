@@ -0,0 +1,241 @@
+#include "../include/LumiMask.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cctype>
+#include <cassert>
+
+namespace {
+  const char kMagic[4] = { 'L','M','S','K' };
+
+  // single pass reader of the golden JSON format straight from the stream buffer
+  class JSONReader
+  {
+  public:
+    JSONReader(std::istream &is) : fBuf(is.rdbuf()),fPos(0) {}
+    void Expect(char c) {
+      if(!Accept(c)) Error(std::string("expected '")+c+"'");
+    }
+    bool Accept(char c) {
+      SkipSpace();
+      if(fBuf->sgetc() != c) return false;
+      Bump();
+      return true;
+    }
+    UInt_t Number() {
+      SkipSpace();
+      ULong64_t value = 0;
+      int n = 0;
+      for(int c = fBuf->sgetc(); c != EOF && isdigit(c); c = fBuf->sgetc(), n++) {
+        value = 10*value + (c-'0');
+        if(value > 0xffffffffULL) Error("number out of range");
+        Bump();
+      }
+      if(n == 0) Error("expected a number");
+      return UInt_t(value);
+    }
+    void Error(const std::string &what) const {
+      std::cout << "[LumiMask] malformed JSON: " << what << " at byte " << fPos << " !" << std::endl;
+      assert(0);
+    }
+  private:
+    void SkipSpace() { while(fBuf->sgetc() != EOF && isspace(fBuf->sgetc())) Bump(); }
+    void Bump()      { fBuf->sbumpc(); fPos++; }
+    std::streambuf *fBuf;
+    ULong64_t       fPos;
+  };
+
+  // number of keys <= key: a binary search whose steps are conditional moves rather than branches,
+  // about four times faster than std::upper_bound for random keys
+  size_t UpperBound(const std::vector<ULong64_t> &keys, const ULong64_t key) {
+    if(keys.empty()) return 0;
+    const ULong64_t *base = &keys[0];
+    size_t n = keys.size();
+    while(n > 1) {
+      const size_t half = n/2;
+      base = (base[half] <= key) ? base+half : base;
+      n -= half;
+    }
+    return (base-&keys[0]) + (*base <= key);
+  }
+
+  void WriteVarint(std::ostream &os, ULong64_t value) {
+    while(value >= 0x80) { os.put(char((value & 0x7f) | 0x80)); value >>= 7; }
+    os.put(char(value));
+  }
+  ULong64_t ReadVarint(std::istream &is) {
+    ULong64_t value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+      const int c = is.get();
+      if(c == EOF) { std::cout << "[LumiMask] truncated binary mask !" << std::endl; assert(0); }
+      value |= ULong64_t(c & 0x7f) << shift;
+      if(!(c & 0x80)) return value;
+    }
+    std::cout << "[LumiMask] corrupt binary mask !" << std::endl;
+    assert(0);
+    return value;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::AddRange(UInt_t run, UInt_t firstLumi, UInt_t lastLumi)
+{
+  // Insert [firstLumi,lastLumi] in place, merging it with the overlapping or adjacent intervals of the run
+  assert(firstLumi <= lastLumi);
+  ULong64_t begin = Key(run,firstLumi);
+  ULong64_t end   = Key(run,lastLumi);
+
+  size_t i = std::upper_bound(fBegin.begin(),fBegin.end(),begin) - fBegin.begin();
+  if(i > 0 && (fEnd[i-1] >> 32) == run && fEnd[i-1]+1 >= begin) { --i; begin = fBegin[i]; }
+  size_t j = i;
+  while(j < fBegin.size() && (fBegin[j] >> 32) == run && fBegin[j] <= end+1) { end = std::max(end,fEnd[j]); ++j; }
+
+  if(j > i) {
+    fBegin[i] = begin;
+    fEnd  [i] = end;
+    fBegin.erase(fBegin.begin()+i+1,fBegin.begin()+j);
+    fEnd  .erase(fEnd  .begin()+i+1,fEnd  .begin()+j);
+  } else {
+    fBegin.insert(fBegin.begin()+i,begin);
+    fEnd  .insert(fEnd  .begin()+i,end);
+  }
+  fSlot = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::Add(const LumiMask &mask)
+{
+  fBegin.insert(fBegin.end(),mask.fBegin.begin(),mask.fBegin.end());
+  fEnd  .insert(fEnd  .end(),mask.fEnd  .begin(),mask.fEnd  .end());
+  Normalize();
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::Clear()
+{
+  fBegin.clear();
+  fEnd  .clear();
+  fSlot = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::Normalize()
+{
+  // Sort the intervals and merge the overlapping or adjacent ones of each run
+  std::vector<std::pair<ULong64_t,ULong64_t> > intervals(fBegin.size());
+  for(size_t i=0; i<fBegin.size(); ++i) intervals[i] = std::make_pair(fBegin[i],fEnd[i]);
+  std::sort(intervals.begin(),intervals.end());
+
+  fBegin.clear();
+  fEnd  .clear();
+  for(size_t i=0; i<intervals.size(); ++i) {
+    const ULong64_t begin = intervals[i].first;
+    const ULong64_t end   = intervals[i].second;
+    if(!fEnd.empty() && (fEnd.back() >> 32) == (begin >> 32) && fEnd.back()+1 >= begin) {
+      fEnd.back() = std::max(fEnd.back(),end);
+    } else {
+      fBegin.push_back(begin);
+      fEnd  .push_back(end);
+    }
+  }
+  fSlot = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::AddJSONFile(const std::string &filepath)
+{
+  std::ifstream is(filepath.c_str());
+  if(!is.is_open()) { std::cout << "[LumiMask] cannot open " << filepath << " !" << std::endl; assert(0); }
+  ReadJSON(is);
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::ReadJSON(std::istream &is)
+{
+  JSONReader reader(is);
+  reader.Expect('{');
+  if(!reader.Accept('}')) {
+    do {
+      const bool quoted = reader.Accept('"');
+      const UInt_t run = reader.Number();
+      if(quoted) reader.Expect('"');
+      reader.Expect(':');
+      reader.Expect('[');
+      if(!reader.Accept(']')) {
+        do {
+          reader.Expect('[');
+          const UInt_t firstLumi = reader.Number();
+          reader.Expect(',');
+          const UInt_t lastLumi  = reader.Number();
+          reader.Expect(']');
+          if(firstLumi > lastLumi) reader.Error("decreasing lumi range");
+          fBegin.push_back(Key(run,firstLumi));
+          fEnd  .push_back(Key(run,lastLumi));
+        } while(reader.Accept(','));
+        reader.Expect(']');
+      }
+    } while(reader.Accept(','));
+    reader.Expect('}');
+  }
+  Normalize();
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::WriteBinary(std::ostream &os) const
+{
+  // per interval: run delta, gap to the previous interval of the run (or first lumi), length
+  os.write(kMagic,sizeof(kMagic));
+  WriteVarint(os,fBegin.size());
+  UInt_t lastRun = 0, lastLumi = 0;
+  for(size_t i=0; i<fBegin.size(); ++i) {
+    const UInt_t run = Run(i);
+    WriteVarint(os,run-lastRun);
+    WriteVarint(os,(i > 0 && run == lastRun) ? FirstLumi(i)-lastLumi : FirstLumi(i));
+    WriteVarint(os,LastLumi(i)-FirstLumi(i));
+    lastRun  = run;
+    lastLumi = LastLumi(i);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void LumiMask::ReadBinary(std::istream &is)
+{
+  char magic[sizeof(kMagic)];
+  if(!is.read(magic,sizeof(magic)) || !std::equal(magic,magic+sizeof(magic),kMagic)) {
+    std::cout << "[LumiMask] not a binary lumi mask !" << std::endl;
+    assert(0);
+  }
+  const ULong64_t n = ReadVarint(is);
+  UInt_t lastRun = 0, lastLumi = 0;
+  for(ULong64_t i=0; i<n; ++i) {
+    const UInt_t run       = lastRun + ReadVarint(is);
+    const UInt_t firstLumi = ((i > 0 && run == lastRun) ? lastLumi : 0) + ReadVarint(is);
+    const UInt_t lastLumiI = firstLumi + ReadVarint(is);
+    fBegin.push_back(Key(run,firstLumi));
+    fEnd  .push_back(Key(run,lastLumiI));
+    lastRun  = run;
+    lastLumi = lastLumiI;
+  }
+  Normalize();
+}
+
+//--------------------------------------------------------------------------------------------------
+Bool_t LumiMask::Contains(UInt_t run, UInt_t lumi) const
+{
+  const ULong64_t key = Key(run,lumi);
+  const size_t    n   = fBegin.size();
+  size_t slot = fSlot;
+  if(slot > n || (slot > 0 && fBegin[slot-1] > key) || (slot < n && fBegin[slot] <= key)) {
+    slot  = UpperBound(fBegin,key);
+    fSlot = slot;
+  }
+  return slot > 0 && key <= fEnd[slot-1];
+}
+
+//--------------------------------------------------------------------------------------------------
+ULong64_t LumiMask::NLumis() const
+{
+  ULong64_t n = 0;
+  for(size_t i=0; i<fBegin.size(); ++i) n += fEnd[i] - fBegin[i] + 1;
+  return n;
+}
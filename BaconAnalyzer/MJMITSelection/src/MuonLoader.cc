@@ -5,16 +5,16 @@
 using namespace baconhep;
 
 MuonLoader::MuonLoader(TTree *iTree) { 
-  fMuons  = new TClonesArray("baconhep::TMuon");
-  iTree->SetBranchAddress("Muon",       &fMuons);
-  fMuonBr  = iTree->GetBranch("Muon");
+  fMuonReader = new CollectionReader(iTree, "Muon", "baconhep::TMuon");
+  fMuons      = fMuonReader->array();
+  fMuonReader->project("pt eta phi ptErr chHadIso04 gammaIso04 neuHadIso04 puIso04 d0 dz muNchi2 trkKink q nValidHits typeBits selectorBits nPixHits nTkLayers nMatchStn");
   fDiMuon  = new TLorentzVector(0.,0.,0.,0.);
   fMassMin = 115;
   fMassMax = 130;
+  fVetoCone = 0.3;
 }
 MuonLoader::~MuonLoader() { 
-  delete fMuons;
-  delete fMuonBr;
+  delete fMuonReader;
   delete fDiMuon;
 }
 void MuonLoader::resetDiMu() { 
@@ -30,8 +30,7 @@ void MuonLoader::setupTree(TTree *iTree) {
   fTree->Branch("dimu"   ,"TLorentzVector", &fDiMuon);
 }
 void MuonLoader::load(int iEvent) { 
-  fMuons   ->Clear();
-  fMuonBr ->GetEntry(iEvent);
+  fMuonReader ->getEntry(iEvent);
 }
 void MuonLoader::fillVetoes(std::vector<TLorentzVector> &iVec) { 
   for(unsigned int i0 = 0; i0 < fSelMuons.size(); i0++) { 
@@ -42,20 +41,14 @@ void MuonLoader::fillVetoes(std::vector<TLorentzVector> &iVec) {
 }
 bool MuonLoader::selectMuons(std::vector<TLorentzVector>& iVetoes) {
   reset(); 
+  fVetoes.set(iVetoes);
+  fVetoes.mask<TMuon>(*fMuonReader,fVetoCone,fOverlap);
   int  lNCount = 0; 
   for  (int i0 = 0; i0 < fMuons->GetEntriesFast(); i0++) { 
     TMuon *pMuon = (TMuon*)((*fMuons)[i0]);
     if(pMuon->pt > 10 && fabs(pMuon->eta) < 2.4) lNCount++;
     if(!passWW(pMuon)) continue;
-    bool pMatch = false;
-    for(unsigned int i1 = 0; i1 < iVetoes.size(); i1++) { 
-      double pDEta = pMuon->eta      - iVetoes[i1].Eta();
-      double pDPhi = fabs(pMuon->phi - iVetoes[i1].Phi());
-      if(fabs(pDPhi) > 2.*TMath::Pi()-fabs(pDPhi)) pDPhi =  2.*TMath::Pi()-fabs(pDPhi);
-      if(sqrt(pDPhi*pDPhi+pDEta*pDEta) > 0.3) continue;
-      pMatch = true;
-    }
-    if(pMatch) continue;
+    if(fOverlap[i0]) continue;
     bool lFill = false;
     for( std::vector<TMuon*>::iterator pMuonIter = fSelMuons.begin(); pMuonIter != fSelMuons.end(); pMuonIter++) { 
       if((*pMuonIter)->pt > pMuon->pt) continue;
@@ -4,13 +4,12 @@
 using namespace baconhep;
 
 PhotonLoader::PhotonLoader(TTree *iTree) { 
-  fPhotons  = new TClonesArray("baconhep::TPhoton");
-  iTree->SetBranchAddress("Photon",       &fPhotons);
-  fPhotonBr  = iTree->GetBranch("Photon");
+  fPhotonReader = new CollectionReader(iTree, "Photon", "baconhep::TPhoton");
+  fPhotons      = fPhotonReader->array();
+  fPhotonReader->project("pt eta phi scEta r9 ecalIso04 hcalIso04 chHadIso03 gammaIso03 neuHadIso03 hovere sieie");
 }
 PhotonLoader::~PhotonLoader() { 
-  delete fPhotons;
-  delete fPhotonBr;
+  delete fPhotonReader;
 }
 void PhotonLoader::reset() { 
   fNPhotons = 0; 
@@ -24,8 +23,7 @@ void PhotonLoader::setupTree(TTree *iTree) {
   fTree->Branch("pho1"     ,"TLorentzVector", &fPtr1);
 }
 void PhotonLoader::load(int iEvent) { 
-  fPhotons   ->Clear();
-  fPhotonBr ->GetEntry(iEvent);
+  fPhotonReader ->getEntry(iEvent);
 }
 void PhotonLoader::fillVetoes(std::vector<TLorentzVector> &iVec) { 
   TLorentzVector pVec;
@@ -8,7 +8,7 @@ RunLumiSet::RunLumiSet(const TGraph &graph)
     Double_t run;
     Double_t lumi;
     graph.GetPoint(i,run,lumi);
-    fSet.insert(RunLumiPairType(run,lumi));
+    fMask.AddLumi(UInt_t(run),UInt_t(lumi));
   }
   
 }
@@ -22,7 +22,7 @@ Long64_t RunLumiSet::Merge(TCollection *list)
   while( (obj=iter.Next()) ) {
     const RunLumiSet *mergeset = dynamic_cast<const RunLumiSet*>(obj);
     if (mergeset) {
-      fSet.insert(mergeset->runLumiSet().begin(), mergeset->runLumiSet().end());
+      fMask.Add(mergeset->Mask());
       nmerged++;
     }
   }
@@ -4,13 +4,13 @@
 using namespace baconhep;
 
 TauLoader::TauLoader(TTree *iTree) { 
-  fTaus  = new TClonesArray("baconhep::TTau");
-  iTree->SetBranchAddress("Tau",       &fTaus);
-  fTauBr  = iTree->GetBranch("Tau");
+  fTauReader = new CollectionReader(iTree, "Tau", "baconhep::TTau");
+  fTaus      = fTauReader->array();
+  fTauReader->project("pt eta phi m antiEleMVA3Cat rawIso3Hits hpsDisc");
+  fVetoCone  = 0.5;
 }
 TauLoader::~TauLoader() { 
-  delete fTaus;
-  delete fTauBr;
+  delete fTauReader;
 }
 void TauLoader::reset() { 
   fNTaus = 0; 
@@ -48,8 +48,7 @@ void TauLoader::setupTree(TTree *iTree) {
   */
 }
 void TauLoader::load(int iEvent) { 
-  fTaus   ->Clear();
-  fTauBr ->GetEntry(iEvent);
+  fTauReader ->getEntry(iEvent);
 }
 void TauLoader::fillVetoes(std::vector<TLorentzVector> &iVec) { 
   TLorentzVector pVec1,pVec2;
@@ -60,6 +59,8 @@ void TauLoader::fillVetoes(std::vector<TLorentzVector> &iVec) {
 }
 bool TauLoader::selectTaus(std::vector<TLorentzVector> iVetoes) {
   reset(); 
+  fVetoes.set(iVetoes);
+  fVetoes.mask<TTau>(*fTauReader,fVetoCone,fOverlap);
   int lCount = 0; 
   TTau *lTau1 = 0; 
   TTau *lTau2 = 0; 
@@ -67,15 +68,7 @@ bool TauLoader::selectTaus(std::vector<TLorentzVector> iVetoes) {
     TTau *pTau = (TTau*)((*fTaus)[i0]);
     if(pTau->pt < 15.)            continue;
     if(!passLoose(pTau))          continue;
-    bool pMatch = false;
-    for(unsigned int i1 = 0; i1 < iVetoes.size(); i1++) { 
-      double pDEta = pTau->eta      - iVetoes[i1].Eta();
-      double pDPhi = fabs(pTau->phi - iVetoes[i1].Phi());
-      if(fabs(pDPhi) > 2.*TMath::Pi()-fabs(pDPhi)) pDPhi =  2.*TMath::Pi()-fabs(pDPhi);
-      if(sqrt(pDPhi*pDPhi+pDEta*pDEta) > 0.5) continue;
-      pMatch = true;
-    }
-    if(pMatch) continue;
+    if(fOverlap[i0]) continue;
     if(lTau1 == 0) lTau1 = pTau;
     if(pTau->pt > lTau1->pt) {lTau2 = pTau; lTau1 = pTau; continue;}
     if(lTau2 == 0)            lTau2 = pTau;
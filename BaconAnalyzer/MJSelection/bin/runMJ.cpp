@@ -7,83 +7,90 @@
 #include "../include/PhotonLoader.hh"
 #include "../include/TauLoader.hh"
 #include "../include/JetLoader.hh"
+#include "BaconAnalyzer/Utils/include/EntryRangeRunner.hh"
 
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include <boost/bind.hpp>
 #include <string>
 #include <iostream>
 
-//Object Processors
-GenLoader       *fGen      = 0; 
-EvtLoader       *fEvt      = 0; 
-MuonLoader      *fMuon     = 0; 
-ElectronLoader  *fElectron = 0; 
-TauLoader       *fTau      = 0; 
-PhotonLoader    *fPhoton   = 0; 
-JetLoader       *fJet      = 0; 
-
-TTree* load(std::string iName) { 
-  TFile *lFile = TFile::Open(iName.c_str());
-  TTree *lTree = (TTree*) lFile->FindObjectAny("Events");
-  return lTree;
-}
-int main( int argc, char **argv ) {
-  gROOT->ProcessLine("#include <vector>");          
-  int maxEvents     = atoi(argv[1]);
-  std::string lName = argv[2];
-  bool        lGen  = atoi(argv[3]);
-  //void runBacon(int iNEvents=10,std::string lName="test.root",bool lGen=false) {   
-  TTree *lTree = load(lName); 
-  if(lTree->GetEntries() < maxEvents || maxEvents == -1) maxEvents = lTree->GetEntries(); 
+//Object Processors of one entry range
+class MJWorker : public EntryRangeRunner::Worker { 
+public:
+  MJWorker(bool iGen) : fGen(0),fEvt(0),fMuon(0),fElectron(0),fTau(0),fPhoton(0),fJet(0),fIsGen(iGen) {}
+  ~MJWorker() { 
+    delete fGen; delete fEvt; delete fMuon; delete fElectron; delete fTau; delete fPhoton; delete fJet;
+  }
+  static EntryRangeRunner::Worker* create(bool iGen) { return new MJWorker(iGen); }
+  void setup(TTree *iTree,TTree *iOut);
+  bool process(const Long64_t i0);
+private:
+  GenLoader       *fGen; 
+  EvtLoader       *fEvt; 
+  MuonLoader      *fMuon; 
+  ElectronLoader  *fElectron; 
+  TauLoader       *fTau; 
+  PhotonLoader    *fPhoton; 
+  JetLoader       *fJet; 
+  bool             fIsGen;
+};
+void MJWorker::setup(TTree *iTree,TTree *iOut) { 
   //Declare Readers
-  fEvt      = new EvtLoader     (lTree);
-  fMuon     = new MuonLoader    (lTree);
-  fElectron = new ElectronLoader(lTree); 
-  fTau      = new TauLoader     (lTree); 
-  fPhoton   = new PhotonLoader  (lTree); 
-  fJet      = new JetLoader     (lTree);
-  if(lGen) fGen      = new GenLoader     (lTree);
-
-  TFile *lFile = new TFile("Output.root","RECREATE");
-  TTree *lOut  = new TTree("Tree","Tree");
+  fEvt      = new EvtLoader     (iTree);
+  fMuon     = new MuonLoader    (iTree);
+  fElectron = new ElectronLoader(iTree); 
+  fTau      = new TauLoader     (iTree); 
+  fPhoton   = new PhotonLoader  (iTree); 
+  fJet      = new JetLoader     (iTree);
+  if(fIsGen) fGen      = new GenLoader     (iTree);
   //Setup Tree
-  fEvt ->setupTree      (lOut);
-  fJet ->setupTree      (lOut); 
-  if(lGen) fGen ->setupTree      (lOut);
+  fEvt ->setupTree      (iOut);
+  fJet ->setupTree      (iOut); 
+  if(fIsGen) fGen ->setupTree      (iOut);
   //Add the triggers we want
   fEvt ->addTrigger("HLT_MET80_Parked_v*");
   fEvt ->addTrigger("HLT_MET80_Parked_v*");
   fEvt ->addTrigger("HLT_MonoCentralPFJet80_PFMETnoMu105_NHEF0p95_v*");
   fEvt ->addTrigger("HLT_MET100_HBHENoiseCleaned_v*");
   fEvt ->addTrigger("HLT_MET120_HBHENoiseCleaned_v*");
-  for(int i0 = 0; i0 < maxEvents; i0++) { 
-    if(i0 % 1000 == 0) std::cout << "===> Processed " << i0 << " - Done : " << (float(i0)/float(maxEvents)) << std::endl;
-    //Load event and require trigger
-    fEvt    ->load(i0);
-    if(!fEvt->passTrigger()) continue;
-    //Apply all Lepton  Vetoes => do we want a pt cut?
-    fTau     ->load(i0);
-    if(fTau->vetoTau()) continue;
-    fMuon    ->load(i0);
-    if(fMuon->vetoMu()) continue;
-    fElectron ->load(i0);
-    if(fElectron->vetoEle(fEvt->fRho)) continue;
-    //Apply a photon veto? (to be checked)
-    //fPhoton ->load(i0);
-    //if(!fPhoton->vetoPhoton()) continue;
+}
+bool MJWorker::process(const Long64_t i0) { 
+  //Load event and require trigger
+  fEvt    ->load(i0);
+  if(!fEvt->passTrigger()) return false;
+  //Apply all Lepton  Vetoes => do we want a pt cut?
+  fTau     ->load(i0);
+  if(fTau->vetoTau()) return false;
+  fMuon    ->load(i0);
+  if(fMuon->vetoMu()) return false;
+  fElectron ->load(i0);
+  if(fElectron->vetoEle(fEvt->fRho)) return false;
+  //Apply a photon veto? (to be checked)
+  //fPhoton ->load(i0);
+  //if(!fPhoton->vetoPhoton()) return false;
 
-    //Select a Jet (to be fixed by Dan)
-    fJet->load(i0); 
-    if(!fJet->selectSingleJet()) continue;
-    //Make the flat ntuple
-    fEvt    ->fillEvent();
-    //This needs to be fixed
-    if(lGen) fGen->load(i0);
-    if(lGen) fGen->selectBoson();
-    lOut->Fill();
-  }
-  lFile->cd();
-  lOut->Write();
-  lFile->Close();
+  //Select a Jet (to be fixed by Dan)
+  fJet->load(i0); 
+  if(!fJet->selectSingleJet()) return false;
+  //Make the flat ntuple
+  fEvt    ->fillEvent();
+  //This needs to be fixed
+  if(fIsGen) fGen->load(i0);
+  if(fIsGen) fGen->selectBoson();
+  return true;
+}
+
+int main( int argc, char **argv ) {
+  gROOT->ProcessLine("#include <vector>");          
+  int maxEvents     = atoi(argv[1]);
+  std::string lName = argv[2];
+  bool        lGen  = atoi(argv[3]);
+  bool        lCheck = argc > 4 && atoi(argv[4]);   // check that the loaders read only the members they project
+  int         lNThreads = argc > 5 ? atoi(argv[5]) : 1;
+  CollectionReader::checkProjections(lCheck);
+  //void runBacon(int iNEvents=10,std::string lName="test.root",bool lGen=false) {   
+  EntryRangeRunner lRunner(lName);
+  lRunner.run(boost::bind(&MJWorker::create,lGen),maxEvents,lNThreads);
 }
@@ -1,6 +1,7 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TElectron.hh"
 
 using namespace baconhep;
@@ -20,7 +21,7 @@ public:
 
 protected: 
   TClonesArray *fElectrons;
-  TBranch      *fElectronBr;
+  CollectionReader *fElectronReader;
   TTree        *fTree;
   float fPt;
   float fEta;
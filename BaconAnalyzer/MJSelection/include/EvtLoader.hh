@@ -36,6 +36,7 @@ protected:
   TTrigger     *fTrigger;
   
   std::vector<std::string>   fTrigString;
+  std::vector<TriggerBitsMask> fTrigMasks;   // fTrigString compiled once
   unsigned int fRun;
   unsigned int fEvtV;
   unsigned int fLumi;
@@ -2,6 +2,7 @@
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "TLorentzVector.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TGenParticle.hh"
 
 using namespace baconhep;
@@ -19,7 +20,7 @@ public:
 
 protected: 
   TClonesArray *fGens;
-  TBranch      *fGenBr;
+  CollectionReader *fGenReader;
   TTree        *fTree;
   float fVPt;
   float fVEta;
@@ -1,6 +1,7 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TJet.hh"
 
 using namespace baconhep;
@@ -19,7 +20,7 @@ public:
   bool passVeto       (TJet *iJet);
 protected: 
   TClonesArray *fJets;
-  TBranch      *fJetBr;
+  CollectionReader *fJetReader;
   TTree        *fTree;
   float         fPt;
   float         fEta;
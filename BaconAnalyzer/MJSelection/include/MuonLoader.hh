@@ -2,6 +2,7 @@
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "TLorentzVector.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TMuon.hh"
 
 using namespace baconhep;
@@ -21,7 +22,7 @@ public:
 
 protected: 
   TClonesArray *fMuons;
-  TBranch      *fMuonBr;
+  CollectionReader *fMuonReader;
   TTree        *fTree;
   float fPt;
   float fEta;
@@ -12,13 +12,12 @@ using namespace baconhep;
 #define ELE_REFERENCE_IDMVA_CUT_BIN5  0.600   // pT>10, |eta|>1.479                                                                                                                                   
 
 ElectronLoader::ElectronLoader(TTree *iTree) { 
-  fElectrons  = new TClonesArray("baconhep::TElectron");
-  iTree->SetBranchAddress("Electron",       &fElectrons);
-  fElectronBr  = iTree->GetBranch("Electron");
+  fElectronReader = new CollectionReader(iTree, "Electron", "baconhep::TElectron");
+  fElectrons      = fElectronReader->array();
+  fElectronReader->project("pt eta phi scEta ptHZZ4l ecalEnergy chHadIso03 gammaIso03 neuHadIso03 chHadIso04 gammaIso04 neuHadIso04 d0 dz sip3d sieie eoverp hovere dEtaIn dPhiIn mva isConv nMissingHits typeBits");
 }
 ElectronLoader::~ElectronLoader() { 
-  delete fElectrons;
-  delete fElectronBr;
+  delete fElectronReader;
 }
 void ElectronLoader::reset() { 
   fPt   = 0; 
@@ -33,8 +32,7 @@ void ElectronLoader::setupTree(TTree *iTree) {
   fTree->Branch("phi_1" ,&fPhi,"fPhi/F");
 }
 void ElectronLoader::load(int iEvent) { 
-  fElectrons   ->Clear();
-  fElectronBr ->GetEntry(iEvent);
+  fElectronReader ->getEntry(iEvent);
 }
 bool ElectronLoader::selectSingleEle(float iRho) {
   reset(); 
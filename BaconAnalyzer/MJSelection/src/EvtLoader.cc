@@ -10,7 +10,7 @@ EvtLoader::EvtLoader(TTree *iTree,std::string iHLTFile) {
 }
 EvtLoader::~EvtLoader() { 
   delete  fEvt;
-  delete  fEvtBr;
+  delete  fTrigger;
 }
 void EvtLoader::reset() { 
   fRun       = 0;
@@ -66,11 +66,12 @@ void EvtLoader::load(int iEvent) {
 }
 void EvtLoader::addTrigger(std::string iName) { 
   fTrigString.push_back(iName);
+  fTrigMasks .push_back(fTrigger->compile(iName));
 }
 bool EvtLoader::passTrigger() {
   bool lPass = false;
-  for(unsigned int i0 = 0; i0 < fTrigString.size(); i0++) { 
-    if(fTrigger->pass(fTrigString[i0],fEvt->triggerBits)) lPass = true;
+  for(unsigned int i0 = 0; i0 < fTrigMasks.size(); i0++) { 
+    if(fTrigMasks[i0].pass(fEvt->triggerBits)) lPass = true;
   }
   return lPass;
 }
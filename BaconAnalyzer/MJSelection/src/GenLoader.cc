@@ -5,13 +5,12 @@
 using namespace baconhep;
 
 GenLoader::GenLoader(TTree *iTree) { 
-  fGens  = new TClonesArray("baconhep::TGenParticle");
-  iTree->SetBranchAddress("GenParticle",       &fGens);
-  fGenBr  = iTree->GetBranch("GenParticle");
+  fGenReader = new CollectionReader(iTree, "GenParticle", "baconhep::TGenParticle");
+  fGens      = fGenReader->array();
+  fGenReader->project("parent pdgId status pt eta phi mass");
 }
 GenLoader::~GenLoader() { 
-  delete fGens;
-  delete fGenBr;
+  delete fGenReader;
 }
 void GenLoader::reset() { 
   fVPt   = 0; 
@@ -54,8 +53,7 @@ void GenLoader::setupTree(TTree *iTree) {
   fTree->Branch("genid_2"  ,&fId2 ,"fId2/I");
 }
 void GenLoader::load(int iEvent) { 
-  fGens   ->Clear();
-  fGenBr ->GetEntry(iEvent);
+  fGenReader ->getEntry(iEvent);
 }
 void GenLoader::selectBoson() {
   reset(); 
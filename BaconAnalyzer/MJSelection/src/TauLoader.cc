@@ -3,13 +3,12 @@
 using namespace baconhep;
 
 TauLoader::TauLoader(TTree *iTree) { 
-  fTaus  = new TClonesArray("baconhep::TTau");
-  iTree->SetBranchAddress("Tau",       &fTaus);
-  fTauBr  = iTree->GetBranch("Tau");
+  fTauReader = new CollectionReader(iTree, "Tau", "baconhep::TTau");
+  fTaus      = fTauReader->array();
+  fTauReader->project("pt eta phi antiEleMVA3Cat rawIso3Hits hpsDisc");
 }
 TauLoader::~TauLoader() { 
-  delete fTaus;
-  delete fTauBr;
+  delete fTauReader;
 }
 void TauLoader::reset() { 
   fPt   = 0; 
@@ -24,8 +23,7 @@ void TauLoader::setupTree(TTree *iTree) {
   fTree->Branch("phi_1" ,&fPhi,"fPhi/F");
 }
 void TauLoader::load(int iEvent) { 
-  fTaus   ->Clear();
-  fTauBr ->GetEntry(iEvent);
+  fTauReader ->getEntry(iEvent);
 }
 bool TauLoader::selectSingleTau() {
   reset(); 
@@ -0,0 +1,151 @@
+//
+// Check that the parallel event loop writes the same entries as a serial run
+//
+//   checkEntryRanges [<number of events>] [<thread counts, comma separated>]
+//
+// Generates an input ntuple (an Events tree with a variable number of values per event, and a
+// lumi summary) and runs a worker that selects events and values, and rejects some lumi sections,
+// through EntryRangeRunner with one thread and with each of the given thread counts (2,3,8 by
+// default). Every output is compared entry by entry (see TreeComparison) with a reference written by
+// a plain loop over the input. Returns 1 on any difference; the files are removed otherwise.
+//
+
+#include "BaconAnalyzer/Utils/include/EntryRangeRunner.hh"
+#include "BaconAnalyzer/Utils/include/TreeComparison.hh"
+#include "BaconAna/DataFormats/interface/LumiSummary.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TRandom3.h>
+#include <TSystem.h>
+#include <boost/bind.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+using namespace baconhep;
+
+const int kMaxValues = 20;
+
+class CheckWorker : public EntryRangeRunner::Worker {
+public:
+  CheckWorker() : fInput(0) {}
+  static EntryRangeRunner::Worker* create() { return new CheckWorker(); }
+  void setup(TTree *iTree,TTree *iOut);
+  bool process(const Long64_t i0);
+  bool acceptLumi(const UInt_t iRun, const UInt_t iLumi) { return iLumi % 4 != 3; }
+
+  TTree   *fInput;
+  UInt_t   fRun, fLumi;
+  Int_t    fN;
+  Float_t  fX[kMaxValues];
+  Long64_t fEntry;
+  Int_t    fNSel;
+  Float_t  fXSel[kMaxValues];
+  Float_t  fSum;
+};
+void CheckWorker::setup(TTree *iTree,TTree *iOut) {
+  fInput = iTree;
+  fInput->SetBranchAddress("run",  &fRun);
+  fInput->SetBranchAddress("lumi", &fLumi);
+  fInput->SetBranchAddress("n",    &fN);
+  fInput->SetBranchAddress("x",    fX);
+  iOut->Branch("run",   &fRun,   "run/i");
+  iOut->Branch("lumi",  &fLumi,  "lumi/i");
+  iOut->Branch("entry", &fEntry, "entry/L");
+  iOut->Branch("nSel",  &fNSel,  "nSel/I");
+  iOut->Branch("xSel",  fXSel,   "xSel[nSel]/F");
+  iOut->Branch("sum",   &fSum,   "sum/F");
+}
+bool CheckWorker::process(const Long64_t i0) {
+  fInput->GetEntry(i0);
+  fEntry = i0;
+  fNSel  = 0;
+  fSum   = 0;
+  for(int i1 = 0; i1 < fN; i1++) {
+    fSum += fX[i1];
+    if(fX[i1] > 0.5) fXSel[fNSel++] = fX[i1];
+  }
+  return fNSel > 0;
+}
+
+// input ntuple: runs of lumi sections of random length, some empty events
+void writeInput(const std::string &filename, const int nEvents) {
+  TFile file(filename.c_str(), "RECREATE");
+  TTree *tree = new TTree("Events", "Events");
+  UInt_t  run = 1, lumi = 0;
+  Int_t   n = 0;
+  Float_t x[kMaxValues];
+  tree->Branch("run",  &run,  "run/i");
+  tree->Branch("lumi", &lumi, "lumi/i");
+  tree->Branch("n",    &n,    "n/I");
+  tree->Branch("x",    x,     "x[n]/F");
+
+  TRandom3 rng(4357);
+  LumiSummary lumis;
+  int nLeft = 0;
+  for(int ievent=0; ievent<nEvents; ievent++) {
+    if(nLeft-- == 0) {
+      if(++lumi > 50) { run++; lumi = 1; }
+      nLeft = rng.Integer(400);
+      lumis.beginBlock(run, lumi);
+    }
+    n = rng.Integer(kMaxValues);
+    for(int i=0; i<n; i++) x[i] = rng.Uniform();
+    tree->Fill();
+    lumis.count(true);
+  }
+  file.cd();
+  tree->Write();
+  lumis.write(&file);
+  file.Close();
+}
+
+// the worker on every entry of the accepted lumi sections, in one loop
+void writeReference(const std::string &inputName, const std::string &outputName) {
+  TFile inFile(inputName.c_str());
+  TTree *inTree = (TTree*)inFile.Get("Events");
+  TFile outFile(outputName.c_str(), "RECREATE");
+  TTree *outTree = new TTree("Tree", "Tree");
+  CheckWorker worker;
+  worker.setup(inTree, outTree);
+  for(Long64_t ientry=0; ientry<inTree->GetEntries(); ientry++) {
+    if(worker.process(ientry) && worker.acceptLumi(worker.fRun, worker.fLumi)) outTree->Fill();
+  }
+  outFile.cd();
+  outTree->Write();
+  outFile.Close();
+  inFile.Close();
+}
+
+int main( int argc, char **argv ) {
+  const int nEvents = (argc > 1) ? atoi(argv[1]) : 20000;
+  std::vector<int> threads(1, 1);
+  std::stringstream ss((argc > 2) ? argv[2] : "2,3,8");
+  std::string field;
+  while(std::getline(ss, field, ',')) threads.push_back(atoi(field.c_str()));
+
+  const std::string inputName     = "checkEntryRanges_input.root";
+  const std::string referenceName = "checkEntryRanges_reference.root";
+  writeInput(inputName, nEvents);
+  writeReference(inputName, referenceName);
+
+  bool same = true;
+  std::vector<std::string> written(1, referenceName);
+  written.push_back(inputName);
+  for(unsigned int irun=0; irun<threads.size(); irun++) {
+    std::stringstream name; name << "checkEntryRanges_" << threads[irun] << "threads.root";
+    EntryRangeRunner runner(inputName);
+    runner.run(boost::bind(&CheckWorker::create), -1, threads[irun], name.str());
+    written.push_back(name.str());
+    std::cout << "[checkEntryRanges] " << threads[irun] << " threads: ";
+    if(TreeComparison::compare(referenceName, name.str(), "Tree", std::cout) != 0) same = false;
+  }
+
+  if(same) {
+    for(unsigned int ifile=0; ifile<written.size(); ifile++) gSystem->Unlink(written[ifile].c_str());
+  }
+  std::cout << "[checkEntryRanges] " << (same ? "all runs wrote the entries of the serial loop" : "FAILED") << std::endl;
+  return same ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+//
+// Compare a tree in two files entry by entry
+//
+//   compareTrees <file A> <file B> [<tree name>]
+//
+// Checks that the trees ("Tree" by default, the output of the BaconAnalyzer executables) have the
+// same entries, the same branches and the same leaf values in every entry, e.g. the output of a
+// serial and a multithreaded run (see TreeComparison). Prints the first differences and returns 1
+// if there are any.
+//
+// Usage sketch for the event loop of the BaconAnalyzer executables (checkEntryRanges does the same
+// on a generated input):
+//   runMJ -1 ntuple.root 0 0 1 && mv Output.root serial.root
+//   runMJ -1 ntuple.root 0 0 8 && compareTrees serial.root Output.root
+//
+// and for the Bacon ntuples of a job with NumThreads = 1 and one with NumThreads > 1 (the jobs can
+// also compare each event with a sequential filling themselves, with checkDeterminism = True):
+//   compareTrees Output_1thread.root Output_8threads.root Events
+//
+
+#include "BaconAnalyzer/Utils/include/TreeComparison.hh"
+#include <iostream>
+
+using namespace baconhep;
+
+int main( int argc, char **argv ) {
+  if(argc < 3) {
+    std::cout << "usage: compareTrees <file A> <file B> [<tree name>]" << std::endl;
+    return 1;
+  }
+  const char *treeName = (argc > 3) ? argv[3] : "Tree";
+
+  return TreeComparison::compare(argv[1], argv[2], treeName, std::cout) == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#ifndef BACONANALYZER_UTILS_ENTRYRANGERUNNER_HH
+#define BACONANALYZER_UTILS_ENTRYRANGERUNNER_HH
+
+#include <Rtypes.h>
+#include <boost/function.hpp>
+#include <string>
+
+class TTree;
+
+namespace baconhep
+{
+  //
+  // Event loop of the BaconAnalyzer executables over the first entries of a tree, split into
+  // contiguous entry ranges processed by worker threads. Each worker opens its own copy of the
+  // input file, owns its loaders and fills its own output tree into a partial file; the partial
+  // files are merged in entry order, so the output has the same entries in the same order as a
+  // serial run. Files and trees are created and written one worker at a time, as ROOT 5 keeps the
+  // current directory in a global; only the entry loops run concurrently.
+  //
+  class EntryRangeRunner
+  {
+    public:
+      class Worker
+      {
+        public:
+          virtual ~Worker(){}
+          // create the loaders on the input tree and the branches of the output tree
+          virtual void setup(TTree *input, TTree *output) = 0;
+          // process an entry; returns true to fill the output tree
+          virtual bool process(const Long64_t entry) = 0;
+          // lumi sections to process: if the input has a lumi summary (see LumiSummary), the
+          // entries of the other lumi sections are skipped without reading them
+          virtual bool acceptLumi(const UInt_t run, const UInt_t lumi) { return true; }
+      };
+      typedef boost::function<Worker*()> WorkerFactory;
+
+      EntryRangeRunner(const std::string &inputName, const std::string &inputTreeName="Events",
+                       const std::string &outputTreeName="Tree");
+      ~EntryRangeRunner(){}
+
+      // process the first nEntries entries (all if nEntries<0) with nThreads workers and write the
+      // output tree to outputName; returns the number of entries processed
+      Long64_t run(const WorkerFactory &factory, const Long64_t nEntries, const int nThreads,
+                   const std::string &outputName="Output.root");
+
+
+    protected:
+      void processRange(const WorkerFactory &factory, const Long64_t first, const Long64_t last,
+                        const std::string &outputName);
+
+      std::string fInputName;
+      std::string fInputTreeName;
+      std::string fOutputTreeName;
+  };
+}
+#endif
@@ -0,0 +1,24 @@
+#ifndef BACONANALYZER_UTILS_TREECOMPARISON_HH
+#define BACONANALYZER_UTILS_TREECOMPARISON_HH
+
+#include <Rtypes.h>
+#include <string>
+#include <ostream>
+
+namespace baconhep
+{
+  //
+  // Entry by entry comparison of a tree in two files: same number of entries, same leaves and
+  // the same leaf values in every entry (NaN equals NaN), e.g. the output of a serial and a
+  // multithreaded run. See compareTrees and checkEntryRanges.
+  //
+  class TreeComparison
+  {
+    public:
+      // number of leaf values that differ, printing the first maxPrinted of them;
+      // -1 if a file or tree is missing or the trees differ in entries or leaves
+      static Long64_t compare(const std::string &fileA, const std::string &fileB, const std::string &treeName,
+                              std::ostream &os, const unsigned int maxPrinted=10);
+  };
+}
+#endif
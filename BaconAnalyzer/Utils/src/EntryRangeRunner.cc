@@ -0,0 +1,157 @@
+#include "../include/EntryRangeRunner.hh"
+#include "BaconAna/DataFormats/interface/LumiSummary.hh"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <TFile.h>
+#include <TTree.h>
+#include <TFileMerger.h>
+#include <TSystem.h>
+#include <TThread.h>
+#include <RVersion.h>
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+#include <TROOT.h>
+#endif
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  // serializes file and tree creation and writing between the workers
+  boost::mutex sFileMutex;
+
+  // runs a worker range and keeps its exception for the main thread
+  void runRange(const boost::function<void()> &range, boost::exception_ptr &error)
+  {
+    try {
+      range();
+    } catch(...) {
+      error = boost::current_exception();
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+EntryRangeRunner::EntryRangeRunner(const std::string &inputName, const std::string &inputTreeName,
+                                   const std::string &outputTreeName):
+  fInputName     (inputName),
+  fInputTreeName (inputTreeName),
+  fOutputTreeName(outputTreeName)
+{}
+
+//--------------------------------------------------------------------------------------------------
+Long64_t EntryRangeRunner::run(const WorkerFactory &factory, const Long64_t nEntries, const int nThreads,
+                               const std::string &outputName)
+{
+  Long64_t nTotal = 0;
+  {
+    TFile *inFile = TFile::Open(fInputName.c_str());
+    if(!inFile || inFile->IsZombie()) { std::cout << "[EntryRangeRunner] " << fInputName << " not found!" << std::endl; assert(0); }
+    TTree *inTree = (TTree*)inFile->Get(fInputTreeName.c_str());
+    if(!inTree) { std::cout << "[EntryRangeRunner] no " << fInputTreeName << " tree in " << fInputName << "!" << std::endl; assert(0); }
+    nTotal = inTree->GetEntries();
+    inFile->Close();
+    delete inFile;
+  }
+  if(nEntries >= 0 && nEntries < nTotal) nTotal = nEntries;
+
+  const int nWorkers = (int)std::max(1LL, std::min((Long64_t)nThreads, nTotal));
+  if(nWorkers == 1) {
+    processRange(factory, 0, nTotal, outputName);
+    return nTotal;
+  }
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+  ROOT::EnableThreadSafety();
+#else
+  TThread::Initialize();
+#endif
+
+  // contiguous ranges, merged in order
+  std::vector<std::string> partNames;
+  std::vector<boost::exception_ptr> errors(nWorkers);
+  boost::thread_group threads;
+  for(int iw=0; iw<nWorkers; iw++) {
+    std::stringstream ss; ss << outputName << ".part" << iw;
+    partNames.push_back(ss.str());
+    const Long64_t first = nTotal*iw/nWorkers;
+    const Long64_t last  = nTotal*(iw+1)/nWorkers;
+    boost::function<void()> range = boost::bind(&EntryRangeRunner::processRange, this, boost::cref(factory), first, last, partNames.back());
+    threads.create_thread(boost::bind(&runRange, range, boost::ref(errors[iw])));
+  }
+  threads.join_all();
+  for(int iw=0; iw<nWorkers; iw++) {
+    if(errors[iw]) boost::rethrow_exception(errors[iw]);
+  }
+
+  TFileMerger merger(kFALSE);
+  merger.OutputFile(outputName.c_str(), kTRUE);
+  for(int iw=0; iw<nWorkers; iw++) merger.AddFile(partNames[iw].c_str());
+  if(!merger.Merge()) { std::cout << "[EntryRangeRunner] could not merge the worker outputs into " << outputName << "!" << std::endl; assert(0); }
+  for(int iw=0; iw<nWorkers; iw++) gSystem->Unlink(partNames[iw].c_str());
+
+  return nTotal;
+}
+
+//--------------------------------------------------------------------------------------------------
+void EntryRangeRunner::processRange(const WorkerFactory &factory, const Long64_t first, const Long64_t last,
+                                    const std::string &outputName)
+{
+  Worker *worker  = 0;
+  TFile  *inFile  = 0;
+  TFile  *outFile = 0;
+  TTree  *outTree = 0;
+  std::vector<std::pair<Long64_t,Long64_t> > skipped;   // entry ranges of the rejected lumi sections
+  {
+    boost::mutex::scoped_lock lock(sFileMutex);
+    inFile = TFile::Open(fInputName.c_str());
+    TTree *inTree = (TTree*)inFile->Get(fInputTreeName.c_str());
+    outFile = new TFile(outputName.c_str(), "RECREATE");
+    outTree = new TTree(fOutputTreeName.c_str(), fOutputTreeName.c_str());
+    outTree->SetDirectory(outFile);
+    worker = factory();
+    worker->setup(inTree, outTree);
+
+    LumiSummary lumis;
+    if(lumis.read(inFile)) {
+      Long64_t nSkipped = 0;
+      for(unsigned int iblock=0; iblock<lumis.blocks().size(); iblock++) {
+        const LumiSummary::Block &block = lumis.blocks()[iblock];
+        const Long64_t blockFirst = std::max(first, block.firstEntry);
+        const Long64_t blockLast  = std::min(last,  block.firstEntry+block.nEntries);
+        if(blockFirst >= blockLast || worker->acceptLumi(block.run, block.lumi)) continue;
+        skipped.push_back(std::pair<Long64_t,Long64_t>(blockFirst, blockLast));
+        nSkipped += blockLast - blockFirst;
+      }
+      std::cout << "[EntryRangeRunner] skipping " << nSkipped << " of " << last-first << " entries in rejected lumi sections" << std::endl;
+    }
+  }
+
+  const Long64_t nEntries = last - first;
+  unsigned int iskip = 0;
+  for(Long64_t ientry=first; ientry<last; ientry++) {
+    if((ientry-first) % 1000 == 0) std::cout << "===> Processed " << ientry-first << " - Done : " << (float(ientry-first)/float(nEntries))
+                                             << " (entries " << first << "-" << last << ")" << std::endl;
+    while(iskip < skipped.size() && skipped[iskip].second <= ientry) iskip++;
+    if(iskip < skipped.size() && skipped[iskip].first <= ientry) continue;
+    if(worker->process(ientry)) outTree->Fill();
+  }
+
+  {
+    boost::mutex::scoped_lock lock(sFileMutex);
+    outFile->cd();
+    outTree->Write();
+    delete worker;
+    outFile->Close();
+    delete outFile;
+    inFile->Close();
+    delete inFile;
+  }
+}
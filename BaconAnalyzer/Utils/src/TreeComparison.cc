@@ -0,0 +1,75 @@
+#include "../include/TreeComparison.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TLeaf.h>
+#include <TObjArray.h>
+#include <vector>
+
+using namespace baconhep;
+
+namespace {
+  // names of all leaves of a tree
+  std::vector<std::string> leafNames(TTree *tree)
+  {
+    std::vector<std::string> names;
+    TObjArray *leaves = tree->GetListOfLeaves();
+    for(int ileaf=0; ileaf<leaves->GetEntriesFast(); ileaf++) names.push_back(((TLeaf*)leaves->UncheckedAt(ileaf))->GetName());
+    return names;
+  }
+
+  TTree* openTree(const std::string &filename, const std::string &treeName, TFile *&file, std::ostream &os)
+  {
+    file = TFile::Open(filename.c_str());
+    if(!file || file->IsZombie()) { os << "[TreeComparison] " << filename << " not found!" << std::endl; return 0; }
+    TTree *tree = (TTree*)file->Get(treeName.c_str());
+    if(!tree) os << "[TreeComparison] no " << treeName << " tree in " << filename << std::endl;
+    return tree;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+Long64_t TreeComparison::compare(const std::string &fileA, const std::string &fileB, const std::string &treeName,
+                                 std::ostream &os, const unsigned int maxPrinted)
+{
+  TFile *inA = 0, *inB = 0;
+  TTree *treeA = openTree(fileA, treeName, inA, os);
+  TTree *treeB = openTree(fileB, treeName, inB, os);
+  Long64_t nDiff = -1;
+  if(treeA && treeB) {
+    const std::vector<std::string> names = leafNames(treeA);
+    if(treeA->GetEntries() != treeB->GetEntries()) {
+      os << "[TreeComparison] " << treeA->GetEntries() << " entries in " << fileA << ", " << treeB->GetEntries() << " in " << fileB << std::endl;
+    } else if(names != leafNames(treeB)) {
+      os << "[TreeComparison] the trees have different branches" << std::endl;
+    } else {
+      std::vector<TLeaf*> leavesA, leavesB;
+      for(unsigned int ileaf=0; ileaf<names.size(); ileaf++) {
+        leavesA.push_back(treeA->GetLeaf(names[ileaf].c_str()));
+        leavesB.push_back(treeB->GetLeaf(names[ileaf].c_str()));
+      }
+
+      nDiff = 0;
+      for(Long64_t ientry=0; ientry<treeA->GetEntries(); ientry++) {
+        treeA->GetEntry(ientry);
+        treeB->GetEntry(ientry);
+        for(unsigned int ileaf=0; ileaf<names.size(); ileaf++) {
+          const int len = leavesA[ileaf]->GetLen();
+          bool same = (len == leavesB[ileaf]->GetLen());
+          for(int ival=0; same && ival<len; ival++) {
+            const double a = leavesA[ileaf]->GetValue(ival);
+            const double b = leavesB[ileaf]->GetValue(ival);
+            same = (a == b) || (a != a && b != b);   // NaN in both is the same value
+          }
+          if(same) continue;
+          if(nDiff < (Long64_t)maxPrinted) os << "[TreeComparison] entry " << ientry << ": " << names[ileaf] << " differs" << std::endl;
+          nDiff++;
+        }
+      }
+      os << "[TreeComparison] " << treeA->GetEntries() << " entries, " << names.size() << " leaves, "
+         << nDiff << " differences" << std::endl;
+    }
+  }
+  if(inA) { inA->Close(); delete inA; }
+  if(inB) { inB->Close(); delete inB; }
+  return nDiff;
+}
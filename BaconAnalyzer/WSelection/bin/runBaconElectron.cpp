@@ -4,62 +4,67 @@
 #include "../include/EvtLoader.hh"
 #include "../include/MuonLoader.hh"
 #include "../include/ElectronLoader.hh"
+#include "BaconAnalyzer/Utils/include/EntryRangeRunner.hh"
 
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include <boost/bind.hpp>
 #include <string>
 #include <iostream>
 
-//Object Processors
-GenLoader       *fGen      = 0; 
-EvtLoader       *fEvt      = 0; 
-MuonLoader      *fMuon     = 0; 
-ElectronLoader  *fElectron = 0; 
-
-TTree* load(std::string iName) { 
-  TFile *lFile = TFile::Open(iName.c_str());
-  TTree *lTree = (TTree*) lFile->FindObjectAny("Events");
-  return lTree;
+//Object Processors of one entry range
+class WEleWorker : public EntryRangeRunner::Worker { 
+public:
+  WEleWorker(bool iGen) : fGen(0),fEvt(0),fMuon(0),fElectron(0),fIsGen(iGen) {}
+  ~WEleWorker() { delete fGen; delete fEvt; delete fMuon; delete fElectron; }
+  static EntryRangeRunner::Worker* create(bool iGen) { return new WEleWorker(iGen); }
+  void setup(TTree *iTree,TTree *iOut);
+  bool process(const Long64_t i0);
+private:
+  GenLoader       *fGen; 
+  EvtLoader       *fEvt; 
+  MuonLoader      *fMuon; 
+  ElectronLoader  *fElectron; 
+  bool             fIsGen;
+};
+void WEleWorker::setup(TTree *iTree,TTree *iOut) { 
+  //Declare Readers
+  fEvt      = new EvtLoader     (iTree);
+  fMuon     = new MuonLoader    (iTree);
+  fElectron = new ElectronLoader(iTree); 
+  if(fIsGen) fGen      = new GenLoader     (iTree);
+  //Setup Tree
+  fEvt ->setupTree      (iOut);
+  fEvt ->setupRecoilTree();
+  fElectron->setupTree      (iOut); 
+  if(fIsGen) fGen ->setupTree      (iOut);
+  if(fIsGen) fGen ->setupRecoilTree();
+}
+bool WEleWorker::process(const Long64_t i0) { 
+  //Load Ntuple & Select 1 good muon
+  fEvt     ->load(i0);
+  fElectron->load(i0);
+  fEvt     ->fillEvent();
+  if(!fElectron->selectSingleEle(fEvt->fRho)) return false;
+  //Get Muon and comupte recoil variables
+  TLorentzVector lElectron = fElectron->electron();
+  fEvt    ->fillRecoil(lElectron);
+  if(fIsGen) fGen->load(i0);
+  if(fIsGen) fGen->selectBoson();
+  if(fIsGen) fGen->fillRecoil(lElectron);
+  return true;
 }
+
 int main( int argc, char **argv ) {
   gROOT->ProcessLine("#include <vector>");          
   int maxEvents     = atoi(argv[1]);
   std::string lName = argv[2];
   bool        lGen  = atoi(argv[3]);
+  bool        lCheck = argc > 4 && atoi(argv[4]);   // check that the loaders read only the members they project
+  int         lNThreads = argc > 5 ? atoi(argv[5]) : 1;
+  CollectionReader::checkProjections(lCheck);
   //void runBacon(int iNEvents=10,std::string lName="test.root",bool lGen=false) {   
-  TTree *lTree = load(lName); 
-  if(lTree->GetEntries() < maxEvents || maxEvents == -1) maxEvents = lTree->GetEntries(); 
-  //Declare Readers
-  fEvt      = new EvtLoader     (lTree);
-  fMuon     = new MuonLoader    (lTree);
-  fElectron = new ElectronLoader(lTree); 
-  if(lGen) fGen      = new GenLoader     (lTree);
-
-  TFile *lFile = new TFile("Output.root","RECREATE");
-  TTree *lOut  = new TTree("Tree","Tree");
-  //Setup Tree
-  fEvt ->setupTree      (lOut);
-  fEvt ->setupRecoilTree();
-  fElectron->setupTree      (lOut); 
-  if(lGen) fGen ->setupTree      (lOut);
-  if(lGen) fGen ->setupRecoilTree();
-  for(int i0 = 0; i0 < maxEvents; i0++) { 
-    if(i0 % 1000 == 0) std::cout << "===> Processed " << i0 << " - Done : " << (float(i0)/float(maxEvents)) << std::endl;
-    //Load Ntuple & Select 1 good muon
-    fEvt     ->load(i0);
-    fElectron->load(i0);
-    fEvt     ->fillEvent();
-    if(!fElectron->selectSingleEle(fEvt->fRho)) continue;
-    //Get Muon and comupte recoil variables
-    TLorentzVector lElectron = fElectron->electron();
-    fEvt    ->fillRecoil(lElectron);
-    if(lGen) fGen->load(i0);
-    if(lGen) fGen->selectBoson();
-    if(lGen) fGen->fillRecoil(lElectron);
-    lOut->Fill();
-  }
-  lFile->cd();
-  lOut->Write();
-  lFile->Close();
+  EntryRangeRunner lRunner(lName);
+  lRunner.run(boost::bind(&WEleWorker::create,lGen),maxEvents,lNThreads);
 }
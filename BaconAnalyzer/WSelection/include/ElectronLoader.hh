@@ -1,3 +1,4 @@
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TElectron.hh"
 #include "TTree.h"
 #include "TBranch.h"
@@ -22,7 +23,7 @@ public:
 
 protected: 
   TClonesArray *fElectrons;
-  TBranch      *fElectronBr;
+  CollectionReader *fElectronReader;
   TTree        *fTree;
   float fPt;
   float fEta;
@@ -1,6 +1,7 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TPhoton.hh"
 
 using namespace baconhep;
@@ -18,7 +19,7 @@ public:
 
 protected: 
   TClonesArray *fPhotons;
-  TBranch      *fPhotonBr;
+  CollectionReader *fPhotonReader;
   TTree        *fTree;
   float         fPt;
   float         fEta;
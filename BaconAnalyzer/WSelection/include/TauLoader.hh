@@ -1,6 +1,7 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TClonesArray.h"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
 #include "BaconAna/DataFormats/interface/TTau.hh"
 
 using namespace baconhep;
@@ -20,7 +21,7 @@ public:
   bool passAntiEMVA3(int iCat, float raw, TString WP);
 protected: 
   TClonesArray *fTaus;
-  TBranch      *fTauBr;
+  CollectionReader *fTauReader;
   TTree        *fTree;
   float fPt;
   float fEta;
@@ -5,13 +5,12 @@
 using namespace baconhep;
 
 GenLoader::GenLoader(TTree *iTree) { 
-  fGens  = new TClonesArray("baconhep::TGenParticle");
-  iTree->SetBranchAddress("GenParticle",       &fGens);
-  fGenBr  = iTree->GetBranch("GenParticle");
+  fGenReader = new CollectionReader(iTree, "GenParticle", "baconhep::TGenParticle");
+  fGens      = fGenReader->array();
+  fGenReader->project("parent pdgId status pt eta phi mass");
 }
 GenLoader::~GenLoader() { 
-  delete fGens;
-  delete fGenBr;
+  delete fGenReader;
 }
 void GenLoader::reset() { 
   fVPt   = 0; 
@@ -61,8 +60,7 @@ void GenLoader::setupRecoilTree() {
   fTree->Branch("genwlepphi"  ,&fGenWLepPhi,"fGenWLepPhi/F");
 }
 void GenLoader::load(int iEvent) { 
-  fGens   ->Clear();
-  fGenBr ->GetEntry(iEvent);
+  fGenReader ->getEntry(iEvent);
 }
 void GenLoader::selectBoson() {
   reset(); 
@@ -4,13 +4,12 @@
 using namespace baconhep;
 
 JetLoader::JetLoader(TTree *iTree) { 
-  fJets  = new TClonesArray("baconhep::TJet");
-  iTree->SetBranchAddress("Jet",       &fJets);
-  fJetBr  = iTree->GetBranch("Jet");
+  fJetReader = new CollectionReader(iTree, "Jet", "baconhep::TJet");
+  fJets      = fJetReader->array();
+  fJetReader->project("pt eta phi mass nCharged nParticles chEmFrac neuEmFrac chHadFrac neuHadFrac");
 }
 JetLoader::~JetLoader() { 
-  delete fJets;
-  delete fJetBr;
+  delete fJetReader;
 }
 void JetLoader::reset() { 
   fPt   = 0; 
@@ -26,8 +25,7 @@ void JetLoader::setupTree(TTree *iTree) {
   fTree->Branch("m_1"   ,&fM  ,"fM/F");
 }
 void JetLoader::load(int iEvent) { 
-  fJets   ->Clear();
-  fJetBr ->GetEntry(iEvent);
+  fJetReader ->getEntry(iEvent);
 }
 bool JetLoader::selectSingleJet() {
   reset(); 
@@ -4,13 +4,12 @@
 using namespace baconhep;
 
 MuonLoader::MuonLoader(TTree *iTree) {
-  fMuons  = new TClonesArray("baconhep::TMuon");
-  iTree->SetBranchAddress("Muon",       &fMuons);
-  fMuonBr  = iTree->GetBranch("Muon");
+  fMuonReader = new CollectionReader(iTree, "Muon", "baconhep::TMuon");
+  fMuons      = fMuonReader->array();
+  fMuonReader->project("pt eta phi chHadIso04 gammaIso04 neuHadIso04 puIso04 d0 dz muNchi2 nValidHits typeBits selectorBits nPixHits nTkLayers nMatchStn");
 }
 MuonLoader::~MuonLoader() {
-  delete fMuons;
-  delete fMuonBr;
+  delete fMuonReader;
 }
 void MuonLoader::reset() {
   fPt   = 0;
@@ -25,8 +24,7 @@ void MuonLoader::setupTree(TTree *iTree) {
   fTree->Branch("phi_1" ,&fPhi,"fPhi/F");
 }
 void MuonLoader::load(int iEvent) {
-  fMuons   ->Clear();
-  fMuonBr ->GetEntry(iEvent);
+  fMuonReader ->getEntry(iEvent);
 }
 bool MuonLoader::selectSingleMu() {
   reset();
@@ -4,13 +4,12 @@
 using namespace baconhep;
 
 PhotonLoader::PhotonLoader(TTree *iTree) { 
-  fPhotons  = new TClonesArray("baconhep::TPhoton");
-  iTree->SetBranchAddress("Photon",       &fPhotons);
-  fPhotonBr  = iTree->GetBranch("Photon");
+  fPhotonReader = new CollectionReader(iTree, "Photon", "baconhep::TPhoton");
+  fPhotons      = fPhotonReader->array();
+  fPhotonReader->project("pt eta phi chHadIso03 gammaIso03 neuHadIso03 hovere sieie");
 }
 PhotonLoader::~PhotonLoader() { 
-  delete fPhotons;
-  delete fPhotonBr;
+  delete fPhotonReader;
 }
 void PhotonLoader::reset() { 
   fPt   = 0; 
@@ -25,8 +24,7 @@ void PhotonLoader::setupTree(TTree *iTree) {
   fTree->Branch("phi_1" ,&fPhi,"fPhi/F");
 }
 void PhotonLoader::load(int iEvent) { 
-  fPhotons   ->Clear();
-  fPhotonBr ->GetEntry(iEvent);
+  fPhotonReader ->getEntry(iEvent);
 }
 bool PhotonLoader::selectSinglePhoton() {
   reset(); 
@@ -0,0 +1,86 @@
+//
+// Compare the single-pass energy correlation functions with the per-beta fastjet contrib ones
+//
+//   compareEnergyCorrelations [<number of jets>] [<seed>]
+//
+// Random jets (1 to 150 constituents around a common axis) are evaluated with
+// baconhep::EnergyCorrelations, as in FillerJet, and with fastjet::EnergyCorrelator(n,beta) and
+// fastjet::EnergyCorrelatorRatio(2,beta) for the betas of FillerJet. Prints the largest relative
+// differences and returns 1 if one exceeds the float precision of the single-pass sums.
+//
+
+#include "BaconProd/Ntupler/interface/EnergyCorrelations.hh"
+#include "BaconProd/Ntupler/interface/EnergyCorrelator.hh"
+#include <fastjet/PseudoJet.hh>
+#include <TRandom3.h>
+#include <TMath.h>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <iostream>
+
+using namespace baconhep;
+
+// a jet of n massless constituents with falling pTs around (eta, phi)
+fastjet::PseudoJet randomJet(TRandom3 &rng, const unsigned int n) {
+  const double axisEta = rng.Uniform(-2.5, 2.5);
+  const double axisPhi = rng.Uniform(-TMath::Pi(), TMath::Pi());
+  std::vector<fastjet::PseudoJet> particles;
+  for(unsigned int i=0; i<n; i++) {
+    const double pt  = 0.5 + rng.Exp(20.);
+    const double eta = axisEta + rng.Gaus(0, 0.3);
+    const double phi = axisPhi + rng.Gaus(0, 0.3);
+    particles.push_back(fastjet::PseudoJet(pt*cos(phi), pt*sin(phi), pt*sinh(eta), pt*cosh(eta)));
+  }
+  return fastjet::join(particles);
+}
+
+double relDiff(const double a, const double b) {
+  if(a == b) return 0;
+  return fabs(a - b)/std::max(fabs(a), fabs(b));
+}
+
+int main( int argc, char **argv ) {
+  const unsigned int nJets = (argc > 1) ? atoi(argv[1]) : 1000;
+  const unsigned int seed  = (argc > 2) ? atoi(argv[2]) : 4357;
+  const double kTolerance  = 1e-4;   // log(dR^2), dR^beta and the pTs are floats in the single pass
+
+  // the betas of FillerJet
+  const double lBetas[] = {0., 0.2, 0.5, 1.0, 2.0};
+  const std::vector<double> betas(lBetas, lBetas + sizeof(lBetas)/sizeof(double));
+  EnergyCorrelations ecf(betas);
+
+  TRandom3 rng(seed);
+  std::vector<double> maxDiff(4*betas.size(), 0);   // [4*ibeta + n-1], n=4 for the ratio
+  unsigned int nFailed = 0;
+  for(unsigned int ijet=0; ijet<nJets; ijet++) {
+    const unsigned int n = (ijet < 5) ? ijet+1 : 1 + rng.Integer(150);
+    const fastjet::PseudoJet jet = randomJet(rng, n);
+    ecf.compute(jet);
+
+    bool failed = false;
+    for(unsigned int ib=0; ib<betas.size(); ib++) {
+      for(int in=1; in<=3; in++) {
+        const double diff = relDiff(ecf.ecf(in, ib), fastjet::EnergyCorrelator(in, betas[ib]).result(jet));
+        maxDiff[4*ib + in-1] = std::max(maxDiff[4*ib + in-1], diff);
+        failed = failed || !(diff < kTolerance);
+      }
+      if(n < 3) continue;  // ECF(3) = 0
+      const double diff = relDiff(ecf.r2(ib), fastjet::EnergyCorrelatorRatio(2, betas[ib]).result(jet));
+      maxDiff[4*ib + 3] = std::max(maxDiff[4*ib + 3], diff);
+      failed = failed || !(diff < kTolerance);
+    }
+    if(failed && nFailed < 10) std::cout << "[compareEnergyCorrelations] jet " << ijet << " (" << n << " constituents) differs" << std::endl;
+    if(failed) nFailed++;
+  }
+
+  std::cout << "[compareEnergyCorrelations] largest relative differences over " << nJets << " jets" << std::endl;
+  for(unsigned int ib=0; ib<betas.size(); ib++) {
+    std::cout << "  beta " << betas[ib] << ": ECF1 " << maxDiff[4*ib] << ", ECF2 " << maxDiff[4*ib+1]
+              << ", ECF3 " << maxDiff[4*ib+2] << ", ECF3/ECF2 " << maxDiff[4*ib+3] << std::endl;
+  }
+  std::cout << "[compareEnergyCorrelations] " << nFailed << " jets above " << kTolerance << std::endl;
+
+  return nFailed > 0 ? 1 : 0;
+}
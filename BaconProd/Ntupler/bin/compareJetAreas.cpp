@@ -0,0 +1,133 @@
+//
+// Compare the jet areas of FillerJet::addJet (explicit ghosts around the constituents) with the
+// ClusterSequenceArea clustering it replaced (active area with explicit ghosts up to |y| = 7)
+//
+//   compareJetAreas [<number of jets>] [<seed>]
+//
+// Random jets (2 to 150 constituents around a common axis, spread as wide as the cone) are
+// reclustered both ways for cone sizes of NtuplerMod from 0.4 to 0.8 (the cone size sets the
+// padding of the ghosts), and groomed as in addJet. The ghosts are placed at random in both, so single areas differ; the mean areas over all
+// jets must agree within kTolerance, and the jet momenta must be the same. The windowed ghosts
+// must also give the same areas when a jet is reclustered again. Prints the mean areas and
+// returns 1 on any failure.
+//
+
+#include "BaconProd/Ntupler/interface/FillerJet.hh"
+#include <fastjet/PseudoJet.hh>
+#include <fastjet/ClusterSequenceArea.hh>
+#include <fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh>
+#include <fastjet/GhostedAreaSpec.hh>
+#include <TRandom3.h>
+#include <TMath.h>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+using namespace baconhep;
+
+const unsigned int kNGroomed = 8;
+const char *kGroomedNames[kNGroomed] = { "ungroomed", "pruned", "trimmed1", "trimmed2", "trimmed3", "trimmed4", "filtered1", "filtered2" };
+
+// constituents of a jet with falling pTs around (eta, phi)
+std::vector<fastjet::PseudoJet> randomJet(TRandom3 &rng, const unsigned int n, const double width, double &axisPhi) {
+  const double axisEta = rng.Uniform(-2.5, 2.5);
+  axisPhi = rng.Uniform(-TMath::Pi(), TMath::Pi());
+  std::vector<fastjet::PseudoJet> particles;
+  for(unsigned int i=0; i<n; i++) {
+    const double pt  = 0.5 + rng.Exp(20.);
+    const double eta = axisEta + rng.Gaus(0, width);
+    const double phi = axisPhi + rng.Gaus(0, width);
+    particles.push_back(fastjet::PseudoJet(pt*cos(phi), pt*sin(phi), pt*sinh(eta), pt*cosh(eta)));
+  }
+  return particles;
+}
+
+// the leading jet and its groomed versions, as in FillerJet::addJet
+std::vector<fastjet::PseudoJet> groomed(FillerJet &filler, fastjet::ClusterSequence &clustering) {
+  fastjet::PseudoJet dummy;
+  const fastjet::PseudoJet jet = filler.CACluster(dummy, clustering);
+  std::vector<fastjet::PseudoJet> jets;
+  jets.push_back(jet);
+  jets.push_back((*filler.fPruner1)(jet));
+  jets.push_back((*filler.fTrimmer1)(jet));
+  jets.push_back((*filler.fTrimmer2)(jet));
+  jets.push_back((*filler.fTrimmer3)(jet));
+  jets.push_back((*filler.fTrimmer4)(jet));
+  jets.push_back((*filler.fFilter1)(jet));
+  jets.push_back((*filler.fFilter2)(jet));
+  return jets;
+}
+
+bool sameMomentum(const fastjet::PseudoJet &a, const fastjet::PseudoJet &b) {
+  const double scale = std::max(a.E(), 1e-3);
+  return fabs(a.px()-b.px()) < 1e-9*scale && fabs(a.py()-b.py()) < 1e-9*scale
+      && fabs(a.pz()-b.pz()) < 1e-9*scale && fabs(a.E()-b.E())   < 1e-9*scale;
+}
+
+int main( int argc, char **argv ) {
+  const unsigned int nJets = (argc > 1) ? atoi(argv[1]) : 500;
+  const unsigned int seed  = (argc > 2) ? atoi(argv[2]) : 4357;
+  const double kTolerance  = 0.02;   // relative difference of the mean areas
+
+  // the area definition FillerJet used before
+  const fastjet::GhostedAreaSpec   ghostSpec(7.0, 1, 0.01);
+  const fastjet::AreaDefinition    areaDef(fastjet::active_area_explicit_ghosts, ghostSpec);
+
+  const double lCones[] = { 0.4, 0.5, 0.6, 0.8 };
+  const std::vector<double> cones(lCones, lCones + sizeof(lCones)/sizeof(double));
+
+  TRandom3 rng(seed);
+  bool ok = true;
+  for(unsigned int icone=0; icone<cones.size(); icone++) {
+    FillerJet filler;
+    filler.fConeSize = cones[icone];
+
+    std::vector<double> sumOld(kNGroomed, 0), sumNew(kNGroomed, 0);
+    unsigned int nMomentum = 0, nRepeat = 0;
+    for(unsigned int ijet=0; ijet<nJets; ijet++) {
+      double axisPhi = 0;
+      const std::vector<fastjet::PseudoJet> particles = randomJet(rng, 2 + rng.Integer(149), 0.5*cones[icone], axisPhi);
+
+      fastjet::ClusterSequenceArea oldClustering(particles, *filler.fCAJetDef, areaDef);
+      const std::vector<fastjet::PseudoJet> oldJets = groomed(filler, oldClustering);
+
+      std::vector<fastjet::PseudoJet> ghosts;
+      double ghostArea = 0;
+      filler.windowGhosts(particles, axisPhi, ghosts, ghostArea);
+      fastjet::ClusterSequenceActiveAreaExplicitGhosts newClustering(particles, *filler.fCAJetDef, ghosts, ghostArea);
+      const std::vector<fastjet::PseudoJet> newJets = groomed(filler, newClustering);
+
+      filler.windowGhosts(particles, axisPhi, ghosts, ghostArea);
+      fastjet::ClusterSequenceActiveAreaExplicitGhosts repeatClustering(particles, *filler.fCAJetDef, ghosts, ghostArea);
+      const std::vector<fastjet::PseudoJet> repeatJets = groomed(filler, repeatClustering);
+
+      bool sameP = true, sameRepeat = true;
+      for(unsigned int ig=0; ig<kNGroomed; ig++) {
+        sumOld[ig] += oldJets[ig].area();
+        sumNew[ig] += newJets[ig].area();
+        sameP      = sameP      && sameMomentum(oldJets[ig], newJets[ig]);
+        sameRepeat = sameRepeat && repeatJets[ig].area() == newJets[ig].area();
+      }
+      if(!sameP)      nMomentum++;
+      if(!sameRepeat) nRepeat++;
+    }
+
+    std::cout << "[compareJetAreas] cone " << cones[icone] << ", " << nJets << " jets, mean areas (before, windowed ghosts):" << std::endl;
+    for(unsigned int ig=0; ig<kNGroomed; ig++) {
+      const double meanOld = sumOld[ig]/nJets, meanNew = sumNew[ig]/nJets;
+      const double diff    = (meanOld > 0) ? fabs(meanNew - meanOld)/meanOld : fabs(meanNew);
+      std::cout << "  " << std::left << std::setw(10) << kGroomedNames[ig] << std::right << " " << meanOld << " " << meanNew
+                << (diff < kTolerance ? "" : "  DIFFERENT") << std::endl;
+      if(!(diff < kTolerance)) ok = false;
+    }
+    if(nMomentum > 0) { std::cout << "[compareJetAreas] " << nMomentum << " jets with another momentum!" << std::endl; ok = false; }
+    if(nRepeat   > 0) { std::cout << "[compareJetAreas] " << nRepeat   << " jets with other areas when reclustered again!" << std::endl; ok = false; }
+  }
+
+  std::cout << "[compareJetAreas] " << (ok ? "mean areas agree within " : "FAILED, tolerance ") << kTolerance << std::endl;
+  return ok ? 0 : 1;
+}
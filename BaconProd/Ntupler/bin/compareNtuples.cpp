@@ -0,0 +1,145 @@
+//
+// Check that two Bacon ntuples hold byte-identical events
+//
+//   compareNtuples <ntuple A> <ntuple B> [<tree name>]
+//
+// Every entry of every branch of the Events tree (or the given tree) is read from both files and
+// compared byte for byte: objects (event info, TClonesArray collections) as serialized by their
+// streamers, other branches as the values of their leaves. Used on the serial and the concurrent
+// NtuplerMod outputs of python/checkDeterminism_MC.py:
+//
+//   cmsRun checkDeterminism_MC.py && compareNtuples Serial.root Threaded3.root
+//
+// Prints the number of differing entries per branch and returns 1 if any branch differs.
+//
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TBranch.h>
+#include <TBranchElement.h>
+#include <TLeaf.h>
+#include <TClass.h>
+#include <TObjArray.h>
+#include <TBufferFile.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+// a top-level branch, read into an object of its class or through its leaves
+struct Branch {
+  std::string     name;
+  TClass         *cls;
+  void           *objA, *objB;
+  TBranch        *branchA, *branchB;
+  Long64_t        nDiffer;
+};
+
+// bytes of an object as written by its streamer
+void serialize(TBufferFile &buf, void *obj, TClass *cls) {
+  buf.Reset();
+  buf.WriteObjectAny(obj, cls);
+}
+
+bool sameLeaves(TBranch *branchA, TBranch *branchB) {
+  TObjArray *leavesA = branchA->GetListOfLeaves();
+  TObjArray *leavesB = branchB->GetListOfLeaves();
+  if(leavesA->GetEntriesFast() != leavesB->GetEntriesFast()) return false;
+  for(int ileaf=0; ileaf<leavesA->GetEntriesFast(); ileaf++) {
+    TLeaf *leafA = (TLeaf*)leavesA->UncheckedAt(ileaf);
+    TLeaf *leafB = (TLeaf*)leavesB->UncheckedAt(ileaf);
+    const int bytes = leafA->GetLen()*leafA->GetLenType();
+    if(leafB->GetLen()*leafB->GetLenType() != bytes) return false;
+    if(memcmp(leafA->GetValuePointer(), leafB->GetValuePointer(), bytes) != 0) return false;
+  }
+  return true;
+}
+
+int main( int argc, char **argv ) {
+  if(argc < 3) {
+    std::cout << "usage: compareNtuples <ntuple A> <ntuple B> [<tree name>]" << std::endl;
+    return 1;
+  }
+  const std::string treeName = (argc > 3) ? argv[3] : "Events";
+
+  TFile *fileA = TFile::Open(argv[1]);
+  TFile *fileB = TFile::Open(argv[2]);
+  if(!fileA || fileA->IsZombie() || !fileB || fileB->IsZombie()) { std::cout << "[compareNtuples] cannot open the ntuples!" << std::endl; return 1; }
+  TTree *treeA = (TTree*)fileA->Get(treeName.c_str());
+  TTree *treeB = (TTree*)fileB->Get(treeName.c_str());
+  if(!treeA || !treeB) { std::cout << "[compareNtuples] no " << treeName << " tree in both files!" << std::endl; return 1; }
+  if(treeA->GetEntries() != treeB->GetEntries()) {
+    std::cout << "[compareNtuples] " << treeA->GetEntries() << " entries in " << argv[1] << ", " << treeB->GetEntries() << " in " << argv[2] << "!" << std::endl;
+    return 1;
+  }
+
+  bool same = true;
+  std::vector<Branch> branches;
+  TObjArray *listA = treeA->GetListOfBranches();
+  for(int ibr=0; ibr<listA->GetEntriesFast(); ibr++) {
+    Branch br;
+    br.branchA = (TBranch*)listA->UncheckedAt(ibr);
+    br.name    = br.branchA->GetName();
+    br.branchB = treeB->GetBranch(br.name.c_str());
+    br.cls     = 0;
+    br.objA    = 0;
+    br.objB    = 0;
+    br.nDiffer = 0;
+    if(!br.branchB) { std::cout << "[compareNtuples] no branch " << br.name << " in " << argv[2] << "!" << std::endl; same = false; continue; }
+    TBranchElement *element = dynamic_cast<TBranchElement*>(br.branchA);
+    if(element) br.cls = TClass::GetClass(element->GetClassName());
+    branches.push_back(br);
+  }
+  if(listA->GetEntriesFast() != treeB->GetListOfBranches()->GetEntriesFast()) {
+    std::cout << "[compareNtuples] the trees have different branches!" << std::endl;
+    same = false;
+  }
+  // addresses are set once the vector is complete, so that they stay valid; the objects are
+  // created by the tree (arrays of the class of their branch)
+  for(unsigned int ibr=0; ibr<branches.size(); ibr++) {
+    if(!branches[ibr].cls) continue;
+    treeA->SetBranchAddress(branches[ibr].name.c_str(), &branches[ibr].objA);
+    treeB->SetBranchAddress(branches[ibr].name.c_str(), &branches[ibr].objB);
+  }
+
+  TBufferFile bufA(TBuffer::kWrite), bufB(TBuffer::kWrite);
+  for(Long64_t ientry=0; ientry<treeA->GetEntries(); ientry++) {
+    treeA->GetEntry(ientry);
+    treeB->GetEntry(ientry);
+    for(unsigned int ibr=0; ibr<branches.size(); ibr++) {
+      Branch &br = branches[ibr];
+      bool sameEntry = true;
+      if(br.cls && br.objA && br.objB) {
+        serialize(bufA, br.objA, br.cls);
+        serialize(bufB, br.objB, br.cls);
+        sameEntry = (bufA.Length() == bufB.Length() && memcmp(bufA.Buffer(), bufB.Buffer(), bufA.Length()) == 0);
+      } else if(!br.cls) {
+        sameEntry = sameLeaves(br.branchA, br.branchB);
+      }
+      if(!sameEntry) br.nDiffer++;
+    }
+  }
+
+  for(unsigned int ibr=0; ibr<branches.size(); ibr++) {
+    const Branch &br = branches[ibr];
+    if(br.nDiffer > 0) {
+      std::cout << "[compareNtuples] " << std::left << std::setw(16) << br.name << std::right << " differs in " << br.nDiffer << " entries" << std::endl;
+      same = false;
+    }
+  }
+  std::cout << "[compareNtuples] " << treeA->GetEntries() << " entries, " << branches.size() << " branches: "
+            << (same ? "byte-identical" : "DIFFERENT") << std::endl;
+
+  treeA->ResetBranchAddresses();
+  treeB->ResetBranchAddresses();
+  for(unsigned int ibr=0; ibr<branches.size(); ibr++) {
+    if(!branches[ibr].cls) continue;
+    if(branches[ibr].objA) branches[ibr].cls->Destructor(branches[ibr].objA);
+    if(branches[ibr].objB) branches[ibr].cls->Destructor(branches[ibr].objB);
+  }
+  fileA->Close();
+  fileB->Close();
+
+  return same ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+//
+// Compare the PF candidate depth and time of FillerPF from the rechit grid with the scans over all rechits
+//
+//   compareRecHitGrid [<number of events>] [<seed>]
+//
+// Random ECAL, HCAL and HO rechits (spread over the detector, with showers around some of the
+// candidates, near |eta| = 5 and across phi = +-pi) are indexed in a PFRecHitGrid, as in
+// FillerPF::fill, and concatenated in one collection for the brute-force timeDeltaR and
+// depthDeltaR. The depth and time of every candidate must be bit-identical for both. Prints the
+// number of differences and returns 1 if there is any.
+//
+
+#include "BaconProd/Ntupler/interface/FillerPF.hh"
+#include "BaconProd/Utils/interface/PFRecHitGrid.hh"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFLayer.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include <TRandom3.h>
+#include <TMath.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+
+using namespace baconhep;
+
+const unsigned int kNLayers = 3;
+const PFLayer::Layer kLayers[kNLayers] = { PFLayer::ECAL_BARREL, PFLayer::HCAL_BARREL1, PFLayer::HCAL_BARREL2 };
+const double kRho[kNLayers] = { 129., 180., 400. };   // radius of the layer
+
+reco::PFRecHit recHit(TRandom3 &rng, const unsigned int ilayer, const unsigned int detId, const double eta, const double phi) {
+  const double rho = kRho[ilayer] + rng.Gaus(0, 5.);
+  reco::PFRecHit hit(detId, kLayers[ilayer], rng.Exp(2.), rho*cos(phi), rho*sin(phi), rho*sinh(eta), 0, 0, 0);
+  hit.setTime(rng.Gaus(0, 2.));
+  return hit;
+}
+
+// an eta-phi position, at the edges of the grid now and then
+void randomPosition(TRandom3 &rng, double &eta, double &phi) {
+  eta = rng.Uniform(-5., 5.);
+  phi = rng.Uniform(-TMath::Pi(), TMath::Pi());
+  if(rng.Rndm() < 0.1) eta = (rng.Rndm() < 0.5 ? -1 : 1)*rng.Uniform(4.9, 5.);
+  if(rng.Rndm() < 0.1) phi = (rng.Rndm() < 0.5 ? -1 : 1)*rng.Uniform(TMath::Pi()-0.05, TMath::Pi());
+}
+
+// same float, also for NaN
+bool same(const float a, const float b) {
+  return a == b || (a != a && b != b);
+}
+
+int main( int argc, char **argv ) {
+  const unsigned int nEvents = (argc > 1) ? atoi(argv[1]) : 10;
+  const unsigned int seed    = (argc > 2) ? atoi(argv[2]) : 4357;
+  const double lCones[] = { 0.08, 0.2, 0.5 };   // the cone of FillerPF and wider ones
+  const std::vector<double> cones(lCones, lCones + sizeof(lCones)/sizeof(double));
+
+  TRandom3 rng(seed);
+  FillerPF filler;
+  PFRecHitGrid grid;
+  unsigned int nCompared = 0, nDepth = 0, nTime = 0;
+  for(unsigned int ievent=0; ievent<nEvents; ievent++) {
+    // candidates at the ECAL entrance
+    std::vector<reco::PFCandidate> candidates;
+    for(unsigned int icand=0; icand<500; icand++) {
+      double eta, phi;
+      randomPosition(rng, eta, phi);
+      const double pt = 1. + rng.Exp(10.);
+      reco::PFCandidate candidate(0, reco::PFCandidate::LorentzVector(pt*cos(phi), pt*sin(phi), pt*sinh(eta), pt*cosh(eta)), reco::PFCandidate::gamma);
+      candidate.setPositionAtECALEntrance(math::XYZPointF(kRho[0]*cos(phi), kRho[0]*sin(phi), kRho[0]*sinh(eta)));
+      candidates.push_back(candidate);
+    }
+
+    // rechits of each layer, uniform and in showers around a third of the candidates
+    std::vector<reco::PFRecHitCollection> layers(kNLayers);
+    unsigned int detId = 1;
+    for(unsigned int ilayer=0; ilayer<kNLayers; ilayer++) {
+      for(unsigned int ihit=0; ihit<3000; ihit++) {
+        double eta, phi;
+        randomPosition(rng, eta, phi);
+        layers[ilayer].push_back(recHit(rng, ilayer, detId++, eta, phi));
+      }
+      for(unsigned int icand=0; icand<candidates.size(); icand+=3) {
+        const unsigned int nHits = rng.Integer(10);
+        for(unsigned int ihit=0; ihit<nHits; ihit++) {
+          const double eta = candidates[icand].positionAtECALEntrance().eta() + rng.Gaus(0, 0.05);
+          const double phi = candidates[icand].positionAtECALEntrance().phi() + rng.Gaus(0, 0.05);
+          layers[ilayer].push_back(recHit(rng, ilayer, detId++, eta, phi));
+        }
+      }
+    }
+
+    // the grid of FillerPF, and the concatenated collection the brute-force overloads scan
+    reco::PFRecHitCollection all;
+    grid.clear();
+    for(unsigned int ilayer=0; ilayer<kNLayers; ilayer++) {
+      grid.addLayer(layers[ilayer]);
+      all.insert(all.end(), layers[ilayer].begin(), layers[ilayer].end());
+    }
+
+    for(unsigned int icand=0; icand<candidates.size(); icand++) {
+      for(unsigned int icone=0; icone<cones.size(); icone++) {
+        nCompared++;
+        if(!same(filler.depthDeltaR(&candidates[icand], grid, cones[icone]), filler.depthDeltaR(&candidates[icand], all, cones[icone]))) nDepth++;
+        if(!same(filler.timeDeltaR (&candidates[icand], grid, cones[icone]), filler.timeDeltaR (&candidates[icand], all, cones[icone]))) nTime++;
+      }
+    }
+  }
+
+  std::cout << "[compareRecHitGrid] " << nCompared << " candidate cones, " << nDepth << " depths and " << nTime << " times differ" << std::endl;
+  const bool ok = nDepth == 0 && nTime == 0;
+  std::cout << "[compareRecHitGrid] " << (ok ? "grid and scans agree" : "FAILED") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+#ifndef BACONPROD_NTUPLER_ENERGYCORRELATIONS_HH
+#define BACONPROD_NTUPLER_ENERGYCORRELATIONS_HH
+
+#include <fastjet/PseudoJet.hh>
+#include <vector>
+
+namespace baconhep
+{
+  //
+  // Energy correlation functions ECF(1..3,beta) of a jet for a list of angular exponents,
+  // with the pt_R measure of fastjet::EnergyCorrelator (pT and rapidity-phi distance).
+  // The pairwise log(dR^2) matrix and the constituent pTs are computed once per jet in
+  // float arrays; each beta then only costs one exp() per pair and the ECF sums.
+  //
+  class EnergyCorrelations
+  {
+    public:
+      // maxParticles>0 keeps only the leading constituents in pT
+      EnergyCorrelations(const std::vector<double> &betas, const unsigned int maxParticles=0);
+      ~EnergyCorrelations();
+
+      void compute(const fastjet::PseudoJet &jet);
+
+      unsigned int nBetas()           const { return fBetas.size(); }
+      double       beta(const int ib) const { return fBetas[ib];    }
+
+      // ECF(n,beta), n=1..3
+      double ecf(const int n, const int ib) const { return fECF[3*ib + n-1]; }
+
+      // ECF(3)/ECF(2), as fastjet::EnergyCorrelatorRatio(2,beta)
+      double r2(const int ib) const { return ecf(3,ib)/ecf(2,ib); }
+
+      // ECF(3)ECF(1)/ECF(2)^2, as fastjet::EnergyCorrelatorDoubleRatio(2,beta)
+      double c2(const int ib) const { return ecf(3,ib)*ecf(1,ib)/(ecf(2,ib)*ecf(2,ib)); }
+
+      // ECF(3)ECF(1)^3/ECF(2)^3
+      double d2(const int ib) const { return ecf(3,ib)*ecf(1,ib)*ecf(1,ib)*ecf(1,ib)/(ecf(2,ib)*ecf(2,ib)*ecf(2,ib)); }
+
+
+    protected:
+      std::vector<double> fBetas;
+      unsigned int        fMaxParticles;
+
+      std::vector<double> fECF;     // [3*ibeta + n-1]
+
+      // per jet work arrays, rows of fLogDR2/fAngle are padded to fStride
+      unsigned int        fN, fStride;
+      std::vector<float>  fPt;
+      std::vector<float>  fLogDR2;  // log(dR^2) of each pair
+      std::vector<float>  fAngle;   // dR^beta of each pair for the current beta
+  };
+}
+#endif
@@ -1,8 +1,10 @@
 #ifndef BACONPROD_NTUPLER_FILLERELECTRON_HH
 #define BACONPROD_NTUPLER_FILLERELECTRON_HH
 
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconProd/Utils/interface/ElectronMomentumCorrector.hh"
+#include "BaconProd/Utils/interface/PFIsoGrid.hh"
+#include "BaconProd/Utils/interface/RefIndexMap.hh"
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
 #include "EGamma/EGammaAnalysisTools/interface/EGammaMvaEleEstimator.h"
 #include <vector>
 #include <string>
@@ -13,10 +15,6 @@
 #include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 class TClonesArray;
-class EcalClusterLazyTools;
-namespace trigger {
-  class TriggerEvent;
-}
 
 
 namespace baconhep
@@ -32,15 +30,15 @@ namespace baconhep
 		const edm::EventSetup                       &iSetup,          // event setup info
 		const reco::Vertex                          &pv,              // event primary vertex
 		const int                                    nvtx,            // number of primary vertices
-		const std::vector<const reco::PFCandidate*> &pfNoPU,          // PFNoPU candidates
-		const std::vector<TriggerRecord>            &triggerRecords,  // list of trigger names and objects
-		const trigger::TriggerEvent                 &triggerEvent);   // event trigger objects
+		const PFIsoGrid                             &pfIsoGrid,       // PFNoPU/PFPU candidates binned in eta-phi
+		const RefIndexMap                           &refIndexMap);    // PF candidate, track and supercluster lookups
   
-      void computeIso(const reco::GsfElectron &ele, const double extRadius,
-                      const std::vector<const reco::PFCandidate*> &pfNoPU,
-                      float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso) const;
+      // PF isolation in the dR<0.3 and dR<0.4 cones, computed in one pass over the grid
+      void computeIso(const reco::GsfElectron &ele, const PFIsoGrid &pfIsoGrid,
+                      float &out_chHadIso03, float &out_gammaIso03, float &out_neuHadIso03,
+                      float &out_chHadIso04, float &out_gammaIso04, float &out_neuHadIso04) const;
       
-      double evalEleIDMVA(const reco::GsfElectron &ele, EcalClusterLazyTools &lazyTools);
+      double evalEleIDMVA(const reco::GsfElectron &ele, const ShowerShapes &shapes);
       
       
       // Electron cuts
@@ -49,11 +47,8 @@ namespace baconhep
       // EDM object collection names
       std::string fEleName;
       std::string fPFCandName;
-      std::string fTrackName;
       std::string fConvName;
       std::string fRhoName;
-      std::string fEBSCName;
-      std::string fEESCName;
       std::string fEBRecHitName;
       std::string fEERecHitName;
 
@@ -62,6 +57,9 @@ namespace baconhep
     
       // Electron momentum corrector
       baconhep::ElectronMomentumCorrector fEleCorr;
+
+      // shower-shape requests and evaluations of the electrons (see showerShapeReport in NtuplerMod)
+      ShowerShapes::Count fShapesCount;
   };
 }
 #endif
@@ -8,6 +8,7 @@
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
 #include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
 namespace trigger {
   class TriggerEvent;
 }
@@ -22,13 +23,14 @@ namespace baconhep
       FillerEventInfo();
       ~FillerEventInfo();
       
-      void fill(TEventInfo         *evtInfo,       // output object to be filled
-                const edm::Event   &iEvent,        // EDM event info
-		const reco::Vertex &pv,            // event primary vertex
-		const bool          hasGoodPV,     // flag for if PV passing cuts is found
-		const TriggerBits   triggerBits);  // bits for corresponding fired triggers
+      void fill(TEventInfo           *evtInfo,       // output object to be filled
+                const edm::Event     &iEvent,        // EDM event info
+		const reco::Vertex   &pv,            // event primary vertex
+		const TrackVertexMap &trkVtxMap,     // track-vertex association
+		const bool            hasGoodPV,     // flag for if PV passing cuts is found
+		const TriggerBits     triggerBits);  // bits for corresponding fired triggers
 	       
-      void computeTrackMET(const reco::Vertex &pv, 
+      void computeTrackMET(const TrackVertexMap &trkVtxMap,
                            const reco::PFCandidateCollection *pfCandCol,
                            float &out_met, float &out_metphi);
     
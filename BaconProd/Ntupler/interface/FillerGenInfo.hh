@@ -5,6 +5,7 @@
 
 // forward class declarations
 #include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticleFwd.h"
 class TClonesArray;
 
 
@@ -22,6 +23,9 @@ namespace baconhep
                 TClonesArray     *particlesArr,   // output array of particles to be filled
 		const edm::Event &iEvent);        // EDM event info
   
+      // true if the particle is stored in the output array
+      bool select(const reco::GenParticle &genP) const;
+      
       
       // EDM object collection names
       std::string fGenEvtInfoName;
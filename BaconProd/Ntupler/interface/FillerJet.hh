@@ -1,9 +1,10 @@
 #ifndef BACONPROD_NTUPLER_FILLERJET_HH
 #define BACONPROD_NTUPLER_FILLERJET_HH
 
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconProd/Utils/interface/JetPUIDMVACalculator.hh"
 #include "BaconProd/Utils/interface/QGLikelihoodCalculator.hh"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
+#include "BaconProd/Utils/interface/JetShapes.hh"
 #include "BaconAna/DataFormats/interface/TAddJet.hh"
 #include "DataFormats/JetReco/interface/PFJet.h"
 #include "DataFormats/JetReco/interface/BasicJet.h"
@@ -11,6 +12,7 @@
 #include "DataFormats/JetReco/interface/GenJetCollection.h"
 #include "fastjet/GhostedAreaSpec.hh"
 #include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
 #include "fastjet/tools/Filter.hh"
 #include "fastjet/tools/Pruner.hh"
 #include "fastjet/GhostedAreaSpec.hh"
@@ -19,14 +21,14 @@
 #include <string>
 
 // forward class declarations
+namespace baconhep {
+  class EnergyCorrelations;
+}
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 class TClonesArray;
 class FactorizedJetCorrector;
 class JetCorrectionUncertainty;
-namespace trigger {
-  class TriggerEvent;
-}
 
 namespace baconhep
 {
@@ -42,8 +44,7 @@ namespace baconhep
                 const edm::Event                 &iEvent,          // event info
 		const edm::EventSetup            &iSetup,          // event setup info
 	        const reco::Vertex		 &pv,	           // event primary vertex
-		const std::vector<TriggerRecord> &triggerRecords,  // list of trigger names and objects
-		const trigger::TriggerEvent      &triggerEvent);   // event trigger objects
+		const TrackVertexMap             &trkVtxMap);      // track-vertex association
             
       void initJetCorr(const std::vector<std::string> &jecFiles, 
                        const std::vector<std::string> &jecUncFiles,
@@ -52,7 +53,11 @@ namespace baconhep
       double correction(fastjet::PseudoJet &iJet,double iRho);      
       void   addJet(TAddJet *pPFJet,const reco::PFJet &itJet,double iRho);
 
-      fastjet::PseudoJet CACluster(fastjet::PseudoJet &iJet, fastjet::ClusterSequenceArea &iCAClustering); 
+      fastjet::PseudoJet CACluster(fastjet::PseudoJet &iJet, fastjet::ClusterSequence &iCAClustering); 
+
+      // explicit ghosts covering the constituents (padded by the cone size) instead of |y|<7
+      void windowGhosts(const std::vector<fastjet::PseudoJet> &iParticles, const double iPhiAxis,
+                        std::vector<fastjet::PseudoJet> &oGhosts, double &oGhostArea) const;
       //float              getTau( fastjet::PseudoJet &iJet,int iN, float iKappa );
       const reco::BasicJet*    match( const reco::PFJet *jet,const reco::BasicJetCollection  *jets );
       const reco::GenJet*      match( const reco::PFJet *jet,const reco::GenJetCollection    *jets );
@@ -82,13 +87,13 @@ namespace baconhep
       // quark-gluon likelihood calculator
       QGLikelihoodCalculator fQGLLCalc;
 
+      // constituent observables of the current jet
+      JetShapes fJetShapes;
+
       fastjet::JetDefinition*       fJetDef;
       fastjet::JetDefinition*       fGenJetDef;
       fastjet::JetDefinition*       fCAJetDef;
-    
-      fastjet::ActiveAreaSpec*      fActiveArea;
-      fastjet::AreaDefinition*      fAreaDefinition;
-      fastjet::ClusterSequenceArea* fClustering;
+      double                        fGhostArea;
       fastjet::Pruner* fPruner1;
       fastjet::Pruner* fPruner2;
 
@@ -99,6 +104,8 @@ namespace baconhep
       fastjet::Filter* fTrimmer2;
       fastjet::Filter* fTrimmer3;
       fastjet::Filter* fTrimmer4;
+
+      EnergyCorrelations* fECF;  // C2 for all betas in one pass
             
       
     protected:
@@ -1,8 +1,9 @@
 #ifndef BACONPROD_NTUPLER_FILLERMUON_HH
 #define BACONPROD_NTUPLER_FILLERMUON_HH
 
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconProd/Utils/interface/MuonMomentumCorrector.hh"
+#include "BaconProd/Utils/interface/PFIsoGrid.hh"
+#include "BaconProd/Utils/interface/RefIndexMap.hh"
 #include <vector>
 #include <string>
 
@@ -12,9 +13,6 @@
 #include "DataFormats/TrackReco/interface/TrackFwd.h"
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 class TClonesArray;
-namespace trigger {
-  class TriggerEvent;
-}
 
 
 namespace baconhep
@@ -29,15 +27,13 @@ namespace baconhep
                 const edm::Event			    &iEvent,	      // event info
 	        const edm::EventSetup			    &iSetup,	      // event setup info
 	        const reco::Vertex			    &pv,	      // event primary vertex
-	        const std::vector<const reco::PFCandidate*> &pfNoPU,	      // PFNoPU candidates
-	        const std::vector<const reco::PFCandidate*> &pfPU,	      // PFPU candidates
-	        const std::vector<TriggerRecord>	    &triggerRecords,  // list of trigger names and objects
-	        const trigger::TriggerEvent		    &triggerEvent);   // event trigger objects
+	        const PFIsoGrid                             &pfIsoGrid,       // PFNoPU/PFPU candidates binned in eta-phi
+	        const RefIndexMap                           &refIndexMap);    // PF candidate and track lookups
      
-      void computeIso(const reco::Track &track, const double extRadius,
-                      const std::vector<const reco::PFCandidate*> &pfNoPU,
-		      const std::vector<const reco::PFCandidate*> &pfPU,
-                      float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso, float &out_puIso) const;
+      // PF isolation in the dR<0.3 and dR<0.4 cones, computed in one pass over the grid
+      void computeIso(const reco::Track &track, const PFIsoGrid &pfIsoGrid,
+                      float &out_chHadIso03, float &out_gammaIso03, float &out_neuHadIso03, float &out_puIso03,
+                      float &out_chHadIso04, float &out_gammaIso04, float &out_neuHadIso04, float &out_puIso04) const;
       
       
       // Muon cuts
@@ -2,12 +2,15 @@
 #define BACONPROD_NTUPLER_FILLERPF_HH
 
 #include <string>
+#include <vector>
 
 // forward class declarations
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
+#include "BaconProd/Utils/interface/PFRecHitGrid.hh"
 
 class TClonesArray;
 
@@ -20,12 +23,17 @@ namespace baconhep
       FillerPF();
       ~FillerPF();
       
-       void fill(TClonesArray       *array,    // output array to be filled
-		 TClonesArray       *iVtxCol,
-		 const edm::Event   &iEvent);  // event info
+       void fill(TClonesArray         *array,      // output array to be filled
+		 TClonesArray         *iVtxCol,
+		 const edm::Event     &iEvent,     // event info
+		 const TrackVertexMap &trkVtxMap); // track-vertex association
     //Useful tools
+    // scan over all rechits, the reference of the grid overloads (see compareRecHitGrid)
     float depthDeltaR(const reco::PFCandidate *iPF,const reco::PFRecHitCollection &iPFCol,double iDR=0.08) ;
     float timeDeltaR (const reco::PFCandidate *iPF,const reco::PFRecHitCollection &iPFCol,double iDR=0.08) ;
+    // same, visiting only the rechits of the grid cells around the candidate
+    float depthDeltaR(const reco::PFCandidate *iPF,const PFRecHitGrid &iGrid,double iDR=0.08) ;
+    float timeDeltaR (const reco::PFCandidate *iPF,const PFRecHitGrid &iGrid,double iDR=0.08) ;
     float depth(const reco::PFCandidate *iPF);
     float time (const reco::PFCandidate *iPF);
       
@@ -33,6 +41,10 @@ namespace baconhep
       std::string fPFName;
       std::string fPVName;
       bool        fAddDepthTime;
+      
+    protected:
+      PFRecHitGrid                        fRecHitGrid;  // ECAL, HCAL and HO rechits of the event
+      std::vector<const reco::PFRecHit*>  fRecHits;     // scratch space for the grid queries
   };
 }
 #endif
@@ -1,7 +1,9 @@
 #ifndef BACONPROD_NTUPLER_FILLERPHOTON_HH
 #define BACONPROD_NTUPLER_FILLERPHOTON_HH
 
-#include "BaconProd/Utils/interface/TriggerTools.hh"
+#include "BaconProd/Utils/interface/PFIsoGrid.hh"
+#include "BaconProd/Utils/interface/RefIndexMap.hh"
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
 #include <vector>
 #include <string>
 
@@ -12,9 +14,6 @@
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 class TClonesArray;
 class EcalClusterLazyTools;
-namespace trigger {
-  class TriggerEvent;
-}
 
 
 namespace baconhep
@@ -29,17 +28,13 @@ namespace baconhep
                 const edm::Event		            &iEvent,	      // event info
 	        const edm::EventSetup		            &iSetup,	      // event setup info
                 const reco::Vertex                          &pv,              // event primary vertex
-		const std::vector<const reco::PFCandidate*> &pfNoPU,          // PFNoPU candidates
-	        const std::vector<const reco::PFCandidate*> &pfPU,	      // PFPU candidates
-	        const std::vector<TriggerRecord>            &triggerRecords,  // list of trigger names and objects
-	        const trigger::TriggerEvent	            &triggerEvent);   // event trigger objects
+		const PFIsoGrid                             &pfIsoGrid,       // PFNoPU/PFPU candidates binned in eta-phi
+		const RefIndexMap                           &refIndexMap);    // PF candidate and supercluster lookups
             
-      void computeIso(const reco::Photon &photon, const std::vector<const reco::PFCandidate*> &pfNoPU,
+      void computeIso(const reco::Photon &photon, const PFIsoGrid &pfIsoGrid,
                       float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso) const;
       
-      float computeIsoForFSR(const reco::PFCandidate *photon,
-                             const std::vector<const reco::PFCandidate*> &pfNoPU,
-		             const std::vector<const reco::PFCandidate*> &pfPU) const;
+      float computeIsoForFSR(const reco::PFCandidate *photon, const PFIsoGrid &pfIsoGrid) const;
 
       
       // Photon cuts
@@ -50,10 +45,11 @@ namespace baconhep
       std::string fPFCandName;
       std::string fEleName;
       std::string fConvName;
-      std::string fEBSCName;
-      std::string fEESCName;
       std::string fEBRecHitName;
       std::string fEERecHitName;
+
+      // shower-shape requests and evaluations of the photons (see showerShapeReport in NtuplerMod)
+      ShowerShapes::Count fShapesCount;
   };
 }
 #endif
@@ -1,7 +1,6 @@
 #ifndef BACONPROD_NTUPLER_FILLERTAU_HH
 #define BACONPROD_NTUPLER_FILLERTAU_HH
 
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 //#include "BaconProd/Utils/interface/TauIsoMVACalculator.hh"
 #include "DataFormats/TauReco/interface/PFTauDiscriminator.h"
 #include "DataFormats/Common/interface/Handle.h"
@@ -13,9 +12,6 @@
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include "DataFormats/TauReco/interface/PFTauFwd.h"
 class TClonesArray;
-namespace trigger {
-  class TriggerEvent;
-}
 
 
 namespace baconhep
@@ -44,9 +40,7 @@ namespace baconhep
       void fill(TClonesArray                     *array,           // output array to be filled
                 const edm::Event                 &iEvent,          // event info
 		const edm::EventSetup            &iSetup,          // event setup info
-		const reco::Vertex               &pv,              // event primary vertex
-		const std::vector<TriggerRecord> &triggerRecords,  // list of trigger names and objects
-		const trigger::TriggerEvent      &triggerEvent);   // event trigger objects
+		const reco::Vertex               &pv);             // event primary vertex
       
       
       // Tau cuts
@@ -12,6 +12,7 @@
 #include "BaconProd/Ntupler/interface/FillerGenInfo.hh"
 #include "BaconProd/Ntupler/interface/FillerVertex.hh"
 #include "BaconProd/Ntupler/interface/FillerPF.hh"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
 
 // tools to parse HLT name patterns
 #include <boost/foreach.hpp>
@@ -43,6 +44,7 @@ ExpertMod::ExpertMod(const edm::ParameterSet &iConfig):
   fHLTTag         ("TriggerResults","","HLT"),
   fHLTObjTag      ("hltTriggerSummaryAOD","","HLT"),
   fHLTFile        (iConfig.getUntrackedParameter<std::string>("TriggerFile","HLT")),
+  fTrkVtxMap      (0),
   fGenEvtInfoName (iConfig.getUntrackedParameter<std::string>("genEventInfoName", "generator")),
   fGenParName     (iConfig.getUntrackedParameter<std::string>("genParticlesName", "genParticles")),
   fPFCandName     (iConfig.getUntrackedParameter<std::string>("pflowCandidatesName", "particleFlow")),
@@ -52,6 +54,7 @@ ExpertMod::ExpertMod(const edm::ParameterSet &iConfig):
   fFillerEvtInfo  (0),
   fFillerGenInfo  (0),
   fFillerPV       (0),
+  fFillerPF       (0),
   fOutputName     (iConfig.getUntrackedParameter<std::string>("outputName", "ntuple.root")),
   fOutputFile     (0),
   fEventTree      (0),
@@ -104,6 +107,8 @@ void ExpertMod::beginJob()
   //
   setTriggers();
 
+  fTrkVtxMap = new baconhep::TrackVertexMap();
+
   //
   // Fillers
   //
@@ -132,6 +137,8 @@ void ExpertMod::beginJob()
   fFillerPV->fMaxRho	    = 2;
 
   fFillerPF  = new baconhep::FillerPF();
+  fFillerPF->fPFName = fPFCandName;
+  fFillerPF->fPVName = fPVName;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -148,6 +155,7 @@ void ExpertMod::endJob()
   delete fFillerGenInfo;
   delete fFillerPV;
   delete fFillerPF;
+  delete fTrkVtxMap;
 
   delete fEvtInfo;
   delete fGenEvtInfo;
@@ -196,9 +204,9 @@ void ExpertMod::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
   assert(pv);
   
   separatePileUp(iEvent, *pv);
-  fFillerEvtInfo->fill(fEvtInfo, iEvent, *pv, (nvertices>0), triggerBits);
+  fFillerEvtInfo->fill(fEvtInfo, iEvent, *pv, *fTrkVtxMap, (nvertices>0), triggerBits);
   fPFParArr->Clear();
-  fFillerPF->fill(fPFParArr,fPVArr,iEvent);
+  fFillerPF->fill(fPFParArr,fPVArr,iEvent,*fTrkVtxMap);
   fEventTree->Fill();
 }
 
@@ -249,41 +257,33 @@ void ExpertMod::separatePileUp(const edm::Event &iEvent, const reco::Vertex &pv)
   fPFNoPU.clear();
   fPFPU.clear();
   
-  for(reco::PFCandidateCollection::const_iterator iP = pfCandCol->begin(); iP!=pfCandCol->end(); ++iP) {
+  // associate tracks to vertices once for the whole event
+  fTrkVtxMap->build(pfCandCol, pvCol, pv);
+  
+  for(unsigned int ipf=0; ipf<pfCandCol->size(); ipf++) {
+    const reco::PFCandidate *iP = &(*pfCandCol)[ipf];
+    const baconhep::TrackVertexMap::PFAssoc &assoc = fTrkVtxMap->pfAssoc(ipf);
     if(iP->particleId() == reco::PFCandidate::h) {  // charged hadrons
-      if(iP->trackRef().isNonnull() && pv.trackWeight(iP->trackRef())>0) {
+      if(assoc.pvWeight>0) {
         // charged hadrons with track used to compute PV
-	fPFNoPU.push_back(&(*iP)); 
+	fPFNoPU.push_back(iP); 
       
       } else {
         // Find closest vertex to charged hadron's vertex source
-	bool vertexFound = false;
+	bool vertexFound = (assoc.vtxIndex >= 0);
 	const reco::Vertex *closestVtx = 0;
-	double dzmin = 10000;
-	
-	for(reco::VertexCollection::const_iterator iV = pvCol->begin(); iV!=pvCol->end(); ++iV) {
-	  if(iP->trackRef().isNonnull() && iV->trackWeight(iP->trackRef())>0) {
-	    vertexFound = true;
-	    closestVtx  = &(*iV);
-	    break;
-	  }
-	  
-	  double dz = fabs(iP->vertex().z() - iV->z());
-	  if(dz < dzmin) {
-	    closestVtx = &(*iV);
-	    dzmin      = dz;
-	  }
-	}
+	if(vertexFound)                closestVtx = &(*pvCol)[assoc.vtxIndex];
+	else if(assoc.closestIndex>=0) closestVtx = &(*pvCol)[assoc.closestIndex];
 	
 	if(vertexFound || closestVtx != &pv) {
-	  fPFPU.push_back(&(*iP));
+	  fPFPU.push_back(iP);
 	} else {
-	  fPFNoPU.push_back(&(*iP));  // Note: when no associated vertex found, assume to come from PV
+	  fPFNoPU.push_back(iP);  // Note: when no associated vertex found, assume to come from PV
 	}
       }
       
     } else {  // all non-charged-hadron PFCandidates are considered to be from PV
-      fPFNoPU.push_back(&(*iP));
+      fPFNoPU.push_back(iP);
     }
   }
 }
@@ -21,6 +21,7 @@ namespace baconhep {
   class FillerGenInfo;
   class FillerVertex;
   class FillerPF;
+  class TrackVertexMap;
 }
 
 //
@@ -66,6 +67,7 @@ class ExpertMod : public edm::EDAnalyzer {
     
     std::vector<const reco::PFCandidate*> fPFNoPU;
     std::vector<const reco::PFCandidate*> fPFPU;
+    baconhep::TrackVertexMap              *fTrkVtxMap;  // per-event track-vertex association
 
     // AOD collection names
     std::string fGenEvtInfoName;
@@ -14,6 +14,7 @@
 #include "BaconAna/DataFormats/interface/TVertex.hh"
 #include "BaconAna/DataFormats/interface/TAddJet.hh"
 #include "BaconAna/DataFormats/interface/TPFPart.hh"
+#include "BaconAna/DataFormats/interface/LumiSummary.hh"
 
 #include "BaconProd/Ntupler/interface/FillerEventInfo.hh"
 #include "BaconProd/Ntupler/interface/FillerGenInfo.hh"
@@ -24,9 +25,23 @@
 #include "BaconProd/Ntupler/interface/FillerTau.hh"
 #include "BaconProd/Ntupler/interface/FillerJet.hh"
 #include "BaconProd/Ntupler/interface/FillerPF.hh"
+#include "BaconProd/Utils/interface/PFIsoGrid.hh"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
+#include "BaconProd/Utils/interface/RefIndexMap.hh"
+#include "BaconProd/Utils/interface/TriggerObjectMatcher.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
+#include "BaconProd/Utils/interface/AsyncTreeWriter.hh"
+#include "BaconProd/Utils/interface/OutputProfile.hh"
+#include "BaconProd/Utils/interface/DeterminismCheck.hh"
 
 // tools to parse HLT name patterns
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
 #include "FWCore/Utilities/interface/RegexMatch.h"
 
 #include "FWCore/Common/interface/TriggerNames.h"
@@ -35,9 +50,29 @@
 
 // data format classes
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlock.h"
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackExtra.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrackExtra.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/CaloRecHit/interface/CaloCluster.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectronCore.h"
+#include "DataFormats/EgammaCandidates/interface/PhotonCore.h"
+#include "DataFormats/EgammaCandidates/interface/Photon.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+#include "DataFormats/JetReco/interface/PFJet.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
+#include "Geometry/Records/interface/CaloGeometryRecord.h"
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 
 // ROOT classes
 #include <TFile.h>
@@ -47,6 +82,47 @@
 #include <TLorentzVector.h>
 #include <TMath.h>
 
+namespace {
+  // queue the objects of an output array for HLT object matching
+  template<class T> void addTriggerQueries(baconhep::TriggerObjectMatcher &matcher, TClonesArray *array)
+  {
+    for(int i=0; i<array->GetEntriesFast(); i++) {
+      T *obj = (T*)array->At(i);
+      matcher.add(obj->eta, obj->phi, obj->hltMatchBits);
+    }
+  }
+  
+  // read a product of the event (if it is there)
+  template<class C> void prefetch(const edm::Event &iEvent, const edm::InputTag &iTag)
+  {
+    edm::Handle<C> handle;
+    iEvent.getByLabel(iTag, handle);
+  }
+
+  // the collection types a prefetched product can have, by their name in prefetchProducts
+  typedef void (*PrefetchFunc)(const edm::Event&, const edm::InputTag&);
+  PrefetchFunc prefetchFunc(const std::string &type)
+  {
+    if(type == "Track")           return &prefetch<reco::TrackCollection>;
+    if(type == "TrackExtra")      return &prefetch<reco::TrackExtraCollection>;
+    if(type == "GsfTrack")        return &prefetch<reco::GsfTrackCollection>;
+    if(type == "GsfTrackExtra")   return &prefetch<reco::GsfTrackExtraCollection>;
+    if(type == "GsfElectronCore") return &prefetch<reco::GsfElectronCoreCollection>;
+    if(type == "PhotonCore")      return &prefetch<reco::PhotonCoreCollection>;
+    if(type == "Photon")          return &prefetch<reco::PhotonCollection>;
+    if(type == "SuperCluster")    return &prefetch<reco::SuperClusterCollection>;
+    if(type == "CaloCluster")     return &prefetch<reco::CaloClusterCollection>;
+    if(type == "Conversion")      return &prefetch<reco::ConversionCollection>;
+    if(type == "PFCandidate")     return &prefetch<reco::PFCandidateCollection>;
+    if(type == "PFBlock")         return &prefetch<reco::PFBlockCollection>;
+    if(type == "PFCluster")       return &prefetch<reco::PFClusterCollection>;
+    if(type == "PFRecHit")        return &prefetch<reco::PFRecHitCollection>;
+    if(type == "PFJet")           return &prefetch<reco::PFJetCollection>;
+    if(type == "GenParticle")     return &prefetch<reco::GenParticleCollection>;
+    return 0;
+  }
+}
+
 
 //--------------------------------------------------------------------------------------------------
 NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
@@ -57,6 +133,10 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
   fHLTTag         ("TriggerResults","","HLT"),
   fHLTObjTag      ("hltTriggerSummaryAOD","","HLT"),
   fHLTFile        (iConfig.getUntrackedParameter<std::string>("TriggerFile","HLT")),
+  fTrgMatcher     (0),
+  fPFIsoGrid      (0),
+  fTrkVtxMap      (0),
+  fRefIndexMap    (0),
   fEleMinPt       (iConfig.getUntrackedParameter<double>("electronMinPt",5)),
   fMuonMinPt      (iConfig.getUntrackedParameter<double>("muonMinPt",0)),
   fTauMinPt       (iConfig.getUntrackedParameter<double>("tauMinPt",20)),
@@ -82,6 +162,8 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
   fNCones         (iConfig.getUntrackedParameter<int>("NumCones", 2)),
   fMinCone        (iConfig.getUntrackedParameter<double>("MinCone" , 0.4)),
   fConeIter       (iConfig.getUntrackedParameter<double>("ConeIter", 0.1)),
+  fNThreads       (iConfig.getUntrackedParameter<int>("NumThreads", iConfig.getUntrackedParameter<int>("NumJetThreads", 1))),
+  fCheckDeterminism(iConfig.getUntrackedParameter<bool>("checkDeterminism", false)),
   fJetName        (iConfig.getUntrackedParameter<std::string>("jetName", "ak5PFJets")),
   fGenJetName     (iConfig.getUntrackedParameter<std::string>("genJetName"   , "ak5GenJets")),
   fJetFlavorName  (iConfig.getUntrackedParameter<std::string>("jetFlavorName", "jetCombinedSecondaryVertexBJetTagsSJ")),
@@ -109,6 +191,8 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
   fFillerMuon     (0),
   fFillerPhoton   (0),
   fFillerTau      (0),
+  fScheduler      (0),
+  fDetCheck       (0),
 //  fIsActiveEvtInfo(iConfig.getUntrackedParameter<bool>("isActiveEventInfo", true)),
 //  fIsActiveGenInfo(iConfig.getUntrackedParameter<bool>("isActiveGenInfo", true)),
 //  fIsActivePV     (iConfig.getUntrackedParameter<bool>("isActivePV", true)),
@@ -118,8 +202,17 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
 //  fIsActiveTau    (iConfig.getUntrackedParameter<bool>("isActiveTau", true)),
 //  fIsActiveJet    (iConfig.getUntrackedParameter<bool>("isActiveJet", true)),
   fOutputName     (iConfig.getUntrackedParameter<std::string>("outputName", "ntuple.root")),
+  fAsyncOutput    (iConfig.getUntrackedParameter<bool>("asyncOutput", false)),
+  fNCompressionThreads(iConfig.getUntrackedParameter<int>("numCompressionThreads", 0)),
+  fOutputProfileName(iConfig.getUntrackedParameter<std::string>("outputProfile", "default")),
+  fColumnarOutput (iConfig.getUntrackedParameter<std::string>("outputFormat", "classic") == "columnar"),
+  fOutputReport   (iConfig.getUntrackedParameter<bool>("outputReport", false)),
+  fShowerShapeReport(iConfig.getUntrackedParameter<bool>("showerShapeReport", false)),
   fOutputFile     (0),
   fEventTree      (0),
+  fWriter         (0),
+  fOutputProfile  (0),
+  fLumiSummary    (0),
   fEvtInfo        (0),
   fGenEvtInfo     (0),
   fGenParArr      (0),
@@ -128,8 +221,16 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
   fTauArr         (0),
   fJetArr         (0),
   fPhotonArr      (0),
-  fPVArr          (0)
+  fPVArr          (0),
+  fCheckEvtInfo   (0),
+  fCheckGenEvtInfo(0)
 {
+  const std::string outputFormat = iConfig.getUntrackedParameter<std::string>("outputFormat", "classic");
+  if(outputFormat != "classic" && outputFormat != "columnar") {
+    std::cout << "[NtuplerMod] unknown output format " << outputFormat << "!" << std::endl;
+    assert(0);
+  }
+
   // Don't write TObject part of the objects
   baconhep::TEventInfo::Class()->IgnoreTObjectStreamer();
   baconhep::TEventInfo::Class()->IgnoreTObjectStreamer();
@@ -144,6 +245,52 @@ NtuplerMod::NtuplerMod(const edm::ParameterSet &iConfig):
   baconhep::TAddJet::Class()->IgnoreTObjectStreamer();
   baconhep::TPFPart::Class()->IgnoreTObjectStreamer();
 
+  //
+  // Products the references of the output objects point into, read before the concurrent fillers
+  // (see prefetchRefTargets), as type:label[:instance]. By default the configured inputs and the
+  // standard AOD products behind them.
+  //
+  std::vector<std::string> lPrefetchDefault;
+  lPrefetchDefault.push_back("Track:"           + fTrackName);
+  lPrefetchDefault.push_back("TrackExtra:"      + fTrackName);
+  lPrefetchDefault.push_back("Track:globalMuons");
+  lPrefetchDefault.push_back("Track:standAloneMuons:UpdatedAtVtx");
+  lPrefetchDefault.push_back("GsfTrack:electronGsfTracks");
+  lPrefetchDefault.push_back("GsfTrackExtra:electronGsfTracks");
+  lPrefetchDefault.push_back("GsfElectronCore:gsfElectronCores");
+  lPrefetchDefault.push_back("PhotonCore:photonCore");
+  lPrefetchDefault.push_back("Photon:"          + fPhotonName);
+  lPrefetchDefault.push_back("SuperCluster:"    + fEBSCName);
+  lPrefetchDefault.push_back("SuperCluster:"    + fEESCName);
+  lPrefetchDefault.push_back("CaloCluster:hybridSuperClusters:hybridBarrelBasicClusters");
+  lPrefetchDefault.push_back("CaloCluster:multi5x5SuperClusters:multi5x5EndcapBasicClusters");
+  lPrefetchDefault.push_back("Conversion:"      + fConvName);
+  lPrefetchDefault.push_back("PFCandidate:"     + fPFCandName);
+  lPrefetchDefault.push_back("PFJet:"           + fJetName);
+  if(fAddParticleFlow) {
+    lPrefetchDefault.push_back("PFBlock:particleFlowBlock");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterECAL");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterHCAL");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterHO");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterPS");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterHFEM");
+    lPrefetchDefault.push_back("PFCluster:particleFlowClusterHFHAD");
+    lPrefetchDefault.push_back("PFRecHit:particleFlowRecHitECAL");
+    lPrefetchDefault.push_back("PFRecHit:particleFlowRecHitHCAL");
+    lPrefetchDefault.push_back("PFRecHit:particleFlowRecHitPS");
+  }
+  if(fUseGen) lPrefetchDefault.push_back("GenParticle:" + fGenParName);
+  const std::vector<std::string> lPrefetch = iConfig.getUntrackedParameter<std::vector<std::string> >("prefetchProducts", lPrefetchDefault);
+  for(unsigned int i0 = 0; i0 < lPrefetch.size(); i0++) {
+    const size_t lColon = lPrefetch[i0].find(':');
+    PrefetchFunc lFunc  = (lColon == std::string::npos) ? 0 : prefetchFunc(lPrefetch[i0].substr(0, lColon));
+    if(!lFunc) {
+      std::cout << "[NtuplerMod] unknown prefetched product " << lPrefetch[i0] << "!" << std::endl;
+      assert(0);
+    }
+    fPrefetch.push_back(std::make_pair(lFunc, edm::InputTag(lPrefetch[i0].substr(lColon+1))));
+  }
+
   fFillerJet     = new baconhep::FillerJet*[fNCones];
   fJetArr        = new TClonesArray*[fNCones];
   fAddJetArr     = new TClonesArray*[fNCones];
@@ -179,27 +326,56 @@ void NtuplerMod::beginJob()
   fOutputFile  = new TFile(fOutputName.c_str(), "RECREATE");
   fTotalEvents = new TH1F("TotalEvents","TotalEvents",1,-10,10);
   fEventTree   = new TTree("Events","Events");
+  fWriter      = new baconhep::AsyncTreeWriter(fEventTree, fAsyncOutput, fNCompressionThreads);
   
-  fEventTree->Branch("Info",fEvtInfo);
+  fWriter->addBranch("Info",fEvtInfo);
   if(fUseGen) {
-    fEventTree->Branch("GenEvtInfo",fGenEvtInfo);
-    fEventTree->Branch("GenParticle",&fGenParArr);
+    fWriter->addBranch("GenEvtInfo",fGenEvtInfo);
+    addArray("GenParticle",fGenParArr);
   }
-  fEventTree->Branch("Electron", &fEleArr);
-  fEventTree->Branch("Muon",     &fMuonArr);
-  fEventTree->Branch("Tau",      &fTauArr);
-  fEventTree->Branch("Photon",   &fPhotonArr);
-  fEventTree->Branch("PV",       &fPVArr);
+  addArray("Electron", fEleArr);
+  addArray("Muon",     fMuonArr);
+  addArray("Tau",      fTauArr);
+  addArray("Photon",   fPhotonArr);
+  addArray("PV",       fPVArr);
   for(int i0 = 0; i0 < fNCones; i0++) { 
     std::stringstream pSS; pSS << "Jet0" << int((fMinCone+i0*fConeIter)*10); 
-    fEventTree->Branch(pSS.str().c_str(),      &fJetArr[i0]);
-    if(fComputeFullJetInfo) fEventTree->Branch(("Add"+pSS.str()).c_str(),   &fAddJetArr[i0]);
+    addArray(pSS.str().c_str(),      fJetArr[i0]);
+    if(fComputeFullJetInfo) addArray(("Add"+pSS.str()).c_str(),   fAddJetArr[i0]);
   }
-  if(fAddParticleFlow)   fEventTree->Branch("PFPart",   &fPFParArr);
+  if(fAddParticleFlow)   addArray("PFPart",   fPFParArr);
+  if(fCheckDeterminism) {
+    // everything the scheduled fillers write (PV is filled before them)
+    fDetCheck        = new baconhep::DeterminismCheck();
+    fCheckEvtInfo    = new baconhep::TEventInfo();
+    fCheckGenEvtInfo = new baconhep::TGenEventInfo();
+    if(fUseGen) addCheckedArray("GenParticle", fGenParArr);
+    addCheckedArray("Electron", fEleArr);
+    addCheckedArray("Muon",     fMuonArr);
+    addCheckedArray("Tau",      fTauArr);
+    addCheckedArray("Photon",   fPhotonArr);
+    for(int i0 = 0; i0 < fNCones; i0++) { 
+      std::stringstream pSS; pSS << "Jet0" << int((fMinCone+i0*fConeIter)*10); 
+      addCheckedArray(pSS.str(),       fJetArr[i0]);
+      addCheckedArray("Add"+pSS.str(), fAddJetArr[i0]);
+    }
+    if(fAddParticleFlow) addCheckedArray("PFPart", fPFParArr);
+  }
+  
+  fOutputProfile = new baconhep::OutputProfile(fOutputProfileName);
+  fOutputProfile->apply(fEventTree);
+  fWriter->setAfterFill(boost::bind(&baconhep::OutputProfile::afterFill, fOutputProfile, fEventTree));
+  fLumiSummary   = new baconhep::LumiSummary();
   //
   // Triggers
   //
   setTriggers();
+  fTrgMatcher = new baconhep::TriggerObjectMatcher();
+
+  fPFIsoGrid = new baconhep::PFIsoGrid();
+  fTrkVtxMap = new baconhep::TrackVertexMap();
+  fRefIndexMap = new baconhep::RefIndexMap();
+  fScheduler   = new baconhep::TaskScheduler();
 
   //
   // Fillers
@@ -222,6 +398,8 @@ void NtuplerMod::beginJob()
 
   if(fAddParticleFlow)   fFillerPF  = new baconhep::FillerPF();
   if(fAddParticleFlow)   fFillerPF->fAddDepthTime = fAddDepthTime;
+  if(fAddParticleFlow)   fFillerPF->fPFName       = fPFCandName;
+  if(fAddParticleFlow)   fFillerPF->fPVName       = fPVName;
 
   fFillerPV = new baconhep::FillerVertex();
   fFillerPV->fPVName	    = fPVName;
@@ -234,15 +412,13 @@ void NtuplerMod::beginJob()
   fFillerEle->fMinPt	    = fEleMinPt;
   fFillerEle->fEleName      = fEleName;
   fFillerEle->fPFCandName   = fPFCandName;
-  fFillerEle->fTrackName    = fTrackName;
   fFillerEle->fConvName     = fConvName;
   fFillerEle->fRhoName      = fRhoIsoName;
-  fFillerEle->fEBSCName     = fEBSCName;
-  fFillerEle->fEESCName     = fEESCName;
   fFillerEle->fEBRecHitName = fEBRecHitName;
   fFillerEle->fEERecHitName = fEERecHitName;
   
   std::string cmsenv = getenv("CMSSW_BASE"); cmsenv+="/src";
+  baconhep::CalibrationRegistry::loadBundle(cmsenv+"/BaconProd/Utils/data/calibrations.bundle");  // text files are parsed if missing
   std::vector<std::string> eleIDFilenames;
   eleIDFilenames.push_back(cmsenv+"/BaconProd/Utils/data/ElectronID_BDTG_EGamma2012NonTrigV0_Cat1.weights.xml");
   eleIDFilenames.push_back(cmsenv+"/BaconProd/Utils/data/ElectronID_BDTG_EGamma2012NonTrigV0_Cat2.weights.xml");
@@ -281,8 +457,6 @@ void NtuplerMod::beginJob()
   fFillerPhoton->fPFCandName   = fPFCandName;
   fFillerPhoton->fEleName      = fEleName;
   fFillerPhoton->fConvName     = fConvName;
-  fFillerPhoton->fEBSCName     = fEBSCName;
-  fFillerPhoton->fEESCName     = fEESCName;
   fFillerPhoton->fEBRecHitName = fEBRecHitName;
   fFillerPhoton->fEERecHitName = fEERecHitName;
   
@@ -345,9 +519,24 @@ void NtuplerMod::endJob()
   // Save to ROOT file
   //
   //fEventTree->Print();
+  fWriter->finish();
   fOutputFile->cd();
   fTotalEvents->Write();
+  fLumiSummary->write(fOutputFile);
   fOutputFile->Write();
+  if(fOutputReport) {
+    fOutputProfile->report(fEventTree, std::cout, fWriter->fillSeconds());
+    if(fAsyncOutput) std::cout << "[NtuplerMod] asynchronous output: the event loop waited " << fWriter->waitSeconds() << " s for the writer" << std::endl;
+  }
+  if(fDetCheck)     fDetCheck->report(std::cout);
+  if(fShowerShapeReport) {
+    fFillerEle->fShapesCount.report(std::cout, "electrons");
+    fFillerPhoton->fShapesCount.report(std::cout, "photons");
+    if(fFillerEle->fShapesCount.nRepeated > 0 || fFillerPhoton->fShapesCount.nRepeated > 0) {
+      std::cout << "[NtuplerMod] shower-shape quantities evaluated more than once for the same object!" << std::endl;
+      assert(0);
+    }
+  }
   fOutputFile->Close();
   
   delete fFillerEvtInfo;
@@ -361,6 +550,19 @@ void NtuplerMod::endJob()
     delete fFillerJet[i0];
   }
   if(fAddParticleFlow) delete fFillerPF;
+  delete fPFIsoGrid;
+  delete fTrkVtxMap;
+  delete fRefIndexMap;
+  delete fTrgMatcher;
+  delete fScheduler;
+  delete fDetCheck;
+  delete fCheckEvtInfo;
+  delete fCheckGenEvtInfo;
+  for(unsigned int i0 = 0; i0 < fCheckArrs.size(); i0++) delete fCheckArrs[i0];
+  delete fWriter;
+  delete fOutputProfile;
+  delete fLumiSummary;
+  baconhep::CalibrationRegistry::clear();
   
   delete fEvtInfo;
   delete fGenEvtInfo;
@@ -375,6 +577,23 @@ void NtuplerMod::endJob()
   delete fPFParArr;
 }
 
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::addArray(const char *name, TClonesArray *&array)
+{
+  if(fColumnarOutput) fWriter->addColumns(name, array);
+  else                fWriter->addBranch (name, array);
+  // the concurrent fillers construct their objects in place, without allocating
+  if(fNThreads > 1) baconhep::TaskScheduler::preallocate(array);
+}
+
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::addCheckedArray(const std::string &name, TClonesArray *&array)
+{
+  fCheckedNames.push_back(name);
+  fCheckedArrs .push_back(&array);
+  fCheckArrs   .push_back(new TClonesArray(array->GetClass(), array->GetSize()));
+}
+
 //--------------------------------------------------------------------------------------------------
 void NtuplerMod::setTriggers()
 {
@@ -405,14 +624,9 @@ void NtuplerMod::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
       triggerBits [fTrigger->fRecords[irec].baconTrigBit] = 1;
     }
   }
-  if(fSkipOnHLTFail && triggerBits == 0) return;  
+  if(fSkipOnHLTFail && triggerBits == 0) { fLumiSummary->count(false); return; }
 
 
-  if(fUseGen) {
-    fGenParArr->Clear();
-    fFillerGenInfo->fill(fGenEvtInfo, fGenParArr, iEvent);
-  }
-    
   fPVArr->Clear();
   int nvertices = 0;
   const reco::Vertex *pv = fFillerPV->fill(fPVArr, nvertices, iEvent);
@@ -420,33 +634,152 @@ void NtuplerMod::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup
   
   separatePileUp(iEvent, *pv);
   
-  fFillerEvtInfo->fill(fEvtInfo, iEvent, *pv, (nvertices>0), triggerBits);
-  
   edm::Handle<trigger::TriggerEvent> hTrgEvt;
   iEvent.getByLabel(fHLTObjTag,hTrgEvt);
+  fTrgMatcher->build(*hTrgEvt);
   
-  fEleArr->Clear();
-  fFillerEle->fill(fEleArr, iEvent, iSetup, *pv, nvertices, fPFNoPU, fTrigger->fRecords, *hTrgEvt);
-
-  fMuonArr->Clear();  
-  fFillerMuon->fill(fMuonArr, iEvent, iSetup, *pv, fPFNoPU, fPFPU, fTrigger->fRecords, *hTrgEvt);
+  // reference-key lookups shared by the lepton and photon fillers
+  edm::Handle<reco::PFCandidateCollection> hPFCandProduct;
+  iEvent.getByLabel(fPFCandName,hPFCandProduct);
+  edm::Handle<reco::TrackCollection> hTrackProduct;
+  iEvent.getByLabel(fTrackName,hTrackProduct);
+  edm::Handle<reco::SuperClusterCollection> hEBSCProduct;
+  iEvent.getByLabel(fEBSCName,hEBSCProduct);
+  edm::Handle<reco::SuperClusterCollection> hEESCProduct;
+  iEvent.getByLabel(fEESCName,hEESCProduct);
+  fRefIndexMap->build(hPFCandProduct, hTrackProduct, hEBSCProduct, hEESCProduct);
+  
+  // references are resolved by the fillers, concurrently: read the products they point into first
+  if(fNThreads > 1) prefetchRefTargets(iEvent, iSetup);
+  
+  runFillers(iEvent, iSetup, *pv, nvertices, triggerBits, fNThreads);
+  if(fCheckDeterminism) checkFillers(iEvent, iSetup, *pv, nvertices, triggerBits);
+  
+  // HLT object matching for all output objects in one pass
+  addTriggerQueries<baconhep::TElectron>(*fTrgMatcher, fEleArr);
+  addTriggerQueries<baconhep::TMuon>    (*fTrgMatcher, fMuonArr);
+  addTriggerQueries<baconhep::TPhoton>  (*fTrgMatcher, fPhotonArr);
+  addTriggerQueries<baconhep::TTau>     (*fTrgMatcher, fTauArr);
+  for(int i0 = 0; i0 < fNCones; i0++) {
+    addTriggerQueries<baconhep::TJet>(*fTrgMatcher, fJetArr[i0]);
+  }
+  fTrgMatcher->match();
+  
+  fLumiSummary->count(true);
+  fWriter->fill();
+}
 
-  fPhotonArr->Clear();  
-  fFillerPhoton->fill(fPhotonArr, iEvent, iSetup, *pv, fPFNoPU, fPFPU, fTrigger->fRecords, *hTrgEvt);
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::prefetchRefTargets(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  //
+  // The fillers retrieve their products under the framework lock, but the references of the objects
+  // (tracks of muons and electrons, electron and photon cores, superclusters and their clusters,
+  // conversions, tau and jet constituents, PF blocks, gen mothers and daughters) are resolved
+  // afterwards, concurrently. A reference into a product not read yet reads it from the file.
+  // Read the products they point into here (prefetchProducts), so that resolving a reference only
+  // looks the product up. The accessors return copies of the references, so the pointers they cache are
+  // not shared between the fillers. The conditions used inside the per-object loops (the calorimeter
+  // geometry of the electron regression) are retrieved for the same reason.
+  //
+  boost::mutex::scoped_lock eventLock(baconhep::TaskScheduler::frameworkMutex());
+  for(unsigned int i0 = 0; i0 < fPrefetch.size(); i0++) fPrefetch[i0].first(iEvent, fPrefetch[i0].second);
+  
+  edm::ESHandle<CaloGeometry> hGeometry;
+  iSetup.get<CaloGeometryRecord>().get(hGeometry);
+}
 
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::runFillers(const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, const int nvertices, const TriggerBits &triggerBits,
+                            const int nThreads)
+{
+  //
+  // Each filler writes its own output and reads the event inputs built above
+  // (vertex, pile-up separation, isolation grid, reference lookups), which no filler modifies.
+  // Outputs are cleared here, since ROOT deallocation is not thread-safe.
+  //
+  fScheduler->clear();
+  
+  if(fUseGen) {
+    fGenParArr->Clear();
+    fScheduler->addTask("GenInfo", boost::bind(&baconhep::FillerGenInfo::fill, fFillerGenInfo, fGenEvtInfo, fGenParArr, boost::cref(iEvent)),
+                        "", "GenEvtInfo,GenParticle");
+  }
+  
+  fScheduler->addTask("EventInfo", boost::bind(&baconhep::FillerEventInfo::fill, fFillerEvtInfo, fEvtInfo, boost::cref(iEvent), boost::cref(pv),
+                                               boost::cref(*fTrkVtxMap), (nvertices>0), triggerBits),
+                      "PV,TrackVertexMap", "Info");
+  
+  fEleArr->Clear();
+  fScheduler->addTask("Electron", boost::bind(&baconhep::FillerElectron::fill, fFillerEle, fEleArr, boost::cref(iEvent), boost::cref(iSetup),
+                                              boost::cref(pv), nvertices, boost::cref(*fPFIsoGrid), boost::cref(*fRefIndexMap)),
+                      "PV,PFIsoGrid,RefIndexMap", "Electron");
+  
+  fMuonArr->Clear();
+  fScheduler->addTask("Muon", boost::bind(&baconhep::FillerMuon::fill, fFillerMuon, fMuonArr, boost::cref(iEvent), boost::cref(iSetup),
+                                          boost::cref(pv), boost::cref(*fPFIsoGrid), boost::cref(*fRefIndexMap)),
+                      "PV,PFIsoGrid,RefIndexMap", "Muon");
+  
+  fPhotonArr->Clear();
+  fScheduler->addTask("Photon", boost::bind(&baconhep::FillerPhoton::fill, fFillerPhoton, fPhotonArr, boost::cref(iEvent), boost::cref(iSetup),
+                                            boost::cref(pv), boost::cref(*fPFIsoGrid), boost::cref(*fRefIndexMap)),
+                      "PV,PFIsoGrid,RefIndexMap", "Photon");
+  
   fTauArr->Clear();
-  fFillerTau->fill(fTauArr, iEvent, iSetup, *pv, fTrigger->fRecords, *hTrgEvt);
+  fScheduler->addTask("Tau", boost::bind(&baconhep::FillerTau::fill, fFillerTau, fTauArr, boost::cref(iEvent), boost::cref(iSetup), boost::cref(pv)),
+                      "PV", "Tau");
   
-  for(int i0 = 0; i0 < fNCones; i0++) { 
+  // each cone has its own filler, corrector/MVA instances and output arrays
+  for(int i0 = 0; i0 < fNCones; i0++) {
     fJetArr   [i0]->Clear();
     fAddJetArr[i0]->Clear();
-    fFillerJet[i0]->fill(fJetArr[i0],fAddJetArr[i0], iEvent, iSetup, *pv, fTrigger->fRecords, *hTrgEvt);
+    std::stringstream name;
+    name << "Jet0" << i0;
+    fScheduler->addTask(name.str(), boost::bind(&baconhep::FillerJet::fill, fFillerJet[i0], fJetArr[i0], fAddJetArr[i0], boost::cref(iEvent), boost::cref(iSetup),
+                                                boost::cref(pv), boost::cref(*fTrkVtxMap)),
+                        "PV,TrackVertexMap", name.str());
   }
-  if(fAddParticleFlow) { 
+  
+  if(fAddParticleFlow) {
     fPFParArr->Clear();
-    fFillerPF->fill(fPFParArr,fPVArr,iEvent);
+    fScheduler->addTask("PFPart", boost::bind(&baconhep::FillerPF::fill, fFillerPF, fPFParArr, fPVArr, boost::cref(iEvent), boost::cref(*fTrkVtxMap)),
+                        "PV,TrackVertexMap", "PFPart");
+  }
+  
+  fScheduler->run(nThreads);
+}
+
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::checkFillers(const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, const int nvertices, const TriggerBits &triggerBits)
+{
+  //
+  // The outputs were filled by the scheduled fillers. Fill them again in sequence into the shadow
+  // objects, swapped in place of the outputs, and compare them bit for bit with the scheduled filling.
+  // The event info members a filler leaves alone keep the values of the output.
+  //
+  *fCheckEvtInfo    = *fEvtInfo;
+  *fCheckGenEvtInfo = *fGenEvtInfo;
+  swapCheckedOutputs();
+  runFillers(iEvent, iSetup, pv, nvertices, triggerBits, 1);
+  swapCheckedOutputs();
+  
+  bool lSame = fDetCheck->compare("Info", baconhep::TEventInfo::Class(), fEvtInfo, fCheckEvtInfo);
+  if(fUseGen) lSame = fDetCheck->compare("GenEvtInfo", baconhep::TGenEventInfo::Class(), fGenEvtInfo, fCheckGenEvtInfo) && lSame;
+  for(unsigned int i0 = 0; i0 < fCheckedArrs.size(); i0++) {
+    lSame = fDetCheck->compare(fCheckedNames[i0], **fCheckedArrs[i0], *fCheckArrs[i0]) && lSame;
+  }
+  if(!lSame) {
+    std::cout << "[NtuplerMod] scheduled and sequential filling differ in run " << iEvent.id().run() << " event " << iEvent.id().event() << "!" << std::endl;
+    assert(0);
   }
-  fEventTree->Fill();
+}
+
+//--------------------------------------------------------------------------------------------------
+void NtuplerMod::swapCheckedOutputs()
+{
+  std::swap(fEvtInfo,    fCheckEvtInfo);
+  std::swap(fGenEvtInfo, fCheckGenEvtInfo);
+  for(unsigned int i0 = 0; i0 < fCheckedArrs.size(); i0++) std::swap(*fCheckedArrs[i0], fCheckArrs[i0]);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -474,6 +807,8 @@ void NtuplerMod::initHLT(const edm::TriggerResults& result, const edm::TriggerNa
       fTrigger->fRecords[irec].hltPathIndex = index;
     }
   }
+  
+  fTrgMatcher->setFilters(fTrigger->fRecords);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -496,43 +831,38 @@ void NtuplerMod::separatePileUp(const edm::Event &iEvent, const reco::Vertex &pv
   fPFNoPU.clear();
   fPFPU.clear();
   
-  for(reco::PFCandidateCollection::const_iterator iP = pfCandCol->begin(); iP!=pfCandCol->end(); ++iP) {
+  // associate tracks to vertices once for the whole event
+  fTrkVtxMap->build(pfCandCol, pvCol, pv);
+  
+  for(unsigned int ipf=0; ipf<pfCandCol->size(); ipf++) {
+    const reco::PFCandidate *iP = &(*pfCandCol)[ipf];
+    const baconhep::TrackVertexMap::PFAssoc &assoc = fTrkVtxMap->pfAssoc(ipf);
     if(iP->particleId() == reco::PFCandidate::h) {  // charged hadrons
-      if(iP->trackRef().isNonnull() && pv.trackWeight(iP->trackRef())>0) {
+      if(assoc.pvWeight>0) {
         // charged hadrons with track used to compute PV
-	fPFNoPU.push_back(&(*iP)); 
+	fPFNoPU.push_back(iP); 
       
       } else {
         // Find closest vertex to charged hadron's vertex source
-	bool vertexFound = false;
+	bool vertexFound = (assoc.vtxIndex >= 0);
 	const reco::Vertex *closestVtx = 0;
-	double dzmin = 10000;
-	
-	for(reco::VertexCollection::const_iterator iV = pvCol->begin(); iV!=pvCol->end(); ++iV) {
-	  if(iP->trackRef().isNonnull() && iV->trackWeight(iP->trackRef())>0) {
-	    vertexFound = true;
-	    closestVtx  = &(*iV);
-	    break;
-	  }
-	  
-	  double dz = fabs(iP->vertex().z() - iV->z());
-	  if(dz < dzmin) {
-	    closestVtx = &(*iV);
-	    dzmin      = dz;
-	  }
-	}
+	if(vertexFound)                closestVtx = &(*pvCol)[assoc.vtxIndex];
+	else if(assoc.closestIndex>=0) closestVtx = &(*pvCol)[assoc.closestIndex];
 	
 	if(vertexFound || closestVtx != &pv) {
-	  fPFPU.push_back(&(*iP));
+	  fPFPU.push_back(iP);
 	} else {
-	  fPFNoPU.push_back(&(*iP));  // Note: when no associated vertex found, assume to come from PV
+	  fPFNoPU.push_back(iP);  // Note: when no associated vertex found, assume to come from PV
 	}
       }
       
     } else {  // all non-charged-hadron PFCandidates are considered to be from PV
-      fPFNoPU.push_back(&(*iP));
+      fPFNoPU.push_back(iP);
     }
   }
+  
+  // index the partition in eta-phi for the isolation cone queries
+  fPFIsoGrid->build(fPFNoPU, fPFPU);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -545,7 +875,10 @@ void NtuplerMod::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
 }
 void NtuplerMod::beginRun(const edm::Run& iRun, const edm::EventSetup& iSetup){}
 void NtuplerMod::endRun  (const edm::Run& iRun, const edm::EventSetup& iSetup){}
-void NtuplerMod::beginLuminosityBlock(const edm::LuminosityBlock& iLumi, const edm::EventSetup& iSetup){}
+void NtuplerMod::beginLuminosityBlock(const edm::LuminosityBlock& iLumi, const edm::EventSetup& iSetup)
+{
+  fLumiSummary->beginBlock(iLumi.run(), iLumi.luminosityBlock());
+}
 void NtuplerMod::endLuminosityBlock  (const edm::LuminosityBlock& iLumi, const edm::EventSetup& iSetup){}
 
 
@@ -4,7 +4,9 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"// Parameters
 #include "FWCore/ParameterSet/interface/ParameterSet.h"// Parameters
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
 #include <string>                                      // string class
+#include <vector>
 
 // forward class declarations
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
@@ -30,6 +32,15 @@ namespace baconhep {
   class FillerTau;
   class FillerJet;
   class FillerPF;
+  class PFIsoGrid;
+  class TrackVertexMap;
+  class RefIndexMap;
+  class TriggerObjectMatcher;
+  class TaskScheduler;
+  class AsyncTreeWriter;
+  class OutputProfile;
+  class LumiSummary;
+  class DeterminismCheck;
 }
 
 //
@@ -58,6 +69,22 @@ class NtuplerMod : public edm::EDAnalyzer {
     
     //
     void separatePileUp(const edm::Event &iEvent, const reco::Vertex &pv);
+    
+    // read the products the references of the output objects point into, before concurrent fillers
+    void prefetchRefTargets(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+    
+    // fill the output objects from the per-event inputs, concurrently if nThreads>1
+    void runFillers(const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, const int nvertices, const TriggerBits &triggerBits,
+                    const int nThreads);
+
+    // refill the outputs in sequence and compare them with the scheduled filling (checkDeterminism)
+    void checkFillers(const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, const int nvertices, const TriggerBits &triggerBits);
+    void swapCheckedOutputs();
+
+    // add an output array to the event tree in the configured output format
+    void addArray(const char *name, TClonesArray *&array);
+    // add an output array of the scheduled fillers to the checkDeterminism comparison
+    void addCheckedArray(const std::string &name, TClonesArray *&array);
 
 
     //--------------------------------------------------------------------------------------------------
@@ -73,9 +100,13 @@ class NtuplerMod : public edm::EDAnalyzer {
     edm::InputTag	fHLTTag;
     edm::InputTag       fHLTObjTag;
     std::string         fHLTFile;
+    baconhep::TriggerObjectMatcher *fTrgMatcher;  // HLT filter objects of the event, resolved once per event
     
     std::vector<const reco::PFCandidate*> fPFNoPU;
     std::vector<const reco::PFCandidate*> fPFPU;
+    baconhep::PFIsoGrid                   *fPFIsoGrid;  // eta-phi index of fPFNoPU/fPFPU for isolation
+    baconhep::TrackVertexMap              *fTrkVtxMap;  // per-event track-vertex association
+    baconhep::RefIndexMap                 *fRefIndexMap;  // PF candidate/track/supercluster lookups by reference key
    
     float fEleMinPt;
     float fMuonMinPt;
@@ -104,6 +135,8 @@ class NtuplerMod : public edm::EDAnalyzer {
     int         fNCones;
     double      fMinCone;
     double      fConeIter;
+    int         fNThreads;
+    bool        fCheckDeterminism;   // compare every event with a sequential filling (slow, for validation)
     std::string fJetName;
     std::string fGenJetName;
     std::string fJetFlavorName;
@@ -125,6 +158,10 @@ class NtuplerMod : public edm::EDAnalyzer {
     std::string fEERecHitName;
     bool        fAddDepthTime;
 
+    // products read by prefetchRefTargets, and how (by the type given in prefetchProducts)
+    typedef void (*PrefetchFunc)(const edm::Event&, const edm::InputTag&);
+    std::vector<std::pair<PrefetchFunc, edm::InputTag> > fPrefetch;
+
     // bacon fillers
     baconhep::FillerEventInfo *fFillerEvtInfo;
     baconhep::FillerGenInfo   *fFillerGenInfo;
@@ -136,6 +173,9 @@ class NtuplerMod : public edm::EDAnalyzer {
     baconhep::FillerJet       **fFillerJet;
     baconhep::FillerPF        *fFillerPF;
     
+    baconhep::TaskScheduler   *fScheduler;  // runs the fillers of an event
+    baconhep::DeterminismCheck *fDetCheck;
+    
     baconhep::TTrigger        *fTrigger;
 //    bool fIsActiveEvtInfo;
 //    bool fIsActiveGenInfo;
@@ -148,9 +188,18 @@ class NtuplerMod : public edm::EDAnalyzer {
     
     // Objects and arrays for output file
     std::string              fOutputName;
+    bool                     fAsyncOutput;           // write the events on a background thread
+    int                      fNCompressionThreads;
+    std::string              fOutputProfileName;
+    bool                     fColumnarOutput;        // arrays written as per-member columns ("columnar" output format)
+    bool                     fOutputReport;          // print the bytes and fill time of each branch at the end of the job
+    bool                     fShowerShapeReport;     // print the shower-shape evaluations of the electrons and photons at the end of the job
     TFile                   *fOutputFile;
     TH1F                    *fTotalEvents;
     TTree                   *fEventTree;
+    baconhep::AsyncTreeWriter *fWriter;              // fills fEventTree from second instances of the output objects
+    baconhep::OutputProfile   *fOutputProfile;       // compression and basket layout of fEventTree
+    baconhep::LumiSummary     *fLumiSummary;         // entry range and event counts of each lumi section
     baconhep::TEventInfo    *fEvtInfo;
     baconhep::TGenEventInfo *fGenEvtInfo;
     TClonesArray            *fGenParArr;
@@ -162,4 +211,11 @@ class NtuplerMod : public edm::EDAnalyzer {
     TClonesArray	    *fPVArr;
     TClonesArray	    **fAddJetArr;
     TClonesArray	    *fPFParArr;
+    
+    // sequential filling of the outputs for checkDeterminism
+    baconhep::TEventInfo       *fCheckEvtInfo;
+    baconhep::TGenEventInfo    *fCheckGenEvtInfo;
+    std::vector<std::string>    fCheckedNames;
+    std::vector<TClonesArray**> fCheckedArrs;   // the output arrays
+    std::vector<TClonesArray*>  fCheckArrs;     // and their shadows
 };
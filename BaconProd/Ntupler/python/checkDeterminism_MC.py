@@ -0,0 +1,24 @@
+#
+# Write the ntuple of makingBacon_MC.py several times from the same events, with every filler
+# enabled: once with the fillers run in sequence (Serial.root) and once each on a pool of 3 and
+# of 8 threads (Threaded3.root, Threaded8.root). The files must hold byte-identical events:
+#
+#   cmsRun checkDeterminism_MC.py && compareNtuples Serial.root Threaded3.root && compareNtuples Serial.root Threaded8.root
+#
+import FWCore.ParameterSet.Config as cms
+from BaconProd.Ntupler.makingBacon_MC import process
+
+process.maxEvents.input = cms.untracked.int32(500)
+
+# every filler, and several cones with the full jet information, so that the concurrent cones are the slow ones
+process.ntupler.addParticleFlow    = cms.untracked.bool(True)
+process.ntupler.NumCones           = cms.untracked.int32(3)
+process.ntupler.computeFullJetInfo = cms.untracked.bool(True)
+
+process.ntuplerSerial    = process.ntupler.clone(outputName = cms.untracked.string('Serial.root'),
+                                                 NumThreads = cms.untracked.int32(1))
+process.ntuplerThreaded3 = process.ntupler.clone(outputName = cms.untracked.string('Threaded3.root'),
+                                                 NumThreads = cms.untracked.int32(3))
+process.ntuplerThreaded8 = process.ntupler.clone(outputName = cms.untracked.string('Threaded8.root'),
+                                                 NumThreads = cms.untracked.int32(8))
+process.baconSequence.replace(process.ntupler, process.ntuplerSerial*process.ntuplerThreaded3*process.ntuplerThreaded8)
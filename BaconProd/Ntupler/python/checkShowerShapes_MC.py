@@ -0,0 +1,15 @@
+#
+# Run makingBacon_MC.py with the shower-shape report: at the end of the job the ntupler prints, for
+# the electrons and the photons, how many shower-shape records were made, how many quantities were
+# requested from them and how many were evaluated by EcalClusterLazyTools. The job stops with an
+# error if a quantity of the seed was evaluated more than once for the same object:
+#
+#   cmsRun checkShowerShapes_MC.py
+#
+import FWCore.ParameterSet.Config as cms
+from BaconProd.Ntupler.makingBacon_MC import process
+
+process.maxEvents.input = cms.untracked.int32(500)
+
+process.ntupler.outputName        = cms.untracked.string('ShowerShapes.root')
+process.ntupler.showerShapeReport = cms.untracked.bool(True)
@@ -52,6 +52,12 @@ cmssw_base = os.environ['CMSSW_BASE']
 process.ntupler = cms.EDAnalyzer('NtuplerMod',
   skipOnHLTFail = cms.untracked.bool(False),
   outputName    = cms.untracked.string('ntuple.root'),
+  asyncOutput   = cms.untracked.bool(False),
+  numCompressionThreads = cms.untracked.int32(0),
+  outputFormat  = cms.untracked.string('classic'),
+  outputProfile = cms.untracked.string('default'),
+  outputReport  = cms.untracked.bool(False),
+  showerShapeReport = cms.untracked.bool(False),
   TriggerFile   = cms.untracked.string(cmssw_base+"/src/BaconAna/DataFormats/data/HLTFile_v0"),                                  
   addParticleFlow  = cms.untracked.bool(True),  
   useGen           = cms.untracked.bool(True),
@@ -73,6 +79,8 @@ process.ntupler = cms.EDAnalyzer('NtuplerMod',
   NumCones                   = cms.untracked.int32(6),                               
   MinCone                    = cms.untracked.double(0.4),                               
   ConeIter                   = cms.untracked.double(0.1),                               
+  NumThreads                 = cms.untracked.int32(1),
+  checkDeterminism           = cms.untracked.bool(False),
   jetName                    = cms.untracked.string('PFJets'),
   genJetName                 = cms.untracked.string('GenJets'),
   jetFlavorName              = cms.untracked.string('byValAlgo'),
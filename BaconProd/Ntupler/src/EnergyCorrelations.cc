@@ -0,0 +1,86 @@
+#include "BaconProd/Ntupler/interface/EnergyCorrelations.hh"
+#include <cmath>
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+EnergyCorrelations::EnergyCorrelations(const std::vector<double> &betas, const unsigned int maxParticles):
+  fBetas       (betas),
+  fMaxParticles(maxParticles),
+  fECF         (3*betas.size(), 0),
+  fN           (0),
+  fStride      (0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+EnergyCorrelations::~EnergyCorrelations(){}
+
+//--------------------------------------------------------------------------------------------------
+void EnergyCorrelations::compute(const fastjet::PseudoJet &jet)
+{
+  assert(jet.has_constituents());
+
+  std::vector<fastjet::PseudoJet> particles = jet.constituents();
+  if(fMaxParticles>0 && particles.size()>fMaxParticles) {
+    particles = fastjet::sorted_by_pt(particles);
+    particles.resize(fMaxParticles);
+  }
+
+  //
+  // Energies and pairwise angles, shared by all betas
+  //==============================
+  fN      = particles.size();
+  fStride = (fN + 7) & ~7u;  // keep rows 32-byte multiples for the vectorized sums
+  fPt.assign(fStride, 0);
+  fLogDR2.assign(fN*fStride, 0);
+  fAngle.assign(fN*fStride, 0);
+
+  double ecf1 = 0;
+  for(unsigned int i=0; i<fN; i++) {
+    fPt[i] = particles[i].perp();
+    ecf1  += particles[i].perp();
+    for(unsigned int j=i+1; j<fN; j++) {
+      const float logDR2 = log(particles[i].squared_distance(particles[j]));
+      fLogDR2[i*fStride + j] = logDR2;
+      fLogDR2[j*fStride + i] = logDR2;
+    }
+  }
+
+  //
+  // ECF sums for each beta
+  //==============================
+  for(unsigned int ib=0; ib<fBetas.size(); ib++) {
+    const float halfBeta = 0.5*fBetas[ib];
+
+    // dR^beta = exp(beta/2 * log(dR^2)); the diagonal and padding stay 0
+    for(unsigned int i=0; i<fN; i++) {
+      float       *angle  = &fAngle[i*fStride];
+      const float *logDR2 = &fLogDR2[i*fStride];
+      for(unsigned int j=0; j<fN; j++) {
+        if(j==i) continue;
+        angle[j] = (halfBeta==0) ? 1 : exp(halfBeta*logDR2[j]);
+      }
+    }
+
+    double ecf2 = 0, ecf3 = 0;
+    for(unsigned int i=0; i<fN; i++) {
+      const float *angleI = &fAngle[i*fStride];
+      for(unsigned int j=i+1; j<fN; j++) {
+        const float *angleJ = &fAngle[j*fStride];
+        const double ansIJ  = double(fPt[i])*fPt[j]*angleI[j];
+        ecf2 += ansIJ;
+
+        float sumK = 0;
+        for(unsigned int k=j+1; k<fN; k++) {
+          sumK += fPt[k]*angleI[k]*angleJ[k];
+        }
+        ecf3 += ansIJ*sumK;
+      }
+    }
+
+    fECF[3*ib]   = ecf1;
+    fECF[3*ib+1] = ecf2;
+    fECF[3*ib+2] = ecf3;
+  }
+}
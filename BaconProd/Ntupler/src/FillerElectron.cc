@@ -1,7 +1,7 @@
 #include "BaconProd/Ntupler/interface/FillerElectron.hh"
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconAna/DataFormats/interface/TElectron.hh"
 #include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Common/interface/Handle.h"
@@ -13,7 +13,6 @@
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/TrackReco/interface/TrackFwd.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
-#include "DataFormats/HLTReco/interface/TriggerEvent.h"
 #include "DataFormats/Math/interface/deltaR.h"
 #include "TrackingTools/TransientTrack/interface/TransientTrackBuilder.h"
 #include "TrackingTools/Records/interface/TransientTrackRecord.h"
@@ -24,6 +23,7 @@
 #include <TLorentzVector.h>
 #include <TMath.h>
 #include <utility>
+#include <algorithm>
 
 using namespace baconhep;
 
@@ -32,11 +32,8 @@ FillerElectron::FillerElectron():
   fMinPt       (7),
   fEleName     ("gsfElectrons"),
   fPFCandName  ("particleFlow"),
-  fTrackName   ("generalTracks"),
   fConvName    ("allConversions"),
   fRhoName     ("kt6PFJets"),
-  fEBSCName    ("correctedHybridSuperClusters"),
-  fEESCName    ("correctedMulti5x5SuperClustersWithPreshower"),
   fEBRecHitName("reducedEcalRecHitsEB"),
   fEERecHitName("reducedEcalRecHitsEE")
 {}
@@ -48,14 +45,15 @@ FillerElectron::~FillerElectron(){}
 void FillerElectron::fill(TClonesArray *array,	    
 	                  const edm::Event &iEvent, const edm::EventSetup &iSetup,      
 	                  const reco::Vertex &pv, const int nvtx,
-			  const std::vector<const reco::PFCandidate*> &pfNoPU,
-			  const std::vector<TriggerRecord> &triggerRecords,
-			  const trigger::TriggerEvent &triggerEvent)
+			  const PFIsoGrid &pfIsoGrid, const RefIndexMap &refIndexMap)
 {
   assert(array);
   assert(fEleCorr.isInitialized());
   assert(fEleIDMVA.isInitialized());
   
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get electron collection
   edm::Handle<reco::GsfElectronCollection> hEleProduct;
   iEvent.getByLabel(fEleName,hEleProduct);
@@ -67,12 +65,7 @@ void FillerElectron::fill(TClonesArray *array,
   iEvent.getByLabel(fPFCandName,hPFCandProduct);
   assert(hPFCandProduct.isValid());
   const reco::PFCandidateCollection *pfCandCol = hPFCandProduct.product();
-  
-  // Get track collection
-  edm::Handle<reco::TrackCollection> hTrackProduct;
-  iEvent.getByLabel(fTrackName,hTrackProduct);
-  assert(hTrackProduct.isValid());
-  const reco::TrackCollection *trackCol = hTrackProduct.product();
+  assert(refIndexMap.pfCandidates() == pfCandCol);
   
   // Get conversions collection
   edm::Handle<reco::ConversionCollection> hConvProduct;
@@ -84,17 +77,6 @@ void FillerElectron::fill(TClonesArray *array,
   edm::InputTag rhoTag(fRhoName,"rho","RECO");
   iEvent.getByLabel(rhoTag,hRho);
   
-  // Get SuperCluster collections
-  edm::Handle<reco::SuperClusterCollection> hEBSCProduct;
-  iEvent.getByLabel(fEBSCName,hEBSCProduct);
-  assert(hEBSCProduct.isValid());
-  const reco::SuperClusterCollection *ebSCCol = hEBSCProduct.product();
-  
-  edm::Handle<reco::SuperClusterCollection> hEESCProduct;
-  iEvent.getByLabel(fEESCName,hEESCProduct);
-  assert(hEESCProduct.isValid());
-  const reco::SuperClusterCollection *eeSCCol = hEESCProduct.product();
-  
     
   const double ELE_MASS = 0.000511;
 
@@ -106,20 +88,22 @@ void FillerElectron::fill(TClonesArray *array,
   edm::InputTag ebRecHitTag(fEBRecHitName);
   edm::InputTag eeRecHitTag(fEERecHitName);
   EcalClusterLazyTools lazyTools(iEvent, iSetup, ebRecHitTag, eeRecHitTag);
+  eventLock.unlock();
   
   for(reco::GsfElectronCollection::const_iterator itEle = eleCol->begin(); itEle!=eleCol->end(); ++itEle) {
     
     const reco::GsfTrackRef gsfTrack = itEle->gsfTrack();
     const reco::SuperClusterRef sc   = itEle->superCluster();
+    const ShowerShapes shapes(lazyTools, *sc, &fShapesCount);  // shared by the corrections, the ID MVA and the filler
     
     // electron pT cut
-    std::pair<double,double> result = fEleCorr.evaluate(&(*itEle), *hRho, nvtx, iEvent.id().run(), iSetup, lazyTools, false);
+    std::pair<double,double> result = fEleCorr.evaluate(&(*itEle), *hRho, nvtx, iEvent.id().run(), iSetup, shapes, false);
     TLorentzVector elevec;
     elevec.SetPtEtaPhiM(itEle->pt(), itEle->eta(), itEle->phi(), ELE_MASS);
     double ptCorr = result.first*TMath::Sin(elevec.Theta());
     if(itEle->pt() < fMinPt && ptCorr < fMinPt) continue;
     
-    // construct object and place in array    
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     TClonesArray &rElectronArr = *array;
     assert(rElectronArr.GetEntries() < rElectronArr.GetSize());
     const int index = rElectronArr.GetEntries();  
@@ -140,19 +124,18 @@ void FillerElectron::fill(TClonesArray *array,
     pElectron->scEta      = sc->eta();
     pElectron->scPhi      = sc->phi();
     pElectron->scEtHZZ4l  = (sc->energy())*(sc->position().Rho())/(sc->position().R())*(pElectron->ptHZZ4l)/(pElectron->pt);
-    pElectron->r9         = lazyTools.e3x3(*(sc->seed())) / sc->rawEnergy();
+    pElectron->r9         = shapes.r9();
     
     pElectron->pfPt  = 0;
     pElectron->pfEta = 0;
     pElectron->pfPhi = 0;
-    for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
-      if( (itEle->track().isNonnull() && itPF->trackRef().isNonnull() && itEle->track() == itPF->trackRef()) ||
-          (itPF->gsfTrackRef().isNonnull() && itPF->gsfTrackRef() == gsfTrack) ) {
-        
-	pElectron->pfPt  = itPF->pt();
-	pElectron->pfEta = itPF->eta();
-	pElectron->pfPhi = itPF->phi();
-      }
+    // last PF candidate sharing the track or the GSF track
+    const int pfIndex = std::max(refIndexMap.pfCandIndex(itEle->track()), refIndexMap.pfCandIndex(gsfTrack));
+    if(pfIndex >= 0) {
+      const reco::PFCandidate &pfcand = (*pfCandCol)[pfIndex];
+      pElectron->pfPt  = pfcand.pt();
+      pElectron->pfEta = pfcand.eta();
+      pElectron->pfPhi = pfcand.phi();
     }
     
     //
@@ -162,15 +145,13 @@ void FillerElectron::fill(TClonesArray *array,
     pElectron->ecalIso03 = itEle->dr03EcalRecHitSumEt();
     pElectron->hcalIso03 = itEle->dr03HcalTowerSumEt();
     
-    computeIso(*itEle, 0.3, pfNoPU,
+    computeIso(*itEle, pfIsoGrid,
                pElectron->chHadIso03,
                pElectron->gammaIso03,
-               pElectron->neuHadIso03);   
-    
-    computeIso(*itEle, 0.4, pfNoPU,
+               pElectron->neuHadIso03,
                pElectron->chHadIso04,
                pElectron->gammaIso04,
-               pElectron->neuHadIso04);   
+               pElectron->neuHadIso04);
     
     //
     // Impact Parameter
@@ -193,7 +174,7 @@ void FillerElectron::fill(TClonesArray *array,
     pElectron->dEtaIn = itEle->deltaEtaSuperClusterTrackAtVtx();
     pElectron->dPhiIn = itEle->deltaPhiSuperClusterTrackAtVtx();
     
-    pElectron->mva = evalEleIDMVA(*itEle, lazyTools);
+    pElectron->mva = evalEleIDMVA(*itEle, shapes);
     
     pElectron->classification = itEle->classification();
     
@@ -217,53 +198,31 @@ void FillerElectron::fill(TClonesArray *array,
     if(itEle->isEEDeeGap())  pElectron->fiducialBits |= kIsEEDeeGap;
     if(itEle->isEERingGap()) pElectron->fiducialBits |= kIsEERingGap;
     
-    pElectron->scID = -1;
-    int scIndex = -1;
-    for(reco::SuperClusterCollection::const_iterator iS = ebSCCol->begin(); iS!=ebSCCol->end(); ++iS) {
-      scIndex++;
-      if(itEle->superCluster().get() == &(*iS)) {
-        pElectron->scID = scIndex;
-	break;
-      }
-    }
-    for(reco::SuperClusterCollection::const_iterator iS = eeSCCol->begin(); iS!=eeSCCol->end(); ++iS) {
-      scIndex++;
-      if(itEle->superCluster().get() == &(*iS)) {
-        pElectron->scID = scIndex;
-	break;
-      }
-    }
-    
-    pElectron->trkID = -1;
-    if(itEle->closestTrack().isNonnull()) {
-      int trkIndex = -1;    
-      for(reco::TrackCollection::const_iterator itTrk = trackCol->begin(); itTrk!=trackCol->end(); ++itTrk) {
-        trkIndex++;
-        if(itEle->closestTrack().get() == &(*itTrk)) {
-          pElectron->trkID = trkIndex;
-	  break;
-        }
-      }
-    }
-    
-    pElectron->hltMatchBits = TriggerTools::matchHLT(pElectron->eta, pElectron->phi, triggerRecords, triggerEvent);
+    pElectron->scID  = refIndexMap.scIndex(itEle->superCluster());
+    pElectron->trkID = refIndexMap.trackIndex(itEle->closestTrack());
   }
 }
 
 //--------------------------------------------------------------------------------------------------
-void FillerElectron::computeIso(const reco::GsfElectron &ele, const double extRadius,
-                                const std::vector<const reco::PFCandidate*> &pfNoPU,
-                                float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso) const
+void FillerElectron::computeIso(const reco::GsfElectron &ele, const PFIsoGrid &pfIsoGrid,
+                                float &out_chHadIso03, float &out_gammaIso03, float &out_neuHadIso03,
+                                float &out_chHadIso04, float &out_gammaIso04, float &out_neuHadIso04) const
 {
-  double chHadIso=0, gammaIso=0, neuHadIso=0;
+  double chHadIso03=0, gammaIso03=0, neuHadIso03=0;
+  double chHadIso04=0, gammaIso04=0, neuHadIso04=0;
   
+  const double extRadius03     = 0.3;
+  const double extRadius04     = 0.4;
   const double intRadiusChHad  = 0.015;
   const double intRadiusGamma  = 0.08;
   const double intRadiusNeuHad = 0.;
   double intRadius = 0;
   
-  for(unsigned int ipf=0; ipf<pfNoPU.size(); ipf++) {
-    const reco::PFCandidate *pfcand = pfNoPU.at(ipf);
+  std::vector<PFIsoGrid::Neighbour> pfCands;
+  pfIsoGrid.neighboursNoPU(ele.eta(), ele.phi(), extRadius04, pfCands);
+  
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;
     
     if(pfcand->particleId() == reco::PFCandidate::gamma &&
        pfcand->mva_nothing_gamma()>0.99 && 
@@ -275,27 +234,38 @@ void FillerElectron::computeIso(const reco::GsfElectron &ele, const double extRa
     else if(pfcand->particleId() == reco::PFCandidate::gamma) { intRadius = ele.isEB() ? 0 : intRadiusGamma;  }
     else if(pfcand->particleId() == reco::PFCandidate::h0)    { intRadius = ele.isEB() ? 0 : intRadiusNeuHad; }
     
-    double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), ele.eta(), ele.phi());
-    if(dr>=extRadius || dr<intRadius) continue;
+    const double dr = pfCands[ipf].dr;
+    if(dr>=extRadius04 || dr<intRadius) continue;
+    const bool in03 = (dr<extRadius03);
 
-    if     (pfcand->particleId() == reco::PFCandidate::h)     { chHadIso  += pfcand->pt(); }
-    else if(pfcand->particleId() == reco::PFCandidate::gamma) { gammaIso  += pfcand->pt(); }
-    else if(pfcand->particleId() == reco::PFCandidate::h0)    { neuHadIso += pfcand->pt(); }
+    if(pfcand->particleId() == reco::PFCandidate::h) {
+      chHadIso04 += pfcand->pt();
+      if(in03) chHadIso03 += pfcand->pt();
+    } else if(pfcand->particleId() == reco::PFCandidate::gamma) {
+      gammaIso04 += pfcand->pt();
+      if(in03) gammaIso03 += pfcand->pt();
+    } else if(pfcand->particleId() == reco::PFCandidate::h0) {
+      neuHadIso04 += pfcand->pt();
+      if(in03) neuHadIso03 += pfcand->pt();
+    }
   }
   
-  out_chHadIso  = chHadIso;
-  out_gammaIso  = gammaIso;
-  out_neuHadIso = neuHadIso;
+  out_chHadIso03  = chHadIso03;
+  out_gammaIso03  = gammaIso03;
+  out_neuHadIso03 = neuHadIso03;
+  out_chHadIso04  = chHadIso04;
+  out_gammaIso04  = gammaIso04;
+  out_neuHadIso04 = neuHadIso04;
 }
 
 //--------------------------------------------------------------------------------------------------
-double FillerElectron::evalEleIDMVA(const reco::GsfElectron &ele, EcalClusterLazyTools& lazyTools)
+double FillerElectron::evalEleIDMVA(const reco::GsfElectron &ele, const ShowerShapes &shapes)
 {
   assert(fEleIDMVA.isInitialized());
   
   const reco::TrackRef kfTrackRef   = ele.closestCtfTrackRef();
   const reco::SuperClusterRef scRef = ele.superCluster();
-  std::vector<float> vCov = lazyTools.localCovariances(*(scRef->seed()));
+  const std::vector<float> &vCov = shapes.localCovariances();
   
   double _fbrem          = (ele.fbrem() < -1.) ? -1. : ele.fbrem();
   double _kftrk_chisq    = kfTrackRef.isNonnull() ? TMath::Min(kfTrackRef->normalizedChi2(),10.) : 0;
@@ -310,7 +280,7 @@ double FillerElectron::evalEleIDMVA(const reco::GsfElectron &ele, EcalClusterLaz
   double _etawidth       = scRef->etaWidth(); 
   double _phiwidth       = scRef->phiWidth();
   double _e1x5e5x5       = (ele.e5x5() != 0) ? 1 - ele.e1x5()/ele.e5x5() : -1;
-  double _r9             = TMath::Min(lazyTools.e3x3(*(scRef->seed()))/scRef->rawEnergy(), 5.);
+  double _r9             = TMath::Min(shapes.r9(), 5.);
   double _h_o_e          = ele.hcalOverEcal();
   double _e_o_p          = (ele.eSuperClusterOverP()  > 20.) ? 20. : ele.eSuperClusterOverP();
   double _eeleclu_o_pout = (ele.eEleClusterOverPout() > 20.) ? 20. : ele.eEleClusterOverPout();
@@ -1,5 +1,6 @@
 #include "BaconProd/Ntupler/interface/FillerEventInfo.hh"
 #include "BaconAna/DataFormats/interface/TEventInfo.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Common/interface/Handle.h"
@@ -32,11 +33,14 @@ FillerEventInfo::~FillerEventInfo(){}
 
 //--------------------------------------------------------------------------------------------------
 void FillerEventInfo::fill(TEventInfo *evtInfo,
-                           const edm::Event &iEvent, const reco::Vertex &pv, const bool hasGoodPV,
+                           const edm::Event &iEvent, const reco::Vertex &pv, const TrackVertexMap &trkVtxMap, const bool hasGoodPV,
 			   const TriggerBits triggerBits)
 {
   assert(evtInfo);
   
+  // the event products are retrieved throughout, so the whole fill is serialized with the other fillers
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   evtInfo->runNum  = iEvent.id().run();
   evtInfo->lumiSec = iEvent.luminosityBlock();
   evtInfo->evtNum  = iEvent.id().event();
@@ -214,7 +218,7 @@ void FillerEventInfo::fill(TEventInfo *evtInfo,
     iEvent.getByLabel(fPFCandName,hPFCandProduct);
     assert(hPFCandProduct.isValid());
     const reco::PFCandidateCollection *pfCandCol = hPFCandProduct.product();
-    computeTrackMET(pv, pfCandCol, evtInfo->trkMET, evtInfo->trkMETphi);
+    computeTrackMET(trkVtxMap, pfCandCol, evtInfo->trkMET, evtInfo->trkMETphi);
     
   }
   //
@@ -244,19 +248,20 @@ void FillerEventInfo::fill(TEventInfo *evtInfo,
 
 
 //--------------------------------------------------------------------------------------------------
-void FillerEventInfo::computeTrackMET(const reco::Vertex &pv, const reco::PFCandidateCollection *pfCandCol,
+void FillerEventInfo::computeTrackMET(const TrackVertexMap &trkVtxMap, const reco::PFCandidateCollection *pfCandCol,
                                       float &out_met, float &out_metphi)
 {  
   out_met    = 0;
   out_metphi = 0;
 
-
+  // candidate associations are indexed by position in the PF collection
+  assert(trkVtxMap.pfCandidates() == pfCandCol);
   
   double metx=0, mety=0;
-  for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
-    if(itPF->trackRef().isNonnull() && pv.trackWeight(itPF->trackRef())>0) {
-      metx  -= itPF->px();
-      mety  -= itPF->py();
+  for(unsigned int ipf=0; ipf<pfCandCol->size(); ipf++) {
+    if(trkVtxMap.pfAssoc(ipf).pvWeight>0) {
+      metx  -= (*pfCandCol)[ipf].px();
+      mety  -= (*pfCandCol)[ipf].py();
     }
   }
   
@@ -1,10 +1,10 @@
 #include "BaconProd/Ntupler/interface/FillerGenInfo.hh"
 #include "BaconAna/DataFormats/interface/TGenEventInfo.hh"
 #include "BaconAna/DataFormats/interface/TGenParticle.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "DataFormats/HepMCCandidate/interface/GenParticleFwd.h"
 #include "DataFormats/HepMCCandidate/interface/GenParticle.h"
-#include "DataFormats/Math/interface/deltaR.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 #include <TClonesArray.h>
 
@@ -26,9 +26,13 @@ void FillerGenInfo::fill(TGenEventInfo *genEvtInfo, TClonesArray *array,
 {
   assert(array);
   
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get generator event information
   edm::Handle<GenEventInfoProduct> hGenEvtInfoProduct;
   iEvent.getByLabel(fGenEvtInfoName,hGenEvtInfoProduct);
+  eventLock.unlock();
   assert(hGenEvtInfoProduct.isValid());
 
   const gen::PdfInfo *pdfInfo = (hGenEvtInfoProduct->hasPDF()) ? hGenEvtInfoProduct->pdf() : 0;
@@ -41,42 +45,81 @@ void FillerGenInfo::fill(TGenEventInfo *genEvtInfo, TClonesArray *array,
   
   // Get generator particles collection
   edm::Handle<reco::GenParticleCollection> hGenParProduct;
+  eventLock.lock();
   iEvent.getByLabel(fGenParName,hGenParProduct);
+  eventLock.unlock();
   assert(hGenParProduct.isValid());  
-  const reco::GenParticleCollection genParticles = *(hGenParProduct.product());  
+  const reco::GenParticleCollection &genParticles = *(hGenParProduct.product());
+  
+  // output index of each GEN particle (by collection key), -1 if not stored
+  std::vector<int> lOutIndex(genParticles.size(), -1);
+  int nOut = 0;
+  for(unsigned int ip=0; ip<genParticles.size(); ip++) {
+    if(select(genParticles[ip])) lOutIndex[ip] = nOut++;
+  }
+  
   // loop over GEN particles
-  std::vector<reco::GenParticle> lMothers;
   TClonesArray &rArray = *array;
-  for (reco::GenParticleCollection::const_iterator itGenP = genParticles.begin(); itGenP!=genParticles.end(); ++itGenP) {
-    if((itGenP->status() == 1     || itGenP->status()      == 99)    &&   //Remove all Status 1 and 99 particles
-       (fabs(itGenP->pdgId()) < 11 || fabs(itGenP->pdgId()) > 17)    &&   //Keep Letpons 
-       !fFillAll) continue; //Require to not fill all particles
-    if(!fFillAll && (itGenP->status() == 2 && itGenP->pdgId() == 21)) continue;
-    if(!fFillAll && (itGenP->status() == 2 && itGenP->pdgId() == 22)) continue;
-    if(!fFillAll && fabs(itGenP->pdgId()) > 50) continue;
-    // construct object and place in array
+  for(unsigned int ip=0; ip<genParticles.size(); ip++) {
+    if(lOutIndex[ip] < 0) continue;
+    const reco::GenParticle &genP = genParticles[ip];
+    
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     assert(rArray.GetEntries() < rArray.GetSize());
     const int index = rArray.GetEntries();
+    assert(index == lOutIndex[ip]);
     new(rArray[index]) baconhep::TGenParticle();
     baconhep::TGenParticle *pGenPart = (baconhep::TGenParticle*)rArray[index];
-    pGenPart->pdgId  = itGenP->pdgId();
-    pGenPart->status = itGenP->status();
-    pGenPart->pt     = itGenP->pt();
-    pGenPart->eta    = itGenP->eta();
-    pGenPart->phi    = itGenP->phi();
-    pGenPart->y      = itGenP->rapidity();
-    pGenPart->mass   = itGenP->mass();
-    if(itGenP->numberOfMothers() >  0 ) {
-      int lId = -2;
-      int pId = 0;
-      reco::GenParticleRef lMom = itGenP->motherRef(); 
-      for( std::vector<reco::GenParticle>::const_iterator itMomP = lMothers.begin(); itMomP != lMothers.end(); ++itMomP) { 
-	if(reco::deltaR(itMomP->eta(),itMomP->phi(),lMom->eta(),lMom->phi()) < 0.01) {lId = pId;  break;}
-	pId++;
-      }
-      pGenPart->parent =  lId;
+    pGenPart->pdgId  = genP.pdgId();
+    pGenPart->status = genP.status();
+    pGenPart->pt     = genP.pt();
+    pGenPart->eta    = genP.eta();
+    pGenPart->phi    = genP.phi();
+    pGenPart->y      = genP.rapidity();
+    pGenPart->mass   = genP.mass();
+    
+    //
+    // Genealogy
+    //==============================
+    pGenPart->parent = -1;
+    if(genP.numberOfMothers() > 0) {
+      const reco::GenParticleRef lMom = genP.motherRef();
+      pGenPart->parent = -2;
+      if(lMom.id() == hGenParProduct.id() && lOutIndex[lMom.key()] >= 0) pGenPart->parent = lOutIndex[lMom.key()];
+    }
+    for(unsigned int id=0; id<genP.numberOfDaughters(); id++) {
+      const reco::GenParticleRef lDau = genP.daughterRef(id);
+      if(lDau.id() != hGenParProduct.id()) continue;
+      const int dauIndex = lOutIndex[lDau.key()];
+      if(dauIndex < 0) continue;
+      if(pGenPart->firstDaughter < 0 || dauIndex < pGenPart->firstDaughter) pGenPart->firstDaughter = dauIndex;
+      if(pGenPart->lastDaughter  < 0 || dauIndex > pGenPart->lastDaughter)  pGenPart->lastDaughter  = dauIndex;
+    }
+  }
+  
+  // the daughter range is only meaningful if every particle in it has this particle as its mother;
+  // otherwise (daughters not stored next to each other) the daughters are found through their parent
+  for(int i=0; i<rArray.GetEntriesFast(); i++) {
+    baconhep::TGenParticle *pGenPart = (baconhep::TGenParticle*)rArray.UncheckedAt(i);
+    if(pGenPart->firstDaughter < 0) continue;
+    bool lContiguous = true;
+    for(int k=pGenPart->firstDaughter; lContiguous && k<=pGenPart->lastDaughter; k++) {
+      lContiguous = (((baconhep::TGenParticle*)rArray.UncheckedAt(k))->parent == i);
     }
-    if(itGenP->numberOfMothers() == 0 ) pGenPart->parent = -1;
-    lMothers.push_back(*itGenP);
+    if(lContiguous) continue;
+    pGenPart->firstDaughter = -2;
+    pGenPart->lastDaughter  = -2;
   }
 }
+
+//--------------------------------------------------------------------------------------------------
+bool FillerGenInfo::select(const reco::GenParticle &genP) const
+{
+  if(fFillAll) return true;
+  if((genP.status() == 1     || genP.status()      == 99)    &&   //Remove all Status 1 and 99 particles
+     (fabs(genP.pdgId()) < 11 || fabs(genP.pdgId()) > 17)) return false;  //Keep Letpons 
+  if(genP.status() == 2 && genP.pdgId() == 21) return false;
+  if(genP.status() == 2 && genP.pdgId() == 22) return false;
+  if(fabs(genP.pdgId()) > 50) return false;
+  return true;
+}
@@ -1,7 +1,8 @@
 #include "BaconProd/Ntupler/interface/FillerJet.hh"
-#include "BaconProd/Ntupler/interface/EnergyCorrelator.hh"
-#include "BaconProd/Utils/interface/TriggerTools.hh"
+#include "BaconProd/Ntupler/interface/EnergyCorrelations.hh"
 #include "BaconProd/Utils/interface/JetTools.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "BaconAna/DataFormats/interface/TJet.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Utilities/interface/InputTag.h"
@@ -18,8 +19,10 @@
 #include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
 #include "CondFormats/JetMETObjects/interface/FactorizedJetCorrector.h"
 #include "CondFormats/JetMETObjects/interface/JetCorrectionUncertainty.h"
+#include "fastjet/internal/BasicRandom.hh"
 #include <TClonesArray.h>
 #include <TLorentzVector.h>
+#include <TMath.h>
 
 using namespace baconhep;
 
@@ -50,11 +53,7 @@ FillerJet::FillerJet():
   //fJetUncertainties   = iJetUnc;
   fCAJetDef           = new fastjet::JetDefinition(fastjet::cambridge_algorithm, fConeSize);
 
-  int activeAreaRepeats = 1;
-  double ghostArea      = 0.01;
-  double ghostEtaMax    = 7.0;
-  fActiveArea           = new fastjet::ActiveAreaSpec (ghostEtaMax,activeAreaRepeats,ghostArea);  
-  fAreaDefinition       = new fastjet::AreaDefinition (fastjet::active_area_explicit_ghosts, *fActiveArea );
+  fGhostArea           = 0.01;
   //Only 2 subjets?
   fPruner1 = new fastjet::Pruner( fastjet::cambridge_algorithm, 0.1, 0.5); //CMS Default
   fPruner2 = new fastjet::Pruner( fastjet::cambridge_algorithm, 0.1, 0.2); //CMS Default
@@ -66,12 +65,16 @@ FillerJet::FillerJet():
   fTrimmer2  = new fastjet::Filter( fastjet::Filter(fastjet::JetDefinition(fastjet::kt_algorithm, 0.2),        fastjet::SelectorPtFractionMin(0.03)));
   fTrimmer3  = new fastjet::Filter( fastjet::Filter(fastjet::JetDefinition(fastjet::kt_algorithm, 0.1),        fastjet::SelectorPtFractionMin(0.03)));
   fTrimmer4  = new fastjet::Filter( fastjet::Filter(fastjet::JetDefinition(fastjet::kt_algorithm, 0.05),        fastjet::SelectorPtFractionMin(0.03)));
+
+  const double lBetas[] = { 0., 0.2, 0.5, 1.0, 2.0 };
+  fECF = new EnergyCorrelations(std::vector<double>(lBetas, lBetas + sizeof(lBetas)/sizeof(double)));
 }
 
 //--------------------------------------------------------------------------------------------------
 FillerJet::~FillerJet()
 {
   delete fJetCorr;
+  delete fECF;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -79,17 +82,17 @@ void FillerJet::initJetCorr(const std::vector<std::string> &jecFiles,
                             const std::vector<std::string> &jecUncFiles,
 			    const std::vector<std::string> &jecFilesForID)
 {
+  // the text files are parsed once per process; each filler builds its own (stateful) correctors
   std::vector<JetCorrectorParameters> corrParams;
   for(unsigned int icorr=0; icorr<jecFiles.size(); icorr++) {
-    corrParams.push_back(JetCorrectorParameters(jecFiles[icorr].c_str()));
+    corrParams.push_back(*CalibrationRegistry::jetCorrectorParameters(jecFiles[icorr]));
   }
   fJetCorr = new FactorizedJetCorrector(corrParams);
-  JetCorrectorParameters param   (jecUncFiles[0]);
-  fJetUnc  = new JetCorrectionUncertainty(param);
+  fJetUnc  = new JetCorrectionUncertainty(*CalibrationRegistry::jetCorrectorParameters(jecUncFiles[0]));
   
   std::vector<JetCorrectorParameters> corrParamsForID;
   for(unsigned int icorr=0; icorr<jecFilesForID.size(); icorr++) {
-    corrParamsForID.push_back(JetCorrectorParameters(jecFilesForID[icorr].c_str()));
+    corrParamsForID.push_back(*CalibrationRegistry::jetCorrectorParameters(jecFilesForID[icorr]));
   }
   fJetCorrForID = new FactorizedJetCorrector(corrParamsForID);
 }
@@ -108,94 +111,95 @@ double FillerJet::correction(fastjet::PseudoJet &iJet,double iRho) {
 void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
                      const edm::Event &iEvent, const edm::EventSetup &iSetup, 
 		     const reco::Vertex	&pv,
-		     const std::vector<TriggerRecord> &triggerRecords,
-		     const trigger::TriggerEvent &triggerEvent) 
+		     const TrackVertexMap &trkVtxMap) 
 {
   assert(array);
   
+  edm::Handle<reco::PFJetCollection>               hJetProduct;
+  edm::Handle<reco::GenJetCollection>              hGenJetProduct;
+  edm::Handle<reco::JetFlavourMatchingCollection>  jetFlavourMatch;
+  edm::Handle<reco::JetFlavourMatchingCollection>  jetFlavourMatchPhys;
+  edm::Handle<reco::BasicJetCollection>            hPruneJetProduct;
+  edm::Handle<reco::PFJetCollection>               hSubJetProduct;
+  edm::Handle<reco::VertexCollection>              hVertexProduct;
+  edm::Handle<double>                              hRho;
+  edm::Handle<reco::JetTagCollection>              hCSVbtags;
+  edm::Handle<reco::JetTagCollection>              hCSVbtagsSubJets;
+  edm::Handle<edm::ValueMap<float> >               hTau1, hTau2, hTau3, hTau4;
+  edm::Handle<edm::ValueMap<float> >               hQGLikelihood;
+  edm::Handle<edm::ValueMap<float> >               hQGLikelihoodSubJets;
+  
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get jet collection
-  edm::Handle<reco::PFJetCollection> hJetProduct;
   iEvent.getByLabel(fJetName,hJetProduct);
   assert(hJetProduct.isValid());
-  const reco::PFJetCollection *jetCol = hJetProduct.product();
 
   // Get gen jet collection
-  edm::Handle<reco::GenJetCollection> hGenJetProduct;
-  const reco::GenJetCollection *genJetCol = 0;
- if(fUseGen) { 
-   iEvent.getByLabel(fGenJetName,hGenJetProduct);
-   assert(hGenJetProduct.isValid());
-   genJetCol = hGenJetProduct.product();
+  if(fUseGen) { 
+    iEvent.getByLabel(fGenJetName,hGenJetProduct);
+    assert(hGenJetProduct.isValid());
   }
 
   // Get Jet Flavor Match
-  edm::Handle<reco::JetFlavourMatchingCollection> jetFlavourMatch;
   if(fUseGen) iEvent.getByLabel(fJetFlavorName, jetFlavourMatch);
-
-  edm::Handle<reco::JetFlavourMatchingCollection> jetFlavourMatchPhys;
   if(fUseGen) iEvent.getByLabel(fJetFlavorPhysName, jetFlavourMatchPhys);
 
   // Get pruned jet collection
-  edm::Handle<reco::BasicJetCollection> hPruneJetProduct;
   iEvent.getByLabel(fPruneJetName,hPruneJetProduct);
   assert(hPruneJetProduct.isValid());
-  const reco::BasicJetCollection *pruneJetCol = hPruneJetProduct.product();
 
   // Get pruned sub jet collection
-  edm::Handle<reco::PFJetCollection> hSubJetProduct;
   iEvent.getByLabel(fSubJetName,hSubJetProduct);
   assert(hSubJetProduct.isValid());
-  //const reco::PFJetCollection *subJetCol = hSubJetProduct.product();
   
   // Get vertex collection
-  edm::Handle<reco::VertexCollection> hVertexProduct;
   iEvent.getByLabel(fPVName,hVertexProduct);
   assert(hVertexProduct.isValid());
-  const reco::VertexCollection *pvCol = hVertexProduct.product();
 
   // Get event energy density for jet correction
-  edm::Handle<double> hRho;
   edm::InputTag rhoTag(fRhoName,"rho","RECO");
   iEvent.getByLabel(rhoTag,hRho);
   assert(hRho.isValid()); 
  
   // Get b-jet tagger
-  edm::Handle<reco::JetTagCollection> hCSVbtags;
   iEvent.getByLabel(fCSVbtagName, hCSVbtags);
   assert(hCSVbtags.isValid());
 
   // Get b sub-jets 
-  edm::Handle<reco::JetTagCollection> hCSVbtagsSubJets;
   iEvent.getByLabel(fCSVbtagSubJetName, hCSVbtagsSubJets);
   assert(hCSVbtagsSubJets.isValid());
-  reco::JetTagCollection hCSVbtagSubJets = *(hCSVbtagsSubJets.product());
   
   // Get N-subjettiness moments
-  edm::Handle<edm::ValueMap<float> > hTau1;
-  iEvent.getByLabel(fJettinessName,"tau1",hTau1);                                                                                                                                                      
+  iEvent.getByLabel(fJettinessName,"tau1",hTau1);
   assert(hTau1.isValid());
-  edm::Handle<edm::ValueMap<float> > hTau2;
   iEvent.getByLabel(fJettinessName,"tau2",hTau2);
   assert(hTau2.isValid());
-  edm::Handle<edm::ValueMap<float> > hTau3;
   iEvent.getByLabel(fJettinessName,"tau3",hTau3); 
   assert(hTau3.isValid());
-  edm::Handle<edm::ValueMap<float> > hTau4;
   iEvent.getByLabel(fJettinessName,"tau3",hTau4); 
   assert(hTau4.isValid());
 
   //Get Quark Gluon Likelihood
-  edm::Handle<edm::ValueMap<float> > hQGLikelihood; 
   iEvent.getByLabel(fQGLikelihood,"qgLikelihood",hQGLikelihood); 
   assert(hQGLikelihood.isValid());
 
   //Get Quark Gluon Likelihood on subjets
-  edm::Handle<edm::ValueMap<float> > hQGLikelihoodSubJets;
   iEvent.getByLabel(fQGLikelihoodSubJets,"qgLikelihood",hQGLikelihoodSubJets);
   assert(hQGLikelihoodSubJets.isValid());
+  eventLock.unlock();
+  
+  const reco::PFJetCollection    *jetCol      = hJetProduct.product();
+  const reco::GenJetCollection   *genJetCol   = fUseGen ? hGenJetProduct.product() : 0;
+  const reco::BasicJetCollection *pruneJetCol = hPruneJetProduct.product();
+  const reco::VertexCollection   *pvCol       = hVertexProduct.product();
+  reco::JetTagCollection hCSVbtagSubJets = *(hCSVbtagsSubJets.product());
   int pId = 0; 
   TClonesArray &rArray      = *array;
   TClonesArray &rExtraArray = *iExtraArray;
+  std::vector<baconhep::TJet*> lMVAJets;  // jets queued for the PU ID MVA, evaluated after the loop
+  fJetPUIDMVACalc.clearBatch();
   for(reco::PFJetCollection::const_iterator itJet = jetCol->begin(); itJet!=jetCol->end(); ++itJet) {
     const double ptRaw = itJet->pt();
     pId++;
@@ -217,7 +221,7 @@ void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
     if(ptRaw*jetcorr < fMinPt || ptRaw < fMinPt) continue;
     bool passLoose = JetTools::passPFLooseID(*itJet);
     
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     assert(rArray.GetEntries() < rArray.GetSize());
     const int index = rArray.GetEntries();
     new(rArray[index]) baconhep::TJet();
@@ -245,10 +249,9 @@ void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
     //
     // Impact Parameter
     //==============================
-    double d0 = JetTools::jetD0(*itJet, pv);
-    double dz = JetTools::jetDz(*itJet, pv);
-    pJet->d0 = d0;
-    pJet->dz = dz;
+    fJetShapes.compute(*itJet, pv, trkVtxMap);
+    pJet->d0 = fJetShapes.d0();
+    pJet->dz = fJetShapes.dz();
 
     //
     // Identification
@@ -271,23 +274,22 @@ void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
     if(matchJet) pJet->prunedm    = matchJet->mass();
     pJet->nCharged   = itJet->chargedMultiplicity();
     pJet->nNeutrals  = itJet->neutralMultiplicity();
-    pJet->nParticles = itJet->getPFConstituents().size();
-    pJet->beta       = JetTools::beta(*itJet, pv);
-    pJet->betaStar   = JetTools::betaStar(*itJet, pv, pvCol);
-    pJet->dR2Mean    = JetTools::dR2Mean(*itJet);
-    pJet->ptD        = JetTools::jetWidth(*itJet);
-    pJet->q          = JetTools::jetCharge(*itJet);
-    TLorentzVector lPull = JetTools::jetPull(*itJet);   //Color Flow observables
-    pJet->pull       = lPull.Pt();
+    pJet->nParticles = fJetShapes.nParticles();
+    pJet->beta       = fJetShapes.beta();
+    pJet->betaStar   = fJetShapes.betaStar();
+    pJet->dR2Mean    = fJetShapes.dR2Mean();
+    pJet->ptD        = fJetShapes.ptD();
+    pJet->q          = fJetShapes.charge();
+    pJet->pull       = fJetShapes.pull();   //Color Flow observables
     pJet->pullAngle  = JetTools::jetPullAngle(*itJet,hSubJetProduct,fConeSize);
     pJet->mva = -2;
     if(passLoose) {
-      double dRMean    = JetTools::dRMean(*itJet);
-      double frac01    = JetTools::frac(*itJet,0.1);
-      double frac02    = JetTools::frac(*itJet,0.2);
-      double frac03    = JetTools::frac(*itJet,0.3);
-      double frac04    = JetTools::frac(*itJet,0.4);
-      double frac05    = JetTools::frac(*itJet,0.5);
+      double dRMean    = fJetShapes.dRMean();
+      double frac01    = fJetShapes.frac(0);
+      double frac02    = fJetShapes.frac(1);
+      double frac03    = fJetShapes.frac(2);
+      double frac04    = fJetShapes.frac(3);
+      double frac05    = fJetShapes.frac(4);
       
       fJetCorrForID->setJetPt(ptRaw);
       fJetCorrForID->setJetEta(itJet->eta());
@@ -298,9 +300,10 @@ void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
       fJetCorrForID->setJetEMF(-99.0);
       double jetcorrForID = fJetCorrForID->getCorrection();
       
-      pJet->mva = fJetPUIDMVACalc.mvaValue((float)pvCol->size(), ptRaw*jetcorrForID, itJet->eta(), itJet->phi(),
-			                   pJet->d0, pJet->dz, pJet->beta, pJet->betaStar, itJet->chargedMultiplicity(), itJet->neutralMultiplicity(),
-			                   dRMean, pJet->dR2Mean, pJet->ptD, frac01, frac02, frac03, frac04, frac05);
+      fJetPUIDMVACalc.addToBatch((float)pvCol->size(), ptRaw*jetcorrForID, itJet->eta(), itJet->phi(),
+			         pJet->d0, pJet->dz, pJet->beta, pJet->betaStar, itJet->chargedMultiplicity(), itJet->neutralMultiplicity(),
+			         dRMean, pJet->dR2Mean, pJet->ptD, frac01, frac02, frac03, frac04, frac05);
+      lMVAJets.push_back(pJet);
     }
     
     //Basic Noise Variables
@@ -324,10 +327,14 @@ void FillerJet::fill(TClonesArray *array,TClonesArray *iExtraArray,
     //pJet->matchedId     = 0;//FIXME
     //pJet->matchedFlavor = 0;//FIXME
     
-    pJet->hltMatchBits = TriggerTools::matchHLT(pJet->eta, pJet->phi, triggerRecords, triggerEvent);
     //Add Extras
     if(fComputeFullInfo) addJet(pAddJet,*itJet,*(hRho.product()));
   } 
+  
+  // PU ID MVA of all loose jets at once
+  std::vector<float> lMVAVals;
+  fJetPUIDMVACalc.evaluateBatch(lMVAVals);
+  for(unsigned int ijet=0; ijet<lMVAJets.size(); ijet++) { lMVAJets[ijet]->mva = lMVAVals[ijet]; }
 }
 void FillerJet::addJet(TAddJet *pPFJet,const reco::PFJet &itJet,double iRho) { 
   std::vector<reco::PFCandidatePtr> pfConstituents = itJet.getPFConstituents(); 
@@ -337,8 +344,13 @@ void FillerJet::addJet(TAddJet *pPFJet,const reco::PFJet &itJet,double iRho) {
     fastjet::PseudoJet   pPart(pfcand->px(),pfcand->py(),pfcand->pz(),pfcand->energy());
     lClusterParticles.push_back(pPart);
   }
-  fClustering = new fastjet::ClusterSequenceArea(lClusterParticles, *fCAJetDef, *fAreaDefinition);
-  fastjet::PseudoJet iJet = CACluster(iJet,*fClustering);
+  
+  // one clustering per jet, shared by all groomers
+  std::vector<fastjet::PseudoJet> lGhosts;
+  double lGhostArea = 0;
+  windowGhosts(lClusterParticles, itJet.phi(), lGhosts, lGhostArea);
+  fastjet::ClusterSequenceActiveAreaExplicitGhosts lClustering(lClusterParticles, *fCAJetDef, lGhosts, lGhostArea);
+  fastjet::PseudoJet iJet = CACluster(iJet,lClustering);
   fastjet::PseudoJet pP1Jet = (*fPruner1)( iJet);
   double pCorr        = correction(pP1Jet,iRho);
   pPFJet->pt_p1       = pP1Jet.pt()*pCorr;
@@ -348,7 +360,7 @@ void FillerJet::addJet(TAddJet *pPFJet,const reco::PFJet &itJet,double iRho) {
   pPFJet->mass_p1     = pP1Jet.m()*pCorr;
   pPFJet->area_p1     = pP1Jet.area();
 
-  fastjet::PseudoJet pP2Jet = (*fPruner1)( iJet);
+  fastjet::PseudoJet pP2Jet = pP1Jet;  // p2 is filled with fPruner1 as well
   pCorr               = correction(pP2Jet,iRho);
   pPFJet->pt_p2       = pP2Jet.pt()*pCorr;
   pPFJet->ptraw_p2    = pP2Jet.pt();
@@ -410,27 +422,68 @@ void FillerJet::addJet(TAddJet *pPFJet,const reco::PFJet &itJet,double iRho) {
   pPFJet->phi_f2      = pF2Jet.phi();
   pPFJet->mass_f2     = pF2Jet.m()*pCorr;
   pPFJet->area_f2     = pF2Jet.area();
-  delete fClustering;
 
   //Jet Shape Correlation observables
-  fastjet::JetDefinition lCJet_def    (fastjet::cambridge_algorithm, 2.0);
-  fastjet::ClusterSequence lCClust_seq(lClusterParticles, lCJet_def);
-  std::vector<fastjet::PseudoJet> inclusive_jets = lCClust_seq.inclusive_jets(0);
-  fastjet::EnergyCorrelatorRatio C2beta0 (2,0. ,fastjet::EnergyCorrelator::pt_R);
-  fastjet::EnergyCorrelatorRatio C2beta02(2,0.2,fastjet::EnergyCorrelator::pt_R);
-  fastjet::EnergyCorrelatorRatio C2beta05(2,0.5,fastjet::EnergyCorrelator::pt_R);
-  fastjet::EnergyCorrelatorRatio C2beta10(2,1.0,fastjet::EnergyCorrelator::pt_R);
-  fastjet::EnergyCorrelatorRatio C2beta20(2,2.0,fastjet::EnergyCorrelator::pt_R);
-  pPFJet->c2_0    = C2beta0 (inclusive_jets[0]);
-  pPFJet->c2_0P2  = C2beta02(inclusive_jets[0]);
-  pPFJet->c2_0P5  = C2beta05(inclusive_jets[0]);
-  pPFJet->c2_1P0  = C2beta10(inclusive_jets[0]);
-  pPFJet->c2_2P0  = C2beta20(inclusive_jets[0]);
+  // (a CA R=2.0 reclustering merges all constituents of the jet, so they are simply joined)
+  std::vector<fastjet::PseudoJet> inclusive_jets(1, fastjet::join(lClusterParticles));
+  // ECF(3,beta)/ECF(2,beta) for beta = 0, 0.2, 0.5, 1.0, 2.0 (fastjet::EnergyCorrelatorRatio(2,beta))
+  fECF->compute(inclusive_jets[0]);
+  pPFJet->c2_0    = fECF->r2(0);
+  pPFJet->c2_0P2  = fECF->r2(1);
+  pPFJet->c2_0P5  = fECF->r2(2);
+  pPFJet->c2_1P0  = fECF->r2(3);
+  pPFJet->c2_2P0  = fECF->r2(4);
 }
-fastjet::PseudoJet FillerJet::CACluster   (fastjet::PseudoJet &iJet, fastjet::ClusterSequenceArea &iCAClustering) { 
+fastjet::PseudoJet FillerJet::CACluster   (fastjet::PseudoJet &iJet, fastjet::ClusterSequence &iCAClustering) { 
   std::vector<fastjet::PseudoJet>  lOutJets = sorted_by_pt(iCAClustering.inclusive_jets(0.0));
   return lOutJets[0];
 }
+//--------------------------------------------------------------------------------------------------
+void FillerJet::windowGhosts(const std::vector<fastjet::PseudoJet> &iParticles, const double iPhiAxis,
+                             std::vector<fastjet::PseudoJet> &oGhosts, double &oGhostArea) const { 
+  // Same ghost grid as an active area with explicit ghosts (grid and pt scatter 1 and 0.1,
+  // mean ghost pt 1e-100), restricted to the constituents' rapidity-phi extent plus the larger of
+  // the cone size (set after construction) and the reclustering radius. The scatter uses a
+  // generator of its own seeded per jet (fastjet's, as the area definition used), so the areas do
+  // not depend on the order (or the thread) in which jets are processed.
+  const double lPad          = std::max(fConeSize, fCAJetDef->R());
+  const double lGridScatter  = 1.0;
+  const double lPtScatter    = 0.1;
+  const double lMeanGhostPt  = 1e-100;
+  
+  double lRapMin = 0, lRapMax = 0, lDPhiMin = 0, lDPhiMax = 0;
+  for(unsigned int i0 = 0; i0 < iParticles.size(); i0++) { 
+    double pRap  = iParticles[i0].rap();
+    double pDPhi = reco::deltaPhi(iParticles[i0].phi(), iPhiAxis);
+    if(i0 == 0 || pRap  < lRapMin)  lRapMin  = pRap;
+    if(i0 == 0 || pRap  > lRapMax)  lRapMax  = pRap;
+    if(i0 == 0 || pDPhi < lDPhiMin) lDPhiMin = pDPhi;
+    if(i0 == 0 || pDPhi > lDPhiMax) lDPhiMax = pDPhi;
+  }
+  lRapMin -= lPad; lRapMax += lPad;
+  double lPhiMin = iPhiAxis + lDPhiMin - lPad;
+  double lPhiMax = iPhiAxis + lDPhiMax + lPad;
+  if(lPhiMax - lPhiMin > TMath::TwoPi()) { lPhiMin = 0; lPhiMax = TMath::TwoPi(); }
+  
+  const double lCell = sqrt(fGhostArea);
+  const int    lNRap = std::max(1, int(ceil((lRapMax - lRapMin)/lCell)));
+  const int    lNPhi = std::max(1, int(ceil((lPhiMax - lPhiMin)/lCell)));
+  const double lDRap = (lRapMax - lRapMin)/lNRap;
+  const double lDPhi = (lPhiMax - lPhiMin)/lNPhi;
+  oGhostArea = lDRap*lDPhi;
+  
+  fastjet::BasicRandom<double> lRandom(lNRap*lNPhi + 1, lNRap + 1);
+  oGhosts.clear();
+  oGhosts.reserve(lNRap*lNPhi);
+  for(int iRap = 0; iRap < lNRap; iRap++) { 
+    for(int iPhi = 0; iPhi < lNPhi; iPhi++) { 
+      double pPhi = lPhiMin + (iPhi+0.5)*lDPhi + lDPhi*(lRandom()-0.5)*lGridScatter;
+      double pRap = lRapMin + (iRap+0.5)*lDRap + lDRap*(lRandom()-0.5)*lGridScatter;
+      double pPt  = lMeanGhostPt*(1+(lRandom()-0.5)*lPtScatter);
+      oGhosts.push_back(fastjet::PseudoJet(pPt*cos(pPhi), pPt*sin(pPhi), pPt*sinh(pRap), pPt*cosh(pRap)));
+    }
+  }
+}
 /*
 float FillerJet::getTau( fastjet::PseudoJet &iJet,int iN, float iKappa ){
   fastjet::Nsubjettiness nSubNKT(iN, Njettiness::onepass_kt_axes, iKappa, fConeSize,fConeSize);
@@ -1,7 +1,7 @@
 #include "BaconProd/Ntupler/interface/FillerMuon.hh"
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
 #include "BaconAna/DataFormats/interface/TMuon.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/MuonReco/interface/Muon.h"
@@ -10,7 +10,6 @@
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
-#include "DataFormats/HLTReco/interface/TriggerEvent.h"
 #include "DataFormats/Math/interface/deltaR.h"
 #include "TrackingTools/TransientTrack/interface/TransientTrackBuilder.h"
 #include "TrackingTools/Records/interface/TransientTrackRecord.h"
@@ -39,14 +38,14 @@ FillerMuon::~FillerMuon(){}
 //--------------------------------------------------------------------------------------------------
 void FillerMuon::fill(TClonesArray *array,
                       const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, 
-		      const std::vector<const reco::PFCandidate*> &pfNoPU,
-		      const std::vector<const reco::PFCandidate*> &pfPU,
-		      const std::vector<TriggerRecord> &triggerRecords,
-		      const trigger::TriggerEvent &triggerEvent)
+		      const PFIsoGrid &pfIsoGrid, const RefIndexMap &refIndexMap)
 {
   assert(array);
   bool lApplyMuscle = false; if(fMuCorr->isInitialized()) lApplyMuscle = true;
   
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get muon collection
   edm::Handle<reco::MuonCollection> hMuonProduct;
   iEvent.getByLabel(fMuonName,hMuonProduct);
@@ -58,6 +57,7 @@ void FillerMuon::fill(TClonesArray *array,
   iEvent.getByLabel(fPFCandName,hPFCandProduct);
   assert(hPFCandProduct.isValid());
   const reco::PFCandidateCollection *pfCandCol = hPFCandProduct.product();
+  assert(refIndexMap.pfCandidates() == pfCandCol);
   
   // Get track collection
   edm::Handle<reco::TrackCollection> hTrackProduct;
@@ -72,6 +72,7 @@ void FillerMuon::fill(TClonesArray *array,
   edm::ESHandle<TransientTrackBuilder> hTransientTrackBuilder;
   iSetup.get<TransientTrackRecord>().get("TransientTrackBuilder",hTransientTrackBuilder);
   const TransientTrackBuilder *transientTrackBuilder = hTransientTrackBuilder.product();  
+  eventLock.unlock();
   
   for(reco::MuonCollection::const_iterator itMu = muonCol->begin(); itMu!=muonCol->end(); ++itMu) {    
     
@@ -85,7 +86,7 @@ void FillerMuon::fill(TClonesArray *array,
     if(lApplyMuscle) muvecCorr = fMuCorr->evaluate(muvec, itMu->charge(), iEvent.id().run(), false);    
     if(muTrack->pt() < fMinPt && muvecCorr.Pt() < fMinPt) continue;
     
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     TClonesArray &rArray = *array;
     assert(rArray.GetEntries() < rArray.GetSize());
     const int index = rArray.GetEntries();
@@ -109,12 +110,12 @@ void FillerMuon::fill(TClonesArray *array,
     pMuon->pfPt  = 0;
     pMuon->pfEta = 0;
     pMuon->pfPhi = 0;
-    for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
-      if(itMu->innerTrack().isNonnull() && itPF->trackRef().isNonnull() && itMu->innerTrack() == itPF->trackRef()) {        
-	pMuon->pfPt  = itPF->pt();
-	pMuon->pfEta = itPF->eta();
-	pMuon->pfPhi = itPF->phi();
-      }
+    const int pfIndex = refIndexMap.pfCandIndex(itMu->innerTrack());
+    if(pfIndex >= 0) {
+      const reco::PFCandidate &pfcand = (*pfCandCol)[pfIndex];
+      pMuon->pfPt  = pfcand.pt();
+      pMuon->pfEta = pfcand.eta();
+      pMuon->pfPhi = pfcand.phi();
     }
     
     //
@@ -124,13 +125,11 @@ void FillerMuon::fill(TClonesArray *array,
     pMuon->ecalIso03 = itMu->isolationR03().emEt;
     pMuon->hcalIso03 = itMu->isolationR03().hadEt;
     
-    computeIso(*muTrack, 0.3, pfNoPU, pfPU,
+    computeIso(*muTrack, pfIsoGrid,
                pMuon->chHadIso03,
                pMuon->gammaIso03,
                pMuon->neuHadIso03,
-               pMuon->puIso03);
-    
-    computeIso(*muTrack, 0.4, pfNoPU, pfPU,
+               pMuon->puIso03,
                pMuon->chHadIso04,
                pMuon->gammaIso04,
                pMuon->neuHadIso04,
@@ -193,36 +192,23 @@ void FillerMuon::fill(TClonesArray *array,
     pMuon->nPixLayers = itMu->innerTrack().isNonnull() ? itMu->innerTrack()->hitPattern().pixelLayersWithMeasurement()   : 0;
     pMuon->nMatchStn  = itMu->numberOfMatchedStations();
     
-    pMuon->trkID = -1;
-    if(itMu->innerTrack().isNonnull()) {
-      int trkIndex = -1;
-      for(reco::TrackCollection::const_iterator itTrk = trackCol->begin(); itTrk!=trackCol->end(); ++itTrk) {
-        trkIndex++;
-	if(itMu->innerTrack().get() == &(*itTrk)) {
-	  pMuon->trkID = index;
-	  break;
-	}
-      }
-    }
-    
-    pMuon->hltMatchBits = TriggerTools::matchHLT(pMuon->eta, pMuon->phi, triggerRecords, triggerEvent);
+    pMuon->trkID = refIndexMap.trackIndex(itMu->innerTrack());
   }
   
   
   if(fSaveTracks) {    
+    // tracks used by muons
+    std::vector<bool> lIsMuon(trackCol->size(), false);
+    for(reco::MuonCollection::const_iterator itMu = muonCol->begin(); itMu!=muonCol->end(); ++itMu) {
+      if(itMu->innerTrack().isNonnull() && itMu->innerTrack().id() == hTrackProduct.id()) lIsMuon[itMu->innerTrack().key()] = true;
+    }
+    
     int trkIndex = -1;
     for(reco::TrackCollection::const_iterator itTrk = trackCol->begin(); itTrk!=trackCol->end(); ++itTrk) {
       trkIndex++;
       
       // check track is not a muon
-      bool isMuon = false;
-      for(reco::MuonCollection::const_iterator itMu = muonCol->begin(); itMu!=muonCol->end(); ++itMu) {
-        if(itMu->innerTrack().isNonnull() && itMu->innerTrack().get() == &(*itTrk)) {
-	  isMuon = true;
-	  break;
-	}
-      }
-      if(isMuon) continue;
+      if(lIsMuon[trkIndex]) continue;
 
       // track pT cut
       TLorentzVector muvec;
@@ -255,12 +241,12 @@ void FillerMuon::fill(TClonesArray *array,
       pMuon->pfPt  = 0;
       pMuon->pfEta = 0;
       pMuon->pfPhi = 0;
-      for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
-        if(itPF->trackRef().isNonnull() && &(*itTrk) == itPF->trackRef().get()) {
-	  pMuon->pfPt  = itPF->pt();
-	  pMuon->pfEta = itPF->eta();
-	  pMuon->pfPhi = itPF->phi();
-        }
+      const int pfIndex = refIndexMap.pfCandIndex(reco::TrackRef(hTrackProduct, trkIndex));
+      if(pfIndex >= 0) {
+        const reco::PFCandidate &pfcand = (*pfCandCol)[pfIndex];
+        pMuon->pfPt  = pfcand.pt();
+        pMuon->pfEta = pfcand.eta();
+        pMuon->pfPhi = pfcand.phi();
       }
     
       //
@@ -270,13 +256,11 @@ void FillerMuon::fill(TClonesArray *array,
       pMuon->ecalIso03 = -1;
       pMuon->hcalIso03 = -1;
     
-      computeIso(*itTrk, 0.3, pfNoPU, pfPU,
+      computeIso(*itTrk, pfIsoGrid,
                  pMuon->chHadIso03,
                  pMuon->gammaIso03,
                  pMuon->neuHadIso03,
-                 pMuon->puIso03);
-    
-      computeIso(*itTrk, 0.4, pfNoPU, pfPU,
+                 pMuon->puIso03,
                  pMuon->chHadIso04,
                  pMuon->gammaIso04,
                  pMuon->neuHadIso04,
@@ -310,49 +294,62 @@ void FillerMuon::fill(TClonesArray *array,
       pMuon->nPixLayers   = itTrk->hitPattern().pixelLayersWithMeasurement();
       pMuon->nMatchStn    = 0;
       pMuon->trkID        = trkIndex;
-      pMuon->hltMatchBits = TriggerTools::matchHLT(pMuon->eta, pMuon->phi, triggerRecords, triggerEvent);
     }    
   } 
 }
 
 //--------------------------------------------------------------------------------------------------
-void FillerMuon::computeIso(const reco::Track &track, const double extRadius,
-                            const std::vector<const reco::PFCandidate*> &pfNoPU,
-			    const std::vector<const reco::PFCandidate*> &pfPU,
-                            float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso, float &out_puIso) const
+void FillerMuon::computeIso(const reco::Track &track, const PFIsoGrid &pfIsoGrid,
+                            float &out_chHadIso03, float &out_gammaIso03, float &out_neuHadIso03, float &out_puIso03,
+                            float &out_chHadIso04, float &out_gammaIso04, float &out_neuHadIso04, float &out_puIso04) const
 {
   // Muon PF isolation with delta-beta PU correction:
   // https://twiki.cern.ch/twiki/bin/view/CMSPublic/SWGuideMuonId#Muon_Isolation
   
-  double chHadIso=0, gammaIso=0, neuHadIso=0;
+  double chHadIso03=0, gammaIso03=0, neuHadIso03=0;
+  double chHadIso04=0, gammaIso04=0, neuHadIso04=0;
   
+  const double extRadius03     = 0.3;
+  const double extRadius04     = 0.4;
   const double ptMin           = 0.5;  
   //const double intRadiusChHad  = 0.0001;
   //const double intRadiusGamma  = 0.01;
   //const double intRadiusNeuHad = 0.01;
   double intRadius = 0;
   
-  for(unsigned int ipf=0; ipf<pfNoPU.size(); ipf++) {
-    const reco::PFCandidate *pfcand = pfNoPU.at(ipf);    
+  std::vector<PFIsoGrid::Neighbour> pfCands;
+  pfIsoGrid.neighboursNoPU(track.eta(), track.phi(), extRadius04, pfCands);
+  
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;    
     if(!(pfcand->trackRef().isNonnull() && pfcand->trackRef().get() == &track)) {
       
       if     (pfcand->particleId() == reco::PFCandidate::h)     { intRadius = 0;}//intRadiusChHad; }
       else if(pfcand->particleId() == reco::PFCandidate::gamma) { intRadius = 0;}//intRadiusGamma;  }
       else if(pfcand->particleId() == reco::PFCandidate::h0)    { intRadius = 0;}//intRadiusNeuHad; }
             
-      double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), track.eta(), track.phi());
-      if(dr>=extRadius || dr<intRadius) continue;
+      const double dr = pfCands[ipf].dr;
+      if(dr>=extRadius04 || dr<intRadius) continue;
+      const bool in03 = (dr<extRadius03);
             
-      if     (pfcand->particleId() == reco::PFCandidate::h)                             { chHadIso  += pfcand->pt(); }
-      else if(pfcand->particleId() == reco::PFCandidate::gamma && pfcand->pt() > ptMin) { gammaIso  += pfcand->pt(); }
-      else if(pfcand->particleId() == reco::PFCandidate::h0    && pfcand->pt() > ptMin) { neuHadIso += pfcand->pt(); }
+      if(pfcand->particleId() == reco::PFCandidate::h) {
+        chHadIso04 += pfcand->pt();
+        if(in03) chHadIso03 += pfcand->pt();
+      } else if(pfcand->particleId() == reco::PFCandidate::gamma && pfcand->pt() > ptMin) {
+        gammaIso04 += pfcand->pt();
+        if(in03) gammaIso03 += pfcand->pt();
+      } else if(pfcand->particleId() == reco::PFCandidate::h0 && pfcand->pt() > ptMin) {
+        neuHadIso04 += pfcand->pt();
+        if(in03) neuHadIso03 += pfcand->pt();
+      }
     }
   }
   
   // compute PU iso
-  double puIso = 0;
-  for(unsigned int ipf=0; ipf<pfPU.size(); ipf++) {
-    const reco::PFCandidate *pfcand = pfPU.at(ipf);
+  double puIso03 = 0, puIso04 = 0;
+  pfIsoGrid.neighboursPU(track.eta(), track.phi(), extRadius04, pfCands);
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;
     if(pfcand->pt() >= ptMin            &&   // NOTE: min pT cut not mentioned in twiki, but apparently needed for HZZ4l sync...
        !(pfcand->trackRef().isNonnull() && 
        pfcand->trackRef().get() == &track))
@@ -361,13 +358,18 @@ void FillerMuon::computeIso(const reco::Track &track, const double extRadius,
       else if(pfcand->particleId() == reco::PFCandidate::gamma) { intRadius = 0;}//intRadiusGamma;  }
       else if(pfcand->particleId() == reco::PFCandidate::h0)    { intRadius = 0;}//intRadiusNeuHad; }
 
-      double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), track.eta(), track.phi());
-      if(dr<extRadius && dr>=intRadius) { puIso += pfcand->pt(); }
+      const double dr = pfCands[ipf].dr;
+      if(dr<extRadius04 && dr>=intRadius) { puIso04 += pfcand->pt(); }
+      if(dr<extRadius03 && dr>=intRadius) { puIso03 += pfcand->pt(); }
     }
   }
   
-  out_chHadIso  = chHadIso;
-  out_gammaIso  = gammaIso;
-  out_neuHadIso = neuHadIso;
-  out_puIso     = puIso;
+  out_chHadIso03  = chHadIso03;
+  out_gammaIso03  = gammaIso03;
+  out_neuHadIso03 = neuHadIso03;
+  out_puIso03     = puIso03;
+  out_chHadIso04  = chHadIso04;
+  out_gammaIso04  = gammaIso04;
+  out_neuHadIso04 = neuHadIso04;
+  out_puIso04     = puIso04;
 }
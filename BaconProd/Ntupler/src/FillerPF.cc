@@ -1,6 +1,7 @@
 #include "BaconProd/Ntupler/interface/FillerPF.hh"
 #include "BaconAna/DataFormats/interface/TPFPart.hh"
 #include "BaconAna/DataFormats/interface/TVertex.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
@@ -29,10 +30,13 @@ FillerPF::~FillerPF(){}
 
 //--------------------------------------------------------------------------------------------------
 void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
-		    const edm::Event &iEvent) 
+		    const edm::Event &iEvent, const TrackVertexMap &trkVtxMap) 
 		   
 {
   assert(array);
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get PF collection
   edm::Handle<reco::PFCandidateCollection> hPFProduct;
   iEvent.getByLabel(fPFName,hPFProduct);
@@ -44,13 +48,33 @@ void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
   iEvent.getByLabel(fPVName,hVertexProduct);
   assert(hVertexProduct.isValid());
   const reco::VertexCollection *pvCol = hVertexProduct.product();
+  eventLock.unlock();
+
+  // associations are indexed by position in the PF and vertex collections
+  assert(trkVtxMap.pfCandidates() == PFCol);
+  assert(trkVtxMap.vertices()     == pvCol);
+
+  // match each vertex of the collection to its output TVertex (if any) once per event
+  std::vector<int> lVtxId(pvCol->size(), -1);
+  for(unsigned int iV = 0; iV < pvCol->size(); iV++) {
+    const reco::Vertex &vtx = (*pvCol)[iV];
+    for(int i0 = 0; i0 < iVtxCol->GetEntries(); i0++) { 
+      baconhep::TVertex* pVertex = (TVertex*)(*iVtxCol)[i0];
+      if(fabs(vtx.x() - pVertex->x) + 
+	 fabs(vtx.y() - pVertex->y) + 
+	 fabs(vtx.z() - pVertex->z) > 0.0001) continue;
+      lVtxId[iV] = i0;
+      break;
+    }
+  }
 
   const reco::PFRecHitCollection *pfRecHitECAL = 0;
   const reco::PFRecHitCollection *pfRecHitHCAL = 0;
   const reco::PFRecHitCollection *pfRecHitHO   = 0;
-  reco::PFRecHitCollection pfRecHitAll;
+  fRecHitGrid.clear();
   if(fAddDepthTime) { 
     //Load all of the stupid PF Rec Hits
+    eventLock.lock();
     edm::Handle<reco::PFRecHitCollection> hPFRecHitECAL;
     iEvent.getByLabel(edm::InputTag("particleFlowRecHitECAL"),hPFRecHitECAL);
     assert(hPFRecHitECAL.isValid());
@@ -65,10 +89,12 @@ void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
     iEvent.getByLabel(edm::InputTag("particleFlowRecHitHO"),hPFRecHitHO);
     assert(hPFRecHitHO.isValid());
     pfRecHitHO = hPFRecHitHO.product();
+    eventLock.unlock();
    
-    for(unsigned int i0 = 0; i0 < pfRecHitECAL ->size(); i0++) pfRecHitAll.push_back((*pfRecHitECAL) [i0]);
-    for(unsigned int i0 = 0; i0 < pfRecHitHCAL ->size(); i0++) pfRecHitAll.push_back((*pfRecHitHCAL) [i0]);
-    for(unsigned int i0 = 0; i0 < pfRecHitHO   ->size(); i0++) pfRecHitAll.push_back((*pfRecHitHO)   [i0]);
+    // index the hits in place, one layer per collection
+    fRecHitGrid.addLayer(*pfRecHitECAL);
+    fRecHitGrid.addLayer(*pfRecHitHCAL);
+    fRecHitGrid.addLayer(*pfRecHitHO);
   }
   /*
   edm::Handle<reco::PFRecHitCollection> hPFRecHitHFEM;
@@ -90,8 +116,9 @@ void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
   TClonesArray &rArray = *array;
   int pId = 0; 
   for(reco::PFCandidateCollection::const_iterator itPF = PFCol->begin(); itPF!=PFCol->end(); itPF++) {
+    const TrackVertexMap::PFAssoc &assoc = trkVtxMap.pfAssoc(pId);
     pId++;
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     assert(rArray.GetEntries() < rArray.GetSize());
     const int index = rArray.GetEntries();
     new(rArray[index]) baconhep::TPFPart();
@@ -114,8 +141,8 @@ void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
     // Depth & Timing Info
     //==============================
     if(fAddDepthTime) { 
-      pPF->time  = timeDeltaR (&(*itPF),pfRecHitAll);
-      pPF->depth = depthDeltaR(&(*itPF),pfRecHitAll);
+      pPF->time  = timeDeltaR (&(*itPF),fRecHitGrid);
+      pPF->depth = depthDeltaR(&(*itPF),fRecHitGrid);
     }
     //pPF->time  = time (&(*itPF));
     //pPF->depth = depth(&(*itPF));
@@ -128,33 +155,14 @@ void FillerPF::fill(TClonesArray *array,TClonesArray *iVtxCol,
     int    ndof     = pfTrack->ndof();
     double chi2     = pfTrack->chi2();
     pPF->trkChi2 = TMath::Prob(chi2,ndof);
-    const reco::Vertex *closestVtx = 0;
-    bool lFirst = true;
-    for(reco::VertexCollection::const_iterator iV = pvCol->begin(); iV!=pvCol->end(); ++iV) {
-      if(lFirst) { 
-	if      ( itPF->trackRef().isNonnull()    ) pPF->dz = itPF->trackRef()   ->dz(iV->position());
-	else if ( itPF->gsfTrackRef().isNonnull() ) pPF->dz = itPF->gsfTrackRef()->dz(iV->position());
-	if      ( itPF->trackRef().isNonnull()    ) pPF->d0 = itPF->trackRef()   ->d0();
-	else if ( itPF->gsfTrackRef().isNonnull() ) pPF->d0 = itPF->gsfTrackRef()->d0();
-	lFirst = false;
-      }
-      if(iV->trackWeight(itPF->trackRef())>0) {
-	closestVtx  = &(*iV);
-	break;
-      }
-    }
-    if(closestVtx == 0) continue;
-    pPF->vtxChi2 = closestVtx->trackWeight(itPF->trackRef());
-    int lId = -1;
-    for(int i0 = 0; i0 < iVtxCol->GetEntries(); i0++) { 
-      baconhep::TVertex* pVertex = (TVertex*)(*iVtxCol)[i0];
-      if(fabs(closestVtx->x() - pVertex->x) + 
-	 fabs(closestVtx->y() - pVertex->y) + 
-	 fabs(closestVtx->z() - pVertex->z) > 0.0001) continue;
-      lId = i0;
-      break;
+    if(!pvCol->empty()) {
+      const reco::Vertex &firstVtx = pvCol->front();
+      pPF->dz = pfTrack->dz(firstVtx.position());
+      pPF->d0 = pfTrack->d0();
     }
-    pPF->vtxId = lId;
+    if(assoc.vtxIndex < 0) continue;
+    pPF->vtxChi2 = assoc.vtxWeight;
+    pPF->vtxId   = lVtxId[assoc.vtxIndex];
   } 
 }
 float FillerPF::depthDeltaR(const reco::PFCandidate *iPF,const reco::PFRecHitCollection &iPFCol,double iDR) { 
@@ -195,6 +203,34 @@ float FillerPF::timeDeltaR(const reco::PFCandidate *iPF,const reco::PFRecHitColl
   }
   return lMaxT;
 }
+float FillerPF::depthDeltaR(const reco::PFCandidate *iPF,const PFRecHitGrid &iGrid,double iDR) { 
+  float lEta     = iPF->positionAtECALEntrance().eta();
+  float lPhi     = iPF->positionAtECALEntrance().phi();
+  float lRhoE    = iPF->positionAtECALEntrance().rho();
+  float lTotRho  = 0; 
+  float lTotE    = 0;
+  iGrid.neighbours(lEta,lPhi,iDR,fRecHits);
+  for(unsigned int i0 = 0; i0 < fRecHits.size(); i0++) { 
+    lTotRho += (fRecHits[i0]->position().rho()-lRhoE)*fRecHits[i0]->energy();
+    lTotE   += fRecHits[i0]->energy();
+  }
+  if(lTotE == 0) return 0;
+  return lTotRho/lTotE;
+}
+float FillerPF::timeDeltaR(const reco::PFCandidate *iPF,const PFRecHitGrid &iGrid,double iDR) { 
+  float lEta     = iPF->positionAtECALEntrance().eta();
+  float lPhi     = iPF->positionAtECALEntrance().phi();
+  float lMaxT    = -999; 
+  float lMaxE    = -999;
+  iGrid.neighbours(lEta,lPhi,iDR,fRecHits);
+  for(unsigned int i0 = 0; i0 < fRecHits.size(); i0++) { 
+    double pEnergy = fRecHits[i0]->energy();
+    if(lMaxE > pEnergy) continue;
+    lMaxE    = pEnergy;
+    lMaxT    = fRecHits[i0]->time();
+  }
+  return lMaxT;
+}
 float FillerPF::depth(const reco::PFCandidate *iPF) { 
   float lTotRho  = 0; 
   float lTotE    = 0;
@@ -1,5 +1,6 @@
 #include "BaconProd/Ntupler/interface/FillerPhoton.hh"
-#include "BaconProd/Utils/interface/TriggerTools.hh"
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "BaconAna/DataFormats/interface/TPhoton.hh"
 #include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
 #include "FWCore/Framework/interface/Event.h"
@@ -10,13 +11,13 @@
 #include "DataFormats/EgammaReco/interface/SuperCluster.h"
 #include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
 #include "RecoEcal/EgammaCoreTools/interface/EcalClusterLazyTools.h"
-#include "DataFormats/HLTReco/interface/TriggerEvent.h"
 #include "DataFormats/Math/interface/deltaR.h"
 #include "DataFormats/EgammaCandidates/interface/Conversion.h"
 #include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
 #include <TClonesArray.h>
 #include <TLorentzVector.h>
 #include <TMath.h>
+#include <memory>
 
 using namespace baconhep;
 
@@ -27,8 +28,6 @@ FillerPhoton::FillerPhoton():
   fPFCandName  ("particleFlow"),
   fEleName     ("gsfElectrons"),
   fConvName    ("allConversions"),
-  fEBSCName    ("correctedHybridSuperClusters"),
-  fEESCName    ("correctedMulti5x5SuperClustersWithPreshower"),
   fEBRecHitName("reducedEcalRecHitsEB"),
   fEERecHitName("reducedEcalRecHitsEE")
 {}
@@ -40,13 +39,13 @@ FillerPhoton::~FillerPhoton(){}
 void FillerPhoton::fill(TClonesArray *array, 
                         const edm::Event &iEvent, const edm::EventSetup &iSetup,
                         const reco::Vertex &pv,
-			const std::vector<const reco::PFCandidate*> &pfNoPU,
-		        const std::vector<const reco::PFCandidate*> &pfPU,
-		        const std::vector<TriggerRecord> &triggerRecords,
-		        const trigger::TriggerEvent &triggerEvent)
+			const PFIsoGrid &pfIsoGrid, const RefIndexMap &refIndexMap)
 {
   assert(array);
   
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get photon collection
   edm::Handle<reco::PhotonCollection> hPhotonProduct;
   iEvent.getByLabel(fPhotonName,hPhotonProduct);
@@ -58,6 +57,7 @@ void FillerPhoton::fill(TClonesArray *array,
   iEvent.getByLabel(fPFCandName,hPFCandProduct);
   assert(hPFCandProduct.isValid());
   const reco::PFCandidateCollection *pfCandCol = hPFCandProduct.product();
+  assert(refIndexMap.pfCandidates() == pfCandCol);
 
   // Get electron collection
   edm::Handle<reco::GsfElectronCollection> hEleProduct;
@@ -69,23 +69,14 @@ void FillerPhoton::fill(TClonesArray *array,
   iEvent.getByLabel(fConvName,hConvProduct);
   assert(hConvProduct.isValid());
 
-  // Get SuperCluster collections
-  edm::Handle<reco::SuperClusterCollection> hEBSCProduct;
-  iEvent.getByLabel(fEBSCName,hEBSCProduct);
-  assert(hEBSCProduct.isValid());
-  const reco::SuperClusterCollection *ebSCCol = hEBSCProduct.product();
-  
-  edm::Handle<reco::SuperClusterCollection> hEESCProduct;
-  iEvent.getByLabel(fEESCName,hEESCProduct);
-  assert(hEESCProduct.isValid());
-  const reco::SuperClusterCollection *eeSCCol = hEESCProduct.product();
-
     
   edm::InputTag ebRecHitTag(fEBRecHitName);
   edm::InputTag eeRecHitTag(fEERecHitName);
   EcalClusterLazyTools lazyTools(iEvent, iSetup, ebRecHitTag, eeRecHitTag);
+  eventLock.unlock();
   
-  std::vector<const reco::PFCandidate*> usedPFPhotons;  // keep track of PF photons that are also counted as standard photons
+  std::vector<bool> usedPFPhotons(pfCandCol->size(), false);  // keep track of PF photons that are also counted as standard photons
+  std::vector<int>  scPFCands;
   
   // PF photon cuts for HZZ4l FSR recovery
   const double pfMinPt  = 2;
@@ -96,7 +87,7 @@ void FillerPhoton::fill(TClonesArray *array,
     // Photon cuts
     if(itPho->pt() < fMinPt) continue;
     
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     TClonesArray &rPhotonArr = *array;
     assert(rPhotonArr.GetEntries() < rPhotonArr.GetSize());
     const int index = rPhotonArr.GetEntries();
@@ -104,7 +95,7 @@ void FillerPhoton::fill(TClonesArray *array,
     baconhep::TPhoton *pPhoton = (baconhep::TPhoton*)rPhotonArr[index];
 
     const reco::SuperClusterRef sc = itPho->superCluster();
-    std::vector<float> vCov = lazyTools.localCovariances(*(sc->seed()));
+    const ShowerShapes shapes(lazyTools, *sc, &fShapesCount);
     
     //
     // Kinematics
@@ -116,30 +107,28 @@ void FillerPhoton::fill(TClonesArray *array,
     pPhoton->scEt  = (sc->energy())*(sc->position().Rho())/(sc->position().R());
     pPhoton->scEta = sc->eta();
     pPhoton->scPhi = sc->phi();
-    pPhoton->r9    = lazyTools.e3x3(*(sc->seed())) / (sc->rawEnergy());
+    pPhoton->r9    = shapes.r9();
 
     // consider standard photon also to be a PF photon if they share supercluster
     pPhoton->pfPt  = 0;
     pPhoton->pfEta = 0;
     pPhoton->pfPhi = 0;
-    bool hasPFMatch=false;
-    for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
-      if(itPF->particleId() != reco::PFCandidate::gamma) continue;
-      if(itPF->pt()        < pfMinPt)  continue;
-      if(fabs(itPF->eta()) > pfMaxEta) continue;
-      
-      const reco::SuperClusterRef pfsc = itPF->superClusterRef();
-      if(pfsc.isNull()) continue;
+    const reco::PFCandidate *pfPhoton = 0;
+    refIndexMap.pfCandIndices(sc, scPFCands);
+    for(unsigned int iSCPF=0; iSCPF<scPFCands.size(); iSCPF++) {
+      const reco::PFCandidate &pfcand = (*pfCandCol)[scPFCands[iSCPF]];
+      if(pfcand.particleId() != reco::PFCandidate::gamma) continue;
+      if(pfcand.pt()        < pfMinPt)  continue;
+      if(fabs(pfcand.eta()) > pfMaxEta) continue;
       
-      if(pfsc == sc) {
-        hasPFMatch = true;
-        usedPFPhotons.push_back(&(*itPF));
-	pPhoton->pfPt  = itPF->pt();
-	pPhoton->pfEta = itPF->eta();
-	pPhoton->pfPhi = itPF->phi();
-	break;
-      }
+      pfPhoton = &pfcand;
+      usedPFPhotons[scPFCands[iSCPF]] = true;
+      pPhoton->pfPt  = pfcand.pt();
+      pPhoton->pfEta = pfcand.eta();
+      pPhoton->pfPhi = pfcand.phi();
+      break;
     }
+    const bool hasPFMatch = (pfPhoton != 0);
 
     //
     // Isolation
@@ -148,16 +137,15 @@ void FillerPhoton::fill(TClonesArray *array,
     pPhoton->ecalIso04 = itPho->ecalRecHitSumEtConeDR04();
     pPhoton->hcalIso04 = itPho->hcalTowerSumEtConeDR04();
     
-    computeIso(*itPho, pfNoPU,
+    computeIso(*itPho, pfIsoGrid,
                pPhoton->chHadIso03,
 	       pPhoton->gammaIso03,
 	       pPhoton->neuHadIso03);
 
     pPhoton->isoForFsr03 = -1;
     if(hasPFMatch) {
-      const reco::PFCandidate *pfcand = usedPFPhotons.back();
-      pPhoton->isoForFsr03 = computeIsoForFSR(pfcand, pfNoPU, pfPU);
-      pPhoton->mvaNothingGamma = pfcand->mva_nothing_gamma();
+      pPhoton->isoForFsr03 = computeIsoForFSR(pfPhoton, pfIsoGrid);
+      pPhoton->mvaNothingGamma = pfPhoton->mva_nothing_gamma();
     }
     
     //
@@ -165,6 +153,7 @@ void FillerPhoton::fill(TClonesArray *array,
     //==============================    
     pPhoton->hovere = itPho->hadronicOverEm();
     pPhoton->sieie  = itPho->sigmaIetaIeta();
+    const std::vector<float> &vCov = shapes.localCovariances();
     pPhoton->sipip  = isnan(vCov[2]) ? 0 : sqrt(vCov[2]);
     
     pPhoton->fiducialBits=0;
@@ -181,28 +170,11 @@ void FillerPhoton::fill(TClonesArray *array,
     if(itPho->isPFlowPhoton())    pPhoton->typeBits |= baconhep::kPFPhoton;  // always 'false' for standard photons?
     if(hasPFMatch)                pPhoton->typeBits |= baconhep::kPFPhoton;  // consider standard photon to be PF if they share supercluster    
    
-    pPhoton->scID = -1;
-    int scIndex = -1;
-    for(reco::SuperClusterCollection::const_iterator itSC = ebSCCol->begin(); itSC!=ebSCCol->end(); ++itSC) {
-      scIndex++;
-      if(itPho->superCluster().get() == &(*itSC)) {
-        pPhoton->scID = scIndex;
-	break;
-      }
-    }
-    for(reco::SuperClusterCollection::const_iterator itSC = eeSCCol->begin(); itSC!=eeSCCol->end(); ++itSC) {
-      scIndex++;
-      if(itPho->superCluster().get() == &(*itSC)) {
-        pPhoton->scID = scIndex;
-	break;
-      }
-    }
+    pPhoton->scID = refIndexMap.scIndex(itPho->superCluster());
     
     pPhoton->hasPixelSeed = itPho->hasPixelSeed();
     
     pPhoton->isConv = ConversionTools::hasMatchedPromptElectron(itPho->superCluster(), hEleProduct, hConvProduct, pv.position(), 2.0, 1e-6, 0);
-    
-    pPhoton->hltMatchBits = TriggerTools::matchHLT(pPhoton->eta, pPhoton->phi, triggerRecords, triggerEvent);
   }
 
   //
@@ -210,6 +182,7 @@ void FillerPhoton::fill(TClonesArray *array,
   // Note: ECAL energy associated with PFMuons also considered FSR candidates
   //
   for(reco::PFCandidateCollection::const_iterator itPF = pfCandCol->begin(); itPF!=pfCandCol->end(); ++itPF) {
+    if(usedPFPhotons[itPF - pfCandCol->begin()]) continue;
     
     TLorentzVector pfpho(0,0,0,0);    
     if(itPF->particleId() == reco::PFCandidate::mu && itPF->ecalEnergy()>0) {
@@ -221,16 +194,7 @@ void FillerPhoton::fill(TClonesArray *array,
     if(pfpho.Pt()        <= pfMinPt)  continue;
     if(fabs(pfpho.Eta()) >= pfMaxEta) continue;
     
-    bool isUsed=false;
-    for(unsigned int iused=0; iused<usedPFPhotons.size(); iused++) {
-      if(&(*itPF) == usedPFPhotons[iused]) {
-        isUsed=true;
-	break;
-      }
-    }
-    if(isUsed) continue;
-    
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     TClonesArray &rPhotonArr = *array;
     assert(rPhotonArr.GetEntries() < rPhotonArr.GetSize());
     const int index = rPhotonArr.GetEntries();
@@ -239,8 +203,8 @@ void FillerPhoton::fill(TClonesArray *array,
 
     const reco::PhotonRef       pho = itPF->photonRef();
     const reco::SuperClusterRef sc  = itPF->superClusterRef();
-    std::vector<float> vCov;
-    if(sc.isNonnull()) vCov = lazyTools.localCovariances(*(sc->seed()));
+    std::auto_ptr<ShowerShapes> shapes;
+    if(sc.isNonnull()) shapes.reset(new ShowerShapes(lazyTools, *sc, &fShapesCount));
     
     //
     // Kinematics
@@ -257,7 +221,7 @@ void FillerPhoton::fill(TClonesArray *array,
       pPhoton->scEt  = (sc->energy())*(sc->position().Rho())/(sc->position().R());
       pPhoton->scEta = sc->eta();
       pPhoton->scPhi = sc->phi();
-      pPhoton->r9    = lazyTools.e3x3(*(sc->seed())) / (sc->rawEnergy());
+      pPhoton->r9    = shapes->r9();
     }
     
     // consider standard photon also to be a PF photon if they share supercluster
@@ -277,13 +241,13 @@ void FillerPhoton::fill(TClonesArray *array,
     pPhoton->neuHadIso03 = -1;
 
     if(pho.isNonnull()) {
-      computeIso(*pho, pfNoPU,
+      computeIso(*pho, pfIsoGrid,
                  pPhoton->chHadIso03,
 	         pPhoton->gammaIso03,
 	         pPhoton->neuHadIso03);
     }
     
-    pPhoton->isoForFsr03     = computeIsoForFSR(&(*itPF), pfNoPU, pfPU);
+    pPhoton->isoForFsr03     = computeIsoForFSR(&(*itPF), pfIsoGrid);
     pPhoton->mvaNothingGamma = itPF->mva_nothing_gamma();
     
     //
@@ -291,7 +255,7 @@ void FillerPhoton::fill(TClonesArray *array,
     //==============================
     if(pho.isNonnull()) pPhoton->hovere = pho->hadronicOverEm();
     if(pho.isNonnull()) pPhoton->sieie  = pho->sigmaIetaIeta();
-    if(sc.isNonnull())  pPhoton->sipip  = isnan(vCov[2]) ? 0 : sqrt(vCov[2]);
+    if(sc.isNonnull())  pPhoton->sipip  = isnan(shapes->localCovariances()[2]) ? 0 : sqrt(shapes->localCovariances()[2]);
     
     pPhoton->fiducialBits=0;
     if(pho.isNonnull()) {
@@ -309,34 +273,15 @@ void FillerPhoton::fill(TClonesArray *array,
     if(itPF->particleId() == reco::PFCandidate::gamma) pPhoton->typeBits |= baconhep::kPFPhoton;
     if(pho.isNonnull() && pho->isStandardPhoton())     pPhoton->typeBits |= baconhep::kEGamma;
        
-    pPhoton->scID = -1;
-    int scIndex = -1;
-    if(sc.isNonnull()) {
-      for(reco::SuperClusterCollection::const_iterator itSC = ebSCCol->begin(); itSC!=ebSCCol->end(); ++itSC) {
-        scIndex++;
-        if(sc.get() == &(*itSC)) {
-          pPhoton->scID = scIndex;
-  	  break;
-        }
-      }
-      for(reco::SuperClusterCollection::const_iterator itSC = eeSCCol->begin(); itSC!=eeSCCol->end(); ++itSC) {
-        scIndex++;
-        if(sc.get() == &(*itSC)) {
-          pPhoton->scID = scIndex;
-	  break;
-        }
-      }
-    }
+    pPhoton->scID = refIndexMap.scIndex(sc);
     
     pPhoton->hasPixelSeed = false;    
     pPhoton->isConv       = false;    
-    pPhoton->hltMatchBits = TriggerTools::matchHLT(pPhoton->eta, pPhoton->phi, triggerRecords, triggerEvent);        
   }  
 }
 
 //--------------------------------------------------------------------------------------------------
-void FillerPhoton::computeIso(const reco::Photon &photon,
-                              const std::vector<const reco::PFCandidate*> &pfNoPU,
+void FillerPhoton::computeIso(const reco::Photon &photon, const PFIsoGrid &pfIsoGrid,
                               float &out_chHadIso, float &out_gammaIso, float &out_neuHadIso) const 
 {
   double chHadIso=0, gammaIso=0, neuHadIso=0;
@@ -346,8 +291,11 @@ void FillerPhoton::computeIso(const reco::Photon &photon,
   const double intRadiusNeuHad = 0.;
   double intRadius = 0;
   
-  for(unsigned int ipf=0; ipf<pfNoPU.size(); ipf++) {
-    const reco::PFCandidate *pfcand = pfNoPU.at(ipf);
+  std::vector<PFIsoGrid::Neighbour> pfCands;
+  pfIsoGrid.neighboursNoPU(photon.eta(), photon.phi(), extRadius, pfCands);
+  
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;
     
     if(pfcand->superClusterRef().isNonnull() && photon.superCluster().isNonnull() &&
        pfcand->superClusterRef() == photon.superCluster())
@@ -357,7 +305,7 @@ void FillerPhoton::computeIso(const reco::Photon &photon,
     else if(pfcand->particleId() == reco::PFCandidate::gamma) { intRadius = photon.isEB() ? 0.015 : 0.00864*fabs(TMath::SinH(photon.superCluster()->eta()))*4.; }
     else if(pfcand->particleId() == reco::PFCandidate::h0)    { intRadius = intRadiusNeuHad; }
     
-    double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), photon.eta(), photon.phi());
+    const double dr = pfCands[ipf].dr;
     if(dr>=extRadius || dr<intRadius) continue;
     
     if     (pfcand->particleId() == reco::PFCandidate::h)     { chHadIso  += pfcand->pt(); }
@@ -371,9 +319,7 @@ void FillerPhoton::computeIso(const reco::Photon &photon,
 }
 
 //--------------------------------------------------------------------------------------------------
-float FillerPhoton::computeIsoForFSR(const reco::PFCandidate *photon,
-                                     const std::vector<const reco::PFCandidate*> &pfNoPU,
-			             const std::vector<const reco::PFCandidate*> &pfPU) const
+float FillerPhoton::computeIsoForFSR(const reco::PFCandidate *photon, const PFIsoGrid &pfIsoGrid) const
 { 
   double extRadius = 0.3;
   double intRadius = 0.01;
@@ -383,14 +329,17 @@ float FillerPhoton::computeIsoForFSR(const reco::PFCandidate *photon,
   double neuIso = 0;
   double puIso  = 0;
   
+  std::vector<PFIsoGrid::Neighbour> pfCands;
+  
   // compute isolation contributions from charged hadrons, neutral hadrons, and photons from the PV
-  for(unsigned int ipf=0; ipf<pfNoPU.size(); ipf++) {      
-    const reco::PFCandidate *pfcand = pfNoPU.at(ipf);
+  pfIsoGrid.neighboursNoPU(photon->eta(), photon->phi(), extRadius, pfCands);
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {      
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;
     
     if(pfcand==photon) continue;
     
     // Add p_T to running sum if PFCandidate is close enough
-    double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), photon->eta(), photon->phi());
+    const double dr = pfCands[ipf].dr;
     if(dr >= extRadius || dr < intRadius) continue;
     
     if     (pfcand->particleId() == reco::PFCandidate::h     && pfcand->pt() > 0.2) { chIso  += pfcand->pt(); }
@@ -399,15 +348,16 @@ float FillerPhoton::computeIsoForFSR(const reco::PFCandidate *photon,
   }
   
   // compute isolation contributions from charged particles not from PV
-  for(unsigned int ipf=0; ipf<pfPU.size(); ipf++) {
-    const reco::PFCandidate *pfcand = pfPU.at(ipf);
+  pfIsoGrid.neighboursPU(photon->eta(), photon->phi(), extRadius, pfCands);
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf].cand;
     assert(pfcand);
 
     if(pfcand->trackRef().isNull()) continue;
     if(pfcand->pt() < 0.2)          continue;
     
     // Add p_T to running sum if PFCandidate is within isolation cone
-    double dr = reco::deltaR(pfcand->eta(), pfcand->phi(), photon->eta(), photon->phi());
+    const double dr = pfCands[ipf].dr;
     if(dr > extRadius || dr <= intRadius) continue;
     
     puIso += pfcand->pt();
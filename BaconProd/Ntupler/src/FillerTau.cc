@@ -1,6 +1,6 @@
 #include "BaconProd/Ntupler/interface/FillerTau.hh"
-#include "BaconProd/Utils/interface/TriggerTools.hh"
 #include "BaconAna/DataFormats/interface/TTau.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
 #include "FWCore/Framework/interface/Event.h"
 #include "DataFormats/TauReco/interface/PFTau.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
@@ -57,12 +57,13 @@ FillerTau::~FillerTau(){}
 
 //--------------------------------------------------------------------------------------------------
 void FillerTau::fill(TClonesArray *array,
-                     const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv, 
-		     const std::vector<TriggerRecord> &triggerRecords,
-		     const trigger::TriggerEvent &triggerEvent) 
+                     const edm::Event &iEvent, const edm::EventSetup &iSetup, const reco::Vertex &pv) 
 {
   assert(array);
 
+  // event products are retrieved one filler at a time when fillers run concurrently
+  boost::mutex::scoped_lock eventLock(TaskScheduler::frameworkMutex());
+  
   // Get tau collection
   edm::Handle<reco::PFTauCollection> hTauProduct;
   iEvent.getByLabel(fTauName,hTauProduct);
@@ -85,6 +86,7 @@ void FillerTau::fill(TClonesArray *array,
   iEvent.getByLabel("hpsPFTauDiscriminationByRawCombinedIsolationDBSumPtCorr3Hits",hCombIsoDBSumPtCorr3HitsRaw);
   edm::Handle<reco::PFTauDiscriminator> hIsoMVA3Raw;
   iEvent.getByLabel("hpsPFTauDiscriminationByIsolationMVA3newDMwoLTraw",hIsoMVA3Raw);
+  eventLock.unlock();
 
 
   for(reco::PFTauCollection::const_iterator itTau = tauCol->begin(); itTau!=tauCol->end(); ++itTau) {
@@ -94,7 +96,7 @@ void FillerTau::fill(TClonesArray *array,
     // tau pT cut
     if(itTau->pt() < fMinPt) continue;
     
-    // construct object and place in array
+    // construct object and place in array (its storage is preallocated, see TaskScheduler::preallocate)
     TClonesArray &rArray = *array;
     assert(rArray.GetEntries() < rArray.GetSize());
     const int index = rArray.GetEntries();
@@ -140,6 +142,5 @@ void FillerTau::fill(TClonesArray *array,
     pTau->antiEleMVA3    = hMVA3EleRejRaw.isValid() ? (*hMVA3EleRejRaw)[tauRef] : 0;
     pTau->antiEleMVA3Cat = hMVA3EleRejCat.isValid() ? (*hMVA3EleRejCat)[tauRef] : 0;
     
-    pTau->hltMatchBits = TriggerTools::matchHLT(pTau->eta, pTau->phi, triggerRecords, triggerEvent);
   } 
 }
@@ -0,0 +1,112 @@
+//
+// Compare the output profiles on an existing Bacon ntuple
+//
+//   benchmarkOutputProfiles <input ntuple> [<profile> ...]
+//
+// The Events tree is rewritten with each profile (all profiles if none is given), printing the
+// profile report, the write and read throughput of the whole tree and the write time of each
+// branch written on its own. Files are written to the working directory and removed afterwards.
+//
+
+#include "BaconProd/Utils/interface/OutputProfile.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TBranch.h>
+#include <TObjArray.h>
+#include <TStopwatch.h>
+#include <TSystem.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+using namespace baconhep;
+
+// rewrite the active branches of inTree; returns the fill time and sets the flush/write time
+double writeTree(TTree *inTree, const std::string &profileName, const std::string &filename, double &writeSeconds, bool report) {
+  TFile outFile(filename.c_str(), "RECREATE");
+  TTree *outTree = inTree->CloneTree(0);
+  OutputProfile profile(profileName);
+  profile.apply(outTree);
+
+  double fillSeconds = 0;
+  for(Long64_t ientry=0; ientry<inTree->GetEntries(); ientry++) {
+    inTree->GetEntry(ientry);
+    TStopwatch timer;
+    outTree->Fill();
+    profile.afterFill(outTree);
+    fillSeconds += timer.RealTime();
+  }
+  TStopwatch timer;
+  outFile.Write();
+  writeSeconds = timer.RealTime();
+  if(report) profile.report(outTree, std::cout, fillSeconds);
+  outFile.Close();
+  return fillSeconds;
+}
+
+int main( int argc, char **argv ) {
+  if(argc < 2) {
+    std::cout << "usage: benchmarkOutputProfiles <input ntuple> [<profile> ...]" << std::endl;
+    return 1;
+  }
+
+  TFile *inFile = TFile::Open(argv[1]);
+  if(!inFile || inFile->IsZombie()) { std::cout << "[benchmarkOutputProfiles] " << argv[1] << " not found!" << std::endl; return 1; }
+  TTree *inTree = (TTree*)inFile->Get("Events");
+  if(!inTree) { std::cout << "[benchmarkOutputProfiles] no Events tree in " << argv[1] << std::endl; return 1; }
+
+  std::vector<std::string> profiles;
+  for(int iarg=2; iarg<argc; iarg++) profiles.push_back(argv[iarg]);
+  if(profiles.empty()) profiles = OutputProfile::names();
+
+  std::vector<std::string> branchNames;
+  TObjArray *branches = inTree->GetListOfBranches();
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) branchNames.push_back(branches->UncheckedAt(ibr)->GetName());
+
+  std::cout << std::fixed;
+  for(unsigned int iprof=0; iprof<profiles.size(); iprof++) {
+    const std::string filename = "benchmark_" + profiles[iprof] + ".root";
+
+    //
+    // whole tree
+    //
+    inTree->SetBranchStatus("*", 1);
+    double writeSeconds = 0;
+    const double fillSeconds = writeTree(inTree, profiles[iprof], filename, writeSeconds, true);
+
+    TFile readFile(filename.c_str());
+    TTree *readTree = (TTree*)readFile.Get("Events");
+    TStopwatch readTimer;
+    double readBytes = 0;
+    for(Long64_t ientry=0; ientry<readTree->GetEntries(); ientry++) readBytes += readTree->GetEntry(ientry);
+    const double readSeconds = readTimer.RealTime();
+    const Long64_t readEntries = readTree->GetEntries();
+    const Long64_t fileSize    = readFile.GetSize();
+    readFile.Close();
+
+    std::cout << "[benchmarkOutputProfiles] " << profiles[iprof] << ": file " << std::setprecision(1) << fileSize/1e6 << " MB"
+              << ", write " << std::setprecision(2) << fillSeconds+writeSeconds << " s"
+              << " (" << std::setprecision(1) << inTree->GetEntries()/(fillSeconds+writeSeconds) << " entries/s)"
+              << ", read " << std::setprecision(2) << readSeconds << " s"
+              << " (" << std::setprecision(1) << readEntries/readSeconds << " entries/s, " << readBytes/1e6/readSeconds << " MB/s)" << std::endl;
+
+    //
+    // each branch on its own
+    //
+    std::cout << "  write time per branch:" << std::endl;
+    for(unsigned int ibr=0; ibr<branchNames.size(); ibr++) {
+      inTree->SetBranchStatus("*", 0);
+      inTree->SetBranchStatus((branchNames[ibr]+"*").c_str(), 1);
+      double branchWriteSeconds = 0;
+      const double branchFillSeconds = writeTree(inTree, profiles[iprof], filename, branchWriteSeconds, false);
+      std::cout << "    " << std::left << std::setw(16) << branchNames[ibr] << std::right
+                << std::setw(10) << std::setprecision(3) << branchFillSeconds+branchWriteSeconds << " s" << std::endl;
+    }
+    gSystem->Unlink(filename.c_str());
+  }
+  inTree->SetBranchStatus("*", 1);
+  inFile->Close();
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+//
+// Measure the bytes read per entry for a collection with and without a projection
+//
+//   benchmarkProjection <input ntuple> <collection> <class> "<members>"
+//
+// e.g. benchmarkProjection ntuple.root Jet05 baconhep::TJet "pt eta phi mass csv"
+// The collection is read in full, then with only the given members, through CollectionReader
+// (classic or columnar files). Each pass opens the file anew, so that no basket read by the first
+// pass is reused by the second, and reports the bytes read from the file (TFile::GetBytesRead,
+// compressed), the bytes unzipped into the branches (TTree::GetEntry) and the read time. Files the
+// operating system still caches read faster in the second pass, so compare the times of cold reads.
+// The projected pass runs in check mode, which also exercises the poisoning of the other members.
+//
+
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TClonesArray.h>
+#include <TStopwatch.h>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+using namespace baconhep;
+
+struct Pass {
+  Long64_t nEntries;
+  Long64_t nObjects;
+  double   fileBytes;   // read from the file
+  double   treeBytes;   // unzipped into the branches
+  double   seconds;
+};
+
+// open the file and read all entries of the collection; false if the file or tree is missing
+bool readCollection(const char *filename, const std::string &name, const std::string &className, const std::string &members,
+                    Pass &pass) {
+  TFile *file = TFile::Open(filename);
+  if(!file || file->IsZombie()) { std::cout << "[benchmarkProjection] " << filename << " not found!" << std::endl; return false; }
+  TTree *tree = (TTree*)file->Get("Events");
+  if(!tree) { std::cout << "[benchmarkProjection] no Events tree in " << filename << std::endl; return false; }
+
+  CollectionReader reader(tree, name, className.c_str());
+  if(!members.empty()) reader.project(members);
+  const Long64_t bytesBefore = file->GetBytesRead();
+  TStopwatch timer;
+  pass.nEntries  = tree->GetEntries();
+  pass.nObjects  = 0;
+  pass.treeBytes = 0;
+  for(Long64_t ientry=0; ientry<pass.nEntries; ientry++) {
+    pass.treeBytes += reader.getEntry(ientry);
+    pass.nObjects  += reader.array()->GetEntriesFast();
+  }
+  pass.seconds   = timer.RealTime();
+  pass.fileBytes = file->GetBytesRead() - bytesBefore;
+  file->Close();
+  delete file;
+  return true;
+}
+
+int main( int argc, char **argv ) {
+  if(argc < 5) {
+    std::cout << "usage: benchmarkProjection <input ntuple> <collection> <class> \"<members>\"" << std::endl;
+    return 1;
+  }
+  const std::string name      = argv[2];
+  const std::string className = argv[3];
+  const std::string members   = argv[4];
+
+  Pass full, proj;
+  if(!readCollection(argv[1], name, className, "", full)) return 1;
+  if(full.nEntries == 0) { std::cout << "[benchmarkProjection] no entries in " << argv[1] << std::endl; return 1; }
+  CollectionReader::checkProjections(true);
+  if(!readCollection(argv[1], name, className, members, proj)) return 1;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "[benchmarkProjection] " << name << ": " << full.nEntries << " entries, " << full.nObjects << " objects" << std::endl;
+  std::cout << "  all members: " << std::setw(10) << full.fileBytes/full.nEntries << " bytes/entry read, " << std::setw(10) << full.treeBytes/full.nEntries
+            << " unzipped, " << std::setprecision(3) << full.seconds << " s" << std::endl;
+  std::cout << std::setprecision(1)
+            << "  projection:  " << std::setw(10) << proj.fileBytes/proj.nEntries << " bytes/entry read, " << std::setw(10) << proj.treeBytes/proj.nEntries
+            << " unzipped, " << std::setprecision(3) << proj.seconds << " s" << std::endl;
+  std::cout << std::setprecision(1)
+            << "  projection reads " << (full.fileBytes > 0 ? 100*proj.fileBytes/full.fileBytes : 0) << "% of the bytes from the file and unzips "
+            << (full.treeBytes > 0 ? 100*proj.treeBytes/full.treeBytes : 0) << "%" << std::endl;
+
+  return (proj.nObjects == full.nObjects) ? 0 : 1;
+}
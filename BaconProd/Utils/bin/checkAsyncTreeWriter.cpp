@@ -0,0 +1,165 @@
+//
+// Compare the output of AsyncTreeWriter in asynchronous and synchronous mode
+//
+//   checkAsyncTreeWriter [<number of events>] [<seed>]
+//
+// Writes the same random events (event info, an electron array and a columnar muon array, some
+// of them empty) with a synchronous and an asynchronous writer, to checkAsyncTreeWriter_sync.root
+// and checkAsyncTreeWriter_async.root, with small baskets so that they are flushed often. The event
+// loop does what NtuplerMod does: it reads an input tree on the main thread, as the framework reads
+// the next event, and fills the output objects while the previous entry is written, checking that
+// the current directory and file stay the ones it set. The time the writer spent filling and the
+// time fill() waited for it are printed: their difference is the writing that overlapped with the
+// event loop. The files are read back and compared entry by entry, object by object (see
+// DeterminismCheck), and removed. Returns 1 on any difference.
+//
+
+#include "BaconProd/Utils/interface/AsyncTreeWriter.hh"
+#include "BaconProd/Utils/interface/DeterminismCheck.hh"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/TEventInfo.hh"
+#include "BaconAna/DataFormats/interface/TElectron.hh"
+#include "BaconAna/DataFormats/interface/TMuon.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TClonesArray.h>
+#include <TRandom3.h>
+#include <TSystem.h>
+#include <TStopwatch.h>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+using namespace baconhep;
+
+const char *kInputName = "checkAsyncTreeWriter_input.root";
+
+// the tree the main thread reads between events, as the framework does
+void writeInput(const int nEntries) {
+  TFile file(kInputName, "RECREATE");
+  TTree tree("Input", "Input");
+  double value = 0;
+  tree.Branch("value", &value, "value/D");
+  for(int ientry=0; ientry<nEntries; ientry++) { value = ientry; tree.Fill(); }
+  tree.Write();
+  file.Close();
+}
+
+// returns the number of events in which the main thread found another current directory or file
+unsigned int writeEvents(const std::string &filename, const bool async, const int nEvents, const unsigned int seed) {
+  TFile input(kInputName);
+  TTree *inputTree = (TTree*)input.Get("Input");
+  double value = 0;
+  inputTree->SetBranchAddress("value", &value);
+
+  TFile output(filename.c_str(), "RECREATE");
+  TTree *tree = new TTree("Events", "Events");
+  TEventInfo   *info    = new TEventInfo();
+  TClonesArray *eleArr  = new TClonesArray("baconhep::TElectron");
+  TClonesArray *muonArr = new TClonesArray("baconhep::TMuon");
+
+  unsigned int nMoved = 0;
+  TStopwatch timer;
+  {
+    AsyncTreeWriter writer(tree, async);
+    writer.addBranch ("Info",     info);
+    writer.addBranch ("Electron", eleArr);
+    writer.addColumns("Muon",     muonArr);
+    tree->SetBasketSize("*", 2000);
+    tree->SetAutoFlush(20);
+
+    TRandom3 rng(seed);
+    for(int ievent=0; ievent<nEvents; ievent++) {
+      output.cd();
+      inputTree->GetEntry(ievent % inputTree->GetEntries());
+      bool moved = (gDirectory != &output || gFile != &output);
+      info->runNum = 1;
+      info->evtNum = ievent;
+      if(ievent % 7 == 0) info->lumiSec = ievent/7;   // kept in the other events
+      info->rhoIso = value;
+      eleArr->Clear();
+      const int nEle = (ievent % 5 == 0) ? 0 : rng.Integer(8);
+      for(int iobj=0; iobj<nEle; iobj++) {
+        TElectron *ele = new((*eleArr)[iobj]) TElectron();
+        ele->pt  = rng.Exp(30.);
+        ele->eta = rng.Uniform(-2.5, 2.5);
+        ele->phi = rng.Uniform(-3.14, 3.14);
+        ele->q   = rng.Integer(2) ? 1 : -1;
+      }
+      muonArr->Clear();
+      const int nMuon = (ievent % 3 == 0) ? 0 : rng.Integer(6);
+      for(int iobj=0; iobj<nMuon; iobj++) {
+        TMuon *muon = new((*muonArr)[iobj]) TMuon();
+        muon->pt  = rng.Exp(30.);
+        muon->eta = rng.Uniform(-2.4, 2.4);
+        muon->phi = rng.Uniform(-3.14, 3.14);
+      }
+      moved = moved || gDirectory != &output || gFile != &output;
+      if(moved) nMoved++;
+
+      writer.fill();
+    }
+    writer.finish();
+    std::cout << "[checkAsyncTreeWriter] " << (async ? "async" : "sync ") << ": " << timer.RealTime() << " s, "
+              << writer.fillSeconds() << " s filling, " << writer.waitSeconds() << " s waiting, "
+              << (async ? writer.fillSeconds()-writer.waitSeconds() : 0.) << " s overlapped" << std::endl;
+  }
+  output.cd();
+  tree->Write();
+  output.Close();
+  input.Close();
+  delete info;
+  delete eleArr;
+  delete muonArr;
+  return nMoved;
+}
+
+int main( int argc, char **argv ) {
+  const int          nEvents = (argc > 1) ? atoi(argv[1]) : 5000;
+  const unsigned int seed    = (argc > 2) ? atoi(argv[2]) : 4357;
+  const std::string syncName  = "checkAsyncTreeWriter_sync.root";
+  const std::string asyncName = "checkAsyncTreeWriter_async.root";
+
+  writeInput(100);
+  const unsigned int nMovedSync  = writeEvents(syncName,  false, nEvents, seed);
+  const unsigned int nMovedAsync = writeEvents(asyncName, true,  nEvents, seed);
+  bool ok = true;
+  if(nMovedSync > 0 || nMovedAsync > 0) {
+    std::cout << "[checkAsyncTreeWriter] current directory or file changed under the main thread in "
+              << nMovedSync << " (sync) and " << nMovedAsync << " (async) events!" << std::endl;
+    ok = false;
+  }
+
+  TFile fileA(syncName.c_str()), fileB(asyncName.c_str());
+  TTree *treeA = (TTree*)fileA.Get("Events");
+  TTree *treeB = (TTree*)fileB.Get("Events");
+  if(!treeA || !treeB || treeA->GetEntries() != nEvents || treeB->GetEntries() != nEvents) {
+    std::cout << "[checkAsyncTreeWriter] expected " << nEvents << " entries in both files!" << std::endl;
+    return 1;
+  }
+  TEventInfo *infoA = new TEventInfo(), *infoB = new TEventInfo();
+  treeA->SetBranchAddress("Info", &infoA);
+  treeB->SetBranchAddress("Info", &infoB);
+  CollectionReader eleA (treeA, "Electron", "baconhep::TElectron"), eleB (treeB, "Electron", "baconhep::TElectron");
+  CollectionReader muonA(treeA, "Muon",     "baconhep::TMuon"),     muonB(treeB, "Muon",     "baconhep::TMuon");
+
+  DeterminismCheck check;
+  for(int ientry=0; ientry<nEvents && check.nDifferences() < 10; ientry++) {
+    treeA->GetBranch("Info")->GetEntry(ientry);
+    treeB->GetBranch("Info")->GetEntry(ientry);
+    eleA.getEntry(ientry);  eleB.getEntry(ientry);
+    muonA.getEntry(ientry); muonB.getEntry(ientry);
+    check.compare("Info",     TEventInfo::Class(), infoA, infoB);
+    check.compare("Electron", *eleA.array(),  *eleB.array());
+    check.compare("Muon",     *muonA.array(), *muonB.array());
+  }
+  check.report(std::cout);
+  fileA.Close();
+  fileB.Close();
+  gSystem->Unlink(kInputName);
+  gSystem->Unlink(syncName.c_str());
+  gSystem->Unlink(asyncName.c_str());
+
+  ok = ok && check.nDifferences() == 0;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+//
+// Check that tasks run on the TaskScheduler pool fill what they fill in sequence
+//
+//   checkTaskScheduler [<number of events>] [<thread counts, comma separated>]
+//
+// Runs for every event tasks shaped like the NtuplerMod fillers: tasks filling their own arrays
+// (electrons, muons) and tasks reading them (one per jet cone, counting the leptons in the jet),
+// with one thread and with each of the given thread counts (2,3,8 by default), on one scheduler
+// whose workers are kept between events. The arrays of the concurrent runs are preallocated (see
+// TaskScheduler::preallocate) and filled without any lock. Every event is compared object by
+// object with the sequential filling (see DeterminismCheck). In every tenth event one more task
+// throws, and the exception must reach the caller. Returns 1 on any failure.
+//
+
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
+#include "BaconProd/Utils/interface/DeterminismCheck.hh"
+#include "BaconAna/DataFormats/interface/TElectron.hh"
+#include "BaconAna/DataFormats/interface/TMuon.hh"
+#include "BaconAna/DataFormats/interface/TJet.hh"
+#include <TClonesArray.h>
+#include <TMath.h>
+#include <TVector2.h>
+#include <boost/bind.hpp>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+using namespace baconhep;
+
+const int kNCones = 4;
+
+// the outputs of an event
+struct Outputs {
+  TClonesArray *ele, *muon;
+  TClonesArray *jet[kNCones];
+};
+
+// random numbers of a task in an event, the same whatever thread runs it
+class TaskRandom {
+  public:
+    TaskRandom(const int ievent, const int itask):fState(2654435761u*(ievent+1) + 40503u*(itask+1)) {}
+    double uniform() {
+      fState = fState*6364136223846793005ULL + 1442695040888963407ULL;
+      return (fState >> 11)*(1.0/9007199254740992.0);
+    }
+    int integer(const int n) { return int(uniform()*n); }
+  protected:
+    unsigned long long fState;
+};
+
+// some work per object, so that the tasks overlap
+float work(const float x) {
+  float sum = 0;
+  for(int i=0; i<2000; i++) sum += TMath::Sin(x+i);
+  return sum;
+}
+
+void fillElectrons(TClonesArray *array, const int ievent) {
+  TaskRandom rng(ievent, 0);
+  array->Clear();
+  const int n = rng.integer(8);
+  for(int iobj=0; iobj<n; iobj++) {
+    TElectron *ele = new((*array)[iobj]) TElectron();
+    ele->pt      = 20./(0.01+rng.uniform());
+    ele->eta     = 5*rng.uniform()-2.5;
+    ele->phi     = TMath::TwoPi()*rng.uniform()-TMath::Pi();
+    ele->q       = rng.integer(2) ? 1 : -1;
+    ele->mva     = work(ele->pt);
+  }
+}
+
+void fillMuons(TClonesArray *array, const int ievent) {
+  TaskRandom rng(ievent, 1);
+  array->Clear();
+  const int n = rng.integer(6);
+  for(int iobj=0; iobj<n; iobj++) {
+    TMuon *muon = new((*array)[iobj]) TMuon();
+    muon->pt     = 20./(0.01+rng.uniform());
+    muon->eta    = 4.8*rng.uniform()-2.4;
+    muon->phi    = TMath::TwoPi()*rng.uniform()-TMath::Pi();
+    muon->q      = rng.integer(2) ? 1 : -1;
+    muon->chHadIso04 = work(muon->pt);
+  }
+}
+
+template<class T> unsigned int nInCone(const TClonesArray *array, const TJet *jet, const double cone) {
+  unsigned int n = 0;
+  for(int iobj=0; iobj<array->GetEntriesFast(); iobj++) {
+    const T *obj = (const T*)array->At(iobj);
+    const double dPhi = TVector2::Phi_mpi_pi(obj->phi - jet->phi);
+    if(TMath::Sqrt((obj->eta-jet->eta)*(obj->eta-jet->eta) + dPhi*dPhi) < cone) n++;
+  }
+  return n;
+}
+
+void fillJets(TClonesArray *array, const TClonesArray *eleArr, const TClonesArray *muonArr, const int icone, const int ievent) {
+  TaskRandom rng(ievent, 2+icone);
+  const double cone = 0.4 + 0.1*icone;
+  array->Clear();
+  const int n = rng.integer(12);
+  for(int iobj=0; iobj<n; iobj++) {
+    TJet *jet = new((*array)[iobj]) TJet();
+    jet->pt         = 30./(0.01+rng.uniform());
+    jet->eta        = 6*rng.uniform()-3;
+    jet->phi        = TMath::TwoPi()*rng.uniform()-TMath::Pi();
+    jet->area       = work(jet->pt);
+    jet->nCharged   = nInCone<TElectron>(eleArr, jet, cone) + nInCone<TMuon>(muonArr, jet, cone);
+    jet->nParticles = jet->nCharged;
+  }
+}
+
+void fail() {
+  throw std::runtime_error("task failed");
+}
+
+void addTasks(TaskScheduler &scheduler, const Outputs &out, const int ievent, const bool withFailure) {
+  scheduler.clear();
+  scheduler.addTask("Electron", boost::bind(&fillElectrons, out.ele,  ievent), "", "Electron");
+  scheduler.addTask("Muon",     boost::bind(&fillMuons,     out.muon, ievent), "", "Muon");
+  for(int icone=0; icone<kNCones; icone++) {
+    std::stringstream name; name << "Jet" << icone;
+    scheduler.addTask(name.str(), boost::bind(&fillJets, out.jet[icone], out.ele, out.muon, icone, ievent), "Electron,Muon", name.str());
+  }
+  if(withFailure) scheduler.addTask("Fail", &fail, "Muon", "Fail");
+}
+
+Outputs createOutputs(const bool preallocate) {
+  Outputs out;
+  out.ele  = new TClonesArray("baconhep::TElectron");
+  out.muon = new TClonesArray("baconhep::TMuon");
+  for(int icone=0; icone<kNCones; icone++) out.jet[icone] = new TClonesArray("baconhep::TJet");
+  if(preallocate) {
+    TaskScheduler::preallocate(out.ele);
+    TaskScheduler::preallocate(out.muon);
+    for(int icone=0; icone<kNCones; icone++) TaskScheduler::preallocate(out.jet[icone]);
+  }
+  return out;
+}
+
+void deleteOutputs(Outputs &out) {
+  delete out.ele;
+  delete out.muon;
+  for(int icone=0; icone<kNCones; icone++) delete out.jet[icone];
+}
+
+int main( int argc, char **argv ) {
+  const int nEvents = (argc > 1) ? atoi(argv[1]) : 500;
+  std::vector<int> threads;
+  std::stringstream ss((argc > 2) ? argv[2] : "2,3,8");
+  std::string field;
+  while(std::getline(ss, field, ',')) threads.push_back(atoi(field.c_str()));
+
+  TaskScheduler serial, pool;
+  Outputs reference = createOutputs(false);
+  Outputs output    = createOutputs(true);
+  DeterminismCheck check;
+  unsigned int nMissed = 0;
+
+  for(unsigned int irun=0; irun<threads.size(); irun++) {
+    for(int ievent=0; ievent<nEvents; ievent++) {
+      const bool withFailure = (ievent % 10 == 9);
+      addTasks(serial, reference, ievent, false);
+      serial.run(1);
+      addTasks(pool, output, ievent, withFailure);
+      bool thrown = false;
+      try {
+        pool.run(threads[irun]);
+      } catch(std::runtime_error&) {
+        thrown = true;
+      }
+      if(thrown != withFailure) nMissed++;
+      if(withFailure) continue;   // the other tasks may not have run
+
+      check.compare("Electron", *reference.ele,  *output.ele);
+      check.compare("Muon",     *reference.muon, *output.muon);
+      for(int icone=0; icone<kNCones; icone++) {
+        std::stringstream name; name << "Jet" << icone;
+        check.compare(name.str(), *reference.jet[icone], *output.jet[icone]);
+      }
+    }
+    std::cout << "[checkTaskScheduler] " << threads[irun] << " threads: " << nEvents << " events run" << std::endl;
+  }
+  check.report(std::cout);
+  if(nMissed > 0) std::cout << "[checkTaskScheduler] the exception of a task was lost or made up in " << nMissed << " events!" << std::endl;
+
+  deleteOutputs(reference);
+  deleteOutputs(output);
+
+  const bool ok = check.nDifferences() == 0 && nMissed == 0;
+  std::cout << "[checkTaskScheduler] " << (ok ? "all runs filled the outputs of the sequential run" : "FAILED") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+//
+// Compare BDTForest with TMVA::Reader on the same inputs
+//
+//   compareBDTForest [<weight file> ...]
+//
+// Without arguments the QG weights (BaconProd/Utils/data/QG.weights.xml, multiclass with gradient
+// boosting) are compared as they are and in three variants written to the working directory and
+// removed afterwards: classification with gradient boosting (sigmoid output), and classification
+// with AdaBoost, uneven tree weights and purity or yes/no leaves (weighted average output), or
+// with the tree weights ignored (UseWeightedTrees False, plain average). Other
+// weight files, e.g. the jet PU ID ones, are compared as they are; files BDTForest cannot evaluate
+// are reported, since the calculators keep TMVA::Reader for them.
+//
+// Half of the input values are set exactly to a cut of the variable, so that ties (x == cut) test
+// the direction of each node. Returns 1 if any output differs from TMVA in any bit.
+//
+
+#include "BaconProd/Utils/interface/BDTForest.hh"
+#include "TMVA/Reader.h"
+#include <TRandom3.h>
+#include <TSystem.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+using namespace baconhep;
+
+const std::string kMethod = "BDT";
+
+std::string readFile(const std::string &filename) {
+  std::ifstream ifs(filename.c_str());
+  std::stringstream buffer;
+  buffer << ifs.rdbuf();
+  return buffer.str();
+}
+
+void writeFile(const std::string &filename, const std::string &text) {
+  std::ofstream ofs(filename.c_str());
+  ofs << text;
+}
+
+// value of an attribute of a tag starting at pos
+std::string attr(const std::string &xml, const size_t pos, const std::string &name) {
+  const size_t end = xml.find('>', pos);
+  size_t begin = xml.find(" " + name + "=\"", pos);
+  if(begin == std::string::npos || begin > end) return "";
+  begin += name.length() + 3;
+  return xml.substr(begin, xml.find('"', begin) - begin);
+}
+
+// replace the value of an attribute in a line holding one tag
+std::string setAttr(std::string line, const std::string &name, const std::string &value) {
+  const std::string key = " " + name + "=\"";
+  const size_t pos = line.find(key);
+  if(pos == std::string::npos) return line;
+  const size_t begin = pos + key.length();
+  return line.replace(begin, line.find('"', begin) - begin, value);
+}
+
+// replace the text of an <Option name="..."> line
+std::string setOption(std::string line, const std::string &value) {
+  const size_t begin = line.find('>') + 1;
+  return line.replace(begin, line.find('<', begin) - begin, value);
+}
+
+//
+// Variants of a multiclass gradient boosting file (TMVA writes one tag per line): two-class
+// classification (Signal and Background, one output), with gradient boosting or with AdaBoost on
+// classification trees, a different weight for each tree and purity or yes/no leaves, and the
+// weights used or not
+//
+enum Variant { kGrad, kAdaBoost, kAdaBoostYesNo, kAdaBoostUnweighted };
+std::string makeVariant(const std::string &xml, const Variant variant) {
+  const bool adaBoost = (variant != kGrad);
+  std::stringstream in(xml), out;
+  std::string line;
+  int itree = 0;
+  bool inClasses = false;
+  while(std::getline(in, line)) {
+    if(line.find("<Info name=\"AnalysisType\"") != std::string::npos) {
+      line = setAttr(line, "value", "Classification");
+    } else if(line.find("<Classes") != std::string::npos) {
+      out << "  <Classes NClass=\"2\">\n    <Class Name=\"Signal\" Index=\"0\"/>\n    <Class Name=\"Background\" Index=\"1\"/>\n  </Classes>\n";
+      inClasses = true;
+    } else if(adaBoost && line.find("<Option name=\"BoostType\"") != std::string::npos) {
+      line = setOption(line, "AdaBoost");
+    } else if(adaBoost && line.find("<Option name=\"UseYesNoLeaf\"") != std::string::npos) {
+      line = setOption(line, variant == kAdaBoostYesNo ? "True" : "False");
+    } else if(adaBoost && line.find("<Option name=\"UseWeightedTrees\"") != std::string::npos) {
+      line = setOption(line, variant == kAdaBoostUnweighted ? "False" : "True");
+    } else if(adaBoost && line.find("<Weights ") != std::string::npos) {
+      line = setAttr(line, "AnalysisType", "0");
+    } else if(adaBoost && line.find("<BinaryTree ") != std::string::npos) {
+      std::stringstream weight; weight << 0.25 + 0.1*(itree++ % 17);
+      line = setAttr(line, "boostWeight", weight.str());
+    } else if(variant == kAdaBoostYesNo && line.find("<Node ") != std::string::npos && atoi(attr(line, 0, "IVar").c_str()) < 0) {
+      // regression trees mark their leaves -99: signal (1) and background (-1) leaves by purity
+      line = setAttr(line, "nType", (atof(attr(line, 0, "purity").c_str()) >= 0.5) ? "1" : "-1");
+    }
+    if(!inClasses) out << line << "\n";
+    if(line.find("</Classes>") != std::string::npos) inClasses = false;
+  }
+  return out.str();
+}
+
+// returns the number of outputs that differ, -1 if BDTForest cannot evaluate the file
+int compare(const std::string &label, const std::string &filename, const unsigned int nRows, TRandom3 &rng) {
+  BDTForest forest;
+  if(!forest.initialize(filename)) {
+    std::cout << "[compareBDTForest] " << label << ": not evaluated by BDTForest, TMVA::Reader is kept" << std::endl;
+    return -1;
+  }
+
+  //
+  // Variables, spectators and the cut values of each variable, in file order
+  //
+  const std::string xml = readFile(filename);
+  std::vector<std::string> names, spectators;
+  std::vector<float> minVal, maxVal;
+  size_t pos = 0;
+  while((pos = xml.find("<Variable ", pos)) != std::string::npos) {
+    names .push_back(attr(xml, pos, "Expression"));
+    minVal.push_back(atof(attr(xml, pos, "Min").c_str()));
+    maxVal.push_back(atof(attr(xml, pos, "Max").c_str()));
+    pos++;
+  }
+  pos = 0;
+  while((pos = xml.find("<Spectator ", pos)) != std::string::npos) spectators.push_back(attr(xml, pos++, "Expression"));
+  std::vector<std::vector<float> > cuts(names.size());
+  pos = 0;
+  while((pos = xml.find("<Node ", pos)) != std::string::npos) {
+    const int ivar = atoi(attr(xml, pos, "IVar").c_str());
+    if(ivar >= 0 && ivar < (int)names.size()) cuts[ivar].push_back(atof(attr(xml, pos, "Cut").c_str()));
+    pos++;
+  }
+
+  std::vector<float> vars(names.size()), spec(spectators.size());
+  TMVA::Reader reader("!Color:Silent");
+  for(unsigned int ivar=0; ivar<names.size(); ivar++) reader.AddVariable(names[ivar], &vars[ivar]);
+  for(unsigned int ispec=0; ispec<spectators.size(); ispec++) reader.AddSpectator(spectators[ispec], &spec[ispec]);
+  reader.BookMVA(kMethod, filename);
+
+  std::vector<int> column(names.size());
+  for(unsigned int ivar=0; ivar<names.size(); ivar++) column[ivar] = forest.varIndex(names[ivar]);
+
+  int nDiff = 0;
+  unsigned int nTies = 0;
+  std::vector<float> row(forest.nVars()), out(forest.nOutputs());
+  for(unsigned int irow=0; irow<nRows; irow++) {
+    for(unsigned int ivar=0; ivar<names.size(); ivar++) {
+      const bool tie = !cuts[ivar].empty() && rng.Integer(2);
+      vars[ivar] = tie ? cuts[ivar][rng.Integer(cuts[ivar].size())] : rng.Uniform(minVal[ivar], maxVal[ivar]);
+      row[column[ivar]] = vars[ivar];
+      if(tie) nTies++;
+    }
+    forest.evaluate(&row[0], 1, &out[0]);
+
+    std::vector<float> expected;
+    if(forest.nOutputs() > 1) expected = reader.EvaluateMulticlass(kMethod);
+    else                      expected.push_back(reader.EvaluateMVA(kMethod));
+    for(unsigned int iout=0; iout<out.size(); iout++) {
+      if(iout < expected.size() && out[iout] == expected[iout]) continue;
+      if(nDiff < 10) std::cout << "[compareBDTForest] " << label << ": input " << irow << " output " << iout << ": BDTForest " << out[iout]
+                               << ", TMVA " << (iout < expected.size() ? expected[iout] : -999) << std::endl;
+      nDiff++;
+    }
+  }
+  std::cout << "[compareBDTForest] " << label << ": " << nRows << " inputs (" << nTies << " values on a cut), "
+            << forest.nOutputs() << " outputs each, " << nDiff << " differences" << std::endl;
+  return nDiff;
+}
+
+int main( int argc, char **argv ) {
+  const unsigned int kNRows = 2000;
+  TRandom3 rng(4357);
+
+  std::vector<std::string> labels, files, written;
+  if(argc > 1) {
+    for(int iarg=1; iarg<argc; iarg++) { labels.push_back(argv[iarg]); files.push_back(argv[iarg]); }
+  } else {
+    if(!getenv("CMSSW_BASE")) { std::cout << "[compareBDTForest] CMSSW_BASE is not set!" << std::endl; return 1; }
+    const std::string qg = std::string(getenv("CMSSW_BASE")) + "/src/BaconProd/Utils/data/QG.weights.xml";
+    const std::string xml = readFile(qg);
+    labels.push_back("QG multiclass Grad");           files.push_back(qg);
+    labels.push_back("QG classification Grad");       files.push_back("compareBDTForest_Grad.weights.xml");
+    labels.push_back("QG AdaBoost purity leaves");    files.push_back("compareBDTForest_AdaBoost.weights.xml");
+    labels.push_back("QG AdaBoost yes/no leaves");    files.push_back("compareBDTForest_AdaBoostYesNo.weights.xml");
+    labels.push_back("QG AdaBoost unweighted trees"); files.push_back("compareBDTForest_AdaBoostUnweighted.weights.xml");
+    writeFile(files[1], makeVariant(xml, kGrad));
+    writeFile(files[2], makeVariant(xml, kAdaBoost));
+    writeFile(files[3], makeVariant(xml, kAdaBoostYesNo));
+    writeFile(files[4], makeVariant(xml, kAdaBoostUnweighted));
+    written.assign(files.begin()+1, files.end());
+  }
+
+  int nDiff = 0;
+  for(unsigned int ifile=0; ifile<files.size(); ifile++) {
+    const int n = compare(labels[ifile], files[ifile], kNRows, rng);
+    if(n > 0) nDiff += n;
+  }
+  for(unsigned int ifile=0; ifile<written.size(); ifile++) gSystem->Unlink(written[ifile].c_str());
+
+  return nDiff > 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+//
+// Compile calibration text files into a binary bundle for CalibrationRegistry::loadBundle
+//
+//   compileCalibBundle <output bundle> <file> [<file> ...]
+//
+// The kind of each file follows from its extension (.txt: JEC, .xml: TMVA BDT, .csv: interval-binned
+// correction table) or from a "jec:", "bdt:" or "corr:" prefix. Weight files that BDTForest cannot evaluate are skipped.
+// The written bundle is read back and each payload compared with its parsed text file.
+// Give the files with the paths the configuration opens them by: a source of the same path, size
+// and modification time is then not read again to find its payload.
+//
+
+#include "BaconProd/Utils/interface/CalibrationBundle.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace baconhep;
+
+unsigned int kindOf(std::string &arg) {
+  const std::string prefixes[] = { "jec:", "bdt:", "corr:" };
+  const unsigned int kinds[]   = { CalibrationBundle::kJetCorrectorParameters, CalibrationBundle::kBDTForest,
+                                   CalibrationBundle::kCorrectionTable };
+  for(unsigned int i=0; i<3; i++) {
+    if(arg.compare(0, prefixes[i].size(), prefixes[i]) == 0) {
+      arg = arg.substr(prefixes[i].size());
+      return kinds[i];
+    }
+  }
+  const std::string ext = (arg.rfind('.') == std::string::npos) ? "" : arg.substr(arg.rfind('.'));
+  if(ext == ".txt") return CalibrationBundle::kJetCorrectorParameters;
+  if(ext == ".xml") return CalibrationBundle::kBDTForest;
+  if(ext == ".csv") return CalibrationBundle::kCorrectionTable;
+  return 0;
+}
+
+int main( int argc, char **argv ) {
+  if(argc < 3) {
+    std::cout << "usage: compileCalibBundle <output bundle> <file> [<file> ...]" << std::endl;
+    return 1;
+  }
+
+  std::vector<CalibrationBundle::Entry> entries;
+  for(int iarg=2; iarg<argc; iarg++) {
+    std::string filename = argv[iarg];
+    const unsigned int kind = kindOf(filename);
+    if(kind == 0) {
+      std::cout << "[compileCalibBundle] unknown kind of " << filename << std::endl;
+      return 1;
+    }
+
+    CalibrationBundle::Entry entry;
+    entry.kind   = kind;
+    entry.source = filename;
+    if(!CalibrationRegistry::compile(kind, filename, entry.payload)) {
+      std::cout << "[compileCalibBundle] skipping " << filename << " (not supported)" << std::endl;
+      continue;
+    }
+    if(!CalibrationBundle::fileStamp(filename, entry.stamp)) {
+      std::cout << "[compileCalibBundle] cannot stat " << filename << std::endl;
+      return 1;
+    }
+    entry.hash = CalibrationBundle::contentHash(filename);
+    entries.push_back(entry);
+    std::cout << "[compileCalibBundle] " << filename << ": " << entry.payload.size() << " bytes" << std::endl;
+  }
+
+  if(!CalibrationBundle::write(argv[1], entries)) {
+    std::cout << "[compileCalibBundle] cannot write " << argv[1] << std::endl;
+    return 1;
+  }
+  std::cout << "[compileCalibBundle] " << entries.size() << " entries written to " << argv[1] << std::endl;
+
+  // read the bundle back and compare each payload with its parsed text file
+  CalibrationBundle bundle;
+  if(!bundle.open(argv[1]) || bundle.nEntries() != entries.size()) {
+    std::cout << "[compileCalibBundle] cannot read back " << argv[1] << std::endl;
+    return 1;
+  }
+  for(unsigned int ientry=0; ientry<entries.size(); ientry++) {
+    const CalibrationBundle::Entry &entry = entries[ientry];
+    unsigned long long size = 0;
+    const char *data = bundle.find(entry.kind, entry.hash, size);
+    unsigned long long hash = 0;
+    if(!data || !bundle.sourceHash(entry.source, entry.stamp, hash) || hash != entry.hash ||
+       !CalibrationRegistry::verify(entry.kind, entry.source, data, size)) {
+      std::cout << "[compileCalibBundle] " << entry.source << " does not read back from " << argv[1] << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "[compileCalibBundle] " << entries.size() << " entries read back and checked" << std::endl;
+  return 0;
+}
@@ -0,0 +1,139 @@
+//
+// Convert a Bacon ntuple to the columnar output format and check the conversion
+//
+//   convertColumnar <input ntuple> <output ntuple>
+//
+// The object arrays of the Events tree are written as columns (see ColumnarCollection), the
+// other branches and the lumi summary as they are. The output is then read back through
+// CollectionReader and every object is compared member by member with the input; the job fails
+// on any difference, and when a data member of a class has no column (it would be lost).
+//
+
+#include "BaconAna/DataFormats/interface/ColumnarCollection.hh"
+#include "BaconAna/DataFormats/interface/CollectionReader.hh"
+#include "BaconAna/DataFormats/interface/LumiSummary.hh"
+#include <TFile.h>
+#include <TTree.h>
+#include <TBranchElement.h>
+#include <TClonesArray.h>
+#include <TObjArray.h>
+#include <TStopwatch.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+using namespace baconhep;
+
+struct Collection {
+  std::string   name;
+  std::string   className;
+  TClonesArray *array;     // classic input
+};
+
+// read all entries of a tree, returning the bytes read per second
+double readRate(TTree *tree) {
+  TStopwatch timer;
+  double bytes = 0;
+  for(Long64_t ientry=0; ientry<tree->GetEntries(); ientry++) bytes += tree->GetEntry(ientry);
+  return bytes/timer.RealTime();
+}
+
+int main( int argc, char **argv ) {
+  if(argc < 3) {
+    std::cout << "usage: convertColumnar <input ntuple> <output ntuple>" << std::endl;
+    return 1;
+  }
+
+  TFile *inFile = TFile::Open(argv[1]);
+  if(!inFile || inFile->IsZombie()) { std::cout << "[convertColumnar] " << argv[1] << " not found!" << std::endl; return 1; }
+  TTree *inTree = (TTree*)inFile->Get("Events");
+  if(!inTree) { std::cout << "[convertColumnar] no Events tree in " << argv[1] << std::endl; return 1; }
+
+  std::vector<Collection> collections;
+  TObjArray *branches = inTree->GetListOfBranches();
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) {
+    TBranchElement *branch = dynamic_cast<TBranchElement*>(branches->UncheckedAt(ibr));
+    if(!branch || std::string(branch->GetClonesName()).empty()) continue;
+    Collection coll;
+    coll.name      = branch->GetName();
+    coll.className = branch->GetClonesName();
+    coll.array     = new TClonesArray(coll.className.c_str());
+    inTree->SetBranchAddress(coll.name.c_str(), &coll.array);
+    collections.push_back(coll);
+  }
+
+  //
+  // write: the other branches are cloned, the arrays gathered into columns
+  //
+  TFile outFile(argv[2], "RECREATE");
+  for(unsigned int icoll=0; icoll<collections.size(); icoll++) inTree->SetBranchStatus((collections[icoll].name+"*").c_str(), 0);
+  TTree *outTree = inTree->CloneTree(0);
+  inTree->SetBranchStatus("*", 1);
+
+  bool complete = true;
+  std::vector<ColumnarCollection*> columns;
+  for(unsigned int icoll=0; icoll<collections.size(); icoll++) {
+    columns.push_back(new ColumnarCollection(collections[icoll].name, collections[icoll].className.c_str()));
+    columns.back()->branch(outTree);
+    const std::vector<std::string> &unstored = columns.back()->unstored();
+    for(unsigned int imem=0; imem<unstored.size(); imem++) {
+      std::cout << "[convertColumnar] " << collections[icoll].className << "::" << unstored[imem] << " has no column!" << std::endl;
+      complete = false;
+    }
+  }
+  for(Long64_t ientry=0; ientry<inTree->GetEntries(); ientry++) {
+    for(unsigned int icoll=0; icoll<collections.size(); icoll++) collections[icoll].array->Clear();
+    inTree->GetEntry(ientry);
+    for(unsigned int icoll=0; icoll<collections.size(); icoll++) columns[icoll]->gather(*collections[icoll].array);
+    outTree->Fill();
+  }
+  LumiSummary lumis;
+  if(lumis.read(inFile)) lumis.write(&outFile);
+  outFile.Write();
+  outFile.Close();
+  for(unsigned int icoll=0; icoll<columns.size(); icoll++) delete columns[icoll];
+
+  //
+  // check: the objects read back from the columns equal the input objects
+  //
+  TFile checkFile(argv[2]);
+  TTree *checkTree = (TTree*)checkFile.Get("Events");
+  std::vector<CollectionReader*> readers;
+  for(unsigned int icoll=0; icoll<collections.size(); icoll++) {
+    readers.push_back(new CollectionReader(checkTree, collections[icoll].name, collections[icoll].className.c_str()));
+  }
+  std::vector<Long64_t> nObjects(collections.size(), 0), nDiffer(collections.size(), 0);
+  for(Long64_t ientry=0; ientry<inTree->GetEntries(); ientry++) {
+    for(unsigned int icoll=0; icoll<collections.size(); icoll++) collections[icoll].array->Clear();
+    inTree->GetEntry(ientry);
+    for(unsigned int icoll=0; icoll<collections.size(); icoll++) {
+      readers[icoll]->getEntry(ientry);
+      const TClonesArray *classic  = collections[icoll].array;
+      const TClonesArray *columnar = readers[icoll]->array();
+      if(classic->GetEntriesFast() != columnar->GetEntriesFast()) { nDiffer[icoll]++; continue; }
+      for(int iobj=0; iobj<classic->GetEntriesFast(); iobj++) {
+        nObjects[icoll]++;
+        if(!readers[icoll]->columns()->sameMembers(classic->UncheckedAt(iobj), columnar->UncheckedAt(iobj))) nDiffer[icoll]++;
+      }
+    }
+  }
+
+  bool same = complete;
+  std::cout << std::fixed;
+  for(unsigned int icoll=0; icoll<collections.size(); icoll++) {
+    std::cout << "[convertColumnar] " << std::left << std::setw(16) << collections[icoll].name << std::right
+              << std::setw(10) << nObjects[icoll] << " objects, " << nDiffer[icoll] << " differ" << std::endl;
+    if(nDiffer[icoll] > 0) same = false;
+  }
+  std::cout << "[convertColumnar] classic "  << std::setprecision(1) << inFile->GetSize()/1e6   << " MB, read at " << readRate(inTree)/1e6    << " MB/s" << std::endl;
+  std::cout << "[convertColumnar] columnar " << std::setprecision(1) << checkFile.GetSize()/1e6 << " MB, read at " << readRate(checkTree)/1e6 << " MB/s" << std::endl;
+
+  // the readers own the buffers checkTree reads into
+  checkTree->ResetBranchAddresses();
+  for(unsigned int icoll=0; icoll<readers.size(); icoll++) delete readers[icoll];
+  checkFile.Close();
+  inFile->Close();
+
+  return same ? 0 : 1;
+}
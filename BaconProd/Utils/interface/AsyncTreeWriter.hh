@@ -0,0 +1,106 @@
+#ifndef BACONPROD_UTILS_ASYNCTREEWRITER_HH
+#define BACONPROD_UTILS_ASYNCTREEWRITER_HH
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <deque>
+
+// forward class declarations
+class TTree;
+class TClonesArray;
+namespace baconhep {
+  class ColumnarCollection;
+}
+namespace boost {
+  class thread;
+}
+
+namespace baconhep {
+
+  //
+  // Fills a tree from a second (back) instance of each output object, on a background thread.
+  // The caller fills the front objects; fill() waits for the previous entry to be written,
+  // swaps the front and back objects and queues the back ones, so the next event can be
+  // processed while the entry is serialized and compressed. Entries are written in order and
+  // with the same content as a synchronous TTree::Fill, which is what fill() does if the
+  // writer is not asynchronous.
+  //
+  // The writer thread takes no lock of the framework while it fills the tree. Its ROOT state is
+  // its own: TTree::Fill reads and changes the current directory and file (gDirectory, gFile) when
+  // baskets are flushed, and these are kept per thread once TThread is initialized, which the
+  // writer does. The output file is only written by the writer thread until finish(), and the
+  // front and back objects are only exchanged in fill(), under the writer's own mutex.
+  //
+  class AsyncTreeWriter
+  {
+    public:
+      // nCompressionThreads>1 compresses the baskets in parallel, where ROOT supports it (6.10 and later)
+      AsyncTreeWriter(TTree *tree, const bool async, const int nCompressionThreads=0);
+      ~AsyncTreeWriter();
+
+      // Branch of the tree filled from front and a back instance owned by the writer. Objects are
+      // copied from the written entry into the new front, as they are kept between synchronous fills.
+      template<class T> void addBranch(const char *name, T *&front) {
+        addSlot(name, T::Class_Name(), reinterpret_cast<void**>(&front), new T(), &copyObject<T>, &deleteObject<T>);
+      }
+      // arrays are cleared by their fillers for every event, so their content is not copied
+      void addBranch(const char *name, TClonesArray *&front);
+      // array written as per-member columns (see ColumnarCollection), gathered on the writing thread
+      void addColumns(const char *name, TClonesArray *&front);
+
+      // queue the current front objects as the next entry, after the previous entry was written;
+      // rethrows an exception of the writer thread
+      void fill();
+
+      // called after each entry is filled, on the thread that filled it (e.g. to tune the baskets)
+      void setAfterFill(const boost::function<void()> &afterFill) { fAfterFill = afterFill; }
+
+      // write the queued entry and stop the thread; call before writing the file
+      void finish();
+
+      // time spent filling the tree, complete after finish(), and time fill() waited for the
+      // previous entry: the difference is the writing that overlapped with the event processing
+      double fillSeconds() const { return fFillSeconds; }
+      double waitSeconds() const { return fWaitSeconds; }
+
+
+    protected:
+      typedef void (*CopyFunc)(void*, const void*);
+      typedef void (*DeleteFunc)(void*);
+
+      struct Slot {
+        void       **front;
+        void        *back;
+        CopyFunc     copy;
+        DeleteFunc   destroy;
+        ColumnarCollection *columns;   // 0 if the object is written in its branch
+      };
+
+      template<class T> static void copyObject(void *dst, const void *src) { *static_cast<T*>(dst) = *static_cast<const T*>(src); }
+      template<class T> static void deleteObject(void *obj) { delete static_cast<T*>(obj); }
+      static void deleteArray(void *obj);
+
+      void addSlot(const char *name, const char *className, void **front, void *back, CopyFunc copy, DeleteFunc destroy,
+                   ColumnarCollection *columns=0);
+      void stop();
+      void writer();
+      void fillEntry();
+
+      TTree              *fTree;
+      bool                fAsync;
+      std::deque<Slot>    fSlots;   // the tree holds the addresses of the back pointers, which a deque keeps stable
+      boost::function<void()> fAfterFill;
+      double              fFillSeconds;
+      double              fWaitSeconds;
+
+      boost::thread              *fThread;
+      boost::mutex                fMutex;
+      boost::condition_variable   fCondition;
+      bool                        fPending;   // entry queued or being written
+      bool                        fStop;
+      boost::exception_ptr        fException;
+  };
+}
+#endif
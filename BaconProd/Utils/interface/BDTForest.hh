@@ -0,0 +1,60 @@
+#ifndef BACONPROD_UTILS_BDTFOREST_HH
+#define BACONPROD_UTILS_BDTFOREST_HH
+
+#include <vector>
+#include <string>
+
+namespace baconhep {
+
+  //
+  // Evaluator for TMVA BDT weight files (classification or multiclass, any boost type).
+  // The trees are read once into one flat node array; a batch of objects is evaluated
+  // tree by tree, so that each tree is walked for all objects while it is in cache.
+  // Results follow TMVA::Reader::EvaluateMVA / EvaluateMulticlass for the same file.
+  //
+  class BDTForest
+  {
+    public:
+      BDTForest();
+      ~BDTForest();
+
+      // returns false if the file is not a BDT method that can be evaluated here
+      // (e.g. Category methods, variable transformations, Fisher cuts or regression)
+      bool initialize(const std::string weightFile);
+
+      bool isInitialized() const { return fIsInitialized; }
+
+      unsigned int nVars()    const { return fVarNames.size(); }
+      unsigned int nOutputs() const { return fNClasses; }  // 1 for classification
+
+      // position of an input variable (weight file expression), -1 if not used
+      int varIndex(const std::string &name) const;
+
+      // inputs: nRows x nVars(), row-major in varIndex() order; out: nRows x nOutputs()
+      void evaluate(const float *inputs, const unsigned int nRows, float *out) const;
+
+      // binary form of an initialized forest, for CalibrationBundle
+      void serialize(std::string &payload) const;
+      bool deserialize(const char *data, const unsigned long long size);
+
+
+    protected:
+      // intermediate node: next = child[x[var] >= cut]; leaf: var<0 and cut is the leaf value
+      struct Node {
+        int   var;
+        float cut;
+        int   child[2];
+      };
+
+      bool fIsInitialized;
+      bool fIsGrad;
+      unsigned int fNClasses;
+      bool fMulticlass;
+
+      std::vector<std::string> fVarNames;
+      std::vector<Node>        fNodes;
+      std::vector<int>         fTreeRoot;    // first node of each tree
+      std::vector<double>      fTreeWeight;  // boost weight of each tree (non-gradient boosting, 1 without UseWeightedTrees)
+  };
+}
+#endif
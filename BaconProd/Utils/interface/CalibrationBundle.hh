@@ -0,0 +1,138 @@
+#ifndef BACONPROD_UTILS_CALIBRATIONBUNDLE_HH
+#define BACONPROD_UTILS_CALIBRATIONBUNDLE_HH
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+namespace baconhep {
+
+  //
+  // Versioned binary file of precompiled calibration payloads (written by compileCalibBundle).
+  // The file is memory-mapped and payloads are read in place. Each entry is identified by its
+  // kind and by the content hash of the text file it was compiled from, so entries of edited
+  // or unknown files are not found and the caller falls back to the text file.
+  // The size and modification time of each source are recorded with its hash, so that a source
+  // that has not been touched since the bundle was compiled need not be read to be hashed.
+  // Payloads are in native byte order; compile the bundle on the architecture that reads it.
+  //
+  class CalibrationBundle
+  {
+    public:
+      enum Kind {
+        kJetCorrectorParameters = 1,  // JEC text file
+        kBDTForest              = 2,  // TMVA BDT weight file
+        kCorrectionTable        = 4   // interval-binned corrections (electron scale/smearing/linearity)
+      };
+      static const unsigned int kVersion = 3;
+
+      struct FileStamp {
+        unsigned long long size;
+        long long          mtime;    // modification time in ns
+        bool operator==(const FileStamp &other) const { return size == other.size && mtime == other.mtime; }
+      };
+
+      struct Entry {
+        unsigned int       kind;
+        unsigned long long hash;     // content hash of the source file
+        FileStamp          stamp;    // of the source file when its hash was taken
+        std::string        source;   // source file name, as the calibration users open it
+        std::string        payload;
+      };
+
+      CalibrationBundle();
+      ~CalibrationBundle();
+
+      // false if the file is missing, not a bundle or of another version
+      bool open(const std::string &filename);
+      void close();
+      bool isOpen() const { return fData != 0; }
+
+      // payload compiled from a source with this content hash, 0 if none
+      const char* find(const unsigned int kind, const unsigned long long hash, unsigned long long &size) const;
+
+      // content hash recorded for a source of this name and stamp; false if there is none
+      bool sourceHash(const std::string &source, const FileStamp &stamp, unsigned long long &hash) const;
+
+      unsigned int nEntries() const { return fNEntries; }
+
+      static bool write(const std::string &filename, const std::vector<Entry> &entries);
+
+      // 64-bit FNV-1a hash of a file content; asserts that the file can be read
+      static unsigned long long contentHash(const std::string &filename);
+
+      // size and modification time of a file; false if it cannot be found
+      static bool fileStamp(const std::string &filename, FileStamp &stamp);
+
+
+    protected:
+      struct TableEntry {
+        unsigned int       kind;
+        unsigned int       sourceLength;
+        unsigned long long hash;
+        unsigned long long sourceOffset;
+        unsigned long long offset;
+        unsigned long long size;
+        unsigned long long sourceSize;
+        long long          sourceMtime;
+      };
+
+      const char              *fData;  // mapped file
+      unsigned long long       fSize;
+      unsigned int             fNEntries;
+      const TableEntry        *fTable;
+  };
+
+  //
+  // Sequential writing/reading of payload fields
+  //
+  class PayloadWriter
+  {
+    public:
+      PayloadWriter(std::string &out):fOut(out) {}
+
+      template<class T> void put(const T &val) { fOut.append(reinterpret_cast<const char*>(&val), sizeof(T)); }
+      void put(const std::string &str) { put((unsigned int)str.size()); fOut.append(str); }
+      template<class T> void putArray(const std::vector<T> &vals) {
+        put((unsigned int)vals.size());
+        if(!vals.empty()) fOut.append(reinterpret_cast<const char*>(&vals[0]), vals.size()*sizeof(T));
+      }
+
+    protected:
+      std::string &fOut;
+  };
+
+  class PayloadReader
+  {
+    public:
+      PayloadReader(const char *data, const unsigned long long size):fData(data),fSize(size),fPos(0) {}
+
+      template<class T> bool get(T &val) {
+        if(fPos + sizeof(T) > fSize) return false;
+        memcpy(&val, fData+fPos, sizeof(T));
+        fPos += sizeof(T);
+        return true;
+      }
+      bool get(std::string &str) {
+        unsigned int n = 0;
+        if(!get(n) || fPos + n > fSize) return false;
+        str.assign(fData+fPos, n);
+        fPos += n;
+        return true;
+      }
+      template<class T> bool getArray(std::vector<T> &vals) {
+        unsigned int n = 0;
+        if(!get(n) || fPos + n*sizeof(T) > fSize) return false;
+        vals.resize(n);
+        if(n>0) memcpy(&vals[0], fData+fPos, n*sizeof(T));
+        fPos += n*sizeof(T);
+        return true;
+      }
+      bool atEnd() const { return fPos == fSize; }
+
+    protected:
+      const char         *fData;
+      unsigned long long  fSize, fPos;
+  };
+}
+#endif
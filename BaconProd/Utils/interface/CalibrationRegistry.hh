@@ -0,0 +1,58 @@
+#ifndef BACONPROD_UTILS_CALIBRATIONREGISTRY_HH
+#define BACONPROD_UTILS_CALIBRATIONREGISTRY_HH
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <string>
+
+// forward class declarations
+class JetCorrectorParameters;
+namespace baconhep {
+  class BDTForest;
+  class CorrectionTable;
+}
+
+namespace baconhep {
+
+  //
+  // Process-wide cache of parsed calibration files.
+  // A file is parsed on its first request and the read-only payload is handed out to all later
+  // requests for the same path and content (e.g. by the jet fillers of every cone size).
+  // Objects with per-call state (jet correctors, TMVA readers) are still built by each user.
+  // If a calibration bundle is loaded, payloads compiled from the same file content are taken
+  // from the bundle instead of parsing the text file. A file is only read again to hash its content
+  // when its size or modification time changed, and not at all if the bundle recorded it as it is.
+  //
+  class CalibrationRegistry
+  {
+    public:
+      typedef std::vector<std::vector<double> > Table;
+
+      // JEC text file, whole file (no section)
+      static boost::shared_ptr<const JetCorrectorParameters> jetCorrectorParameters(const std::string &filename);
+
+      // TMVA weight file; null if BDTForest cannot evaluate it
+      static boost::shared_ptr<const BDTForest> bdtForest(const std::string &filename);
+
+      // comma separated "min, max, values..." rows ('#' starts a comment) indexed by interval; asserts if a row is too short
+      static boost::shared_ptr<const CorrectionTable> correctionTable(const std::string &filename);
+
+      // map a bundle written by compileCalibBundle; false (and no bundle) if it cannot be used
+      static bool loadBundle(const std::string &filename);
+
+      // bundle payload of a text file (CalibrationBundle::Kind); false if it cannot be compiled
+      static bool compile(const unsigned int kind, const std::string &filename, std::string &payload);
+
+      // true if a bundle payload reads back as the parsed text file, printing the first difference
+      static bool verify(const unsigned int kind, const std::string &filename, const char *data, const unsigned long long size);
+
+      // drop the cached payloads and the bundle (payloads still in use stay alive with their users)
+      static void clear();
+
+
+    protected:
+      // file path and hash of its content
+      static std::string key(const std::string &filename, const unsigned long long hash);
+  };
+}
+#endif
@@ -0,0 +1,48 @@
+#ifndef BACONPROD_UTILS_CORRECTIONTABLE_HH
+#define BACONPROD_UTILS_CORRECTIONTABLE_HH
+
+#include <vector>
+#include <string>
+
+namespace baconhep {
+
+  //
+  // Table of corrections binned in closed intervals [min,max] of one variable (run number, pT, ...),
+  // with one value per category in each row. The interval ends are indexed at build time so that
+  // a lookup is a binary search; overlapping intervals resolve to the last row containing the value,
+  // as a linear scan over the rows would.
+  //
+  class CorrectionTable
+  {
+    public:
+      CorrectionTable();
+      ~CorrectionTable(){}
+
+      // rows of "min, max, value[0], ..., value[nValues-1]"; false if a row is too short
+      bool build(const std::vector<std::vector<double> > &rows, const unsigned int nValues);
+
+      unsigned int nRows()   const { return fNRows;   }
+      unsigned int nValues() const { return fNValues; }
+
+      // last row whose interval contains x, -1 if none
+      int find(const double x) const;
+
+      double value(const unsigned int row, const unsigned int icat) const { return fValues[row*fNValues + icat]; }
+
+      void serialize(std::string &payload) const;
+      bool deserialize(const char *data, const unsigned long long size);
+
+
+    protected:
+      unsigned int        fNRows;
+      unsigned int        fNValues;
+      std::vector<double> fValues;    // nRows x nValues
+
+      // x == fBounds[i] resolves to fPointRow[i]; fBounds[i-1] < x < fBounds[i] to fGapRow[i]
+      // (fGapRow has one more entry, for x above the last bound)
+      std::vector<double> fBounds;
+      std::vector<int>    fPointRow;
+      std::vector<int>    fGapRow;
+  };
+}
+#endif
@@ -0,0 +1,42 @@
+#ifndef BACONPROD_UTILS_DETERMINISMCHECK_HH
+#define BACONPROD_UTILS_DETERMINISMCHECK_HH
+
+#include <string>
+#include <ostream>
+
+// forward class declarations
+class TClass;
+class TClonesArray;
+class TBufferFile;
+
+namespace baconhep {
+
+  //
+  // Compares the output objects of two fillings of the same event, e.g. on concurrent tasks and
+  // in sequence, by the bytes their streamers write: objects that pass are written identically.
+  //
+  class DeterminismCheck
+  {
+    public:
+      DeterminismCheck();
+      ~DeterminismCheck();
+
+      // false if the arrays differ, printing the first object that differs
+      bool compare(const std::string &name, const TClonesArray &a, const TClonesArray &b);
+      // the same for single objects of a dictionary class
+      bool compare(const std::string &name, const TClass *cls, const void *a, const void *b);
+
+      unsigned int nCompared()    const { return fNCompared; }
+      unsigned int nDifferences() const { return fNDifferences; }
+      void report(std::ostream &os) const;
+
+
+    protected:
+      bool sameBytes(const TClass *cls, const void *a, const void *b);
+
+      TBufferFile *fBufferA, *fBufferB;
+      unsigned int fNCompared;
+      unsigned int fNDifferences;
+  };
+}
+#endif
@@ -12,41 +12,26 @@
 #ifndef BACONPROD_UTILS_ELECTRONENERGYSMEARINGSCALING_HH
 #define BACONPROD_UTILS_ELECTRONENERGYSMEARINGSCALING_HH
 
-#include <vector>
+#include <boost/shared_ptr.hpp>
 #include <utility>
 
 // number of categories
+//  0: barrel, |eta|<1, R9< 0.94
+//  1: barrel, |eta|<1, R9>=0.94
+//  2: barrel, |eta|>1, R9< 0.94
+//  3: barrel, |eta|>1, R9>=0.94
+//  4: endcap, |eta|<2, R9< 0.94
+//  5: endcap, |eta|<2, R9>=0.94
+//  6: endcap, |eta|>2, R9< 0.94
+//  7: endcap, |eta|>2, R9>=0.94
 #define NCAT 8
 
 class TRandom3;
-class EcalClusterLazyTools;
+namespace baconhep { class ShowerShapes; class CorrectionTable; }
 namespace reco { class GsfElectron; }
 
 namespace baconhep {
   
-  class CorrRecord {
-    public:      
-      CorrRecord():runNumMin(0),runNumMax(999999) {  
-        for(int i=0; i<NCAT; i++)
-	  corr[i]=1.;
-      }
-      ~CorrRecord(){}
-      
-      unsigned int runNumMin;  // run range minimum
-      unsigned int runNumMax;  // run range maximum
-      
-      // corrections by category
-      //  0: barrel, |eta|<1, R9< 0.94
-      //  1: barrel, |eta|<1, R9>=0.94
-      //  2: barrel, |eta|>1, R9< 0.94
-      //  3: barrel, |eta|>1, R9>=0.94
-      //  4: endcap, |eta|<2, R9< 0.94
-      //  5: endcap, |eta|<2, R9>=0.94
-      //  6: endcap, |eta|>2, R9< 0.94
-      //  7: endcap, |eta|>2, R9>=0.94
-      double corr[NCAT]; 
-  };  
-  
   class ElectronEnergySmearingScaling {
     public:
       ElectronEnergySmearingScaling();
@@ -83,11 +68,11 @@ namespace baconhep {
         const double	         energy,     // electron energy
 	const double	         error,      // eletron energy uncertainty
 	const unsigned int       runNum,     // run number
-	EcalClusterLazyTools    &lazyTools,  // class to compute ECAL cluster quantities
+	const ShowerShapes      &shapes,     // shower shapes of the electron supercluster seed
 	const bool               printDebug=false);
   
     protected:
-      void loadCorrections(const char *infilename, std::vector<CorrRecord> &records);
+      boost::shared_ptr<const CorrectionTable> loadCorrections(const char *infilename);
       
       bool fIsInitialized;
       
@@ -98,10 +83,11 @@ namespace baconhep {
       DatasetType fDatasetType;                     // dataset type
       double      fLumiRatio;                       // ratio of luminosity for 2012A,B,C to 2012D
       
-      std::vector<CorrRecord> fScalesRecords;       // data for scale corrections
-      std::vector<CorrRecord> fSmearsType1Records;  // data for type 1 resolution corrections
-      std::vector<CorrRecord> fSmearsType2Records;  // data for type 2 resolution corrections
-      std::vector<CorrRecord> fSmearsType3Records;  // data for type 3 resolution corrections
+      // run range x category tables
+      boost::shared_ptr<const CorrectionTable> fScales;       // scale corrections
+      boost::shared_ptr<const CorrectionTable> fSmearsType1;  // type 1 resolution corrections
+      boost::shared_ptr<const CorrectionTable> fSmearsType2;  // type 2 resolution corrections
+      boost::shared_ptr<const CorrectionTable> fSmearsType3;  // type 3 resolution corrections
   };
 }
 #endif
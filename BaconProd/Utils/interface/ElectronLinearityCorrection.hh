@@ -13,36 +13,22 @@
 #define BACONPROD_UTILS_ELECTRONLINEARITYCORRECTION_HH
 
 #include "BaconProd/Utils/interface/ElectronEnergySmearingScaling.hh"
-#include <vector>
+#include <boost/shared_ptr.hpp>
 
+// number of categories
+//  0: barrel, classification<2, |eta|<1
+//  1: barrel, classification<2, |eta|>1
+//  2: endcap, classification<2
+//  3: barrel, classification>2, |eta|<1
+//  4: barrel, classification>2, |eta|>1
+//  5: endcap, classification>2
 #define NLINCAT 6
 
 namespace reco { class GsfElectron; }
+namespace baconhep { class CorrectionTable; }
 
 namespace baconhep {
   
-  class LinearityRecord {
-    public:      
-      LinearityRecord():ptMin(0),ptMax(999999) {  
-        for(int i=0; i<NLINCAT; i++)
-	  corr[i]=1.;
-      }
-      ~LinearityRecord(){}
-      
-      unsigned int ptMin;  // pT range minimum
-      unsigned int ptMax;  // pT range maximum
-      
-      // linearity corrections by category
-      //  0: barrel, classification<2, |eta|<1
-      //  1: barrel, classification<2, |eta|>1
-      //  2: endcap, classification<2
-      //  3: barrel, classification>2, |eta|<1
-      //  4: barrel, classification>2, |eta|>1
-      //  5: endcap, classification>2
-      double corr[NLINCAT]; 
-  };  
-  
-  
   class ElectronLinearityCorrection {
     public:
       ElectronLinearityCorrection();
@@ -60,7 +46,7 @@ namespace baconhep {
     protected:
       bool fIsInitialized;
       ElectronEnergySmearingScaling::DatasetType fDatasetType;  // dataset type
-      std::vector<LinearityRecord> fLinearityRecords;           // data for linearity corrections
+      boost::shared_ptr<const CorrectionTable>   fLinearity;    // pT range x category linearity corrections
   };
 }
 #endif
@@ -45,7 +45,7 @@ namespace baconhep {
 	const int                nvertices,                         // number of primary vertices
 	const unsigned int       runNum,                            // run number
 	const edm::EventSetup   &iSetup,                            // event setup handle
-	EcalClusterLazyTools    &lazyTools,                         // class to compute ECAL cluster quantities
+	const ShowerShapes      &shapes,                            // shower shapes of the electron supercluster seed
 	const bool               printDebug=false);
           
     protected:
@@ -1,12 +1,17 @@
 #ifndef BACONPROD_UTILS_JETPUIDMVACALCULATOR_HH
 #define BACONPROD_UTILS_JETPUIDMVACALCULATOR_HH
 
+#include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 // forward class declarations
 namespace TMVA {
   class Reader;
 }
+namespace baconhep {
+  class BDTForest;
+}
 
 namespace baconhep {
 
@@ -40,13 +45,39 @@ namespace baconhep {
 		     const float dRMean, const float dR2Mean, const float ptD,
 		     const float frac01, const float frac02, const float frac03, const float frac04, const float frac05,
 		     const bool printDebug=false);
+      
+      // Batch evaluation: queue the (loose ID) jets of an event, then evaluate them together.
+      // Values are returned in the order the jets were added.
+      void clearBatch() { fBatch.clear(); }
+      void addToBatch(const float nvtx,
+                      const float jetPt, const float jetEta, const float jetPhi,
+		      const float d0, const float dZ,
+		      const float beta, const float betaStar,
+		      const float nCharged, const float nNeutrals,
+		      const float dRMean, const float dR2Mean, const float ptD,
+		      const float frac01, const float frac02, const float frac03, const float frac04, const float frac05);
+      void evaluateBatch(std::vector<float> &vals);
      
     
     private:
-      void initReader(TMVA::Reader *reader, const std::string filename);
+      enum { kNvtx, kJetPt, kJetEta, kJetPhi, kD0, kDZ, kBeta, kBetaStar, kNCharged, kNNeutrals,
+             kDRMean, kDR2Mean, kPtD, kFrac01, kFrac02, kFrac03, kFrac04, kFrac05, kNInputs };
+      
+      bool initForest(boost::shared_ptr<const BDTForest> &forest, std::vector<int> &varMap, const std::string filename);
+      void evaluate(const float *inputs, const unsigned int nJets, float *vals);
+      void evaluatePtBin(const BDTForest *forest, const std::vector<int> &varMap,
+                         TMVA::Reader *reader, const std::string &methodTag,
+                         const float *inputs, const std::vector<unsigned int> &jets, float *vals);
       
       bool fIsInitialized;
       
+      // plain BDT weight files are evaluated with the flattened forests (shared by all calculators
+      // using the same file), other methods (e.g. Category) with TMVA
+      boost::shared_ptr<const BDTForest> fLowPtForest, fHighPtForest;
+      std::vector<int>                   fLowPtVarMap, fHighPtVarMap;  // input of each forest variable
+      
+      std::vector<float> fBatch;  // kNInputs values per queued jet
+      
       TMVA::Reader *fLowPtReader;
       TMVA::Reader *fHighPtReader;
       std::string fLowPtMethodTag;
@@ -0,0 +1,67 @@
+#ifndef BACONPROD_UTILS_JETSHAPES_HH
+#define BACONPROD_UTILS_JETSHAPES_HH
+
+#include <vector>
+
+// forward class declarations
+#include "DataFormats/JetReco/interface/PFJetCollection.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+
+namespace baconhep {
+
+  class TrackVertexMap;
+
+  //
+  // Constituent-based jet observables of JetTools computed in one pass.
+  // The PF constituents are read once into flat arrays (tracked constituents in a
+  // second set of arrays) and all shapes, track fractions and the pull are summed
+  // in the same loop, in constituent order, so results agree with JetTools.
+  //
+  class JetShapes
+  {
+    public:
+      JetShapes();
+      ~JetShapes();
+
+      // load constituents of the jet and compute all observables
+      void compute(const reco::PFJet &jet, const reco::Vertex &pv, const TrackVertexMap &trkVtxMap, const double dzCut=0.2);
+
+      unsigned int nParticles() const { return fPt.size(); }
+
+      double d0()       const { return fD0;       }  // JetTools::jetD0
+      double dz()       const { return fDz;       }  // JetTools::jetDz
+      double beta()     const { return fBeta;     }  // JetTools::beta
+      double betaStar() const { return fBetaStar; }  // JetTools::betaStar
+      double dRMean()   const { return fDRMean;   }  // JetTools::dRMean (all types)
+      double dR2Mean()  const { return fDR2Mean;  }  // JetTools::dR2Mean (all types)
+      double ptD()      const { return fPtD;      }  // JetTools::jetWidth (varType=0, all types)
+      double charge()   const { return fCharge;   }  // JetTools::jetCharge
+      double pull()     const { return fPull;     }  // JetTools::jetPull(...).Pt()
+
+      // JetTools::frac for dRMax = 0.1*(ibin+1), ibin=0..kNFrac-1
+      enum { kNFrac = 5 };
+      double frac(const unsigned int ibin) const { return fFrac[ibin]; }
+
+
+    protected:
+      void load(const reco::PFJet &jet, const reco::Vertex &pv);
+
+      // all constituents
+      std::vector<double> fPt, fEta, fPhi;
+
+      // constituents with a track
+      std::vector<double>             fTrkCandPt;  // candidate pT
+      std::vector<double>             fTrkPt;      // track pT
+      std::vector<double>             fTrkDz;      // track dz w.r.t. the PV
+      std::vector<int>                fTrkCharge;
+      std::vector<const reco::Track*> fTrack;
+
+      double fD0, fDz;
+      double fBeta, fBetaStar;
+      double fDRMean, fDR2Mean, fPtD;
+      double fCharge, fPull;
+      double fFrac[kNFrac];
+  };
+}
+#endif
@@ -7,6 +7,7 @@
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include "DataFormats/BTauReco/interface/JetTag.h"
 #include "DataFormats/Common/interface/ValueMap.h"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
 #include "TLorentzVector.h"
 
 namespace baconhep {
@@ -19,7 +20,7 @@ namespace baconhep {
       static double beta(const reco::PFJet &jet, const reco::Vertex &pv, const double dzCut=0.2);
       
       // fraction of pT contributed by particles associated with a pile-up vertex
-      static double betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const reco::VertexCollection *pvCol, const double dzCut=0.2);
+      static double betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const TrackVertexMap &trkVtxMap, const double dzCut=0.2);
       
       // mean dR of constituents from jet axis
       static double dRMean(const reco::PFJet &jet, const int pfType=-1);
@@ -0,0 +1,71 @@
+#ifndef BACONPROD_UTILS_OUTPUTPROFILE_HH
+#define BACONPROD_UTILS_OUTPUTPROFILE_HH
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+// forward class declarations
+class TTree;
+class TBranch;
+class TObjArray;
+
+namespace baconhep {
+
+  //
+  // Compression and basket layout of the Bacon event tree, by branch group:
+  //   scalar: per-event records read by every analysis (Info, GenEvtInfo, PV)
+  //   object: reconstructed object arrays (Electron, Muon, Tau, Photon, jets)
+  //   bulk:   large arrays read by few analyses (GenParticle, PFPart)
+  // A tuned profile fills the first entries with the initial baskets, then sizes each basket to
+  // hold one cluster of entries at the observed bytes per entry and flushes the tree every cluster.
+  // The "default" profile keeps the ROOT defaults (file compression, 32 kB baskets, automatic flush).
+  //
+  class OutputProfile
+  {
+    public:
+      enum Group { kScalar=0, kObject, kBulk, kNGroups };
+      enum Algorithm { kKeep=0, kZLIB=1, kLZMA=2, kLZ4=4, kZSTD=5 };  // ROOT compression algorithm codes
+
+      // "default", "fast", "balanced" or "compact"; asserts on another name
+      OutputProfile(const std::string &name="default");
+      ~OutputProfile(){}
+
+      const std::string& name() const { return fName; }
+      static std::vector<std::string> names();
+
+      static Group group(const std::string &branchName);
+      static const char* groupName(const Group group);
+
+      // ROOT compression settings (algorithm*100+level) of a branch, -1 to keep the file setting.
+      // Algorithms missing in this ROOT version fall back to ZLIB.
+      int compressionSettings(const std::string &branchName) const;
+
+      // set the compression of the branches of a new tree
+      void apply(TTree *tree) const;
+
+      // call after every fill; sizes the baskets once the sample entries are filled
+      void afterFill(TTree *tree);
+      bool isTuned() const { return fTuned; }
+
+      // bytes and compression of each top-level branch (after the file is written)
+      void report(TTree *tree, std::ostream &os, const double fillSeconds) const;
+
+
+    protected:
+      struct Compression {
+        int algorithm;
+        int level;
+      };
+
+      static bool isAvailable(const int algorithm);
+      void sizeBaskets(TObjArray *branches, const long long nEntries) const;
+
+      std::string  fName;
+      Compression  fCompression[kNGroups];
+      int          fNSample;          // entries filled before sizing the baskets, 0: no tuning
+      int          fClusterEntries;   // entries per basket cluster once tuned
+      bool         fTuned;
+  };
+}
+#endif
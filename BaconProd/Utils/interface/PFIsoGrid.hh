@@ -0,0 +1,65 @@
+#ifndef BACONPROD_UTILS_PFISOGRID_HH
+#define BACONPROD_UTILS_PFISOGRID_HH
+
+#include <vector>
+
+// forward class declarations
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+
+namespace baconhep {
+
+  //
+  // Binned eta-phi index of the PFNoPU and PFPU candidates of an event.
+  // Built once per event from the pile-up partition, so that an isolation cone
+  // query only visits the cells overlapping the cone instead of the full collection.
+  //
+  class PFIsoGrid
+  {
+    public:
+      struct Neighbour {
+        const reco::PFCandidate *cand;
+        double dr;        // deltaR to the query direction
+        unsigned int idx; // position in the input PFNoPU/PFPU collection
+      };
+
+      PFIsoGrid(const double etaMax=5.0, const double cellSize=0.1);
+      ~PFIsoGrid();
+
+      void build(const std::vector<const reco::PFCandidate*> &pfNoPU,
+                 const std::vector<const reco::PFCandidate*> &pfPU);
+
+      // Collect PFNoPU (PFPU) candidates with deltaR <= maxRadius of (eta,phi).
+      // The output is ordered as in the input collection, so that sums over it
+      // are identical to those of a plain scan over the collection.
+      void neighboursNoPU(const double eta, const double phi, const double maxRadius, std::vector<Neighbour> &out) const;
+      void neighboursPU  (const double eta, const double phi, const double maxRadius, std::vector<Neighbour> &out) const;
+
+
+    protected:
+      struct Cell {
+        const reco::PFCandidate *cand;
+        double eta, phi;
+        unsigned int idx;
+      };
+
+      struct Grid {
+        std::vector<unsigned int> start;  // first entry of each cell in 'cands' (size nCells+1)
+        std::vector<Cell>         cands;  // candidates ordered by cell
+      };
+
+      int  etaBin(const double eta) const;
+      int  phiBin(const double phi) const;
+      void fillGrid(Grid &grid, const std::vector<const reco::PFCandidate*> &pfCands);
+      void query(const Grid &grid, const double eta, const double phi, const double maxRadius, std::vector<Neighbour> &out) const;
+
+      double fEtaMax;
+      int    fNEta, fNPhi;
+      double fEtaWidth, fPhiWidth;
+
+      Grid fNoPU;
+      Grid fPU;
+
+      std::vector<unsigned int> fCellOf;  // scratch space for the counting sort
+  };
+}
+#endif
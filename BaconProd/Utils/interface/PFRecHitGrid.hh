@@ -0,0 +1,58 @@
+#ifndef BACONPROD_UTILS_PFRECHITGRID_HH
+#define BACONPROD_UTILS_PFRECHITGRID_HH
+
+#include <vector>
+
+// forward class declarations
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
+
+namespace baconhep {
+
+  //
+  // Binned eta-phi index of PF rechits, one grid per calorimeter layer (collection).
+  // Hits are referenced, not copied, and their eta/phi are computed once per event,
+  // so that a cone query only visits the cells overlapping the cone.
+  //
+  class PFRecHitGrid
+  {
+    public:
+      PFRecHitGrid(const double etaMax=5.0, const double cellSize=0.1);
+      ~PFRecHitGrid();
+
+      // remove all layers; call once per event before addLayer()
+      void clear();
+
+      // index the hits of one layer; the collection must outlive the queries
+      void addLayer(const reco::PFRecHitCollection &recHits);
+
+      // Collect hits with deltaR <= maxRadius of (eta,phi). The output is ordered by layer
+      // and by position in the layer collection, as in a scan over the concatenated layers.
+      void neighbours(const float eta, const float phi, const double maxRadius, std::vector<const reco::PFRecHit*> &out) const;
+
+
+    protected:
+      struct Cell {
+        const reco::PFRecHit *hit;
+        float eta, phi;
+      };
+
+      struct Grid {
+        std::vector<unsigned int> start;  // first entry of each cell in 'hits' (size nCells+1)
+        std::vector<Cell>         hits;   // hits ordered by cell
+      };
+
+      int  etaBin(const double eta) const;
+      int  phiBin(const double phi) const;
+      void query(const Grid &grid, const float eta, const float phi, const double maxRadius, std::vector<const reco::PFRecHit*> &out) const;
+
+      double fEtaMax;
+      int    fNEta, fNPhi;
+      double fEtaWidth, fPhiWidth;
+
+      std::vector<Grid> fLayers;
+      unsigned int      fNLayers;  // layers in use; grids beyond are kept to reuse their memory
+
+      std::vector<unsigned int> fCellOf;  // scratch space for the counting sort
+  };
+}
+#endif
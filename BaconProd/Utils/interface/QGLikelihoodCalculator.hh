@@ -1,11 +1,13 @@
 #ifndef BACONPROD_UTILS_QGLIKELIHOODCALCULATOR_HH
 #define BACONPROD_UTILS_QGLIKELIHOODCALCULATOR_HH
 
+#include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 // forward class declarations
-namespace TMVA {
-  class Reader;
+namespace baconhep {
+  class BDTForest;
 }
 
 namespace baconhep {
@@ -33,16 +35,12 @@ namespace baconhep {
     private:
       bool fIsInitialized;
       
-      TMVA::Reader *fReader;
-      std::string fMethodTag;
+      enum { kNvtx, kJetPt, kJetEta, kJetPhi, kBeta, kBetaStar, kNParticles, kNCharged,
+             kDRMean, kPtD, kFrac01, kFrac02, kFrac03, kFrac04, kFrac05, kNInputs };
       
-      // input variables to compute the likelihood
-      float _nvtx,
-            _jetPt, _jetEta, _jetPhi,
-            _beta, _betaStar,
-            _nParticles, _nCharged,
-            _dRMean, _ptD,
-            _frac01, _frac02, _frac03, _frac04, _frac05;    
+      boost::shared_ptr<const BDTForest> fForest;  // shared by all calculators using the same weight file
+      std::string fMethodTag;
+      std::vector<int> fVarMap;  // input (enum above) of each weight file variable
   };
 }
 #endif
@@ -0,0 +1,75 @@
+#ifndef BACONPROD_UTILS_REFINDEXMAP_HH
+#define BACONPROD_UTILS_REFINDEXMAP_HH
+
+#include <vector>
+
+// forward class declarations
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrackFwd.h"
+#include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+namespace baconhep {
+
+  //
+  // Per-event lookups from reference keys to collection indices.
+  // The track, GSF track and supercluster references of the PF candidates are read once
+  // into key-indexed tables (one per referenced product), so that finding the PF candidates
+  // of a lepton, or the index of its track or supercluster, does not scan the collections.
+  //
+  class RefIndexMap
+  {
+    public:
+      RefIndexMap();
+      ~RefIndexMap();
+
+      void build(const edm::Handle<reco::PFCandidateCollection>  &hPFCands,
+                 const edm::Handle<reco::TrackCollection>        &hTracks,
+                 const edm::Handle<reco::SuperClusterCollection> &hEBSC,
+                 const edm::Handle<reco::SuperClusterCollection> &hEESC);
+
+      const reco::PFCandidateCollection* pfCandidates() const { return fPFCandCol; }
+
+      // index of the last PF candidate (collection order) with this track (GSF track), -1 if none
+      int pfCandIndex(const reco::TrackRef    &track)    const;
+      int pfCandIndex(const reco::GsfTrackRef &gsfTrack) const;
+
+      // indices of the PF candidates with this supercluster, in collection order
+      void pfCandIndices(const reco::SuperClusterRef &sc, std::vector<int> &out) const;
+
+      // index in the track collection, -1 if the reference is null or from another product
+      int trackIndex(const reco::TrackRef &track) const;
+
+      // index in the EB superclusters followed by the EE superclusters, -1 if in neither
+      int scIndex(const reco::SuperClusterRef &sc) const;
+
+
+    protected:
+      struct Entry {
+        edm::ProductID id;
+        unsigned int   key;
+        int            index;
+      };
+
+      // entries of one referenced product, grouped by key (start has size maxKey+2)
+      struct KeyTable {
+        edm::ProductID            id;
+        std::vector<unsigned int> start;
+        std::vector<int>          index;
+      };
+
+      static void fillTables(const std::vector<Entry> &entries, std::vector<KeyTable> &tables);
+      static const KeyTable* findTable(const std::vector<KeyTable> &tables, const edm::ProductID &id, const unsigned int key);
+
+      const reco::PFCandidateCollection *fPFCandCol;
+      edm::ProductID                     fTrackID, fEBSCID, fEESCID;
+      unsigned int                       fNTracks, fNEBSC, fNEESC;
+
+      std::vector<KeyTable> fPFByTrack;
+      std::vector<KeyTable> fPFByGsfTrack;
+      std::vector<KeyTable> fPFBySC;
+  };
+}
+#endif
@@ -0,0 +1,98 @@
+#ifndef BACONPROD_UTILS_SHOWERSHAPES_HH
+#define BACONPROD_UTILS_SHOWERSHAPES_HH
+
+#include <vector>
+#include <ostream>
+#include <string>
+
+// forward class declarations
+class EcalClusterLazyTools;
+namespace reco { class SuperCluster; class CaloCluster; }
+
+namespace baconhep {
+
+  //
+  // Shower-shape quantities of the seed cluster of one supercluster.
+  // Each quantity is computed by EcalClusterLazyTools on its first request and kept,
+  // so that the regression, the smearing, the ID MVA and the filler of the same
+  // electron (photon) share one evaluation instead of walking the rechits again.
+  //
+  // Every call of the lazy tools goes through the record, which counts the requests and the
+  // evaluations of each quantity. A record given a Count adds its numbers to it when it is
+  // destroyed (see showerShapeReport in NtuplerMod).
+  //
+  class ShowerShapes
+  {
+    public:
+      enum Quantity {
+        kE3x3, kE5x5, kEMax, kE2nd, kETop, kEBottom, kELeft, kERight,
+        kE2x5Max, kE2x5Top, kE2x5Bottom, kE2x5Left, kE2x5Right,
+        kNQuantities
+      };
+      static const unsigned int kLocalCovariances = kNQuantities;    // counter index of localCovariances()
+      static const unsigned int kClusters         = kNQuantities+1;  // counter index of clusterEMax/E3x3()
+      static const unsigned int kNCounters        = kNQuantities+2;
+
+      // requests and lazy-tools evaluations of the records of a filler
+      struct Count {
+        Count();
+        void report(std::ostream &os, const std::string &label) const;
+
+        unsigned long nRecords;
+        unsigned long nRequests   [kNCounters];
+        unsigned long nEvaluations[kNCounters];
+        unsigned long nRepeated;   // seed quantities evaluated more than once in a record
+      };
+
+      ShowerShapes(EcalClusterLazyTools &lazyTools, const reco::SuperCluster &sc, Count *count=0);
+      ~ShowerShapes();
+
+      float get(const Quantity q) const;
+
+      float e3x3()       const { return get(kE3x3);       }
+      float e5x5()       const { return get(kE5x5);       }
+      float eMax()       const { return get(kEMax);       }
+      float e2nd()       const { return get(kE2nd);       }
+      float eTop()       const { return get(kETop);       }
+      float eBottom()    const { return get(kEBottom);    }
+      float eLeft()      const { return get(kELeft);      }
+      float eRight()     const { return get(kERight);     }
+      float e2x5Max()    const { return get(kE2x5Max);    }
+      float e2x5Top()    const { return get(kE2x5Top);    }
+      float e2x5Bottom() const { return get(kE2x5Bottom); }
+      float e2x5Left()   const { return get(kE2x5Left);   }
+      float e2x5Right()  const { return get(kE2x5Right);  }
+
+      // seed E3x3 over supercluster raw energy
+      double r9() const;
+
+      // sigma_ieta_ieta^2, cov(ieta,iphi), sigma_iphi_iphi^2 of the seed
+      const std::vector<float>& localCovariances() const;
+
+      // EMax and E3x3 of another cluster of the supercluster, not kept
+      float clusterEMax(const reco::CaloCluster &cluster) const;
+      float clusterE3x3(const reco::CaloCluster &cluster) const;
+
+      const reco::CaloCluster& seed() const { return *fSeed; }
+
+      // requests and evaluations of a Quantity, of kLocalCovariances or of kClusters
+      unsigned int nRequests   (const unsigned int i) const { return fNRequests[i];    }
+      unsigned int nEvaluations(const unsigned int i) const { return fNEvaluations[i]; }
+
+
+    protected:
+      EcalClusterLazyTools     *fLazyTools;
+      const reco::CaloCluster  *fSeed;
+      double                    fRawEnergy;  // supercluster raw energy
+      Count                    *fCount;
+
+      mutable unsigned int       fComputed;  // bit per Quantity
+      mutable float              fValues[kNQuantities];
+      mutable bool               fHasCov;
+      mutable std::vector<float> fCov;
+
+      mutable unsigned int fNRequests   [kNCounters];
+      mutable unsigned int fNEvaluations[kNCounters];
+  };
+}
+#endif
@@ -0,0 +1,87 @@
+#ifndef BACONPROD_UTILS_TASKSCHEDULER_HH
+#define BACONPROD_UTILS_TASKSCHEDULER_HH
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/exception_ptr.hpp>
+#include <vector>
+#include <set>
+#include <string>
+
+// forward class declarations
+class TClonesArray;
+namespace boost {
+  class thread_group;
+}
+
+namespace baconhep {
+
+  //
+  // Runs a list of tasks on a pool of threads, respecting the data they declare.
+  // Each task names the inputs it reads and the outputs it writes (comma separated); a task
+  // waits for every earlier task that writes one of its inputs or outputs, or reads one of
+  // its outputs. Any schedule is therefore equivalent to running the tasks in the order they
+  // were added, which is what run() does with a single thread.
+  //
+  // The worker threads are started by the first run() that needs them and wait for the next run
+  // between runs; the calling thread takes tasks too.
+  //
+  class TaskScheduler
+  {
+    public:
+      TaskScheduler();
+      ~TaskScheduler();
+
+      void addTask(const std::string &name, const boost::function<void()> &task,
+                   const std::string &inputs, const std::string &outputs);
+      void clear();
+
+      unsigned int nTasks() const { return fTasks.size(); }
+
+      // run every task once; nThreads<=1 runs them in order on the calling thread.
+      // The first exception thrown by a task is rethrown once no task is running.
+      void run(const int nThreads);
+
+      // guards framework calls (event product access) made from concurrent tasks
+      static boost::mutex& frameworkMutex();
+
+      // Allocate and construct every object an output array can hold (its size), once, before the
+      // tasks filling it run: the objects are then constructed in place by the tasks, as
+      // new((*array)[i]) T(), without ROOT allocation and so without the framework mutex.
+      // Clearing the array (without option "C") keeps the objects.
+      static void preallocate(TClonesArray *array);
+
+    protected:
+      struct Task {
+        std::string              name;
+        boost::function<void()>  task;
+        std::vector<std::string> inputs, outputs;
+        std::vector<int>         successors;
+        int                      nDeps;
+      };
+
+      void worker(const unsigned int iworker);
+      void runTasks(boost::mutex::scoped_lock &lock);  // takes tasks until the run ends
+
+      std::vector<Task> fTasks;
+
+      // worker pool
+      boost::thread_group      *fWorkers;
+      unsigned int              fNWorkers;
+      unsigned long             fRun;       // number of the current run, counted from 1
+      unsigned int              fNActive;   // workers taking part in it
+      unsigned int              fNBusy;     // workers taking tasks of it
+      bool                      fStop;
+
+      // state of a run
+      boost::mutex              fMutex;
+      boost::condition_variable fCondition;
+      std::vector<int>          fPending;   // unfinished dependencies of each task
+      std::set<int>             fReady;     // started in the order they were added
+      unsigned int              fNDone;
+      unsigned int              fNRunning;
+      boost::exception_ptr      fException;
+  };
+}
+#endif
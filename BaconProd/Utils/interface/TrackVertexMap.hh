@@ -0,0 +1,92 @@
+#ifndef BACONPROD_UTILS_TRACKVERTEXMAP_HH
+#define BACONPROD_UTILS_TRACKVERTEXMAP_HH
+
+#include <vector>
+
+// forward class declarations
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+namespace baconhep {
+
+  //
+  // Per-event track to vertex association.
+  // Each vertex track list is read once to map tracks to the first vertex using them
+  // (and to their weight in the event primary vertex); vertices are also kept sorted
+  // in z so that closest-vertex searches are logarithmic in the number of vertices.
+  //
+  class TrackVertexMap
+  {
+    public:
+      struct PFAssoc {
+        int   vtxIndex;      // first vertex (collection order) with trackWeight>0, -1 if none
+        float vtxWeight;     // track weight in that vertex
+        float pvWeight;      // track weight in the event primary vertex
+        int   closestIndex;  // vertex closest in z to the candidate vertex, -1 if none
+        float dzClosest;     // |dz| to that vertex
+      };
+
+      TrackVertexMap();
+      ~TrackVertexMap();
+
+      void build(const reco::PFCandidateCollection *pfCandCol,
+                 const reco::VertexCollection      *pvCol,
+                 const reco::Vertex                &pv);
+
+      const reco::PFCandidateCollection* pfCandidates() const { return fPFCandCol; }
+      const reco::VertexCollection*      vertices()     const { return fPVCol;     }
+      const reco::Vertex*                pv()           const { return fPV;        }
+      int                                pvIndex()      const { return fPVIndex;   }
+
+      // association of the i-th candidate of the PF collection used in build()
+      const PFAssoc& pfAssoc(const unsigned int ipf) const { return fPFAssoc[ipf]; }
+
+      // track lookups
+      int   vertexIndex (const reco::TrackRef &track) const;
+      float vertexWeight(const reco::TrackRef &track) const;
+      float pvWeight    (const reco::TrackRef &track) const;
+
+      // index of the vertex closest in z (first in collection order on ties), -1 if none within maxDz
+      int closestVertex(const double z, const double maxDz=10000) const;
+
+      // true if a vertex with ndof>=minNdof, at least minDistToPV away from the PV, has |track.dz(vertex)|<dzCut
+      bool hasCompatibleVertex(const reco::Track &track, const double dzCut,
+                               const double minNdof, const double minDistToPV) const;
+
+
+    protected:
+      struct TrackEntry {
+        edm::ProductID id;
+        unsigned int   key;
+        int            vtxIndex;
+        float          vtxWeight;
+        float          pvWeight;
+        bool operator<(const TrackEntry &other) const {
+          if(id != other.id)   return id < other.id;
+          if(key != other.key) return key < other.key;
+          return vtxIndex < other.vtxIndex;
+        }
+      };
+
+      struct ZEntry {
+        double z;
+        int    index;
+        bool operator<(const ZEntry &other) const { return (z < other.z) || (z == other.z && index < other.index); }
+      };
+
+      const TrackEntry* findTrack(const reco::TrackRef &track) const;
+
+      const reco::PFCandidateCollection *fPFCandCol;
+      const reco::VertexCollection      *fPVCol;
+      const reco::Vertex                *fPV;
+      int                                fPVIndex;
+      double                             fMaxVtxRho;
+
+      std::vector<TrackEntry> fTracks;  // sorted by track product key
+      std::vector<ZEntry>     fZSorted; // vertices sorted by z
+      std::vector<PFAssoc>    fPFAssoc;
+  };
+}
+#endif
@@ -0,0 +1,61 @@
+#ifndef BACONPROD_UTILS_TRIGGEROBJECTMATCHER_HH
+#define BACONPROD_UTILS_TRIGGEROBJECTMATCHER_HH
+
+#include "BaconAna/DataFormats/interface/BaconAnaDefs.hh"
+#include "BaconAna/DataFormats/interface/TriggerRecord.hh"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include <vector>
+
+// forward class declarations
+namespace trigger {
+  class TriggerEvent;
+}
+
+namespace baconhep {
+
+  //
+  // Batched HLT object matching.
+  // The filter tags of the trigger records are built once per HLT menu and resolved
+  // against the TriggerEvent once per event, with the eta/phi of the filter objects
+  // copied into flat arrays. Objects of all types are then queued and matched in one pass.
+  //
+  class TriggerObjectMatcher
+  {
+    public:
+      TriggerObjectMatcher(const double dRMax=0.2);
+      ~TriggerObjectMatcher();
+
+      // collect the (filter, bacon trigger object bit) pairs; call on every change in HLT menu
+      void setFilters(const std::vector<TriggerRecord> &triggerRecords);
+
+      // resolve filter indices and load trigger objects of the event
+      void build(const trigger::TriggerEvent &triggerEvent);
+
+      // queue an object; its bits are set by match()
+      void add(const double eta, const double phi, TriggerObjects &bits);
+
+      // set bits of all queued objects with a filter object within dRMax and empty the queue
+      void match();
+
+
+    protected:
+      struct Filter {
+        edm::InputTag  tag;
+        TriggerObjects mask;   // bacon bits of all records using this filter
+      };
+
+      struct Query {
+        double          eta, phi;
+        TriggerObjects *bits;
+      };
+
+      double fDRMax;
+
+      std::vector<Filter>         fFilters;
+      std::vector<int>            fFilterIndex;  // per event: filter of each object range
+      std::vector<unsigned int>   fStart;        // per event: first object of each range (size nRanges+1)
+      std::vector<float>          fEta, fPhi;    // per event: filter objects, grouped by filter
+      std::vector<Query>          fQueries;
+  };
+}
+#endif
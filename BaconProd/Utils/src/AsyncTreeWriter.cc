@@ -0,0 +1,175 @@
+#include "BaconProd/Utils/interface/AsyncTreeWriter.hh"
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
+#include "BaconAna/DataFormats/interface/ColumnarCollection.hh"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <TTree.h>
+#include <TDirectory.h>
+#include <TClonesArray.h>
+#include <TClass.h>
+#include <TThread.h>
+#include <TStopwatch.h>
+#include <RVersion.h>
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+#include <TROOT.h>
+#endif
+#include <algorithm>
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+AsyncTreeWriter::AsyncTreeWriter(TTree *tree, const bool async, const int nCompressionThreads):
+  fTree   (tree),
+  fAsync  (async),
+  fFillSeconds(0),
+  fWaitSeconds(0),
+  fThread (0),
+  fPending(false),
+  fStop   (false)
+{
+  assert(fTree);
+  if(fAsync) {
+    TThread::Initialize();  // ROOT locks its global tables when objects are streamed from another thread
+    fThread = new boost::thread(boost::bind(&AsyncTreeWriter::writer, this));
+  }
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+  if(nCompressionThreads > 1) ROOT::EnableImplicitMT(nCompressionThreads);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+AsyncTreeWriter::~AsyncTreeWriter()
+{
+  stop();
+  for(unsigned int islot=0; islot<fSlots.size(); islot++) {
+    fSlots[islot].destroy(fSlots[islot].back);
+    delete fSlots[islot].columns;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::addBranch(const char *name, TClonesArray *&front)
+{
+  assert(front);
+  TClonesArray *back = new TClonesArray(front->GetClass(), front->GetSize());
+  if(fAsync) TaskScheduler::preallocate(back);  // filled in turn with front, by concurrent fillers
+  addSlot(name, "TClonesArray", reinterpret_cast<void**>(&front), back, 0, &deleteArray);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::addColumns(const char *name, TClonesArray *&front)
+{
+  assert(front);
+  TClonesArray *back = new TClonesArray(front->GetClass(), front->GetSize());
+  if(fAsync) TaskScheduler::preallocate(back);  // filled in turn with front, by concurrent fillers
+  addSlot(name, "TClonesArray", reinterpret_cast<void**>(&front), back, 0, &deleteArray,
+          new ColumnarCollection(name, front->GetClass()->GetName()));
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::addSlot(const char *name, const char *className, void **front, void *back, CopyFunc copy, DeleteFunc destroy,
+                              ColumnarCollection *columns)
+{
+  assert(front && *front && back);
+  Slot slot;
+  slot.front   = front;
+  slot.back    = back;
+  slot.copy    = copy;
+  slot.destroy = destroy;
+  slot.columns = columns;
+  fSlots.push_back(slot);
+  if(columns) columns->branch(fTree);
+  else        fTree->Branch(name, className, &fSlots.back().back);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::deleteArray(void *obj)
+{
+  delete static_cast<TClonesArray*>(obj);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::fill()
+{
+  boost::mutex::scoped_lock lock(fMutex);
+  TStopwatch timer;
+  while(fPending) fCondition.wait(lock);
+  fWaitSeconds += timer.RealTime();
+  if(fException) boost::rethrow_exception(fException);
+
+  // the filled objects become the entry to write, the previous entry is filled next
+  for(unsigned int islot=0; islot<fSlots.size(); islot++) {
+    Slot &slot = fSlots[islot];
+    std::swap(*slot.front, slot.back);
+    if(slot.copy) slot.copy(*slot.front, slot.back);
+  }
+
+  if(!fAsync) {
+    fillEntry();
+    return;
+  }
+  fPending = true;
+  fCondition.notify_all();
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::fillEntry()
+{
+  TStopwatch timer;
+  for(unsigned int islot=0; islot<fSlots.size(); islot++) {
+    const Slot &slot = fSlots[islot];
+    if(slot.columns) slot.columns->gather(*static_cast<TClonesArray*>(slot.back));
+  }
+  fTree->Fill();
+  if(fAfterFill) fAfterFill();
+  fFillSeconds += timer.RealTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::finish()
+{
+  stop();
+  if(fException) boost::rethrow_exception(fException);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::stop()
+{
+  if(!fThread) return;
+  {
+    boost::mutex::scoped_lock lock(fMutex);
+    fStop = true;
+    fCondition.notify_all();
+  }
+  fThread->join();
+  delete fThread;
+  fThread = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void AsyncTreeWriter::writer()
+{
+  // the current directory of this thread, used when baskets are flushed
+  if(fTree->GetDirectory()) fTree->GetDirectory()->cd();
+
+  boost::mutex::scoped_lock lock(fMutex);
+  while(true) {
+    // a queued entry is written before stopping
+    while(!fPending && !fStop) fCondition.wait(lock);
+    if(!fPending) return;
+
+    lock.unlock();
+    boost::exception_ptr error;
+    try {
+      fillEntry();
+    } catch(...) {
+      error = boost::current_exception();
+    }
+    lock.lock();
+
+    if(error && !fException) fException = error;
+    fPending = false;
+    fCondition.notify_all();
+  }
+}
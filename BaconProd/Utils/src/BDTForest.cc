@@ -0,0 +1,304 @@
+#include "BaconProd/Utils/interface/BDTForest.hh"
+#include "BaconProd/Utils/interface/CalibrationBundle.hh"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+
+  // minimal scanner for the XML tags of a TMVA weight file
+  struct Tag {
+    std::string name;
+    std::string attrs;
+    bool        closing;
+    bool        selfClosing;
+    size_t      end;  // position after '>'
+  };
+
+  // tree node being read
+  struct OpenNode {
+    int   index;
+    int   cType;
+    int   nType;
+    float res, purity;
+    int   nChildren;
+  };
+
+  bool nextTag(const std::string &text, size_t &pos, Tag &tag)
+  {
+    while(true) {
+      const size_t open = text.find('<', pos);
+      if(open == std::string::npos) return false;
+      const size_t close = text.find('>', open);
+      if(close == std::string::npos) return false;
+      pos = close+1;
+      if(text[open+1] == '?' || text[open+1] == '!') continue;
+
+      tag.closing     = (text[open+1] == '/');
+      tag.selfClosing = (text[close-1] == '/');
+      const size_t nameBegin = open + (tag.closing ? 2 : 1);
+      const size_t nameEnd   = text.find_first_of(" \t\r\n/>", nameBegin);
+      tag.name  = text.substr(nameBegin, nameEnd-nameBegin);
+      tag.attrs = text.substr(nameEnd, close-nameEnd);
+      tag.end   = pos;
+      return true;
+    }
+  }
+
+  std::string attr(const Tag &tag, const std::string &name)
+  {
+    const std::string key = " " + name + "=\"";
+    size_t begin = tag.attrs.find(key);
+    if(begin == std::string::npos) return "";
+    begin += key.length();
+    return tag.attrs.substr(begin, tag.attrs.find('"', begin)-begin);
+  }
+
+  std::string text(const std::string &xml, const Tag &tag)
+  {
+    const size_t begin = xml.find_first_not_of(" \t\r\n", tag.end);
+    const size_t end   = xml.find('<', tag.end);
+    if(begin >= end) return "";
+    return xml.substr(begin, xml.find_last_not_of(" \t\r\n", end-1)+1-begin);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+BDTForest::BDTForest():
+  fIsInitialized(false),
+  fIsGrad       (false),
+  fNClasses     (1),
+  fMulticlass   (false)
+{}
+
+//--------------------------------------------------------------------------------------------------
+BDTForest::~BDTForest(){}
+
+//--------------------------------------------------------------------------------------------------
+bool BDTForest::initialize(const std::string weightFile)
+{
+  fIsInitialized = false;
+  fVarNames.clear();
+  fNodes.clear();
+  fTreeRoot.clear();
+  fTreeWeight.clear();
+
+  std::ifstream ifs(weightFile.c_str());
+  if(!ifs.is_open()) { std::cout << "[BDTForest] " << weightFile << " not found!" << std::endl; assert(0); }
+  std::stringstream buffer;
+  buffer << ifs.rdbuf();
+  const std::string xml = buffer.str();
+
+  std::string method, analysisType, boostType;
+  bool useYesNoLeaf     = false;
+  bool useWeightedTrees = true;
+  bool regressionLeaves = false;
+
+  std::vector<OpenNode> stack;  // nodes whose closing tag has not been read yet
+
+  size_t pos = 0;
+  Tag tag;
+  while(nextTag(xml, pos, tag)) {
+    if(tag.name == "MethodSetup" && !tag.closing) {
+      // only plain BDT methods; Category files embed their sub-methods further down
+      if(!method.empty()) return false;
+      method = attr(tag, "Method");
+      if(method.compare(0, 5, "BDT::") != 0) return false;
+
+    } else if(tag.name == "Info" && attr(tag, "name") == "AnalysisType") {
+      analysisType = attr(tag, "value");
+
+    } else if(tag.name == "Option" && !tag.closing) {
+      const std::string option = attr(tag, "name");
+      if(option == "BoostType")    boostType    = text(xml, tag);
+      if(option == "UseYesNoLeaf") useYesNoLeaf = (text(xml, tag) == "True");
+      if(option == "UseWeightedTrees") useWeightedTrees = (text(xml, tag) == "True");
+
+    } else if(tag.name == "Variable") {
+      fVarNames.push_back(attr(tag, "Expression"));
+
+    } else if(tag.name == "Transformations" && !tag.closing) {
+      if(atoi(attr(tag, "NTransformations").c_str()) != 0) return false;
+
+    } else if(tag.name == "Classes" && !tag.closing) {
+      fNClasses = atoi(attr(tag, "NClass").c_str());
+
+    } else if(tag.name == "Weights" && !tag.closing) {
+      // gradient boosting grows regression trees, whose leaves return their response
+      regressionLeaves = (atoi(attr(tag, "AnalysisType").c_str()) == 1);
+
+    } else if(tag.name == "BinaryTree" && !tag.closing) {
+      fTreeRoot.push_back(fNodes.size());
+      fTreeWeight.push_back(atof(attr(tag, "boostWeight").c_str()));
+
+    } else if(tag.name == "Node") {
+      if(!tag.closing) {
+        if(atoi(attr(tag, "NCoef").c_str()) != 0) return false;
+
+        OpenNode node;
+        node.index     = fNodes.size();
+        node.cType     = atoi(attr(tag, "cType").c_str());
+        node.nType     = atoi(attr(tag, "nType").c_str());
+        node.res       = atof(attr(tag, "res").c_str());
+        node.purity    = atof(attr(tag, "purity").c_str());
+        node.nChildren = 0;
+
+        Node flat;
+        flat.var      = atoi(attr(tag, "IVar").c_str());
+        flat.cut      = atof(attr(tag, "Cut").c_str());
+        flat.child[0] = flat.child[1] = -1;
+        fNodes.push_back(flat);
+
+        if(!stack.empty()) {
+          // TMVA goes right if (x >= cut) == cType
+          OpenNode   &parent = stack.back();
+          const bool right   = (attr(tag, "pos") == "r");
+          fNodes[parent.index].child[right == (parent.cType==1) ? 1 : 0] = node.index;
+          parent.nChildren++;
+        }
+        stack.push_back(node);
+      }
+
+      if(tag.closing || tag.selfClosing) {
+        if(stack.empty()) return false;
+        const OpenNode node = stack.back();
+        stack.pop_back();
+
+        Node &flat = fNodes[node.index];
+        if(node.nType == 0) {
+          if(node.nChildren != 2 || flat.var < 0 || flat.var >= int(fVarNames.size())) return false;
+        } else {
+          flat.var = -1;
+          if(regressionLeaves)  flat.cut = node.res;
+          else if(useYesNoLeaf) flat.cut = node.nType;
+          else                  flat.cut = node.purity;
+        }
+      }
+    }
+  }
+
+  if(method.empty() || fTreeRoot.empty() || !stack.empty()) return false;
+
+  fIsGrad     = (boostType == "Grad");
+  fMulticlass = (analysisType == "Multiclass");
+  if(fMulticlass && !fIsGrad) return false;
+  if(!fMulticlass && analysisType != "Classification") return false;
+  if(!fMulticlass) fNClasses = 1;
+  // without weighted trees TMVA averages the trees with equal weights
+  if(!useWeightedTrees) fTreeWeight.assign(fTreeWeight.size(), 1.);
+
+  fIsInitialized = true;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+int BDTForest::varIndex(const std::string &name) const
+{
+  for(unsigned int ivar=0; ivar<fVarNames.size(); ivar++) {
+    if(fVarNames[ivar] == name) return ivar;
+  }
+  return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BDTForest::evaluate(const float *inputs, const unsigned int nRows, float *out) const
+{
+  assert(fIsInitialized);
+
+  const unsigned int nVars = fVarNames.size();
+  std::vector<double> sums(nRows*fNClasses, 0);
+  double norm = 0;
+
+  for(unsigned int itree=0; itree<fTreeRoot.size(); itree++) {
+    const unsigned int iclass = fMulticlass ? itree%fNClasses : 0;
+    const double       weight = fIsGrad ? 1 : fTreeWeight[itree];
+    norm += weight;
+
+    for(unsigned int irow=0; irow<nRows; irow++) {
+      const float *x = inputs + irow*nVars;
+      int inode = fTreeRoot[itree];
+      while(fNodes[inode].var >= 0) {
+        const Node &node = fNodes[inode];
+        inode = node.child[x[node.var] >= node.cut];
+      }
+      sums[irow*fNClasses + iclass] += weight*fNodes[inode].cut;
+    }
+  }
+
+  for(unsigned int irow=0; irow<nRows; irow++) {
+    const double *sum = &sums[irow*fNClasses];
+    if(fMulticlass) {
+      for(unsigned int iclass=0; iclass<fNClasses; iclass++) {
+        double denom = 0;
+        for(unsigned int jclass=0; jclass<fNClasses; jclass++) {
+          if(jclass != iclass) denom += exp(sum[jclass] - sum[iclass]);
+        }
+        out[irow*fNClasses + iclass] = 1.0/(1.0 + denom);
+      }
+    } else if(fIsGrad) {
+      out[irow] = 2.0/(1.0 + exp(-2.0*sum[0])) - 1;
+    } else {
+      out[irow] = (norm > std::numeric_limits<double>::epsilon()) ? sum[0]/norm : 0;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void BDTForest::serialize(std::string &payload) const
+{
+  assert(fIsInitialized);
+
+  PayloadWriter writer(payload);
+  writer.put((unsigned int)fVarNames.size());
+  for(unsigned int ivar=0; ivar<fVarNames.size(); ivar++) {
+    writer.put(fVarNames[ivar]);
+  }
+  writer.put((unsigned char)fIsGrad);
+  writer.put((unsigned char)fMulticlass);
+  writer.put(fNClasses);
+  writer.putArray(fTreeRoot);
+  writer.putArray(fTreeWeight);
+  writer.putArray(fNodes);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool BDTForest::deserialize(const char *data, const unsigned long long size)
+{
+  fIsInitialized = false;
+
+  PayloadReader reader(data, size);
+  unsigned int nVars = 0;
+  if(!reader.get(nVars)) return false;
+  fVarNames.resize(nVars);
+  for(unsigned int ivar=0; ivar<nVars; ivar++) {
+    if(!reader.get(fVarNames[ivar])) return false;
+  }
+  unsigned char isGrad = 0, multiclass = 0;
+  if(!reader.get(isGrad) || !reader.get(multiclass) || !reader.get(fNClasses)) return false;
+  fIsGrad     = isGrad;
+  fMulticlass = multiclass;
+  if(!reader.getArray(fTreeRoot) || !reader.getArray(fTreeWeight) || !reader.getArray(fNodes) || !reader.atEnd()) return false;
+
+  // a damaged payload must not send the tree walk out of the node array
+  if(fNClasses == 0 || (!fIsGrad && fTreeWeight.size() != fTreeRoot.size())) return false;
+  for(unsigned int itree=0; itree<fTreeRoot.size(); itree++) {
+    if(fTreeRoot[itree] < 0 || fTreeRoot[itree] >= (int)fNodes.size()) return false;
+  }
+  for(unsigned int inode=0; inode<fNodes.size(); inode++) {
+    const Node &node = fNodes[inode];
+    if(node.var < 0) continue;
+    if(node.var >= (int)nVars) return false;
+    for(unsigned int ichild=0; ichild<2; ichild++) {
+      if(node.child[ichild] <= (int)inode || node.child[ichild] >= (int)fNodes.size()) return false;
+    }
+  }
+
+  fIsInitialized = true;
+  return true;
+}
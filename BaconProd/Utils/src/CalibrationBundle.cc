@@ -0,0 +1,178 @@
+#include "BaconProd/Utils/interface/CalibrationBundle.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  const char kMagic[8] = { 'B','A','C','O','N','C','A','L' };
+
+  // file header, followed by the entry table, the source names and the payloads (8-byte aligned)
+  struct Header {
+    char         magic[8];
+    unsigned int version;
+    unsigned int nEntries;
+  };
+
+  unsigned long long align8(const unsigned long long pos) { return (pos + 7) & ~7ULL; }
+}
+
+//--------------------------------------------------------------------------------------------------
+CalibrationBundle::CalibrationBundle():
+  fData    (0),
+  fSize    (0),
+  fNEntries(0),
+  fTable   (0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+CalibrationBundle::~CalibrationBundle()
+{
+  close();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationBundle::open(const std::string &filename)
+{
+  close();
+
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if(fd < 0) return false;
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) { ::close(fd); return false; }
+  void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(data == MAP_FAILED) return false;
+
+  fData = static_cast<const char*>(data);
+  fSize = st.st_size;
+
+  const Header *header = reinterpret_cast<const Header*>(fData);
+  if(memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+     sizeof(Header) + header->nEntries*sizeof(TableEntry) > fSize) {
+    close();
+    return false;
+  }
+  fNEntries = header->nEntries;
+  fTable    = reinterpret_cast<const TableEntry*>(fData + sizeof(Header));
+
+  for(unsigned int ie=0; ie<fNEntries; ie++) {
+    if(fTable[ie].offset + fTable[ie].size > fSize || fTable[ie].sourceOffset + fTable[ie].sourceLength > fSize) {
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void CalibrationBundle::close()
+{
+  if(fData) munmap(const_cast<char*>(fData), fSize);
+  fData     = 0;
+  fSize     = 0;
+  fNEntries = 0;
+  fTable    = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+const char* CalibrationBundle::find(const unsigned int kind, const unsigned long long hash, unsigned long long &size) const
+{
+  for(unsigned int ie=0; ie<fNEntries; ie++) {
+    if(fTable[ie].kind != kind || fTable[ie].hash != hash) continue;
+    size = fTable[ie].size;
+    return fData + fTable[ie].offset;
+  }
+  size = 0;
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationBundle::sourceHash(const std::string &source, const FileStamp &stamp, unsigned long long &hash) const
+{
+  for(unsigned int ie=0; ie<fNEntries; ie++) {
+    if(fTable[ie].sourceSize != stamp.size || fTable[ie].sourceMtime != stamp.mtime) continue;
+    if(source.compare(0, std::string::npos, fData + fTable[ie].sourceOffset, fTable[ie].sourceLength) != 0) continue;
+    hash = fTable[ie].hash;
+    return true;
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationBundle::write(const std::string &filename, const std::vector<Entry> &entries)
+{
+  Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version  = kVersion;
+  header.nEntries = entries.size();
+
+  // lay out the source names and payloads after the table
+  std::vector<TableEntry> table(entries.size());
+  unsigned long long pos = sizeof(Header) + entries.size()*sizeof(TableEntry);
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    table[ie].kind         = entries[ie].kind;
+    table[ie].hash         = entries[ie].hash;
+    table[ie].sourceSize   = entries[ie].stamp.size;
+    table[ie].sourceMtime  = entries[ie].stamp.mtime;
+    table[ie].sourceLength = entries[ie].source.size();
+    table[ie].sourceOffset = pos;
+    pos += entries[ie].source.size();
+  }
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    pos = align8(pos);
+    table[ie].offset = pos;
+    table[ie].size   = entries[ie].payload.size();
+    pos += entries[ie].payload.size();
+  }
+
+  std::ofstream ofs(filename.c_str(), std::ios::binary);
+  if(!ofs.is_open()) return false;
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  if(!table.empty()) ofs.write(reinterpret_cast<const char*>(&table[0]), table.size()*sizeof(TableEntry));
+  unsigned long long written = sizeof(Header) + table.size()*sizeof(TableEntry);
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    ofs.write(entries[ie].source.data(), entries[ie].source.size());
+    written += entries[ie].source.size();
+  }
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    const std::string padding(table[ie].offset - written, '\0');
+    ofs.write(padding.data(), padding.size());
+    ofs.write(entries[ie].payload.data(), entries[ie].payload.size());
+    written = table[ie].offset + table[ie].size;
+  }
+  return ofs.good();
+}
+
+//--------------------------------------------------------------------------------------------------
+unsigned long long CalibrationBundle::contentHash(const std::string &filename)
+{
+  std::ifstream ifs(filename.c_str(), std::ios::binary);
+  if(!ifs.is_open()) { std::cout << "[CalibrationBundle] " << filename << " not found!" << std::endl; assert(0); }
+
+  unsigned long long hash = 14695981039346656037ULL;
+  char buffer[4096];
+  while(ifs.read(buffer, sizeof(buffer)) || ifs.gcount()>0) {
+    const std::streamsize n = ifs.gcount();
+    for(std::streamsize i=0; i<n; i++) {
+      hash ^= (unsigned char)buffer[i];
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationBundle::fileStamp(const std::string &filename, FileStamp &stamp)
+{
+  struct stat st;
+  if(stat(filename.c_str(), &st) != 0) return false;
+  stamp.size  = st.st_size;
+  stamp.mtime = st.st_mtim.tv_sec*1000000000LL + st.st_mtim.tv_nsec;
+  return true;
+}
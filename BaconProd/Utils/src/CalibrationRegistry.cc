@@ -0,0 +1,294 @@
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/CalibrationBundle.hh"
+#include "BaconProd/Utils/interface/BDTForest.hh"
+#include "BaconProd/Utils/interface/CorrectionTable.hh"
+#include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
+#include <boost/thread/mutex.hpp>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  boost::mutex sRegistryMutex;
+  std::map<std::string, boost::shared_ptr<const JetCorrectorParameters> > sJetCorrectorParameters;
+  std::map<std::string, boost::shared_ptr<const BDTForest> >              sBDTForests;
+  std::map<std::string, boost::shared_ptr<const CorrectionTable> >        sCorrectionTables;
+  CalibrationBundle sBundle;
+
+  // content hashes by file path, with the size and modification time they were taken at
+  struct HashedFile {
+    CalibrationBundle::FileStamp stamp;
+    unsigned long long           hash;
+  };
+  std::map<std::string, HashedFile> sFileHashes;
+
+  // content hash of a file; the file is only read if it changed since the last request and the
+  // bundle has no hash of it as it is now
+  unsigned long long hashOf(const std::string &filename)
+  {
+    CalibrationBundle::FileStamp stamp;
+    if(!CalibrationBundle::fileStamp(filename, stamp)) { std::cout << "[CalibrationRegistry] " << filename << " not found!" << std::endl; assert(0); }
+    std::map<std::string, HashedFile>::const_iterator it = sFileHashes.find(filename);
+    if(it != sFileHashes.end() && it->second.stamp == stamp) return it->second.hash;
+
+    HashedFile &file = sFileHashes[filename];
+    file.stamp = stamp;
+    if(!sBundle.sourceHash(filename, stamp, file.hash)) file.hash = CalibrationBundle::contentHash(filename);
+    return file.hash;
+  }
+
+  //
+  // JEC payload: definitions line (as in the text file, without braces), then the records
+  //
+  void serializeJEC(const JetCorrectorParameters &params, std::string &payload)
+  {
+    const JetCorrectorParameters::Definitions &defs = params.definitions();
+    std::stringstream line;
+    line << defs.nBinVar();
+    for(unsigned int ivar=0; ivar<defs.nBinVar(); ivar++) line << " " << defs.binVar(ivar);
+    line << " " << defs.nParVar();
+    for(unsigned int ivar=0; ivar<defs.nParVar(); ivar++) line << " " << defs.parVar(ivar);
+    line << " " << defs.formula() << " " << (defs.isResponse() ? "Response" : "Correction") << " " << defs.level();
+
+    PayloadWriter writer(payload);
+    writer.put(line.str());
+    writer.put(params.size());
+    for(unsigned int irec=0; irec<params.size(); irec++) {
+      const JetCorrectorParameters::Record &rec = params.record(irec);
+      std::vector<float> xmin(defs.nBinVar()), xmax(defs.nBinVar());
+      for(unsigned int ivar=0; ivar<defs.nBinVar(); ivar++) {
+        xmin[ivar] = rec.xMin(ivar);
+        xmax[ivar] = rec.xMax(ivar);
+      }
+      writer.putArray(xmin);
+      writer.putArray(xmax);
+      writer.putArray(rec.parameters());
+    }
+  }
+
+  JetCorrectorParameters* deserializeJEC(const char *data, const unsigned long long size)
+  {
+    PayloadReader reader(data, size);
+    std::string line;
+    unsigned int nRecords = 0;
+    if(!reader.get(line) || !reader.get(nRecords)) return 0;
+    const JetCorrectorParameters::Definitions defs(line);
+
+    std::vector<JetCorrectorParameters::Record> records;
+    records.reserve(nRecords);
+    std::vector<float> xmin, xmax, pars;
+    for(unsigned int irec=0; irec<nRecords; irec++) {
+      if(!reader.getArray(xmin) || !reader.getArray(xmax) || !reader.getArray(pars)) return 0;
+      if(xmin.size() != defs.nBinVar() || xmax.size() != defs.nBinVar()) return 0;
+      records.push_back(JetCorrectorParameters::Record(defs.nBinVar(), xmin, xmax, pars));
+    }
+    if(!reader.atEnd()) return 0;
+    return new JetCorrectorParameters(defs, records);
+  }
+
+  // comma separated numbers, one row per non-empty line ('#' starts a comment)
+  void parseTable(const std::string &filename, CalibrationRegistry::Table &table)
+  {
+    std::ifstream ifs(filename.c_str());
+    if(!ifs.is_open()) { std::cout << "[CalibrationRegistry] " << filename << " not found!" << std::endl; assert(0); }
+
+    std::string line;
+    while(std::getline(ifs,line)) {
+      line = line.substr(0, line.find('#'));
+      if(line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+      std::vector<double> row;
+      std::stringstream ss(line);
+      std::string field;
+      while(std::getline(ss,field,',')) {
+        row.push_back(atof(field.c_str()));
+      }
+      table.push_back(row);
+    }
+  }
+
+  // all rows share the number of values of the shortest row
+  bool buildCorrectionTable(const CalibrationRegistry::Table &table, CorrectionTable &corrTable)
+  {
+    if(table.empty()) return corrTable.build(table, 0);
+    unsigned int nCols = table[0].size();
+    for(unsigned int irow=1; irow<table.size(); irow++) {
+      nCols = std::min(nCols, (unsigned int)table[irow].size());
+    }
+    return nCols >= 2 && corrTable.build(table, nCols-2);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string CalibrationRegistry::key(const std::string &filename, const unsigned long long hash)
+{
+  std::stringstream ss;
+  ss << filename << "#" << std::hex << hash;
+  return ss.str();
+}
+
+//--------------------------------------------------------------------------------------------------
+boost::shared_ptr<const JetCorrectorParameters> CalibrationRegistry::jetCorrectorParameters(const std::string &filename)
+{
+  boost::mutex::scoped_lock lock(sRegistryMutex);
+  const unsigned long long hash = hashOf(filename);
+  boost::shared_ptr<const JetCorrectorParameters> &params = sJetCorrectorParameters[key(filename, hash)];
+  if(params) return params;
+
+  unsigned long long size = 0;
+  const char *data = sBundle.find(CalibrationBundle::kJetCorrectorParameters, hash, size);
+  if(data) params.reset(deserializeJEC(data, size));
+  if(!params) params.reset(new JetCorrectorParameters(filename));
+  return params;
+}
+
+//--------------------------------------------------------------------------------------------------
+boost::shared_ptr<const BDTForest> CalibrationRegistry::bdtForest(const std::string &filename)
+{
+  boost::mutex::scoped_lock lock(sRegistryMutex);
+  const unsigned long long hash = hashOf(filename);
+  const std::string lKey = key(filename, hash);
+  std::map<std::string, boost::shared_ptr<const BDTForest> >::const_iterator it = sBDTForests.find(lKey);
+  if(it != sBDTForests.end()) return it->second;
+
+  // unsupported files are cached as null too, so they are only scanned once
+  BDTForest *forest = new BDTForest();
+  unsigned long long size = 0;
+  const char *data = sBundle.find(CalibrationBundle::kBDTForest, hash, size);
+  if(!(data && forest->deserialize(data, size)) && !forest->initialize(filename)) { delete forest; forest = 0; }
+  boost::shared_ptr<const BDTForest> &entry = sBDTForests[lKey];
+  entry.reset(forest);
+  return entry;
+}
+
+//--------------------------------------------------------------------------------------------------
+boost::shared_ptr<const CorrectionTable> CalibrationRegistry::correctionTable(const std::string &filename)
+{
+  boost::mutex::scoped_lock lock(sRegistryMutex);
+  const unsigned long long hash = hashOf(filename);
+  boost::shared_ptr<const CorrectionTable> &entry = sCorrectionTables[key(filename, hash)];
+  if(entry) return entry;
+
+  CorrectionTable *corrTable = new CorrectionTable();
+  unsigned long long size = 0;
+  const char *data = sBundle.find(CalibrationBundle::kCorrectionTable, hash, size);
+  if(!(data && corrTable->deserialize(data, size))) {
+    Table table;
+    parseTable(filename, table);
+    if(!buildCorrectionTable(table, *corrTable)) { std::cout << "[CalibrationRegistry] " << filename << " is not an interval table!" << std::endl; assert(0); }
+  }
+  entry.reset(corrTable);
+  return entry;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationRegistry::loadBundle(const std::string &filename)
+{
+  boost::mutex::scoped_lock lock(sRegistryMutex);
+  return sBundle.open(filename);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationRegistry::compile(const unsigned int kind, const std::string &filename, std::string &payload)
+{
+  payload.clear();
+  if(kind == CalibrationBundle::kJetCorrectorParameters) {
+    serializeJEC(JetCorrectorParameters(filename), payload);
+
+  } else if(kind == CalibrationBundle::kBDTForest) {
+    BDTForest forest;
+    if(!forest.initialize(filename)) return false;
+    forest.serialize(payload);
+
+  } else if(kind == CalibrationBundle::kCorrectionTable) {
+    Table table;
+    parseTable(filename, table);
+    CorrectionTable corrTable;
+    if(!buildCorrectionTable(table, corrTable)) return false;
+    corrTable.serialize(payload);
+
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CalibrationRegistry::verify(const unsigned int kind, const std::string &filename, const char *data, const unsigned long long size)
+{
+  if(kind == CalibrationBundle::kJetCorrectorParameters) {
+    // definitions and every record, field by field
+    const JetCorrectorParameters parsed(filename);
+    boost::shared_ptr<const JetCorrectorParameters> loaded(deserializeJEC(data, size));
+    if(!loaded) { std::cout << "[CalibrationRegistry] " << filename << ": JEC payload not readable" << std::endl; return false; }
+    const JetCorrectorParameters::Definitions &defA = parsed.definitions();
+    const JetCorrectorParameters::Definitions &defB = loaded->definitions();
+    bool same = defA.nBinVar() == defB.nBinVar() && defA.nParVar() == defB.nParVar() && defA.formula() == defB.formula() &&
+                defA.isResponse() == defB.isResponse() && defA.level() == defB.level();
+    for(unsigned int ivar=0; same && ivar<defA.nBinVar(); ivar++) same = (defA.binVar(ivar) == defB.binVar(ivar));
+    for(unsigned int ivar=0; same && ivar<defA.nParVar(); ivar++) same = (defA.parVar(ivar) == defB.parVar(ivar));
+    if(!same) { std::cout << "[CalibrationRegistry] " << filename << ": JEC definitions differ" << std::endl; return false; }
+    if(parsed.size() != loaded->size()) { std::cout << "[CalibrationRegistry] " << filename << ": " << parsed.size() << " and " << loaded->size() << " JEC records" << std::endl; return false; }
+    for(unsigned int irec=0; irec<parsed.size(); irec++) {
+      const JetCorrectorParameters::Record &recA = parsed.record(irec);
+      const JetCorrectorParameters::Record &recB = loaded->record(irec);
+      same = (recA.parameters() == recB.parameters());
+      for(unsigned int ivar=0; same && ivar<defA.nBinVar(); ivar++) same = (recA.xMin(ivar) == recB.xMin(ivar) && recA.xMax(ivar) == recB.xMax(ivar));
+      if(!same) { std::cout << "[CalibrationRegistry] " << filename << ": JEC record " << irec << " differs" << std::endl; return false; }
+    }
+
+  } else if(kind == CalibrationBundle::kBDTForest) {
+    // the payload covers every member of a forest, so equal payloads are equal forests
+    BDTForest parsed, loaded;
+    if(!parsed.initialize(filename) || !loaded.deserialize(data, size)) { std::cout << "[CalibrationRegistry] " << filename << ": BDT payload not readable" << std::endl; return false; }
+    std::string payloadA, payloadB;
+    parsed.serialize(payloadA);
+    loaded.serialize(payloadB);
+    if(payloadA != payloadB) { std::cout << "[CalibrationRegistry] " << filename << ": BDT forests differ" << std::endl; return false; }
+
+  } else if(kind == CalibrationBundle::kCorrectionTable) {
+    // lookups at the ends and the middle of every interval against a scan of the text rows
+    Table rows;
+    parseTable(filename, rows);
+    CorrectionTable loaded;
+    if(!loaded.deserialize(data, size)) { std::cout << "[CalibrationRegistry] " << filename << ": correction table payload not readable" << std::endl; return false; }
+    if(loaded.nRows() != rows.size()) { std::cout << "[CalibrationRegistry] " << filename << ": " << rows.size() << " and " << loaded.nRows() << " rows" << std::endl; return false; }
+    for(unsigned int irow=0; irow<rows.size(); irow++) {
+      if(rows[irow].size() < loaded.nValues()+2) { std::cout << "[CalibrationRegistry] " << filename << ": row " << irow << " is too short" << std::endl; return false; }
+    }
+    for(unsigned int irow=0; irow<rows.size(); irow++) {
+      const double probes[] = { rows[irow][0], 0.5*(rows[irow][0] + rows[irow][1]), rows[irow][1] };
+      for(unsigned int iprobe=0; iprobe<3; iprobe++) {
+        int expected = -1;
+        for(unsigned int jrow=0; jrow<rows.size(); jrow++) {
+          if(rows[jrow][0] <= probes[iprobe] && probes[iprobe] <= rows[jrow][1]) expected = jrow;
+        }
+        if(loaded.find(probes[iprobe]) != expected) { std::cout << "[CalibrationRegistry] " << filename << ": lookup of " << probes[iprobe] << " differs" << std::endl; return false; }
+      }
+      for(unsigned int icat=0; icat<loaded.nValues(); icat++) {
+        if(loaded.value(irow, icat) != rows[irow][icat+2]) { std::cout << "[CalibrationRegistry] " << filename << ": row " << irow << " differs" << std::endl; return false; }
+      }
+    }
+
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void CalibrationRegistry::clear()
+{
+  boost::mutex::scoped_lock lock(sRegistryMutex);
+  sJetCorrectorParameters.clear();
+  sBDTForests.clear();
+  sCorrectionTables.clear();
+  sFileHashes.clear();
+  sBundle.close();
+}
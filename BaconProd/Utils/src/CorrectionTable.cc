@@ -0,0 +1,87 @@
+#include "BaconProd/Utils/interface/CorrectionTable.hh"
+#include "BaconProd/Utils/interface/CalibrationBundle.hh"
+#include <algorithm>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+CorrectionTable::CorrectionTable():
+  fNRows  (0),
+  fNValues(0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+bool CorrectionTable::build(const std::vector<std::vector<double> > &rows, const unsigned int nValues)
+{
+  fNRows   = 0;
+  fNValues = nValues;
+  fValues.clear();
+  fBounds.clear();
+  fPointRow.clear();
+  fGapRow.clear();
+
+  std::vector<double> mins, maxs;
+  for(unsigned int irow=0; irow<rows.size(); irow++) {
+    if(rows[irow].size() < 2+nValues) return false;
+    mins.push_back(rows[irow][0]);
+    maxs.push_back(rows[irow][1]);
+    fBounds.push_back(rows[irow][0]);
+    fBounds.push_back(rows[irow][1]);
+    fValues.insert(fValues.end(), rows[irow].begin()+2, rows[irow].begin()+2+nValues);
+  }
+  fNRows = rows.size();
+
+  std::sort(fBounds.begin(), fBounds.end());
+  fBounds.erase(std::unique(fBounds.begin(), fBounds.end()), fBounds.end());
+
+  // resolve every elementary piece (bound points and the open gaps between them) once;
+  // later rows overwrite earlier ones, so each piece keeps the last row covering it
+  fPointRow.assign(fBounds.size(), -1);
+  fGapRow.assign(fBounds.size()+1, -1);
+  for(unsigned int irow=0; irow<fNRows; irow++) {
+    if(mins[irow] > maxs[irow]) continue;
+    const unsigned int first = std::lower_bound(fBounds.begin(), fBounds.end(), mins[irow]) - fBounds.begin();
+    const unsigned int last  = std::lower_bound(fBounds.begin(), fBounds.end(), maxs[irow]) - fBounds.begin();
+    for(unsigned int ib=first; ib<=last; ib++) {
+      fPointRow[ib] = irow;
+      if(ib > first) fGapRow[ib] = irow;
+    }
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+int CorrectionTable::find(const double x) const
+{
+  const unsigned int ib = std::lower_bound(fBounds.begin(), fBounds.end(), x) - fBounds.begin();
+  if(ib < fBounds.size() && fBounds[ib] == x) return fPointRow[ib];
+  return fGapRow[ib];
+}
+
+//--------------------------------------------------------------------------------------------------
+void CorrectionTable::serialize(std::string &payload) const
+{
+  PayloadWriter writer(payload);
+  writer.put(fNRows);
+  writer.put(fNValues);
+  writer.putArray(fValues);
+  writer.putArray(fBounds);
+  writer.putArray(fPointRow);
+  writer.putArray(fGapRow);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CorrectionTable::deserialize(const char *data, const unsigned long long size)
+{
+  PayloadReader reader(data, size);
+  if(!reader.get(fNRows) || !reader.get(fNValues)) return false;
+  if(!reader.getArray(fValues) || !reader.getArray(fBounds) || !reader.getArray(fPointRow) || !reader.getArray(fGapRow)) return false;
+  if(!reader.atEnd()) return false;
+
+  if(fValues.size() != (unsigned long long)fNRows*fNValues) return false;
+  if(fPointRow.size() != fBounds.size() || fGapRow.size() != fBounds.size()+1) return false;
+  for(unsigned int ib=0; ib<fGapRow.size(); ib++) {
+    if(fGapRow[ib] >= (int)fNRows || (ib < fPointRow.size() && fPointRow[ib] >= (int)fNRows)) return false;
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+#include "BaconProd/Utils/interface/DeterminismCheck.hh"
+#include <TClass.h>
+#include <TClonesArray.h>
+#include <TBufferFile.h>
+#include <cstring>
+#include <iostream>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+DeterminismCheck::DeterminismCheck():
+  fBufferA     (new TBufferFile(TBuffer::kWrite)),
+  fBufferB     (new TBufferFile(TBuffer::kWrite)),
+  fNCompared   (0),
+  fNDifferences(0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+DeterminismCheck::~DeterminismCheck()
+{
+  delete fBufferA;
+  delete fBufferB;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool DeterminismCheck::compare(const std::string &name, const TClonesArray &a, const TClonesArray &b)
+{
+  fNCompared++;
+  if(a.GetClass() != b.GetClass() || a.GetEntriesFast() != b.GetEntriesFast()) {
+    std::cout << "[DeterminismCheck] " << name << ": " << a.GetEntriesFast() << " and " << b.GetEntriesFast() << " objects" << std::endl;
+    fNDifferences++;
+    return false;
+  }
+  for(int iobj=0; iobj<a.GetEntriesFast(); iobj++) {
+    if(sameBytes(a.GetClass(), a.UncheckedAt(iobj), b.UncheckedAt(iobj))) continue;
+    std::cout << "[DeterminismCheck] " << name << ": object " << iobj << " differs" << std::endl;
+    fNDifferences++;
+    return false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool DeterminismCheck::compare(const std::string &name, const TClass *cls, const void *a, const void *b)
+{
+  fNCompared++;
+  if(sameBytes(cls, a, b)) return true;
+  std::cout << "[DeterminismCheck] " << name << " differs" << std::endl;
+  fNDifferences++;
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+void DeterminismCheck::report(std::ostream &os) const
+{
+  os << "[DeterminismCheck] " << fNCompared << " outputs compared, " << fNDifferences << " differences" << std::endl;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool DeterminismCheck::sameBytes(const TClass *cls, const void *a, const void *b)
+{
+  fBufferA->Reset();
+  fBufferB->Reset();
+  fBufferA->WriteObjectAny(a, cls);
+  fBufferB->WriteObjectAny(b, cls);
+  return fBufferA->Length() == fBufferB->Length() && memcmp(fBufferA->Buffer(), fBufferB->Buffer(), fBufferA->Length()) == 0;
+}
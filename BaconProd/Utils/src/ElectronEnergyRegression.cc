@@ -1,10 +1,10 @@
 #include "BaconProd/Utils/interface/ElectronEnergyRegression.hh"
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include "DataFormats/EgammaReco/interface/SuperCluster.h"
 #include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
 #include "FWCore/Framework/interface/EventSetup.h"
-#include "RecoEcal/EgammaCoreTools/interface/EcalClusterLazyTools.h"
 #include "RecoEgamma/EgammaTools/interface/EcalClusterLocal.h"
 #include "Cintex/Cintex.h"
 #include <TFile.h>
@@ -52,7 +52,7 @@ void ElectronEnergyRegression::initialize(const char *regressionFilename, Regres
 
 //--------------------------------------------------------------------------------------------------
 std::pair<double,double> ElectronEnergyRegression::evaluate(const reco::GsfElectron *ele, double rho, int nvertices, 
-                                                            const edm::EventSetup &iSetup, EcalClusterLazyTools &lazyTools,
+                                                            const edm::EventSetup &iSetup, const ShowerShapes &shapes,
 							    bool printDebug)
 {  
   assert(ele);
@@ -63,13 +63,15 @@ std::pair<double,double> ElectronEnergyRegression::evaluate(const reco::GsfElect
   const reco::SuperClusterRef sc   = ele->superCluster();
   const reco::CaloClusterPtr& seed = sc->seed();  
   
-  // compute shower shape variables for the supercluster seed
-  std::vector<float> vCov = lazyTools.localCovariances(*seed);
+  // shower shape variables for the supercluster seed
+  const std::vector<float> &vCov = shapes.localCovariances();
   
   // compute ECAL local quantites for the supercluster seed
   float etacry, phicry, thetatilt, phitilt;
   int ieta, iphi;
   EcalClusterLocal local;
+  // reads the calorimeter geometry from the event setup, where NtuplerMod::prefetchRefTargets has
+  // already retrieved it for the event, so that concurrent fillers only read the cached record
   if(seed->hitsAndFractions().at(0).first.subdetId()==EcalBarrel) {
     local.localCoordsEB(*seed,iSetup,etacry,phicry,ieta,iphi,thetatilt,phitilt); 
   } else {
@@ -82,7 +84,7 @@ std::pair<double,double> ElectronEnergyRegression::evaluate(const reco::GsfElect
   double SCRawEnergy      = sc->rawEnergy();                        // SuperCluster raw energy
   double scEta            = sc->eta();                              // SuperCluster eta
   double scPhi            = sc->phi();                              // SuperCluster phi
-  double R9               = lazyTools.e3x3(*seed)/sc->rawEnergy();  // SuperCluster R9
+  double R9               = shapes.r9();                            // SuperCluster R9
   double etawidth         = sc->etaWidth();                         // SuperCluster width in eta
   double phiwidth         = sc->phiWidth();                         // SuperCluster width in phi
   double NClusters        = sc->clustersSize();                     // number of basic clusters in the SuperCluster
@@ -90,22 +92,22 @@ std::pair<double,double> ElectronEnergyRegression::evaluate(const reco::GsfElect
   double EtaSeed          = seed->eta();                            // seed cluster eta
   double PhiSeed          = seed->phi();                            // seed cluster phi
   double ESeed            = seed->energy();                         // seed cluster energy
-  double E3x3Seed         = lazyTools.e3x3(*seed);                  // seed cluster E3x3
-  double E5x5Seed         = lazyTools.e5x5(*seed);                  // seed cluster E5x5
+  double E3x3Seed         = shapes.e3x3();                          // seed cluster E3x3
+  double E5x5Seed         = shapes.e5x5();                          // seed cluster E5x5
   double see              = isnan(vCov[0]) ? 0 : sqrt(vCov[0]);     // SuperCluster sigma_ieta_ieta
   double spp              = isnan(vCov[2]) ? 0 : sqrt(vCov[2]);     // SuperCluster sigma_iphi_iphi
   double sep              = isnan(vCov[1]) ? 0 : vCov[1]/see/spp;   // SuperCluster cov(ieta,iphi)/(sigma_ieta_ieta * sigma_iphi_iphi)
-  double EMaxSeed         = lazyTools.eMax(*seed);                  // seed cluster EMax
-  double E2ndSeed         = lazyTools.e2nd(*seed);                  // seed cluster E2nd
-  double ETopSeed         = lazyTools.eTop(*seed);                  // seed cluster ETop
-  double EBottomSeed      = lazyTools.eBottom(*seed);               // seed cluster EBottom
-  double ELeftSeed        = lazyTools.eLeft(*seed);                 // seed cluster ELeft
-  double ERightSeed       = lazyTools.eRight(*seed);                // seed cluster ERight
-  double E2x5MaxSeed      = lazyTools.e2x5Max(*seed);               // seed cluster E2x5Max
-  double E2x5TopSeed      = lazyTools.e2x5Top(*seed);               // seed cluster E2x5Top
-  double E2x5BottomSeed   = lazyTools.e2x5Bottom(*seed);            // seed cluster E2x5Bottom
-  double E2x5LeftSeed     = lazyTools.e2x5Left(*seed);              // seed cluster E2x5Left
-  double E2x5RightSeed    = lazyTools.e2x5Right(*seed);             // seed cluster E2x5Right
+  double EMaxSeed         = shapes.eMax();                          // seed cluster EMax
+  double E2ndSeed         = shapes.e2nd();                          // seed cluster E2nd
+  double ETopSeed         = shapes.eTop();                          // seed cluster ETop
+  double EBottomSeed      = shapes.eBottom();                       // seed cluster EBottom
+  double ELeftSeed        = shapes.eLeft();                         // seed cluster ELeft
+  double ERightSeed       = shapes.eRight();                        // seed cluster ERight
+  double E2x5MaxSeed      = shapes.e2x5Max();                       // seed cluster E2x5Max
+  double E2x5TopSeed      = shapes.e2x5Top();                       // seed cluster E2x5Top
+  double E2x5BottomSeed   = shapes.e2x5Bottom();                    // seed cluster E2x5Bottom
+  double E2x5LeftSeed     = shapes.e2x5Left();                      // seed cluster E2x5Left
+  double E2x5RightSeed    = shapes.e2x5Right();                     // seed cluster E2x5Right
   double IEtaSeed         = ieta;                                   // seed cluster IEta
   double IPhiSeed         = iphi;                                   // seed cluster IPhi
   double EtaCrySeed       = etacry;                                 // eta of highest energy crystal in seed cluster
@@ -186,18 +188,18 @@ std::pair<double,double> ElectronEnergyRegression::evaluate(const reco::GsfElect
   double ESub1         = sub1 ? sub1->energy()        : 0.;     // 1st sub-cluster energy
   double EtaSub1       = sub1 ? sub1->eta()           : 999.;   // 1st sub-cluster eta
   double PhiSub1       = sub1 ? sub1->phi()           : 999.;   // 1st sub-cluster phi
-  double EMaxSub1      = sub1 ? lazyTools.eMax(*sub1) : 0.;     // 1st sub-cluster EMax
-  double E3x3Sub1      = sub1 ? lazyTools.e3x3(*sub1) : 0.;     // 1st sub-cluster E3x3
+  double EMaxSub1      = sub1 ? shapes.clusterEMax(*sub1) : 0.; // 1st sub-cluster EMax
+  double E3x3Sub1      = sub1 ? shapes.clusterE3x3(*sub1) : 0.; // 1st sub-cluster E3x3
   double ESub2         = sub2 ? sub2->energy()        : 0.;     // 2nd sub-cluster energy
   double EtaSub2       = sub2 ? sub2->eta()           : 999.;   // 2nd sub-cluster eta
   double PhiSub2       = sub2 ? sub2->phi()           : 999.;   // 2nd sub-cluster phi
-  double EMaxSub2      = sub2 ? lazyTools.eMax(*sub2) : 0.;     // 2nd sub-cluster EMax
-  double E3x3Sub2      = sub2 ? lazyTools.e3x3(*sub2) : 0.;     // 2nd sub-cluster E3x3
+  double EMaxSub2      = sub2 ? shapes.clusterEMax(*sub2) : 0.; // 2nd sub-cluster EMax
+  double E3x3Sub2      = sub2 ? shapes.clusterE3x3(*sub2) : 0.; // 2nd sub-cluster E3x3
   double ESub3         = sub3 ? sub3->energy()        : 0.;     // 3rd sub-cluster energy
   double EtaSub3       = sub3 ? sub3->eta()           : 999.;   // 3rd sub-cluster eta
   double PhiSub3       = sub3 ? sub3->phi()           : 999.;   // 3rd sub-cluster phi
-  double EMaxSub3      = sub3 ? lazyTools.eMax(*sub3) : 0.;     // 3rd sub-cluster EMax
-  double E3x3Sub3      = sub3 ? lazyTools.e3x3(*sub3) : 0.;     // 3rd sub-cluster E3x3
+  double EMaxSub3      = sub3 ? shapes.clusterEMax(*sub3) : 0.; // 3rd sub-cluster EMax
+  double E3x3Sub3      = sub3 ? shapes.clusterE3x3(*sub3) : 0.; // 3rd sub-cluster E3x3
   double NPshwClusters = nPsClus;                               // number of preshower clusters
   double EPshwSub1     = pshwsub1 ? pshwsub1->energy() : 0.;    // 1st preshower cluster energy
   double EtaPshwSub1   = pshwsub1 ? pshwsub1->eta()    : 999.;  // 1st preshower cluster eta
@@ -1,6 +1,8 @@
 #include "BaconProd/Utils/interface/ElectronEnergySmearingScaling.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/CorrectionTable.hh"
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
-#include "RecoEcal/EgammaCoreTools/interface/EcalClusterLazyTools.h"
 #include <TRandom3.h>
 #include <fstream>
 #include <string>
@@ -33,10 +35,10 @@ void ElectronEnergySmearingScaling::initialize(const DatasetType  dataset,
   fDatasetType = dataset;
   fCorrType    = corrType;
     
-  loadCorrections(scalesFilename,      fScalesRecords);       // load scale corrections
-  loadCorrections(smearsType1Filename, fSmearsType1Records);  // load type 1 resolution corrections
-  loadCorrections(smearsType2Filename, fSmearsType2Records);  // load type 2 resolution corrections
-  loadCorrections(smearsType3Filename, fSmearsType3Records);  // load type 3 resolution corrections
+  fScales      = loadCorrections(scalesFilename);       // load scale corrections
+  fSmearsType1 = loadCorrections(smearsType1Filename);  // load type 1 resolution corrections
+  fSmearsType2 = loadCorrections(smearsType2Filename);  // load type 2 resolution corrections
+  fSmearsType3 = loadCorrections(smearsType3Filename);  // load type 3 resolution corrections
   
   fDoRand = doRand;
   if(fDoRand)
@@ -54,11 +56,11 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
   const double             energy,	// electron energy
   const double             error,	// eletron energy uncertainty
   const unsigned int       runNum,	// run number
-  EcalClusterLazyTools    &lazyTools,   // class to compute ECAL cluster quantities
+  const ShowerShapes      &shapes,      // shower shapes of the electron supercluster seed
   const bool               printDebug)  
 {
   double scEta = ele->superCluster()->eta();
-  double r9    = lazyTools.e3x3(*(ele->superCluster()->seed())) / ele->superCluster()->rawEnergy();
+  double r9    = shapes.r9();
   bool   isEB  = ele->isEB();
   bool   isMC  = (fDatasetType==kSummer11) ||
                  (fDatasetType==kFall11) ||
@@ -79,17 +81,13 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
   //
   // scale correction
   //
-  int irun = -1;
-  for(unsigned int irec=0; irec<fScalesRecords.size(); irec++) {
-    if(fScalesRecords[irec].runNumMin <= runNum && runNum <= fScalesRecords[irec].runNumMax)
-      irun = irec;
-  }
+  const int irun = fScales->find(runNum);
   if(!isMC) assert(irun>-1);
   
   //
   // resolution correction
   //
-  // (NOTE 1: Indices for fSmearsType*Records[] are hard-coded; make sure indices correspond to entries in input .csv files)
+  // (NOTE 1: Row indices for fSmearsType* are hard-coded; make sure indices correspond to entries in input .csv files)
   // (NOTE 2: While smearing values are assigned for data and MC events, smearing is done for MC only;
   //          it's superfluous and may be a bit confusing, but staying close to 
   //          /CMSSW/EgammaAnalysis/ElectronTools/src/ElectronEnergyCalibrator.cc for now...)
@@ -97,25 +95,25 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
   double dsigMC=0;
   if(fCorrType==1) {
     if(fDatasetType==kFall11 || fDatasetType==kJan16ReReco) {
-      dsigMC = fSmearsType1Records[0].corr[icat];
+      dsigMC = fSmearsType1->value(0,icat);
       
     } else if(fDatasetType==kSummer12_DR53X_HCP2012 || fDatasetType==kMoriond2013) {
       if(isMC) {
         if(fLumiRatio==0) {
-          dsigMC = fSmearsType1Records[1].corr[icat];
+          dsigMC = fSmearsType1->value(1,icat);
         } else if(fLumiRatio==1) {
-          dsigMC = fSmearsType1Records[2].corr[icat];
+          dsigMC = fSmearsType1->value(2,icat);
         } else {
           double rn = gRandom->Uniform();
           // NOTE: In /CMSSW/EgammaAnalysis/ElectronTools/src/ElectronEnergyCalibrator.cc the boundary
           //       cases fLumiRatio=0 and fLumiRatio=1 contradict the meaning of fLumiRatio for 
           //       intermediate values. The implementation below makes the meaning is consistent.
 	  //       In CMSSW, the 2012D values are applied when rn > fLumiRatio ...
-	  if(rn<fLumiRatio) dsigMC = fSmearsType1Records[1].corr[icat]; 
-          else              dsigMC = fSmearsType1Records[2].corr[icat];
+	  if(rn<fLumiRatio) dsigMC = fSmearsType1->value(1,icat); 
+          else              dsigMC = fSmearsType1->value(2,icat);
         }
       } else {
-        dsigMC = (runNum<=203002) ? fSmearsType1Records[0].corr[icat] : fSmearsType1Records[1].corr[icat];
+        dsigMC = (runNum<=203002) ? fSmearsType1->value(0,icat) : fSmearsType1->value(1,icat);
       }
     } else {
       assert(0);
@@ -123,17 +121,17 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
   
   } else if(fCorrType==2) {
     if(fDatasetType==kFall11 || fDatasetType==kJan16ReReco)
-      dsigMC = fSmearsType2Records[0].corr[icat];    
+      dsigMC = fSmearsType2->value(0,icat);    
     else if(fDatasetType==kSummer12_LegacyPaper || fDatasetType==k22Jan2013ReReco)
-      dsigMC = fSmearsType2Records[1].corr[icat];    
+      dsigMC = fSmearsType2->value(1,icat);    
     else
       assert(0);
     
   } else if(fCorrType==3) {
-    if     (fDatasetType==kSummer11               || fDatasetType==kReReco)      { dsigMC = fSmearsType3Records[0].corr[icat]; }
-    else if(fDatasetType==kFall11		  || fDatasetType==kJan16ReReco) { dsigMC = fSmearsType3Records[1].corr[icat]; }
-    else if(fDatasetType==kSummer12  	          || fDatasetType==kICHEP2012)   { dsigMC = fSmearsType3Records[2].corr[icat]; }
-    else if(fDatasetType==kSummer12_DR53X_HCP2012 || fDatasetType==kMoriond2013) { dsigMC = fSmearsType3Records[3].corr[icat]; }
+    if     (fDatasetType==kSummer11               || fDatasetType==kReReco)      { dsigMC = fSmearsType3->value(0,icat); }
+    else if(fDatasetType==kFall11		  || fDatasetType==kJan16ReReco) { dsigMC = fSmearsType3->value(1,icat); }
+    else if(fDatasetType==kSummer12  	          || fDatasetType==kICHEP2012)   { dsigMC = fSmearsType3->value(2,icat); }
+    else if(fDatasetType==kSummer12_DR53X_HCP2012 || fDatasetType==kMoriond2013) { dsigMC = fSmearsType3->value(3,icat); }
     else
       assert(0);
   
@@ -146,7 +144,7 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
     double corrMC = fDoRand ? fRand->Gaus(1.,dsigMC) : (1.+dsigMC);
     newEnergy *= corrMC;
   } else {
-    double scale = fScalesRecords[irun].corr[icat];
+    double scale = fScales->value(irun,icat);
     newEnergy *= scale;
   }
   
@@ -166,26 +164,14 @@ std::pair<double,double> ElectronEnergySmearingScaling::evaluate(
 }
 
 //--------------------------------------------------------------------------------------------------
-void ElectronEnergySmearingScaling::loadCorrections(const char *infilename, std::vector<CorrRecord> &records)
+boost::shared_ptr<const CorrectionTable> ElectronEnergySmearingScaling::loadCorrections(const char *infilename)
 {  
   //
-  // Parse .csv file of run dependent corrections
+  // Run dependent corrections from .csv file
   // Expected .csv file format:
   //    runNumMin,runNumMax,corr[0],corr[1],corr[2],corr[3],corr[4],corr[5],corr[6],corr[7]
   //
-  std::ifstream ifs;
-  std::string line;  
-  CorrRecord rec;
-  char c0,c1,c2,c3,c4,c5,c6,c7,c8;  // eat commas in CSV file
-
-  ifs.open(infilename);
-  if(!ifs.is_open()) { std::cout << "[ElectronEnergySmearingScaling] " << infilename << " not found!" << std::endl; assert(0); }
-  while(std::getline(ifs,line)) {
-    std::istringstream ss(line);
-    ss >> rec.runNumMin >> c0 >> rec.runNumMax >> c1 
-       >> rec.corr[0]   >> c2 >> rec.corr[1]   >> c3 >> rec.corr[2] >> c4 >> rec.corr[3] >> c5
-       >> rec.corr[4]   >> c6 >> rec.corr[5]   >> c7 >> rec.corr[6] >> c8 >> rec.corr[7];
-    records.push_back(rec);
-  }
-  ifs.close();
+  boost::shared_ptr<const CorrectionTable> table = CalibrationRegistry::correctionTable(infilename);
+  assert(table->nValues() >= NCAT);
+  return table;
 }
@@ -1,4 +1,6 @@
 #include "BaconProd/Utils/interface/ElectronLinearityCorrection.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/CorrectionTable.hh"
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include <fstream>
 #include <string>
@@ -21,26 +23,12 @@ void ElectronLinearityCorrection::initialize(const ElectronEnergySmearingScaling
   fDatasetType = dataset;
   
   //
-  // Parse .csv file of run dependent corrections
+  // pT dependent corrections from .csv file
   // Expected .csv file format:
   //    ptMin, ptMax, corr[0], corr[1], corr[2], corr[3], corr[4], corr[5]
   //
-  std::ifstream ifs;
-  std::string line;  
-  LinearityRecord rec;
-  char c0,c1,c2,c3,c4,c5,c6;  // eat commas in CSV file
-  
-  // load lineary corrections
-  ifs.open(infilename);
-  assert(ifs.is_open());
-  while(std::getline(ifs,line)) {
-    std::istringstream ss(line);
-    ss >> rec.ptMin   >> c0 >> rec.ptMax   >> c1 
-       >> rec.corr[0] >> c2 >> rec.corr[1] >> c3 >> rec.corr[2] >> c4
-       >> rec.corr[3] >> c5 >> rec.corr[4] >> c6 >> rec.corr[5];
-    fLinearityRecords.push_back(rec);
-  }
-  ifs.close();
+  fLinearity = CalibrationRegistry::correctionTable(infilename);
+  assert(fLinearity->nValues() >= NLINCAT);
   
   fIsInitialized=true;
 }
@@ -64,21 +52,20 @@ double ElectronLinearityCorrection::corrScale(const reco::GsfElectron *ele,
   double corr = 0;
   
   if(!isMC) {
-    for(unsigned int irec=0; irec < fLinearityRecords.size(); irec++) {
-      if( (pt >= fLinearityRecords[irec].ptMin) && (pt <= fLinearityRecords[irec].ptMax) ) {
-        if(isEB) {
-          if(fabs(scEta) < 1) {
-            if(classification<2) { corr = fLinearityRecords[irec].corr[0]; } 
-	    else                 { corr = fLinearityRecords[irec].corr[3]; }        
-	  } else {
-            if(classification<2) { corr = fLinearityRecords[irec].corr[1]; }  
-	    else                 { corr = fLinearityRecords[irec].corr[4]; }      
-          }
-      
-        } else { // !isEB
-          if(classification<2) { corr = fLinearityRecords[irec].corr[2]; } 
-	  else                 { corr = fLinearityRecords[irec].corr[5]; }
+    const int irec = fLinearity->find(pt);
+    if(irec >= 0) {
+      if(isEB) {
+        if(fabs(scEta) < 1) {
+          if(classification<2) { corr = fLinearity->value(irec,0); } 
+	  else                 { corr = fLinearity->value(irec,3); }        
+	} else {
+          if(classification<2) { corr = fLinearity->value(irec,1); }  
+	  else                 { corr = fLinearity->value(irec,4); }      
         }
+      
+      } else { // !isEB
+        if(classification<2) { corr = fLinearity->value(irec,2); } 
+	else                 { corr = fLinearity->value(irec,5); }
       }
     }
   }
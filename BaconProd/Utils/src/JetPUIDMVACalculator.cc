@@ -1,10 +1,18 @@
 #include "BaconProd/Utils/interface/JetPUIDMVACalculator.hh"
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/BDTForest.hh"
 #include "TMVA/Reader.h"
 #include <iostream>
 #include <cmath>
 
 using namespace baconhep;
 
+namespace {
+  // weight file names of the inputs, in the order of the input enum
+  const char* kInputNames[] = { "nvtx", "jetPt", "jetEta", "jetPhi", "d0", "dZ", "beta", "betaStar", "nCharged", "nNeutrals",
+                                "dRMean", "dR2Mean", "ptD", "frac01", "frac02", "frac03", "frac04", "frac05" };
+}
+
 //--------------------------------------------------------------------------------------------------
 JetPUIDMVACalculator::JetPUIDMVACalculator():
   fIsInitialized(false),
@@ -29,7 +37,7 @@ void JetPUIDMVACalculator::initialize(const JetPUIDMVACalculator::JetIDType jetI
   fLowPtMethodTag  = lowPtMethodTag;
   fHighPtMethodTag = highPtMethodTag;
   
-  if(lowPtWeightFile.length()>0) {
+  if(lowPtWeightFile.length()>0 && !initForest(fLowPtForest, fLowPtVarMap, lowPtWeightFile)) {
     fLowPtReader = new TMVA::Reader();
     fLowPtReader->AddVariable("nvtx", &_nvtx); 
     if(jetIDType != k53) fLowPtReader->AddVariable("jetPt",  &_jetPt);  
@@ -57,7 +65,7 @@ void JetPUIDMVACalculator::initialize(const JetPUIDMVACalculator::JetIDType jetI
     fLowPtReader->BookMVA(fLowPtMethodTag, lowPtWeightFile);
   }
   
-  if(highPtWeightFile.length()>0) {
+  if(highPtWeightFile.length()>0 && !initForest(fHighPtForest, fHighPtVarMap, highPtWeightFile)) {
     fHighPtReader = new TMVA::Reader();
     if(jetIDType == kBaseline) {
       fHighPtReader->AddVariable("nvtx",     &_nvtx);
@@ -154,6 +162,23 @@ void JetPUIDMVACalculator::initialize(const JetPUIDMVACalculator::JetIDType jetI
   fIsInitialized = true;
 }
 
+//--------------------------------------------------------------------------------------------------
+bool JetPUIDMVACalculator::initForest(boost::shared_ptr<const BDTForest> &forest, std::vector<int> &varMap, const std::string filename)
+{
+  forest = CalibrationRegistry::bdtForest(filename);
+  if(!forest) return false;
+  
+  varMap.assign(forest->nVars(), -1);
+  for(unsigned int iin=0; iin<kNInputs; iin++) {
+    const int ivar = forest->varIndex(kInputNames[iin]);
+    if(ivar >= 0) varMap[ivar] = iin;
+  }
+  for(unsigned int ivar=0; ivar<varMap.size(); ivar++) {
+    if(varMap[ivar] < 0) { forest.reset(); return false; }
+  }
+  return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 float JetPUIDMVACalculator::mvaValue(const float nvtx, const float jetPt, const float jetEta, const float jetPhi,
 		                     const float d0, const float dZ, const float beta, const float betaStar,
@@ -161,41 +186,121 @@ float JetPUIDMVACalculator::mvaValue(const float nvtx, const float jetPt, const
 		                     const float frac01, const float frac02, const float frac03, const float frac04, const float frac05,
 				     const bool printDebug)
 {
-  _nvtx      = nvtx;
-  _jetPt     = jetPt;
-  _jetEta    = jetEta;
-  _jetPhi    = jetPhi;
-  _d0        = fabs(d0);
-  _dZ        = fabs(dZ);
-  _beta      = beta;
-  _betaStar  = betaStar;
-  _nCharged  = nCharged;
-  _nNeutrals = nNeutrals;
-  _dRMean    = dRMean;
-  _dR2Mean   = dR2Mean;
-  _ptD       = ptD;
-  _frac01    = frac01;
-  _frac02    = frac02;
-  _frac03    = frac03;
-  _frac04    = frac04;
-  _frac05    = frac05;
-  
-  double val = -2;
-  if(jetPt < 10) { val = (fLowPtReader  ? fLowPtReader->EvaluateMVA(fLowPtMethodTag)   : -2); } 
-  else           { val = (fHighPtReader ? fHighPtReader->EvaluateMVA(fHighPtMethodTag) : -2); }
+  // evaluated as a batch of one, appended to (and then removed from) any queued jets
+  addToBatch(nvtx, jetPt, jetEta, jetPhi, d0, dZ, beta, betaStar, nCharged, nNeutrals,
+             dRMean, dR2Mean, ptD, frac01, frac02, frac03, frac04, frac05);
+  const unsigned int first = fBatch.size() - kNInputs;
+  const float *in = &fBatch[first];
+  float val = -2;
+  evaluate(in, 1, &val);
   
   if(printDebug) {
     std::cout << "[JetPUIDMVACalculator]" << std::endl;
-    std::cout << "Inputs: nvtx= " << _nvtx;
-    std::cout << "  jetPt= " << _jetPt << "  jetEta= " << _jetEta << "  jetPhi= " << _jetPhi;
-    std::cout << "  |d0|= " << _d0 << "  |dZ|= " << _dZ;
-    std::cout << "  beta= " << _beta << "  betaStar= " << _betaStar;
-    std::cout << "  nCharged= " << _nCharged << "  nNeutrals= " << nNeutrals;
-    std::cout << "  dRMean= " << _dRMean << "  dR2Mean= " << _dR2Mean << "  ptD= " << _ptD;
-    std::cout << "  frac01= " << _frac01 << "  frac02= " << _frac02 << "  frac03= " << _frac03 << "  frac04= " << _frac04 << "  frac05= " << _frac05;
+    std::cout << "Inputs: nvtx= " << in[kNvtx];
+    std::cout << "  jetPt= " << in[kJetPt] << "  jetEta= " << in[kJetEta] << "  jetPhi= " << in[kJetPhi];
+    std::cout << "  |d0|= " << in[kD0] << "  |dZ|= " << in[kDZ];
+    std::cout << "  beta= " << in[kBeta] << "  betaStar= " << in[kBetaStar];
+    std::cout << "  nCharged= " << in[kNCharged] << "  nNeutrals= " << in[kNNeutrals];
+    std::cout << "  dRMean= " << in[kDRMean] << "  dR2Mean= " << in[kDR2Mean] << "  ptD= " << in[kPtD];
+    std::cout << "  frac01= " << in[kFrac01] << "  frac02= " << in[kFrac02] << "  frac03= " << in[kFrac03] << "  frac04= " << in[kFrac04] << "  frac05= " << in[kFrac05];
     std::cout << std::endl;
     std::cout << " > MVA value = " << val << std::endl;
   }
+  fBatch.resize(first);
   
   return val;
 }
+
+//--------------------------------------------------------------------------------------------------
+void JetPUIDMVACalculator::addToBatch(const float nvtx, const float jetPt, const float jetEta, const float jetPhi,
+		                      const float d0, const float dZ, const float beta, const float betaStar,
+		                      const float nCharged, const float nNeutrals, const float dRMean, const float dR2Mean, const float ptD,
+		                      const float frac01, const float frac02, const float frac03, const float frac04, const float frac05)
+{
+  const unsigned int first = fBatch.size();
+  fBatch.resize(first + kNInputs);
+  float *in = &fBatch[first];
+  in[kNvtx]      = nvtx;
+  in[kJetPt]     = jetPt;
+  in[kJetEta]    = jetEta;
+  in[kJetPhi]    = jetPhi;
+  in[kD0]        = fabs(d0);
+  in[kDZ]        = fabs(dZ);
+  in[kBeta]      = beta;
+  in[kBetaStar]  = betaStar;
+  in[kNCharged]  = nCharged;
+  in[kNNeutrals] = nNeutrals;
+  in[kDRMean]    = dRMean;
+  in[kDR2Mean]   = dR2Mean;
+  in[kPtD]       = ptD;
+  in[kFrac01]    = frac01;
+  in[kFrac02]    = frac02;
+  in[kFrac03]    = frac03;
+  in[kFrac04]    = frac04;
+  in[kFrac05]    = frac05;
+}
+
+//--------------------------------------------------------------------------------------------------
+void JetPUIDMVACalculator::evaluateBatch(std::vector<float> &vals)
+{
+  const unsigned int nJets = fBatch.size()/kNInputs;
+  vals.assign(nJets, -2);
+  if(nJets>0) evaluate(&fBatch[0], nJets, &vals[0]);
+  clearBatch();
+}
+
+//--------------------------------------------------------------------------------------------------
+void JetPUIDMVACalculator::evaluate(const float *inputs, const unsigned int nJets, float *vals)
+{
+  std::vector<unsigned int> lLowPt, lHighPt;
+  for(unsigned int ijet=0; ijet<nJets; ijet++) {
+    vals[ijet] = -2;
+    if(inputs[ijet*kNInputs + kJetPt] < 10) lLowPt.push_back(ijet);
+    else                                    lHighPt.push_back(ijet);
+  }
+  evaluatePtBin(fLowPtForest.get(),  fLowPtVarMap,  fLowPtReader,  fLowPtMethodTag,  inputs, lLowPt,  vals);
+  evaluatePtBin(fHighPtForest.get(), fHighPtVarMap, fHighPtReader, fHighPtMethodTag, inputs, lHighPt, vals);
+}
+
+//--------------------------------------------------------------------------------------------------
+void JetPUIDMVACalculator::evaluatePtBin(const BDTForest *forest, const std::vector<int> &varMap,
+                                         TMVA::Reader *reader, const std::string &methodTag,
+                                         const float *inputs, const std::vector<unsigned int> &jets, float *vals)
+{
+  if(jets.empty()) return;
+  
+  if(forest) {
+    const unsigned int nVars = varMap.size();
+    std::vector<float> rows(jets.size()*nVars), out(jets.size());
+    for(unsigned int ij=0; ij<jets.size(); ij++) {
+      const float *in = inputs + jets[ij]*kNInputs;
+      for(unsigned int ivar=0; ivar<nVars; ivar++) { rows[ij*nVars + ivar] = in[varMap[ivar]]; }
+    }
+    forest->evaluate(&rows[0], jets.size(), &out[0]);
+    for(unsigned int ij=0; ij<jets.size(); ij++) { vals[jets[ij]] = out[ij]; }
+    
+  } else if(reader) {
+    for(unsigned int ij=0; ij<jets.size(); ij++) {
+      const float *in = inputs + jets[ij]*kNInputs;
+      _nvtx      = in[kNvtx];
+      _jetPt     = in[kJetPt];
+      _jetEta    = in[kJetEta];
+      _jetPhi    = in[kJetPhi];
+      _d0        = in[kD0];
+      _dZ        = in[kDZ];
+      _beta      = in[kBeta];
+      _betaStar  = in[kBetaStar];
+      _nCharged  = in[kNCharged];
+      _nNeutrals = in[kNNeutrals];
+      _dRMean    = in[kDRMean];
+      _dR2Mean   = in[kDR2Mean];
+      _ptD       = in[kPtD];
+      _frac01    = in[kFrac01];
+      _frac02    = in[kFrac02];
+      _frac03    = in[kFrac03];
+      _frac04    = in[kFrac04];
+      _frac05    = in[kFrac05];
+      vals[jets[ij]] = reader->EvaluateMVA(methodTag);
+    }
+  }
+}
@@ -0,0 +1,138 @@
+#include "BaconProd/Utils/interface/JetShapes.hh"
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
+#include "DataFormats/JetReco/interface/PFJet.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include <cmath>
+
+using namespace baconhep;
+
+namespace {
+  // upper dR edges of the JetTools::frac rings
+  const double kFracDRMax[JetShapes::kNFrac] = { 0.1, 0.2, 0.3, 0.4, 0.5 };
+}
+
+//--------------------------------------------------------------------------------------------------
+JetShapes::JetShapes():
+  fD0(-1000), fDz(-1000),
+  fBeta(0), fBetaStar(0),
+  fDRMean(0), fDR2Mean(0), fPtD(0),
+  fCharge(0), fPull(0)
+{
+  for(unsigned int ibin=0; ibin<kNFrac; ibin++) { fFrac[ibin] = 0; }
+}
+
+//--------------------------------------------------------------------------------------------------
+JetShapes::~JetShapes(){}
+
+//--------------------------------------------------------------------------------------------------
+void JetShapes::load(const reco::PFJet &jet, const reco::Vertex &pv)
+{
+  fPt.clear();
+  fEta.clear();
+  fPhi.clear();
+  fTrkCandPt.clear();
+  fTrkPt.clear();
+  fTrkDz.clear();
+  fTrkCharge.clear();
+  fTrack.clear();
+  fD0 = fDz = -1000;
+
+  // getPFConstituents() builds a new vector on every call
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
+  fPt.reserve(nPFCands);
+  fEta.reserve(nPFCands);
+  fPhi.reserve(nPFCands);
+
+  for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
+    const reco::PFCandidate &pfcand = *(pfCands[ipf]);
+    fPt.push_back(pfcand.pt());
+    fEta.push_back(pfcand.eta());
+    fPhi.push_back(pfcand.phi());
+
+    const reco::TrackRef track = pfcand.trackRef();
+    if(track.isNull()) continue;
+
+    // impact parameters of the leading charged constituent (constituents are stored by descending pT)
+    if(fTrack.empty()) {
+      fDz = track->dz(pv.position());
+      fD0 = -track->dxy(pv.position());
+    }
+    fTrkCandPt.push_back(pfcand.pt());
+    fTrkPt.push_back(track->pt());
+    fTrkDz.push_back(track->dz(pv.position()));
+    fTrkCharge.push_back(track->charge());
+    fTrack.push_back(&(*track));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void JetShapes::compute(const reco::PFJet &jet, const reco::Vertex &pv, const TrackVertexMap &trkVtxMap, const double dzCut)
+{
+  load(jet, pv);
+
+  //
+  // Shapes
+  //==============================
+  const double jetPt  = jet.pt();
+  const double jetEta = jet.eta();
+  const double jetPhi = jet.phi();
+
+  double drmean=0, dr2mean=0, sumPt=0, sumPt2=0;
+  double pullX=0, pullY=0;
+  double frac[kNFrac] = { 0, 0, 0, 0, 0 };
+
+  const unsigned int nCands = fPt.size();
+  for(unsigned int i=0; i<nCands; i++) {
+    const double pt   = fPt[i];
+    const double dEta = jetEta - fEta[i];
+    const double dPhi = reco::deltaPhi(jetPhi, fPhi[i]);
+    const double dR2  = dEta*dEta + dPhi*dPhi;
+    const double dr   = sqrt(dR2);
+
+    drmean  += dr*pt/jetPt;
+    dr2mean += dR2*(pt*pt);
+    sumPt   += pt;
+    sumPt2  += pt*pt;
+
+    for(unsigned int ibin=0; ibin<kNFrac; ibin++) {
+      if(dr <= kFracDRMax[ibin] && dr >= kFracDRMax[ibin] - 0.1) frac[ibin] += pt/jetPt;
+    }
+
+    // pull vector: pT-weighted dR^2 along the constituent direction
+    const double w = (pt/jetPt)*dR2;
+    pullX += w*cos(dPhi);
+    pullY += w*sin(dPhi);
+  }
+
+  fDRMean  = drmean;
+  fDR2Mean = dr2mean/sumPt2;
+  fPtD     = sumPt2/sqrt(sumPt2)/sumPt;
+  fPull    = sqrt(pullX*pullX + pullY*pullY);
+  for(unsigned int ibin=0; ibin<kNFrac; ibin++) { fFrac[ibin] = frac[ibin]; }
+
+  //
+  // Track fractions and charge
+  //==============================
+  double ptPV=0, ptPU=0, ptTrk=0, charge=0, sumCandPt=0;
+
+  const unsigned int nTrks = fTrkPt.size();
+  for(unsigned int i=0; i<nTrks; i++) {
+    ptTrk     += fTrkPt[i];
+    charge    += fTrkCandPt[i]*fTrkCharge[i];
+    sumCandPt += fTrkCandPt[i];
+
+    const double dzPV = fabs(fTrkDz[i]);
+    if(dzPV < dzCut) ptPV += fTrkPt[i];
+
+    // any other good vertex (ndof>=4, not the PV) within dzCut of the track
+    if(dzPV > dzCut && trkVtxMap.hasCompatibleVertex(*fTrack[i], dzCut, 4, 0.02)) ptPU += fTrkPt[i];
+  }
+
+  fBeta     = (ptTrk>0) ? ptPV/ptTrk : 0;
+  fBetaStar = ptPU/((ptTrk==0) ? 1 : ptTrk);
+  fCharge   = charge/((sumCandPt==0) ? 1 : sumCandPt);
+}
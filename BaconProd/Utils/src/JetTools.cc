@@ -17,9 +17,10 @@ using namespace baconhep;
 double JetTools::beta(const reco::PFJet &jet, const reco::Vertex &pv, const double dzCut)
 {
   double pt_jets=0, pt_jets_tot=0;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     const reco::TrackRef       track  = pfcand->trackRef();
     if(track.isNull()) continue;
     
@@ -34,13 +35,14 @@ double JetTools::beta(const reco::PFJet &jet, const reco::Vertex &pv, const doub
 }
 
 //--------------------------------------------------------------------------------------------------
-double JetTools::betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const reco::VertexCollection *pvCol, const double dzCut)
+double JetTools::betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const TrackVertexMap &trkVtxMap, const double dzCut)
 {
   double pileup=0, total=0;
   
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     const reco::TrackRef       track  = pfcand->trackRef();
     if(track.isNull()) continue;
     total += track->pt();
@@ -48,12 +50,8 @@ double JetTools::betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const
     double dzPV = fabs(track->dz(pv.position()));
     if(dzPV <= dzCut) continue;
     
-    double dzMin = dzPV;
-    for(reco::VertexCollection::const_iterator itVtx = pvCol->begin(); itVtx!=pvCol->end(); ++itVtx) {
-      if(itVtx->ndof() < 4 || (pv.position() - itVtx->position()).R() < 0.02) continue;
-      dzMin = TMath::Min(dzMin, fabs(track->dz(itVtx->position())));
-    }
-    if(dzMin < dzCut) pileup += track->pt();
+    // any other good vertex (ndof>=4, not the PV) within dzCut of the track
+    if(trkVtxMap.hasCompatibleVertex(*track, dzCut, 4, 0.02)) pileup += track->pt();
   }
   if(total==0) total=1;
   
@@ -64,9 +62,10 @@ double JetTools::betaStar(const reco::PFJet &jet, const reco::Vertex &pv, const
 double JetTools::dRMean(const reco::PFJet &jet, const int pfType)
 {
   double drmean=0;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     if(pfType!=-1 && pfcand->particleId() != pfType) continue;
     
     double dr = reco::deltaR(jet.eta(),jet.phi(),pfcand->eta(),pfcand->phi());    
@@ -81,9 +80,10 @@ double JetTools::dR2Mean(const reco::PFJet &jet, const int pfType)
 {
   double dr2mean=0;
   double sumpt2=0;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     if(pfType!=-1 && pfcand->particleId() != pfType) continue;
     
     sumpt2 += pfcand->pt() * pfcand->pt();
@@ -102,9 +102,10 @@ double JetTools::frac(const reco::PFJet &jet, const double dRMax, const int pfTy
   const double dRMin = dRMax - 0.1;
   
   double fraction = 0;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     if(pfType!=-1 && pfcand->particleId() != pfType) continue;
     
     double dr = reco::deltaR(jet.eta(),jet.phi(),pfcand->eta(),pfcand->phi());    
@@ -122,9 +123,10 @@ double JetTools::jetDz(const reco::PFJet &jet, const reco::Vertex &pv)
 {
   // Assumes constituents are stored by descending pT
   double dz=-1000;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     const reco::TrackRef       track  = pfcand->trackRef();
     if(track.isNull()) continue;
     dz = track->dz(pv.position());
@@ -138,9 +140,10 @@ double JetTools::jetD0(const reco::PFJet &jet, const reco::Vertex &pv)
 {
   // Assumes constituents are stored by descending pT
   double d0=-1000;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     const reco::TrackRef       track  = pfcand->trackRef();
     if(track.isNull()) continue;
     d0 = -track->dxy(pv.position());
@@ -155,9 +158,10 @@ double JetTools::jetWidth(const reco::PFJet &jet, const int varType, const int p
 {
   double ptD=0, sumPt=0, sumPt2=0;
   TMatrixDSym covMatrix(2); covMatrix=0.;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     if(pfType!=-1 && pfcand->particleId() != pfType) continue;
     
     double dEta = jet.eta() - pfcand->eta();
@@ -216,9 +220,10 @@ double JetTools::jetCharge(const reco::PFJet &jet)
 {
   // Assumes constituents are stored by descending pT
   double charge=0; double lSumPt = 0;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     const reco::TrackRef       track  = pfcand->trackRef();
     if(track.isNull()) continue;
     charge += pfcand->pt()*track->charge();
@@ -261,9 +266,10 @@ double* JetTools::subJetQG(const reco::PFJet &jet,edm::Handle<reco::PFJetCollect
 TLorentzVector JetTools::jetPull(const reco::PFJet &jet )
 {
   TLorentzVector lPull;
-  const unsigned int nPFCands = jet.getPFConstituents().size();
+  const std::vector<reco::PFCandidatePtr> pfCands = jet.getPFConstituents();
+  const unsigned int nPFCands = pfCands.size();
   for(unsigned int ipf=0; ipf<nPFCands; ipf++) {
-    const reco::PFCandidatePtr pfcand = jet.getPFConstituents().at(ipf);
+    const reco::PFCandidatePtr pfcand = pfCands.at(ipf);
     double dEta = pfcand->eta()-jet.eta();
     double dPhi = reco::deltaPhi(pfcand->phi(),jet.phi());
     double dR2  = dEta*dEta + dPhi*dPhi;
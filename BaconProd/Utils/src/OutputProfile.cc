@@ -0,0 +1,184 @@
+#include "BaconProd/Utils/interface/OutputProfile.hh"
+#include <TTree.h>
+#include <TBranch.h>
+#include <TObjArray.h>
+#include <RVersion.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  struct ProfileDef {
+    const char *name;
+    int         algorithm[OutputProfile::kNGroups];   // scalar, object, bulk
+    int         level    [OutputProfile::kNGroups];
+    int         nSample;
+    int         clusterEntries;
+  };
+
+  const ProfileDef kProfiles[] = {
+    { "default",  { OutputProfile::kKeep, OutputProfile::kKeep, OutputProfile::kKeep }, { 0, 0, 0 },   0,    0 },
+    { "fast",     { OutputProfile::kLZ4,  OutputProfile::kLZ4,  OutputProfile::kZLIB }, { 4, 4, 1 }, 100, 1000 },
+    { "balanced", { OutputProfile::kLZ4,  OutputProfile::kZLIB, OutputProfile::kZSTD }, { 4, 4, 5 }, 100, 2000 },
+    { "compact",  { OutputProfile::kZLIB, OutputProfile::kLZMA, OutputProfile::kLZMA }, { 6, 6, 8 }, 100, 5000 }
+  };
+  const unsigned int kNProfiles = sizeof(kProfiles)/sizeof(kProfiles[0]);
+
+  // basket size bounds once tuned
+  const int kMinBasketSize = 1024;
+  const int kMaxBasketSize = 4*1024*1024;
+}
+
+//--------------------------------------------------------------------------------------------------
+OutputProfile::OutputProfile(const std::string &name):
+  fName          (name),
+  fNSample       (0),
+  fClusterEntries(0),
+  fTuned         (false)
+{
+  const ProfileDef *def = 0;
+  for(unsigned int iprof=0; iprof<kNProfiles; iprof++) {
+    if(name == kProfiles[iprof].name) def = &kProfiles[iprof];
+  }
+  if(!def) { std::cout << "[OutputProfile] unknown profile " << name << "!" << std::endl; assert(0); }
+
+  for(unsigned int igroup=0; igroup<kNGroups; igroup++) {
+    fCompression[igroup].algorithm = def->algorithm[igroup];
+    fCompression[igroup].level     = def->level[igroup];
+  }
+  fNSample        = def->nSample;
+  fClusterEntries = def->clusterEntries;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::vector<std::string> OutputProfile::names()
+{
+  std::vector<std::string> out;
+  for(unsigned int iprof=0; iprof<kNProfiles; iprof++) out.push_back(kProfiles[iprof].name);
+  return out;
+}
+
+//--------------------------------------------------------------------------------------------------
+OutputProfile::Group OutputProfile::group(const std::string &branchName)
+{
+  // columns of a collection ("<collection>_<member>") go with the collection
+  const std::string name = branchName.substr(0, branchName.find('_'));
+  if(name == "Info" || name == "GenEvtInfo" || name == "PV") return kScalar;
+  if(name == "GenParticle" || name == "PFPart")              return kBulk;
+  return kObject;
+}
+
+//--------------------------------------------------------------------------------------------------
+const char* OutputProfile::groupName(const Group group)
+{
+  const char *groupNames[] = { "scalar", "object", "bulk" };
+  return groupNames[group];
+}
+
+//--------------------------------------------------------------------------------------------------
+bool OutputProfile::isAvailable(const int algorithm)
+{
+  if(algorithm == kLZ4)  return ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0);
+  if(algorithm == kZSTD) return ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+int OutputProfile::compressionSettings(const std::string &branchName) const
+{
+  const Compression &comp = fCompression[group(branchName)];
+  if(comp.algorithm == kKeep) return -1;
+  if(isAvailable(comp.algorithm)) return comp.algorithm*100 + comp.level;
+
+  // LZ4 is chosen for speed, ZSTD for size
+  return (comp.algorithm == kLZ4) ? kZLIB*100 + 1 : kZLIB*100 + 6;
+}
+
+//--------------------------------------------------------------------------------------------------
+void OutputProfile::apply(TTree *tree) const
+{
+  assert(tree);
+  for(unsigned int igroup=0; igroup<kNGroups; igroup++) {
+    const int algorithm = fCompression[igroup].algorithm;
+    if(algorithm != kKeep && !isAvailable(algorithm)) {
+      std::cout << "[OutputProfile] " << fName << ": compression algorithm " << algorithm << " of the " << groupName((Group)igroup)
+                << " branches is not available in this ROOT version, using ZLIB" << std::endl;
+    }
+  }
+
+  TObjArray *branches = tree->GetListOfBranches();
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) {
+    TBranch *branch = (TBranch*)branches->UncheckedAt(ibr);
+    const int settings = compressionSettings(branch->GetName());
+    if(settings >= 0) branch->SetCompressionSettings(settings);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void OutputProfile::afterFill(TTree *tree)
+{
+  if(fTuned || fNSample <= 0 || tree->GetEntries() < fNSample) return;
+
+  // write out the sample so that the byte counts of every branch are complete
+  tree->FlushBaskets();
+  sizeBaskets(tree->GetListOfBranches(), tree->GetEntries());
+  tree->SetAutoFlush(fClusterEntries);
+  fTuned = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void OutputProfile::sizeBaskets(TObjArray *branches, const long long nEntries) const
+{
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) {
+    TBranch *branch = (TBranch*)branches->UncheckedAt(ibr);
+
+    // one cluster per basket, with some margin for fluctuations; a parent is sized before
+    // its sub-branches, as ROOT passes the size of a split branch on to them
+    const double bytesPerEntry = double(branch->GetTotBytes()) / nEntries;
+    int size = int(1.1*bytesPerEntry*fClusterEntries);
+    size = std::max(kMinBasketSize, std::min(kMaxBasketSize, size));
+    size = (size/512 + 1)*512;
+    branch->SetBasketSize(size);
+
+    sizeBaskets(branch->GetListOfBranches(), nEntries);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void OutputProfile::report(TTree *tree, std::ostream &os, const double fillSeconds) const
+{
+  assert(tree);
+  const std::ios::fmtflags flags     = os.flags();
+  const std::streamsize    precision = os.precision();
+  const long long nEntries = tree->GetEntries();
+  const double    totBytes = tree->GetTotBytes();
+  const double    zipBytes = tree->GetZipBytes();
+
+  os << "[OutputProfile] " << fName << ": " << nEntries << " entries, "
+     << std::fixed << std::setprecision(1) << totBytes/1e6 << " MB -> " << zipBytes/1e6 << " MB, filled in "
+     << std::setprecision(2) << fillSeconds << " s";
+  if(fillSeconds > 0) os << " (" << std::setprecision(1) << nEntries/fillSeconds << " entries/s, " << totBytes/1e6/fillSeconds << " MB/s)";
+  os << std::endl;
+
+  os << "  " << std::left << std::setw(16) << "branch" << std::setw(8) << "group" << std::right << std::setw(10) << "settings"
+     << std::setw(14) << "bytes" << std::setw(14) << "zip bytes" << std::setw(8) << "ratio" << std::setw(9) << "share"
+     << std::setw(12) << "bytes/entry" << std::endl;
+
+  TObjArray *branches = tree->GetListOfBranches();
+  for(int ibr=0; ibr<branches->GetEntriesFast(); ibr++) {
+    TBranch *branch = (TBranch*)branches->UncheckedAt(ibr);
+    const double branchTot = branch->GetTotBytes("*");
+    const double branchZip = branch->GetZipBytes("*");
+    os << "  " << std::left << std::setw(16) << branch->GetName() << std::setw(8) << groupName(group(branch->GetName()))
+       << std::right << std::setw(10) << branch->GetCompressionSettings()
+       << std::setw(14) << std::setprecision(0) << branchTot << std::setw(14) << branchZip
+       << std::setw(8) << std::setprecision(2) << (branchZip > 0 ? branchTot/branchZip : 0)
+       << std::setw(8) << std::setprecision(1) << (zipBytes > 0 ? 100*branchZip/zipBytes : 0) << "%"
+       << std::setw(12) << std::setprecision(0) << (nEntries > 0 ? branchTot/nEntries : 0) << std::endl;
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
@@ -0,0 +1,136 @@
+#include "BaconProd/Utils/interface/PFIsoGrid.hh"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include <TMath.h>
+#include <algorithm>
+#include <cassert>
+
+using namespace baconhep;
+
+namespace {
+  bool byIndex(const PFIsoGrid::Neighbour &a, const PFIsoGrid::Neighbour &b) { return a.idx < b.idx; }
+}
+
+//--------------------------------------------------------------------------------------------------
+PFIsoGrid::PFIsoGrid(const double etaMax, const double cellSize):
+  fEtaMax(etaMax)
+{
+  assert(etaMax>0 && cellSize>0);
+  fNEta     = int(2.*etaMax/cellSize + 0.5);
+  fNPhi     = int(TMath::TwoPi()/cellSize + 0.5);
+  if(fNEta<1) fNEta = 1;
+  if(fNPhi<1) fNPhi = 1;
+  fEtaWidth = 2.*etaMax/fNEta;
+  fPhiWidth = TMath::TwoPi()/fNPhi;
+}
+
+//--------------------------------------------------------------------------------------------------
+PFIsoGrid::~PFIsoGrid(){}
+
+//--------------------------------------------------------------------------------------------------
+int PFIsoGrid::etaBin(const double eta) const
+{
+  // candidates beyond the grid acceptance are collected in the edge cells
+  int ibin = int((eta + fEtaMax)/fEtaWidth);
+  if(eta < -fEtaMax) ibin = 0;
+  if(ibin < 0)       ibin = 0;
+  if(ibin >= fNEta)  ibin = fNEta-1;
+  return ibin;
+}
+
+//--------------------------------------------------------------------------------------------------
+int PFIsoGrid::phiBin(const double phi) const
+{
+  int ibin = int(floor((phi + TMath::Pi())/fPhiWidth)) % fNPhi;
+  if(ibin < 0) ibin += fNPhi;
+  return ibin;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFIsoGrid::build(const std::vector<const reco::PFCandidate*> &pfNoPU,
+                      const std::vector<const reco::PFCandidate*> &pfPU)
+{
+  fillGrid(fNoPU, pfNoPU);
+  fillGrid(fPU,   pfPU);
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFIsoGrid::fillGrid(Grid &grid, const std::vector<const reco::PFCandidate*> &pfCands)
+{
+  // counting sort of the candidates into their cells
+  const unsigned int nCells = fNEta*fNPhi;
+  grid.start.assign(nCells+1, 0);
+  grid.cands.resize(pfCands.size());
+  fCellOf.resize(pfCands.size());
+
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    const reco::PFCandidate *pfcand = pfCands[ipf];
+    fCellOf[ipf] = etaBin(pfcand->eta())*fNPhi + phiBin(pfcand->phi());
+    grid.start[fCellOf[ipf]+1]++;
+  }
+  for(unsigned int icell=0; icell<nCells; icell++) {
+    grid.start[icell+1] += grid.start[icell];
+  }
+
+  std::vector<unsigned int> pos(grid.start.begin(), grid.start.end()-1);
+  for(unsigned int ipf=0; ipf<pfCands.size(); ipf++) {
+    Cell &cell = grid.cands[pos[fCellOf[ipf]]++];
+    cell.cand = pfCands[ipf];
+    cell.eta  = pfCands[ipf]->eta();
+    cell.phi  = pfCands[ipf]->phi();
+    cell.idx  = ipf;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFIsoGrid::query(const Grid &grid, const double eta, const double phi, const double maxRadius,
+                      std::vector<Neighbour> &out) const
+{
+  out.clear();
+  if(grid.cands.empty()) return;
+
+  const int etaLo = etaBin(eta - maxRadius);
+  const int etaHi = etaBin(eta + maxRadius);
+
+  // phi window, wrapping around at +/-pi
+  const int phiC  = phiBin(phi);
+  int       nPhi  = int(maxRadius/fPhiWidth) + 1;
+  int       phiLo = phiC - nPhi;
+  int       phiHi = phiC + nPhi;
+  if(2*nPhi+1 >= fNPhi) { phiLo = 0; phiHi = fNPhi-1; }
+
+  for(int ieta=etaLo; ieta<=etaHi; ieta++) {
+    for(int ip=phiLo; ip<=phiHi; ip++) {
+      int iphi = ip;
+      if(iphi < 0)      iphi += fNPhi;
+      if(iphi >= fNPhi) iphi -= fNPhi;
+
+      const unsigned int icell = ieta*fNPhi + iphi;
+      for(unsigned int ic=grid.start[icell]; ic<grid.start[icell+1]; ic++) {
+        const Cell &cell = grid.cands[ic];
+        double dr = reco::deltaR(cell.eta, cell.phi, eta, phi);
+        if(dr > maxRadius) continue;
+
+        Neighbour nb;
+        nb.cand = cell.cand;
+        nb.dr   = dr;
+        nb.idx  = cell.idx;
+        out.push_back(nb);
+      }
+    }
+  }
+
+  std::sort(out.begin(), out.end(), byIndex);
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFIsoGrid::neighboursNoPU(const double eta, const double phi, const double maxRadius, std::vector<Neighbour> &out) const
+{
+  query(fNoPU, eta, phi, maxRadius, out);
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFIsoGrid::neighboursPU(const double eta, const double phi, const double maxRadius, std::vector<Neighbour> &out) const
+{
+  query(fPU, eta, phi, maxRadius, out);
+}
@@ -0,0 +1,132 @@
+#include "BaconProd/Utils/interface/PFRecHitGrid.hh"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include <TMath.h>
+#include <algorithm>
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+PFRecHitGrid::PFRecHitGrid(const double etaMax, const double cellSize):
+  fEtaMax(etaMax),
+  fNLayers(0)
+{
+  assert(etaMax>0 && cellSize>0);
+  fNEta     = int(2.*etaMax/cellSize + 0.5);
+  fNPhi     = int(TMath::TwoPi()/cellSize + 0.5);
+  if(fNEta<1) fNEta = 1;
+  if(fNPhi<1) fNPhi = 1;
+  fEtaWidth = 2.*etaMax/fNEta;
+  fPhiWidth = TMath::TwoPi()/fNPhi;
+}
+
+//--------------------------------------------------------------------------------------------------
+PFRecHitGrid::~PFRecHitGrid(){}
+
+//--------------------------------------------------------------------------------------------------
+int PFRecHitGrid::etaBin(const double eta) const
+{
+  // hits beyond the grid acceptance are collected in the edge cells
+  int ibin = int((eta + fEtaMax)/fEtaWidth);
+  if(eta < -fEtaMax) ibin = 0;
+  if(ibin < 0)       ibin = 0;
+  if(ibin >= fNEta)  ibin = fNEta-1;
+  return ibin;
+}
+
+//--------------------------------------------------------------------------------------------------
+int PFRecHitGrid::phiBin(const double phi) const
+{
+  int ibin = int(floor((phi + TMath::Pi())/fPhiWidth)) % fNPhi;
+  if(ibin < 0) ibin += fNPhi;
+  return ibin;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFRecHitGrid::clear()
+{
+  fNLayers = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFRecHitGrid::addLayer(const reco::PFRecHitCollection &recHits)
+{
+  if(fNLayers == fLayers.size()) fLayers.push_back(Grid());
+  Grid &grid = fLayers[fNLayers++];
+
+  // eta/phi are computed from the hit positions once per event
+  std::vector<Cell> cells(recHits.size());
+  for(unsigned int ihit=0; ihit<recHits.size(); ihit++) {
+    cells[ihit].hit = &recHits[ihit];
+    cells[ihit].eta = recHits[ihit].position().eta();
+    cells[ihit].phi = recHits[ihit].position().phi();
+  }
+
+  // counting sort of the hits into their cells
+  const unsigned int nCells = fNEta*fNPhi;
+  grid.start.assign(nCells+1, 0);
+  grid.hits.resize(recHits.size());
+  fCellOf.resize(recHits.size());
+
+  for(unsigned int ihit=0; ihit<recHits.size(); ihit++) {
+    fCellOf[ihit] = etaBin(cells[ihit].eta)*fNPhi + phiBin(cells[ihit].phi);
+    grid.start[fCellOf[ihit]+1]++;
+  }
+  for(unsigned int icell=0; icell<nCells; icell++) {
+    grid.start[icell+1] += grid.start[icell];
+  }
+
+  std::vector<unsigned int> pos(grid.start.begin(), grid.start.end()-1);
+  for(unsigned int ihit=0; ihit<recHits.size(); ihit++) {
+    grid.hits[pos[fCellOf[ihit]]++] = cells[ihit];
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFRecHitGrid::query(const Grid &grid, const float eta, const float phi, const double maxRadius,
+                         std::vector<const reco::PFRecHit*> &out) const
+{
+  if(grid.hits.empty()) return;
+
+  // the cone test is done in float, so widen the eta window by a little more than its precision
+  const double pad   = 1e-4;
+  const int    etaLo = etaBin(eta - maxRadius - pad);
+  const int    etaHi = etaBin(eta + maxRadius + pad);
+
+  // phi window, wrapping around at +/-pi
+  const int phiC  = phiBin(phi);
+  int       nPhi  = int(maxRadius/fPhiWidth) + 1;
+  int       phiLo = phiC - nPhi;
+  int       phiHi = phiC + nPhi;
+  if(2*nPhi+1 >= fNPhi) { phiLo = 0; phiHi = fNPhi-1; }
+
+  const unsigned int first = out.size();
+  for(int ieta=etaLo; ieta<=etaHi; ieta++) {
+    for(int ip=phiLo; ip<=phiHi; ip++) {
+      int iphi = ip;
+      if(iphi < 0)      iphi += fNPhi;
+      if(iphi >= fNPhi) iphi -= fNPhi;
+
+      const unsigned int icell = ieta*fNPhi + iphi;
+      for(unsigned int ih=grid.start[icell]; ih<grid.start[icell+1]; ih++) {
+        const Cell &cell = grid.hits[ih];
+        if(reco::deltaR(cell.eta, cell.phi, eta, phi) > maxRadius) continue;
+        out.push_back(cell.hit);
+      }
+    }
+  }
+
+  // hits of a layer are elements of one collection, so address order is collection order
+  std::sort(out.begin()+first, out.end());
+}
+
+//--------------------------------------------------------------------------------------------------
+void PFRecHitGrid::neighbours(const float eta, const float phi, const double maxRadius,
+                              std::vector<const reco::PFRecHit*> &out) const
+{
+  out.clear();
+  for(unsigned int ilayer=0; ilayer<fNLayers; ilayer++) {
+    query(fLayers[ilayer], eta, phi, maxRadius, out);
+  }
+}
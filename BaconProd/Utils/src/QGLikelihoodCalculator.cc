@@ -1,90 +1,88 @@
 #include "BaconProd/Utils/interface/QGLikelihoodCalculator.hh"
-#include "TMVA/Reader.h"
-#include <vector>
+#include "BaconProd/Utils/interface/CalibrationRegistry.hh"
+#include "BaconProd/Utils/interface/BDTForest.hh"
 #include <iostream>
+#include <cassert>
 
 using namespace baconhep;
 
+namespace {
+  // weight file names of the inputs, in the order of the input enum
+  const char* kInputNames[] = { "nvtx", "jetPt", "jetEta", "jetPhi", "beta", "betaStar", "nParticles", "nCharged",
+                                "dRMean", "ptD", "frac01", "frac02", "frac03", "frac04", "frac05" };
+}
+
 //--------------------------------------------------------------------------------------------------
 QGLikelihoodCalculator::QGLikelihoodCalculator():
   fIsInitialized(false),
-  fReader(0),
   fMethodTag("")
 {}
 
 //--------------------------------------------------------------------------------------------------
-QGLikelihoodCalculator::~QGLikelihoodCalculator()
-{
-  delete fReader;
-}
+QGLikelihoodCalculator::~QGLikelihoodCalculator(){}
 
 //--------------------------------------------------------------------------------------------------
 void QGLikelihoodCalculator::initialize(const std::string methodTag, const std::string weightFile)
 {
-  fReader = new TMVA::Reader();
-  
-  fReader->AddVariable("nvtx",       &_nvtx);
-  fReader->AddVariable("jetPt",      &_jetPt);
-  fReader->AddVariable("jetEta",     &_jetEta);
-  fReader->AddVariable("jetPhi",     &_jetPhi);
-  fReader->AddVariable("beta",       &_beta);
-  fReader->AddVariable("betaStar",   &_betaStar);
-  fReader->AddVariable("nParticles", &_nParticles);
-  fReader->AddVariable("nCharged",   &_nCharged);
-  fReader->AddVariable("dRMean",     &_dRMean);
-  fReader->AddVariable("ptD",        &_ptD);
-  fReader->AddVariable("frac01",     &_frac01);
-  fReader->AddVariable("frac02",     &_frac02);
-  fReader->AddVariable("frac03",     &_frac03);
-  fReader->AddVariable("frac04",     &_frac04);
-  fReader->AddVariable("frac05",     &_frac05);
-  
   fMethodTag = methodTag;
-  fReader->BookMVA(fMethodTag, weightFile);
-  
+
+  fForest = CalibrationRegistry::bdtForest(weightFile);
+  assert(fForest);
+  assert(fForest->nOutputs() == 3);
+
+  fVarMap.assign(fForest->nVars(), -1);
+  for(unsigned int iin=0; iin<kNInputs; iin++) {
+    const int ivar = fForest->varIndex(kInputNames[iin]);
+    if(ivar >= 0) fVarMap[ivar] = iin;
+  }
+  for(unsigned int ivar=0; ivar<fVarMap.size(); ivar++) {
+    assert(fVarMap[ivar] >= 0);
+  }
+
   fIsInitialized = true;
 }
 
 //--------------------------------------------------------------------------------------------------
 void QGLikelihoodCalculator::mvaValues(float *qgvals, const float nvtx,
-                                       const float jetPt, const float jetEta, const float jetPhi, const float beta, const float betaStar, 
+                                       const float jetPt, const float jetEta, const float jetPhi, const float beta, const float betaStar,
 				       const float nParticles, const float nCharged, const float dRMean, const float ptD,
 		                       const float frac01, const float frac02, const float frac03, const float frac04, const float frac05,
 				       const bool printDebug)
 {
-  _nvtx       = nvtx;
-  _jetPt      = jetPt;
-  _jetEta     = jetEta;
-  _jetPhi     = jetPhi;
-  _beta       = beta;
-  _betaStar   = betaStar;
-  _nParticles = nParticles;
-  _nCharged   = nCharged;
-  _dRMean     = dRMean;
-  _ptD        = ptD;
-  _frac01     = frac01;
-  _frac02     = frac02;
-  _frac03     = frac03;
-  _frac04     = frac04;
-  _frac05     = frac05;
-  
-  const std::vector<float> &vals = fReader->EvaluateMulticlass(fMethodTag);
-  
+  float inputs[kNInputs];
+  inputs[kNvtx]       = nvtx;
+  inputs[kJetPt]      = jetPt;
+  inputs[kJetEta]     = jetEta;
+  inputs[kJetPhi]     = jetPhi;
+  inputs[kBeta]       = beta;
+  inputs[kBetaStar]   = betaStar;
+  inputs[kNParticles] = nParticles;
+  inputs[kNCharged]   = nCharged;
+  inputs[kDRMean]     = dRMean;
+  inputs[kPtD]        = ptD;
+  inputs[kFrac01]     = frac01;
+  inputs[kFrac02]     = frac02;
+  inputs[kFrac03]     = frac03;
+  inputs[kFrac04]     = frac04;
+  inputs[kFrac05]     = frac05;
+
+  std::vector<float> row(fVarMap.size());
+  for(unsigned int ivar=0; ivar<fVarMap.size(); ivar++) {
+    row[ivar] = inputs[fVarMap[ivar]];
+  }
+  fForest->evaluate(&row[0], 1, qgvals);
+
   if(printDebug) {
     std::cout << "[QGLikelihoodCalculator]" << std::endl;
     std::cout << "Method Tag: " << fMethodTag << std::endl;
-    std::cout << "Inputs: jetPt= " << _jetPt << "  jetEta= " << _jetEta << "  jetPhi= " << _jetPhi;
-    std::cout << "  beta= " << _beta << "  betaStar= " << _betaStar;
-    std::cout << "  nParticles= " << _nParticles << "  nCharged= " << _nCharged;
-    std::cout << "  dRMean= " << _dRMean << "  ptD= " << _ptD;
-    std::cout << "  frac01= " << _frac01 << "  frac02= " << _frac02 << "  frac03= " << _frac03 << "  frac04= " << _frac04 << "  frac05= " << _frac05;
+    std::cout << "Inputs: jetPt= " << jetPt << "  jetEta= " << jetEta << "  jetPhi= " << jetPhi;
+    std::cout << "  beta= " << beta << "  betaStar= " << betaStar;
+    std::cout << "  nParticles= " << nParticles << "  nCharged= " << nCharged;
+    std::cout << "  dRMean= " << dRMean << "  ptD= " << ptD;
+    std::cout << "  frac01= " << frac01 << "  frac02= " << frac02 << "  frac03= " << frac03 << "  frac04= " << frac04 << "  frac05= " << frac05;
     std::cout << std::endl;
-    std::cout << " > Quark LL   = " << vals[0] << std::endl;
-    std::cout << " > Gluon LL   = " << vals[1] << std::endl;
-    std::cout << " > Pile-up LL = " << vals[2] << std::endl;
+    std::cout << " > Quark LL   = " << qgvals[0] << std::endl;
+    std::cout << " > Gluon LL   = " << qgvals[1] << std::endl;
+    std::cout << " > Pile-up LL = " << qgvals[2] << std::endl;
   }
-  
-  qgvals[0] = vals[0];
-  qgvals[1] = vals[1];
-  qgvals[2] = vals[2];
 }
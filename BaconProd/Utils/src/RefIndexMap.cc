@@ -0,0 +1,160 @@
+#include "BaconProd/Utils/interface/RefIndexMap.hh"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+RefIndexMap::RefIndexMap():
+  fPFCandCol(0),
+  fNTracks  (0),
+  fNEBSC    (0),
+  fNEESC    (0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+RefIndexMap::~RefIndexMap(){}
+
+//--------------------------------------------------------------------------------------------------
+void RefIndexMap::build(const edm::Handle<reco::PFCandidateCollection>  &hPFCands,
+                        const edm::Handle<reco::TrackCollection>        &hTracks,
+                        const edm::Handle<reco::SuperClusterCollection> &hEBSC,
+                        const edm::Handle<reco::SuperClusterCollection> &hEESC)
+{
+  assert(hPFCands.isValid());
+  assert(hTracks.isValid());
+  assert(hEBSC.isValid());
+  assert(hEESC.isValid());
+
+  fPFCandCol = hPFCands.product();
+  fTrackID   = hTracks.id();
+  fEBSCID    = hEBSC.id();
+  fEESCID    = hEESC.id();
+  fNTracks   = hTracks->size();
+  fNEBSC     = hEBSC->size();
+  fNEESC     = hEESC->size();
+
+  std::vector<Entry> lTrackEntries, lGsfEntries, lSCEntries;
+  for(unsigned int ipf=0; ipf<fPFCandCol->size(); ipf++) {
+    const reco::PFCandidate &pfcand = (*fPFCandCol)[ipf];
+    Entry entry;
+    entry.index = ipf;
+    if(pfcand.trackRef().isNonnull()) {
+      entry.id  = pfcand.trackRef().id();
+      entry.key = pfcand.trackRef().key();
+      lTrackEntries.push_back(entry);
+    }
+    if(pfcand.gsfTrackRef().isNonnull()) {
+      entry.id  = pfcand.gsfTrackRef().id();
+      entry.key = pfcand.gsfTrackRef().key();
+      lGsfEntries.push_back(entry);
+    }
+    if(pfcand.superClusterRef().isNonnull()) {
+      entry.id  = pfcand.superClusterRef().id();
+      entry.key = pfcand.superClusterRef().key();
+      lSCEntries.push_back(entry);
+    }
+  }
+  fillTables(lTrackEntries, fPFByTrack);
+  fillTables(lGsfEntries,   fPFByGsfTrack);
+  fillTables(lSCEntries,    fPFBySC);
+}
+
+//--------------------------------------------------------------------------------------------------
+void RefIndexMap::fillTables(const std::vector<Entry> &entries, std::vector<KeyTable> &tables)
+{
+  // one table per referenced product, with a counting sort by key that keeps collection order
+  tables.clear();
+  std::vector<unsigned int> lTableOf(entries.size());
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    unsigned int itab=0;
+    for(; itab<tables.size(); itab++) {
+      if(tables[itab].id == entries[ie].id) break;
+    }
+    if(itab == tables.size()) {
+      tables.push_back(KeyTable());
+      tables.back().id = entries[ie].id;
+      tables.back().start.assign(1, 0);
+    }
+    KeyTable &table = tables[itab];
+    if(table.start.size() < entries[ie].key+2) table.start.resize(entries[ie].key+2, 0);
+    table.start[entries[ie].key+1]++;
+    lTableOf[ie] = itab;
+  }
+
+  std::vector< std::vector<unsigned int> > lPos(tables.size());
+  for(unsigned int itab=0; itab<tables.size(); itab++) {
+    KeyTable &table = tables[itab];
+    for(unsigned int ikey=1; ikey<table.start.size(); ikey++) {
+      table.start[ikey] += table.start[ikey-1];
+    }
+    table.index.resize(table.start.back());
+    lPos[itab].assign(table.start.begin(), table.start.end()-1);
+  }
+
+  for(unsigned int ie=0; ie<entries.size(); ie++) {
+    KeyTable &table = tables[lTableOf[ie]];
+    table.index[lPos[lTableOf[ie]][entries[ie].key]++] = entries[ie].index;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+const RefIndexMap::KeyTable* RefIndexMap::findTable(const std::vector<KeyTable> &tables,
+                                                    const edm::ProductID &id, const unsigned int key)
+{
+  for(unsigned int itab=0; itab<tables.size(); itab++) {
+    if(tables[itab].id != id) continue;
+    if(key+1 >= tables[itab].start.size()) return 0;
+    return &tables[itab];
+  }
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int RefIndexMap::pfCandIndex(const reco::TrackRef &track) const
+{
+  if(track.isNull()) return -1;
+  const KeyTable *table = findTable(fPFByTrack, track.id(), track.key());
+  if(!table) return -1;
+  const unsigned int end = table->start[track.key()+1];
+  return (end > table->start[track.key()]) ? table->index[end-1] : -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+int RefIndexMap::pfCandIndex(const reco::GsfTrackRef &gsfTrack) const
+{
+  if(gsfTrack.isNull()) return -1;
+  const KeyTable *table = findTable(fPFByGsfTrack, gsfTrack.id(), gsfTrack.key());
+  if(!table) return -1;
+  const unsigned int end = table->start[gsfTrack.key()+1];
+  return (end > table->start[gsfTrack.key()]) ? table->index[end-1] : -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+void RefIndexMap::pfCandIndices(const reco::SuperClusterRef &sc, std::vector<int> &out) const
+{
+  out.clear();
+  if(sc.isNull()) return;
+  const KeyTable *table = findTable(fPFBySC, sc.id(), sc.key());
+  if(!table) return;
+  out.assign(table->index.begin() + table->start[sc.key()], table->index.begin() + table->start[sc.key()+1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+int RefIndexMap::trackIndex(const reco::TrackRef &track) const
+{
+  if(track.isNull() || track.id() != fTrackID || track.key() >= fNTracks) return -1;
+  return track.key();
+}
+
+//--------------------------------------------------------------------------------------------------
+int RefIndexMap::scIndex(const reco::SuperClusterRef &sc) const
+{
+  if(sc.isNull()) return -1;
+  if(sc.id() == fEBSCID && sc.key() < fNEBSC) return sc.key();
+  if(sc.id() == fEESCID && sc.key() < fNEESC) return fNEBSC + sc.key();
+  return -1;
+}
@@ -0,0 +1,113 @@
+#include "BaconProd/Utils/interface/ShowerShapes.hh"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "RecoEcal/EgammaCoreTools/interface/EcalClusterLazyTools.h"
+#include <cassert>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+ShowerShapes::Count::Count():
+  nRecords (0),
+  nRepeated(0)
+{
+  for(unsigned int i=0; i<kNCounters; i++) { nRequests[i] = 0; nEvaluations[i] = 0; }
+}
+
+//--------------------------------------------------------------------------------------------------
+void ShowerShapes::Count::report(std::ostream &os, const std::string &label) const
+{
+  unsigned long nSeedRequests = 0, nSeedEvaluations = 0;
+  for(unsigned int i=0; i<kClusters; i++) { nSeedRequests += nRequests[i]; nSeedEvaluations += nEvaluations[i]; }
+  os << "[ShowerShapes] " << label << ": " << nRecords << " records, " << nSeedRequests << " seed requests, "
+     << nSeedEvaluations << " lazy-tools evaluations of the seed (" << nRepeated << " repeated), "
+     << nEvaluations[kClusters] << " of other clusters" << std::endl;
+}
+
+//--------------------------------------------------------------------------------------------------
+ShowerShapes::ShowerShapes(EcalClusterLazyTools &lazyTools, const reco::SuperCluster &sc, Count *count):
+  fLazyTools(&lazyTools),
+  fSeed     (sc.seed().get()),
+  fRawEnergy(sc.rawEnergy()),
+  fCount    (count),
+  fComputed (0),
+  fHasCov   (false)
+{
+  assert(fSeed);
+  for(unsigned int i=0; i<kNCounters; i++) { fNRequests[i] = 0; fNEvaluations[i] = 0; }
+}
+
+//--------------------------------------------------------------------------------------------------
+ShowerShapes::~ShowerShapes()
+{
+  if(!fCount) return;
+  fCount->nRecords++;
+  for(unsigned int i=0; i<kNCounters; i++) {
+    fCount->nRequests[i]    += fNRequests[i];
+    fCount->nEvaluations[i] += fNEvaluations[i];
+    if(i < kClusters && fNEvaluations[i] > 1) fCount->nRepeated += fNEvaluations[i]-1;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+float ShowerShapes::get(const Quantity q) const
+{
+  fNRequests[q]++;
+  const unsigned int bit = 1u<<q;
+  if(fComputed & bit) return fValues[q];
+
+  fNEvaluations[q]++;
+  float val = 0;
+  switch(q) {
+    case kE3x3:       val = fLazyTools->e3x3(*fSeed);       break;
+    case kE5x5:       val = fLazyTools->e5x5(*fSeed);       break;
+    case kEMax:       val = fLazyTools->eMax(*fSeed);       break;
+    case kE2nd:       val = fLazyTools->e2nd(*fSeed);       break;
+    case kETop:       val = fLazyTools->eTop(*fSeed);       break;
+    case kEBottom:    val = fLazyTools->eBottom(*fSeed);    break;
+    case kELeft:      val = fLazyTools->eLeft(*fSeed);      break;
+    case kERight:     val = fLazyTools->eRight(*fSeed);     break;
+    case kE2x5Max:    val = fLazyTools->e2x5Max(*fSeed);    break;
+    case kE2x5Top:    val = fLazyTools->e2x5Top(*fSeed);    break;
+    case kE2x5Bottom: val = fLazyTools->e2x5Bottom(*fSeed); break;
+    case kE2x5Left:   val = fLazyTools->e2x5Left(*fSeed);   break;
+    case kE2x5Right:  val = fLazyTools->e2x5Right(*fSeed);  break;
+    default: assert(0);
+  }
+  fValues[q] = val;
+  fComputed |= bit;
+  return val;
+}
+
+//--------------------------------------------------------------------------------------------------
+double ShowerShapes::r9() const
+{
+  return e3x3() / fRawEnergy;
+}
+
+//--------------------------------------------------------------------------------------------------
+const std::vector<float>& ShowerShapes::localCovariances() const
+{
+  fNRequests[kLocalCovariances]++;
+  if(!fHasCov) {
+    fNEvaluations[kLocalCovariances]++;
+    fCov    = fLazyTools->localCovariances(*fSeed);
+    fHasCov = true;
+  }
+  return fCov;
+}
+
+//--------------------------------------------------------------------------------------------------
+float ShowerShapes::clusterEMax(const reco::CaloCluster &cluster) const
+{
+  fNRequests[kClusters]++;
+  fNEvaluations[kClusters]++;
+  return fLazyTools->eMax(cluster);
+}
+
+//--------------------------------------------------------------------------------------------------
+float ShowerShapes::clusterE3x3(const reco::CaloCluster &cluster) const
+{
+  fNRequests[kClusters]++;
+  fNEvaluations[kClusters]++;
+  return fLazyTools->e3x3(cluster);
+}
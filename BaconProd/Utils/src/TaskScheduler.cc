@@ -0,0 +1,204 @@
+#include "BaconProd/Utils/interface/TaskScheduler.hh"
+#include <TClonesArray.h>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <sstream>
+
+using namespace baconhep;
+
+namespace {
+  // created at library load, before any task can run
+  boost::mutex sFrameworkMutex;
+
+  std::vector<std::string> splitNames(const std::string &names)
+  {
+    std::vector<std::string> out;
+    std::stringstream ss(names);
+    std::string name;
+    while(std::getline(ss,name,',')) {
+      const size_t first = name.find_first_not_of(" ");
+      if(first == std::string::npos) continue;
+      out.push_back(name.substr(first, name.find_last_not_of(" ")-first+1));
+    }
+    return out;
+  }
+
+  bool intersects(const std::vector<std::string> &a, const std::vector<std::string> &b)
+  {
+    for(unsigned int i=0; i<a.size(); i++) {
+      if(std::find(b.begin(), b.end(), a[i]) != b.end()) return true;
+    }
+    return false;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+TaskScheduler::TaskScheduler():
+  fWorkers (0),
+  fNWorkers(0),
+  fRun     (0),
+  fNActive (0),
+  fNBusy   (0),
+  fStop    (false),
+  fNDone   (0),
+  fNRunning(0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+TaskScheduler::~TaskScheduler()
+{
+  if(!fWorkers) return;
+  {
+    boost::mutex::scoped_lock lock(fMutex);
+    fStop = true;
+    fCondition.notify_all();
+  }
+  fWorkers->join_all();
+  delete fWorkers;
+  fWorkers = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::addTask(const std::string &name, const boost::function<void()> &task,
+                            const std::string &inputs, const std::string &outputs)
+{
+  Task newTask;
+  newTask.name    = name;
+  newTask.task    = task;
+  newTask.inputs  = splitNames(inputs);
+  newTask.outputs = splitNames(outputs);
+  newTask.nDeps   = 0;
+
+  const int index = fTasks.size();
+  for(unsigned int itask=0; itask<fTasks.size(); itask++) {
+    Task &prev = fTasks[itask];
+    if(intersects(prev.outputs, newTask.inputs) || intersects(prev.outputs, newTask.outputs) || intersects(prev.inputs, newTask.outputs)) {
+      prev.successors.push_back(index);
+      newTask.nDeps++;
+    }
+  }
+  fTasks.push_back(newTask);
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::clear()
+{
+  fTasks.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::run(const int nThreads)
+{
+  if(nThreads <= 1 || fTasks.size() <= 1) {
+    for(unsigned int itask=0; itask<fTasks.size(); itask++) {
+      fTasks[itask].task();
+    }
+    return;
+  }
+
+  // the calling thread is one of the threads
+  const unsigned int nWorkers = std::min(nThreads, (int)fTasks.size()) - 1;
+
+  boost::mutex::scoped_lock lock(fMutex);
+  if(!fWorkers) fWorkers = new boost::thread_group();
+  for(; fNWorkers<nWorkers; fNWorkers++) {
+    fWorkers->create_thread(boost::bind(&TaskScheduler::worker, this, fNWorkers));
+  }
+
+  fPending.resize(fTasks.size());
+  fReady.clear();
+  for(unsigned int itask=0; itask<fTasks.size(); itask++) {
+    fPending[itask] = fTasks[itask].nDeps;
+    if(fPending[itask] == 0) fReady.insert(itask);
+  }
+  fNDone     = 0;
+  fNRunning  = 0;
+  fException = boost::exception_ptr();
+  fNActive   = nWorkers;
+  fRun++;
+  fCondition.notify_all();
+
+  runTasks(lock);
+
+  // the workers may still be running their last tasks, or not have seen the run yet
+  while(fNRunning > 0 || fNBusy > 0) {
+    fCondition.wait(lock);
+  }
+  fNActive = 0;
+  const boost::exception_ptr error = fException;
+  lock.unlock();
+
+  if(error) boost::rethrow_exception(error);
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::worker(const unsigned int iworker)
+{
+  boost::mutex::scoped_lock lock(fMutex);
+  unsigned long lastRun = 0;
+  while(true) {
+    // wait for a run this worker takes part in
+    while(!fStop && (fRun == lastRun || iworker >= fNActive)) {
+      if(iworker >= fNActive) lastRun = fRun;
+      fCondition.wait(lock);
+    }
+    if(fStop) return;
+
+    lastRun = fRun;
+    fNBusy++;
+    runTasks(lock);
+    fNBusy--;
+    fCondition.notify_all();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::runTasks(boost::mutex::scoped_lock &lock)
+{
+  while(true) {
+    // stop when everything ran, or after a failure (tasks already running still finish)
+    while(fReady.empty() && fNDone < fTasks.size() && !fException) {
+      fCondition.wait(lock);
+    }
+    if(fNDone == fTasks.size() || fException) {
+      fCondition.notify_all();
+      return;
+    }
+
+    const int itask = *fReady.begin();
+    fReady.erase(fReady.begin());
+    fNRunning++;
+
+    lock.unlock();
+    boost::exception_ptr error;
+    try {
+      fTasks[itask].task();
+    } catch(...) {
+      error = boost::current_exception();
+    }
+    lock.lock();
+
+    fNRunning--;
+    fNDone++;
+    if(error && !fException) fException = error;
+    for(unsigned int isucc=0; isucc<fTasks[itask].successors.size(); isucc++) {
+      const int next = fTasks[itask].successors[isucc];
+      if(--fPending[next] == 0) fReady.insert(next);
+    }
+    fCondition.notify_all();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+boost::mutex& TaskScheduler::frameworkMutex()
+{
+  return sFrameworkMutex;
+}
+
+//--------------------------------------------------------------------------------------------------
+void TaskScheduler::preallocate(TClonesArray *array)
+{
+  array->ExpandCreateFast(array->GetSize());
+  array->Clear();
+}
@@ -0,0 +1,208 @@
+#include "BaconProd/Utils/interface/TrackVertexMap.hh"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+TrackVertexMap::TrackVertexMap():
+  fPFCandCol(0),
+  fPVCol    (0),
+  fPV       (0),
+  fPVIndex  (-1),
+  fMaxVtxRho(0)
+{}
+
+//--------------------------------------------------------------------------------------------------
+TrackVertexMap::~TrackVertexMap(){}
+
+//--------------------------------------------------------------------------------------------------
+void TrackVertexMap::build(const reco::PFCandidateCollection *pfCandCol,
+                           const reco::VertexCollection      *pvCol,
+                           const reco::Vertex                &pv)
+{
+  assert(pfCandCol);
+  assert(pvCol);
+  
+  fPFCandCol = pfCandCol;
+  fPVCol     = pvCol;
+  fPV        = &pv;
+  fPVIndex   = -1;
+  fMaxVtxRho = 0;
+  fTracks.clear();
+  fZSorted.clear();
+  fPFAssoc.clear();
+  
+  //
+  // Vertex z-ordering
+  //==============================
+  for(unsigned int ivtx=0; ivtx<pvCol->size(); ivtx++) {
+    const reco::Vertex &vtx = (*pvCol)[ivtx];
+    if(&vtx == &pv) fPVIndex = ivtx;
+    if(vtx.position().Rho() > fMaxVtxRho) fMaxVtxRho = vtx.position().Rho();
+    
+    ZEntry zentry;
+    zentry.z     = vtx.z();
+    zentry.index = ivtx;
+    fZSorted.push_back(zentry);
+  }
+  std::sort(fZSorted.begin(), fZSorted.end());
+  
+  //
+  // Track -> vertex table
+  //==============================
+  // one entry per (track, vertex) pair, read from the vertex track lists
+  std::vector<TrackEntry> lPairs;
+  for(unsigned int ivtx=0; ivtx<pvCol->size(); ivtx++) {
+    const reco::Vertex &vtx = (*pvCol)[ivtx];
+    for(reco::Vertex::trackRef_iterator itTrk = vtx.tracks_begin(); itTrk!=vtx.tracks_end(); ++itTrk) {
+      TrackEntry entry;
+      entry.id        = itTrk->id();
+      entry.key       = itTrk->key();
+      entry.vtxIndex  = ivtx;
+      entry.vtxWeight = vtx.trackWeight(*itTrk);
+      entry.pvWeight  = 0;
+      lPairs.push_back(entry);
+    }
+  }
+  std::sort(lPairs.begin(), lPairs.end());
+  
+  // collapse to one entry per track: first vertex with non-zero weight, and the weight in the PV
+  for(unsigned int i0=0; i0<lPairs.size(); ) {
+    TrackEntry entry = lPairs[i0];
+    entry.vtxIndex  = -1;
+    entry.vtxWeight = 0;
+    entry.pvWeight  = 0;
+    unsigned int i1 = i0;
+    for(; i1<lPairs.size() && lPairs[i1].id == lPairs[i0].id && lPairs[i1].key == lPairs[i0].key; i1++) {
+      if(entry.vtxIndex<0 && lPairs[i1].vtxWeight>0) {
+        entry.vtxIndex  = lPairs[i1].vtxIndex;
+        entry.vtxWeight = lPairs[i1].vtxWeight;
+      }
+      if(lPairs[i1].vtxIndex == fPVIndex) entry.pvWeight = lPairs[i1].vtxWeight;
+    }
+    fTracks.push_back(entry);
+    i0 = i1;
+  }
+  
+  //
+  // PF candidate associations
+  //==============================
+  fPFAssoc.resize(pfCandCol->size());
+  for(unsigned int ipf=0; ipf<pfCandCol->size(); ipf++) {
+    const reco::PFCandidate &pfcand = (*pfCandCol)[ipf];
+    PFAssoc &assoc = fPFAssoc[ipf];
+    assoc.vtxIndex     = -1;
+    assoc.vtxWeight    = 0;
+    assoc.pvWeight     = 0;
+    
+    if(pfcand.trackRef().isNonnull()) {
+      const TrackEntry *entry = findTrack(pfcand.trackRef());
+      if(entry) {
+        assoc.vtxIndex  = entry->vtxIndex;
+        assoc.vtxWeight = entry->vtxWeight;
+        assoc.pvWeight  = entry->pvWeight;
+      }
+    }
+    
+    assoc.closestIndex = closestVertex(pfcand.vertex().z());
+    assoc.dzClosest    = (assoc.closestIndex>=0) ? fabs(pfcand.vertex().z() - (*pvCol)[assoc.closestIndex].z()) : -1;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+const TrackVertexMap::TrackEntry* TrackVertexMap::findTrack(const reco::TrackRef &track) const
+{
+  TrackEntry key;
+  key.id       = track.id();
+  key.key      = track.key();
+  key.vtxIndex = -1;
+  std::vector<TrackEntry>::const_iterator it = std::lower_bound(fTracks.begin(), fTracks.end(), key);
+  if(it==fTracks.end() || it->id != key.id || it->key != key.key) return 0;
+  return &(*it);
+}
+
+//--------------------------------------------------------------------------------------------------
+int TrackVertexMap::vertexIndex(const reco::TrackRef &track) const
+{
+  const TrackEntry *entry = track.isNonnull() ? findTrack(track) : 0;
+  return entry ? entry->vtxIndex : -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+float TrackVertexMap::vertexWeight(const reco::TrackRef &track) const
+{
+  const TrackEntry *entry = track.isNonnull() ? findTrack(track) : 0;
+  return entry ? entry->vtxWeight : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+float TrackVertexMap::pvWeight(const reco::TrackRef &track) const
+{
+  const TrackEntry *entry = track.isNonnull() ? findTrack(track) : 0;
+  return entry ? entry->pvWeight : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+int TrackVertexMap::closestVertex(const double z, const double maxDz) const
+{
+  if(fZSorted.empty()) return -1;
+  
+  ZEntry key;
+  key.z     = z;
+  key.index = -1;
+  
+  // first vertex at or above z, and the first vertex of the z-run just below it
+  std::vector<ZEntry>::const_iterator itHi = std::lower_bound(fZSorted.begin(), fZSorted.end(), key);
+  std::vector<ZEntry>::const_iterator itLo = fZSorted.end();
+  if(itHi != fZSorted.begin()) {
+    itLo = itHi-1;
+    while(itLo != fZSorted.begin() && (itLo-1)->z == itLo->z) --itLo;
+  }
+  
+  int    best   = -1;
+  double bestDz = maxDz;
+  if(itHi != fZSorted.end()) {
+    double dz = fabs(z - itHi->z);
+    if(dz < bestDz) { best = itHi->index; bestDz = dz; }
+  }
+  if(itLo != fZSorted.end()) {
+    double dz = fabs(z - itLo->z);
+    if(dz < bestDz || (dz == bestDz && best >= 0 && itLo->index < best)) { best = itLo->index; bestDz = dz; }
+  }
+  return best;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool TrackVertexMap::hasCompatibleVertex(const reco::Track &track, const double dzCut,
+                                         const double minNdof, const double minDistToPV) const
+{
+  assert(fPVCol);
+  
+  // |dz| differs from the z separation by the transverse term of Track::dz(), which is bounded
+  // by the transverse distance between track reference point and vertex times |pz|/pt
+  std::vector<ZEntry>::const_iterator itBegin = fZSorted.begin();
+  std::vector<ZEntry>::const_iterator itEnd   = fZSorted.end();
+  double zMax = 0;
+  if(track.pt() > 0) {
+    const double window = dzCut + (track.referencePoint().Rho() + fMaxVtxRho)*fabs(track.pz())/track.pt() + 1e-6;
+    ZEntry key;
+    key.z     = track.vz() - window;
+    key.index = -1;
+    itBegin = std::lower_bound(fZSorted.begin(), fZSorted.end(), key);
+    zMax    = track.vz() + window;
+  }
+  
+  for(std::vector<ZEntry>::const_iterator it = itBegin; it!=itEnd; ++it) {
+    if(track.pt() > 0 && it->z > zMax) break;
+    
+    const reco::Vertex &vtx = (*fPVCol)[it->index];
+    if(vtx.ndof() < minNdof || (fPV->position() - vtx.position()).R() < minDistToPV) continue;
+    if(fabs(track.dz(vtx.position())) < dzCut) return true;
+  }
+  return false;
+}
@@ -0,0 +1,96 @@
+#include "BaconProd/Utils/interface/TriggerObjectMatcher.hh"
+#include "DataFormats/HLTReco/interface/TriggerEvent.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include <cmath>
+
+using namespace baconhep;
+
+//--------------------------------------------------------------------------------------------------
+TriggerObjectMatcher::TriggerObjectMatcher(const double dRMax):
+  fDRMax(dRMax)
+{}
+
+//--------------------------------------------------------------------------------------------------
+TriggerObjectMatcher::~TriggerObjectMatcher(){}
+
+//--------------------------------------------------------------------------------------------------
+void TriggerObjectMatcher::setFilters(const std::vector<TriggerRecord> &triggerRecords)
+{
+  // one entry per filter name, with the bits of every record referring to it
+  fFilters.clear();
+  for(unsigned int irec=0; irec<triggerRecords.size(); irec++) {
+    for(unsigned int iobj=0; iobj<triggerRecords[irec].objectMap.size(); iobj++) {
+      const std::string  &filterName = triggerRecords[irec].objectMap[iobj].first;
+      const unsigned int  filterBit  = triggerRecords[irec].objectMap[iobj].second;
+
+      unsigned int ifilt=0;
+      for(; ifilt<fFilters.size(); ifilt++) {
+        if(fFilters[ifilt].tag.label() == filterName) break;
+      }
+      if(ifilt == fFilters.size()) {
+        Filter filter;
+        filter.tag = edm::InputTag(filterName,"","HLT");
+        fFilters.push_back(filter);
+      }
+      fFilters[ifilt].mask[filterBit] = 1;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void TriggerObjectMatcher::build(const trigger::TriggerEvent &triggerEvent)
+{
+  fFilterIndex.clear();
+  fStart.assign(1, 0);
+  fEta.clear();
+  fPhi.clear();
+
+  const trigger::TriggerObjectCollection &toc = triggerEvent.getObjects();
+  for(unsigned int ifilt=0; ifilt<fFilters.size(); ifilt++) {
+    // filterIndex must be less than the size of trgEvent or you get a CMSException: _M_range_check
+    const trigger::size_type index = triggerEvent.filterIndex(fFilters[ifilt].tag);
+    if(index >= triggerEvent.sizeFilters()) continue;
+
+    const trigger::Keys &keys = triggerEvent.filterKeys(index);
+    if(keys.empty()) continue;
+    for(unsigned int hlto=0; hlto<keys.size(); hlto++) {
+      const trigger::TriggerObject &tobj = toc[keys[hlto]];
+      fEta.push_back(tobj.eta());
+      fPhi.push_back(tobj.phi());
+    }
+    fFilterIndex.push_back(ifilt);
+    fStart.push_back(fEta.size());
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+void TriggerObjectMatcher::add(const double eta, const double phi, TriggerObjects &bits)
+{
+  Query query;
+  query.eta  = eta;
+  query.phi  = phi;
+  query.bits = &bits;
+  fQueries.push_back(query);
+}
+
+//--------------------------------------------------------------------------------------------------
+void TriggerObjectMatcher::match()
+{
+  for(unsigned int irange=0; irange<fFilterIndex.size(); irange++) {
+    const TriggerObjects &mask = fFilters[fFilterIndex[irange]].mask;
+
+    for(unsigned int iq=0; iq<fQueries.size(); iq++) {
+      Query &query = fQueries[iq];
+      if(((*query.bits) & mask) == mask) continue;  // nothing left to set by this filter
+
+      for(unsigned int ihlt=fStart[irange]; ihlt<fStart[irange+1]; ihlt++) {
+        if(fabs(query.eta - fEta[ihlt]) >= fDRMax) continue;
+        if(reco::deltaR(query.eta, query.phi, fEta[ihlt], fPhi[ihlt]) < fDRMax) {
+          (*query.bits) |= mask;
+          break;
+        }
+      }
+    }
+  }
+  fQueries.clear();
+}